@@ -22,13 +22,10 @@
 
 #include "lut.h"
 
-/* The number of bits to form the hash, which governs the overall size
- * of the hash lookup table, and hence the amount of chaining */
-
-#define HASH_BITS 16
+#define HASH_BITS LUT_HASH_BITS
 
 #define HASH(timecode) ((timecode) & ((1 << HASH_BITS) - 1))
-#define NO_SLOT ((unsigned)-1)
+#define NO_SLOT LUT_NO_SLOT
 
 
 /* Initialise an empty hash lookup table to store the given number
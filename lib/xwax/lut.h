@@ -20,6 +20,13 @@
 #ifndef LUT_H
 #define LUT_H
 
+/* The number of bits to form the hash, which governs the overall size
+ * of the hash lookup table, and hence the amount of chaining */
+
+#define LUT_HASH_BITS 16
+
+#define LUT_NO_SLOT ((unsigned)-1)
+
 typedef unsigned int slot_no_t;
 
 struct slot {
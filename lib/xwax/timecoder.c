@@ -248,24 +248,70 @@ static int build_lookup(struct timecode_def *def)
  */
 
 struct timecode_def* timecoder_find_definition(const char *name)
+{
+    struct timecode_def *def;
+
+    def = timecoder_find_definition_without_lookup(name);
+    if (def == NULL)
+        return NULL;  /* not found */
+
+    if (build_lookup(def) == -1)
+        return NULL;  /* error */
+
+    return def;
+}
+
+/*
+ * Find a timecode definition by name, without building its lookup
+ * table. The table must be built or set before the definition is
+ * used by a timecoder.
+ *
+ * Return: pointer to timecode definition, or NULL if not available
+ */
+
+struct timecode_def* timecoder_find_definition_without_lookup(const char *name)
 {
     unsigned int n;
 
     for (n = 0; n < ARRAY_SIZE(timecodes); n++) {
         struct timecode_def *def = &timecodes[n];
 
-        if (strcmp(def->name, name) != 0)
-            continue;
-
-        if (build_lookup(def) == -1)
-            return NULL;  /* error */
-
-        return def;
+        if (strcmp(def->name, name) == 0)
+            return def;
     }
 
     return NULL;  /* not found */
 }
 
+/*
+ * Where necessary, build the lookup table of a definition
+ *
+ * Return: -1 if not enough memory could be allocated, otherwise 0
+ */
+
+int timecoder_build_lookup(struct timecode_def *def)
+{
+    return build_lookup(def);
+}
+
+/*
+ * Use a lookup table that has been built previously, e.g. one that
+ * has been mapped from a file. The memory is owned by the caller and
+ * must stay valid until timecoder_free_lookup() is called.
+ */
+
+void timecoder_set_lookup(struct timecode_def *def,
+                          struct slot *slot, slot_no_t *table)
+{
+    assert(!def->lookup);
+
+    def->lut.slot = slot;
+    def->lut.table = table;
+    def->lut.avail = def->length;
+    def->lookup = true;
+    def->external_lookup = true;
+}
+
 /*
  * Free the timecoder lookup tables when they are no longer needed
  */
@@ -276,8 +322,11 @@ void timecoder_free_lookup(void) {
     for (n = 0; n < ARRAY_SIZE(timecodes); n++) {
         struct timecode_def *def = &timecodes[n];
 
-        if (def->lookup)
+        if (def->lookup && !def->external_lookup)
             lut_clear(&def->lut);
+
+        def->lookup = false;
+        def->external_lookup = false;
     }
 }
 
@@ -42,7 +42,8 @@ struct timecode_def {
         taps; /* central LFSR taps, excluding end taps */
     unsigned int length, /* in cycles */
         safe; /* last 'safe' timecode number (for auto disconnect) */
-    bool lookup; /* true if lut has been generated */
+    bool lookup, /* true if lut has been generated */
+        external_lookup; /* true if lut memory is owned by the caller */
     struct lut lut;
 };
 
@@ -83,6 +84,10 @@ struct timecoder {
 };
 
 struct timecode_def* timecoder_find_definition(const char *name);
+struct timecode_def* timecoder_find_definition_without_lookup(const char *name);
+int timecoder_build_lookup(struct timecode_def *def);
+void timecoder_set_lookup(struct timecode_def *def,
+                          struct slot *slot, slot_no_t *table);
 void timecoder_free_lookup(void);
 
 void timecoder_init(struct timecoder *tc, struct timecode_def *def,
@@ -40,6 +40,9 @@ Mixxx.ControllerScreen {
     }
 
     // function transformFrame(input: ArrayBuffer, timestamp: date) {
+    // Screens with partialUpdate="true" also receive the changed regions of
+    // the frame, as an array of {x, y, width, height} objects.
+    // function transformFrame(input: ArrayBuffer, timestamp: date, damage: Array) {
     transformFrame: function(input, timestamp) {
         return new ArrayBuffer(0);
     }
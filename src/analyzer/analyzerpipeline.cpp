@@ -0,0 +1,128 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <QThread>
+
+#include "analyzer/constants.h"
+#include "rigtorp/SPSCQueue.h"
+#include "util/assert.h"
+#include "util/tracerecorder.h"
+
+namespace {
+
+// Allows the decoding thread to run ahead of the slowest analyzer
+// by a few chunks, which compensates the varying processing time of
+// the analyzers per chunk.
+constexpr int kNumChunks = 4;
+
+} // anonymous namespace
+
+class AnalyzerPipeline::Stage final : public QThread {
+  public:
+    Stage(AnalyzerPipeline* pPipeline, AnalyzerWithState* pAnalyzer)
+            : m_pPipeline(pPipeline),
+              m_pAnalyzer(pAnalyzer),
+              // All chunks and the nullptr that terminates the thread
+              m_queue(kNumChunks + 1),
+              m_queuedChunks(0) {
+        setObjectName(QStringLiteral("AnalyzerPipeline::Stage"));
+    }
+
+    ~Stage() override {
+        enqueue(nullptr);
+        wait();
+    }
+
+    void enqueue(Chunk* pChunk) {
+        // Never blocks, because the number of chunks in flight is bounded
+        const bool enqueued = m_queue.try_push(pChunk);
+        VERIFY_OR_DEBUG_ASSERT(enqueued) {
+            m_queue.push(pChunk);
+        }
+        m_queuedChunks.release();
+    }
+
+  protected:
+    void run() override {
+        while (true) {
+            m_queuedChunks.acquire();
+            Chunk** ppChunk = m_queue.front();
+            DEBUG_ASSERT(ppChunk);
+            Chunk* pChunk = *ppChunk;
+            m_queue.pop();
+            if (!pChunk) {
+                return;
+            }
+            {
+                mixxx::ScopedTraceEvent traceEvent("AnalyzerPipeline::processSamples");
+                m_pAnalyzer->processSamples(pChunk->pSamples,
+                        static_cast<int>(pChunk->sampleCount));
+            }
+            m_pPipeline->releaseChunk(pChunk);
+        }
+    }
+
+  private:
+    AnalyzerPipeline* const m_pPipeline;
+    AnalyzerWithState* const m_pAnalyzer;
+    rigtorp::SPSCQueue<Chunk*> m_queue;
+    QSemaphore m_queuedChunks;
+};
+
+AnalyzerPipeline::AnalyzerPipeline(std::vector<AnalyzerWithState>* pAnalyzers)
+        : m_nextChunk(0),
+          m_freeChunks(kNumChunks) {
+    DEBUG_ASSERT(pAnalyzers);
+    m_chunks.reserve(kNumChunks);
+    for (int i = 0; i < kNumChunks; ++i) {
+        m_chunks.push_back(std::make_unique<Chunk>());
+        m_chunks.back()->buffer = mixxx::SampleBuffer(mixxx::kAnalysisSamplesPerChunk);
+    }
+    m_stages.reserve(pAnalyzers->size());
+    for (auto& analyzer : *pAnalyzers) {
+        m_stages.push_back(std::make_unique<Stage>(this, &analyzer));
+        // Inherits the priority of the owning thread
+        m_stages.back()->start();
+    }
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    drain();
+    // Terminates and joins all stages
+    m_stages.clear();
+}
+
+mixxx::SampleBuffer::WritableSlice AnalyzerPipeline::nextChunkBuffer() {
+    m_freeChunks.acquire();
+    Chunk* pChunk = m_chunks[m_nextChunk].get();
+    DEBUG_ASSERT(pChunk->pendingStages.load() == 0);
+    return mixxx::SampleBuffer::WritableSlice(pChunk->buffer);
+}
+
+void AnalyzerPipeline::submitChunk(const CSAMPLE* pSamples, SINT sampleCount) {
+    Chunk* pChunk = m_chunks[m_nextChunk].get();
+    if (m_stages.empty() || sampleCount <= 0) {
+        // The buffer is reused for the next chunk
+        m_freeChunks.release();
+        return;
+    }
+    m_nextChunk = (m_nextChunk + 1) % m_chunks.size();
+    DEBUG_ASSERT(pSamples >= pChunk->buffer.data());
+    DEBUG_ASSERT(pSamples + sampleCount <= pChunk->buffer.data() + pChunk->buffer.size());
+    pChunk->pSamples = pSamples;
+    pChunk->sampleCount = sampleCount;
+    pChunk->pendingStages.store(static_cast<int>(m_stages.size()));
+    for (const auto& pStage : m_stages) {
+        pStage->enqueue(pChunk);
+    }
+}
+
+void AnalyzerPipeline::releaseChunk(Chunk* pChunk) {
+    if (pChunk->pendingStages.fetch_sub(1) == 1) {
+        m_freeChunks.release();
+    }
+}
+
+void AnalyzerPipeline::drain() {
+    m_freeChunks.acquire(kNumChunks);
+    m_freeChunks.release(kNumChunks);
+}
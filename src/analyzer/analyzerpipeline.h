@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QSemaphore>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+// Fans out each chunk of decoded audio data to all analyzers that are
+// running concurrently on separate worker threads, one thread per analyzer.
+// The decoding thread only needs to wait for the slowest analyzer instead
+// of the sum of all analyzers.
+//
+// The decoded audio data is stored in a ring of chunk buffers. Each chunk
+// is passed to all stages through bounded lock-free queues and reused
+// after the last stage has finished processing it. Stages process their
+// chunks in order, so chunks also become available again in order.
+//
+// Analyzers are still initialized and finished by the owning thread. It
+// must only access the analyzers after drain() has returned.
+class AnalyzerPipeline final {
+  public:
+    // The analyzers must outlive the pipeline
+    explicit AnalyzerPipeline(std::vector<AnalyzerWithState>* pAnalyzers);
+    ~AnalyzerPipeline();
+
+    // Blocks until a chunk buffer becomes available for decoding the
+    // next chunk into it. Each buffer has a capacity of
+    // mixxx::kAnalysisSamplesPerChunk samples.
+    mixxx::SampleBuffer::WritableSlice nextChunkBuffer();
+
+    // Passes the chunk that has been decoded into the buffer returned
+    // by the preceding call of nextChunkBuffer() to all analyzers.
+    void submitChunk(const CSAMPLE* pSamples, SINT sampleCount);
+
+    // Blocks until all analyzers have processed all submitted chunks.
+    void drain();
+
+  private:
+    class Stage;
+
+    struct Chunk {
+        mixxx::SampleBuffer buffer;
+        const CSAMPLE* pSamples = nullptr;
+        SINT sampleCount = 0;
+        // The number of stages that have not processed the chunk yet
+        std::atomic<int> pendingStages{0};
+    };
+
+    void releaseChunk(Chunk* pChunk);
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::size_t m_nextChunk;
+    // Available while the chunk buffers are not referenced by any stage
+    QSemaphore m_freeChunks;
+
+    std::vector<std::unique_ptr<Stage>> m_stages;
+};
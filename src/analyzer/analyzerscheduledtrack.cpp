@@ -3,8 +3,10 @@
 #include "analyzer/analyzertrack.h"
 #include "track/trackid.h"
 
-AnalyzerScheduledTrack::AnalyzerScheduledTrack(TrackId trackId, AnalyzerTrack::Options options)
-        : m_trackId(trackId), m_options(options) {
+AnalyzerScheduledTrack::AnalyzerScheduledTrack(TrackId trackId,
+        AnalyzerTrack::Options options,
+        AnalyzerPriority priority)
+        : m_trackId(trackId), m_options(options), m_priority(priority) {
 }
 
 const TrackId& AnalyzerScheduledTrack::getTrackId() const {
@@ -14,3 +16,7 @@ const TrackId& AnalyzerScheduledTrack::getTrackId() const {
 const AnalyzerTrack::Options& AnalyzerScheduledTrack::getOptions() const {
     return m_options;
 }
+
+AnalyzerPriority AnalyzerScheduledTrack::getPriority() const {
+    return m_priority;
+}
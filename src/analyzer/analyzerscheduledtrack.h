@@ -3,11 +3,27 @@
 #include "analyzer/analyzertrack.h"
 #include "track/trackid.h"
 
+/// Classes of scheduled tracks in descending order of urgency.
+enum class AnalyzerPriority {
+    /// Loaded into a deck or sampler by the user
+    DeckLoaded = 0,
+    /// Loaded into a preview deck
+    Preview,
+    /// Loaded into a deck by AutoDJ ahead of the transition
+    AutoDjNext,
+    /// Batch analysis of the library. AnalysisFeature runs those in a
+    /// separate scheduler, so they never compete with the classes above.
+    Batch,
+};
+
+constexpr int kAnalyzerPriorityCount = static_cast<int>(AnalyzerPriority::Batch) + 1;
+
 /// A track to be scheduled for analysis with additional options.
 class AnalyzerScheduledTrack {
   public:
     AnalyzerScheduledTrack(TrackId trackId,
-            AnalyzerTrack::Options options = AnalyzerTrack::Options());
+            AnalyzerTrack::Options options = AnalyzerTrack::Options(),
+            AnalyzerPriority priority = AnalyzerPriority::Batch);
 
     /// Fetches the id of the track to be analyzed.
     const TrackId& getTrackId() const;
@@ -15,11 +31,16 @@ class AnalyzerScheduledTrack {
     /// Fetches the additional options.
     const AnalyzerTrack::Options& getOptions() const;
 
+    /// Fetches the scheduling class.
+    AnalyzerPriority getPriority() const;
+
   private:
     /// The id of the track to be analyzed.
     TrackId m_trackId;
     /// The additional options.
     AnalyzerTrack::Options m_options;
+    /// The scheduling class.
+    AnalyzerPriority m_priority;
 };
 
 Q_DECLARE_TYPEINFO(AnalyzerScheduledTrack, Q_MOVABLE_TYPE);
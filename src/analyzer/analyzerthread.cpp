@@ -10,6 +10,7 @@
 #include "analyzer/analyzerwaveform.h"
 #include "analyzer/constants.h"
 #include "library/dao/analysisdao.h"
+#include "library/library_prefs.h"
 #include "moc_analyzerthread.cpp"
 #include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
@@ -17,6 +18,7 @@
 #include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
 #include "util/logger.h"
+#include "util/tracerecorder.h"
 
 namespace {
 
@@ -82,6 +84,7 @@ AnalyzerThread::AnalyzerThread(
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
           m_nextTrack(2), // minimum capacity
+          m_abortCurrentTrack(false),
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
@@ -118,6 +121,13 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    if (m_pConfig->getValue(mixxx::library::prefs::kAnalyzerPipelineConfigKey,
+                mixxx::library::prefs::kAnalyzerPipelineDefault)) {
+        // The analyzers must not be added or removed while the pipeline exists
+        m_pPipeline = std::make_unique<AnalyzerPipeline>(&m_analyzers);
+        kLogger.debug() << "Running analyzers on separate pipeline stages";
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
@@ -160,6 +170,9 @@ void AnalyzerThread::doRun() {
         if (processTrack) {
             const auto analysisResult = analyzeAudioSource(audioSource);
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
+            if (m_pPipeline) {
+                m_pPipeline->drain();
+            }
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
                 // any errors or partial if it has been aborted due to a corrupt
@@ -187,6 +200,7 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_pPipeline.reset();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -197,6 +211,9 @@ bool AnalyzerThread::submitNextTrack(const AnalyzerTrack& nextTrack) {
     kLogger.debug()
             << "Enqueueing next track"
             << nextTrack.getTrack()->getId();
+    // Submitting is only allowed when idle, so the previous track has
+    // already been finished.
+    m_abortCurrentTrack.store(false);
     if (m_nextTrack.try_emplace(std::move(nextTrack))) {
         // Ensure that the submitted track gets processed eventually
         // by waking the worker thread up after adding a new task to
@@ -208,6 +225,11 @@ bool AnalyzerThread::submitNextTrack(const AnalyzerTrack& nextTrack) {
     return false;
 }
 
+void AnalyzerThread::abortCurrentTrack() {
+    kLogger.debug() << "Aborting current track";
+    m_abortCurrentTrack.store(true);
+}
+
 WorkerThread::TryFetchWorkItemsResult AnalyzerThread::tryFetchWorkItems() {
     DEBUG_ASSERT(!m_currentTrack.has_value());
     AnalyzerTrack* pFront = m_nextTrack.front();
@@ -237,9 +259,10 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
-        if (isStopping()) {
+        if (isStopping() || m_abortCurrentTrack.load()) {
             return AnalysisResult::Cancelled;
         }
+        mixxx::ScopedTraceEvent traceEvent("AnalyzerThread::analyzeChunk");
 
         // 1st step: Decode next chunk of audio data
 
@@ -250,11 +273,14 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
         // Request the next chunk of audio data
+        const auto chunkBuffer = m_pPipeline
+                ? m_pPipeline->nextChunkBuffer()
+                : mixxx::SampleBuffer::WritableSlice(m_sampleBuffer);
         const auto readableSampleFrames =
                 audioSource->readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                chunkBuffer));
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -281,6 +307,10 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                 // chunk!
 
                 remainingFrameRange.growFront(chunkFrameRange.length());
+                if (m_pPipeline) {
+                    // Return the unused chunk buffer
+                    m_pPipeline->submitChunk(nullptr, 0);
+                }
                 continue;
             }
             DEBUG_ASSERT(remainingFrameRange.end() < audioSource->frameIndexRange().end());
@@ -293,12 +323,22 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         }
 
         sleepWhileSuspended();
-        if (isStopping()) {
+        if (isStopping() || m_abortCurrentTrack.load()) {
+            if (m_pPipeline) {
+                // Return the unused chunk buffer
+                m_pPipeline->submitChunk(nullptr, 0);
+            }
             return AnalysisResult::Cancelled;
         }
 
         // 2nd: step: Analyze chunk of decoded audio data
-        if (!readableSampleFrames.frameIndexRange().empty()) {
+        if (m_pPipeline) {
+            // The analyzers process the chunk concurrently while the
+            // next chunk is decoded. Empty chunks are discarded.
+            m_pPipeline->submitChunk(
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableLength());
+        } else if (!readableSampleFrames.frameIndexRange().empty()) {
             for (auto&& analyzer : m_analyzers) {
                 analyzer.processSamples(
                         readableSampleFrames.readableData(),
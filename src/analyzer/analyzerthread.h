@@ -1,10 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzertrack.h"
 #include "preferences/usersettings.h"
@@ -79,6 +81,11 @@ class AnalyzerThread : public WorkerThread {
     // worker thread, yet.
     bool submitNextTrack(const AnalyzerTrack& nextTrack);
 
+    // Aborts the analysis of the most recently submitted track without
+    // blocking. The track is reported as done with an unknown progress.
+    // Has no effect if the track has already been finished.
+    void abortCurrentTrack();
+
   signals:
     // Use a single signal for progress updates to ensure that all signals
     // are queued and received in the same order as emitted from the internal
@@ -112,6 +119,9 @@ class AnalyzerThread : public WorkerThread {
     // for this purpose, which will become available in C++20.
     rigtorp::SPSCQueue<AnalyzerTrack> m_nextTrack;
 
+    // Reset when submitting the next track
+    std::atomic<bool> m_abortCurrentTrack;
+
     /////////////////////////////////////////////////////////////////////////
     // Thread local: Only used in the constructor/destructor and within
     // run() by the worker thread.
@@ -120,6 +130,9 @@ class AnalyzerThread : public WorkerThread {
 
     mixxx::SampleBuffer m_sampleBuffer;
 
+    // Only set if the analyzers are running on separate pipeline stages
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
+
     std::optional<AnalyzerTrack> m_currentTrack;
 
     AnalyzerThreadState m_emittedState;
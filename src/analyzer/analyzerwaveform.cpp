@@ -6,6 +6,7 @@
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilteriirbank.h"
 #include "track/track.h"
 #include "util/logger.h"
 #include "waveform/waveform.h"
@@ -116,6 +117,9 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer pTrack) const {
         QList<AnalysisDao::AnalysisInfo> analyses =
                 m_analysisDao.getAnalysesForTrack(trackId);
 
+        // The files of obsolete analyses are deleted after all analyses
+        // have been released, because they are memory mapped until then.
+        QList<int> obsoleteAnalysisIds;
         QListIterator<AnalysisDao::AnalysisInfo> it(analyses);
         while (it.hasNext()) {
             const AnalysisDao::AnalysisInfo& analysis = it.next();
@@ -129,7 +133,7 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer pTrack) const {
                     missingWaveform = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
-                    m_analysisDao.deleteAnalysis(analysis.analysisId);
+                    obsoleteAnalysisIds.append(analysis.analysisId);
                 }
             }
             if (analysis.type == AnalysisDao::TYPE_WAVESUMMARY) {
@@ -140,10 +144,14 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer pTrack) const {
                     missingWavesummary = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
-                    m_analysisDao.deleteAnalysis(analysis.analysisId);
+                    obsoleteAnalysisIds.append(analysis.analysisId);
                 }
             }
         }
+        analyses.clear();
+        for (const int analysisId : std::as_const(obsoleteAnalysisIds)) {
+            m_analysisDao.deleteAnalysis(analysisId);
+        }
     }
 
 #ifdef __STEM__
@@ -226,9 +234,14 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
         m_buffers.size = count;
     }
 
-    m_filters.low->process(pWaveformInput, &m_buffers.low[0], count);
-    m_filters.mid->process(pWaveformInput, &m_buffers.mid[0], count);
-    m_filters.high->process(pWaveformInput, &m_buffers.high[0], count);
+    // The bands use different kinds of filters, each processes both
+    // channels in parallel lanes
+    EngineFilterIIRBank<4, IIR_LP, 1>::process(
+            {m_filters.low.get()}, {pWaveformInput}, {&m_buffers.low[0]}, count);
+    EngineFilterIIRBank<8, IIR_BP, 1>::process(
+            {m_filters.mid.get()}, {pWaveformInput}, {&m_buffers.mid[0]}, count);
+    EngineFilterIIRBank<4, IIR_HP, 1>::process(
+            {m_filters.high.get()}, {pWaveformInput}, {&m_buffers.high[0]}, count);
 
     m_waveform->setSaveState(Waveform::SaveState::NotSaved);
     m_waveformSummary->setSaveState(Waveform::SaveState::NotSaved);
@@ -326,6 +339,7 @@ void AnalyzerWaveform::storeResults(TrackPointer pTrack) {
         m_waveform->setCompletion(m_waveform->getDataSize());
         m_waveform->setVersion(WaveformFactory::currentWaveformVersion());
         m_waveform->setDescription(WaveformFactory::currentWaveformDescription());
+        m_waveform->buildMipLevels();
     }
 
     // Force completion to waveform size
@@ -15,7 +15,9 @@
 class QImage;
 #endif
 
-class EngineFilterIIRBase;
+class EngineFilterBessel4Low;
+class EngineFilterBessel4Band;
+class EngineFilterBessel4High;
 class QSqlDatabase;
 
 struct WaveformStride {
@@ -173,9 +175,9 @@ class AnalyzerWaveform : public Analyzer {
     mixxx::audio::ChannelCount m_channelCount;
 
     struct Filters {
-        std::unique_ptr<EngineFilterIIRBase> low;
-        std::unique_ptr<EngineFilterIIRBase> mid;
-        std::unique_ptr<EngineFilterIIRBase> high;
+        std::unique_ptr<EngineFilterBessel4Low> low;
+        std::unique_ptr<EngineFilterBessel4Band> mid;
+        std::unique_ptr<EngineFilterBessel4High> high;
     };
 
     Filters m_filters;
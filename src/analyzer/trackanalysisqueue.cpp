@@ -0,0 +1,86 @@
+#include "analyzer/trackanalysisqueue.h"
+
+#include "util/assert.h"
+
+void TrackAnalysisQueue::enqueue(AnalyzerScheduledTrack track) {
+    const AnalyzerPriority priority = track.getPriority();
+    queue(priority).push_back(QueuedTrack{std::move(track), Clock::now()});
+}
+
+void TrackAnalysisQueue::requeue(AnalyzerScheduledTrack track) {
+    const AnalyzerPriority priority = track.getPriority();
+    queue(priority).push_front(QueuedTrack{std::move(track), Clock::now()});
+}
+
+bool TrackAnalysisQueue::isEmpty() const {
+    for (const auto& queue : m_queues) {
+        if (!queue.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int TrackAnalysisQueue::size() const {
+    int count = 0;
+    for (const auto& queue : m_queues) {
+        count += static_cast<int>(queue.size());
+    }
+    return count;
+}
+
+const TrackAnalysisQueue::QueuedTrack& TrackAnalysisQueue::front() const {
+    for (const auto& queue : m_queues) {
+        if (!queue.empty()) {
+            return queue.front();
+        }
+    }
+    DEBUG_ASSERT(!"Queue is empty");
+    return m_queues.back().front();
+}
+
+void TrackAnalysisQueue::popFront() {
+    for (auto& queue : m_queues) {
+        if (!queue.empty()) {
+            queue.pop_front();
+            return;
+        }
+    }
+    DEBUG_ASSERT(!"Queue is empty");
+}
+
+void TrackAnalysisQueue::clear() {
+    for (auto& queue : m_queues) {
+        queue.clear();
+    }
+}
+
+std::optional<std::size_t> TrackAnalysisQueue::workerToPreempt(
+        AnalyzerPriority priority,
+        const std::vector<std::optional<AnalyzerPriority>>& workerPriorities) const {
+    // All queued tracks with at least the same priority are dequeued
+    // before the new track.
+    std::size_t urgentTracksCount = 0;
+    for (int i = 0; i <= static_cast<int>(priority); ++i) {
+        urgentTracksCount += m_queues[i].size();
+    }
+    std::size_t availableWorkersCount = 0;
+    std::optional<std::size_t> preemptedWorker;
+    for (std::size_t i = 0; i < workerPriorities.size(); ++i) {
+        const auto& workerPriority = workerPriorities[i];
+        if (!workerPriority) {
+            ++availableWorkersCount;
+            continue;
+        }
+        // Preempt the worker with the least urgent track
+        if (*workerPriority > priority &&
+                (!preemptedWorker ||
+                        *workerPriority > *workerPriorities[*preemptedWorker])) {
+            preemptedWorker = i;
+        }
+    }
+    if (urgentTracksCount <= availableWorkersCount) {
+        return std::nullopt;
+    }
+    return preemptedWorker;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "analyzer/analyzerscheduledtrack.h"
+
+/// The tracks that are waiting for analysis in a TrackAnalysisScheduler.
+///
+/// Tracks are dequeued by priority and in FIFO order within the same
+/// priority. This class only decides about the order of the tracks and
+/// which worker to preempt, it does not know anything about the workers.
+class TrackAnalysisQueue {
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct QueuedTrack {
+        AnalyzerScheduledTrack track;
+        Clock::time_point queuedAt;
+    };
+
+    /// Appends a track to the queue of its priority.
+    void enqueue(AnalyzerScheduledTrack track);
+
+    /// Reinserts a track that has been preempted in front of all other
+    /// tracks with the same priority.
+    void requeue(AnalyzerScheduledTrack track);
+
+    bool isEmpty() const;
+    int size() const;
+
+    /// The track that is dequeued next, i.e. the least recently queued
+    /// track with the highest priority. Must not be called if the queue
+    /// is empty.
+    const QueuedTrack& front() const;
+    void popFront();
+
+    void clear();
+
+    /// Decides which worker to preempt after a track with the given
+    /// priority has been enqueued. The priority of the current track of
+    /// each worker is passed in the order of the workers, std::nullopt
+    /// for idle workers and workers that have already been preempted.
+    ///
+    /// A worker is only preempted if there are not enough idle workers
+    /// for all queued tracks with at least the given priority. The worker
+    /// that analyzes the least urgent track with a lower priority is
+    /// chosen. Returns the index of this worker or std::nullopt if no
+    /// worker needs to be preempted.
+    std::optional<std::size_t> workerToPreempt(
+            AnalyzerPriority priority,
+            const std::vector<std::optional<AnalyzerPriority>>& workerPriorities) const;
+
+  private:
+    std::deque<QueuedTrack>& queue(AnalyzerPriority priority) {
+        return m_queues[static_cast<int>(priority)];
+    }
+
+    // One FIFO queue per priority
+    std::array<std::deque<QueuedTrack>, kAnalyzerPriorityCount> m_queues;
+};
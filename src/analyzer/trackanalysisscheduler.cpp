@@ -5,6 +5,8 @@
 #include "moc_trackanalysisscheduler.cpp"
 #include "track/trackid.h"
 #include "util/logger.h"
+#include "util/math.h"
+#include "util/stat.h"
 
 namespace {
 
@@ -15,6 +17,30 @@ constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
+// The time between scheduling and dequeuing a track is recorded per
+// priority. Values are rounded up to the next power of 2 to obtain a
+// histogram with logarithmic buckets.
+const QString kQueueLatencyStatTags[kAnalyzerPriorityCount] = {
+        QStringLiteral("TrackAnalysisScheduler: Queue latency DeckLoaded"),
+        QStringLiteral("TrackAnalysisScheduler: Queue latency Preview"),
+        QStringLiteral("TrackAnalysisScheduler: Queue latency AutoDjNext"),
+        QStringLiteral("TrackAnalysisScheduler: Queue latency Batch"),
+};
+
+const Stat::ComputeFlags kQueueLatencyStatFlags = Stat::COUNT | Stat::AVERAGE |
+        Stat::MIN | Stat::MAX | Stat::HISTOGRAM;
+
+void trackQueueLatency(AnalyzerPriority priority, std::chrono::milliseconds latency) {
+    const auto latencyMillis = static_cast<double>(latency.count());
+    const double bucketMillis = latencyMillis >= 1.0
+            ? std::exp2(std::ceil(std::log2(latencyMillis)))
+            : 0.0;
+    Stat::track(kQueueLatencyStatTags[static_cast<int>(priority)],
+            Stat::DURATION_MSEC,
+            kQueueLatencyStatFlags,
+            bucketMillis);
+}
+
 void deleteTrackAnalysisScheduler(TrackAnalysisScheduler* plainPtr) {
     if (plainPtr) {
         // Trigger stop
@@ -170,7 +196,7 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
         }
     }
     const int totalTracksCount =
-            m_dequeuedTracksCount + static_cast<int>(m_queuedTracks.size());
+            m_dequeuedTracksCount + m_queuedTracks.size();
     DEBUG_ASSERT(m_currentTrackNumber <= m_dequeuedTracksCount);
     DEBUG_ASSERT(m_dequeuedTracksCount <= totalTracksCount);
     emit progress(
@@ -220,8 +246,24 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
             DEBUG_ASSERT((analyzerProgress == kAnalyzerProgressDone) // success
                     || (analyzerProgress == kAnalyzerProgressUnknown)); // failure
             m_pendingTrackIds.erase(trackId);
-            worker.onAnalyzerProgress(analyzerProgress);
-            emit trackProgress(trackId, analyzerProgress);
+            const auto preemptedTrack = worker.onTrackDone();
+            if (preemptedTrack &&
+                    preemptedTrack->getTrackId() == trackId &&
+                    analyzerProgress == kAnalyzerProgressUnknown) {
+                // The analysis has been aborted. Reschedule the track
+                // with its original priority.
+                kLogger.debug()
+                        << "Rescheduling preempted track"
+                        << trackId;
+                m_queuedTracks.requeue(*preemptedTrack);
+                DEBUG_ASSERT(m_dequeuedTracksCount > 0);
+                --m_dequeuedTracksCount;
+                m_currentTrackNumber = math_min(m_currentTrackNumber, m_dequeuedTracksCount);
+                worker.onAnalyzerProgress(kAnalyzerProgressUnknown);
+            } else {
+                worker.onAnalyzerProgress(analyzerProgress);
+                emit trackProgress(trackId, analyzerProgress);
+            }
         }
         break;
     case AnalyzerThreadState::Exit:
@@ -243,14 +285,46 @@ bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
                 << track.getTrackId();
         return false;
     }
-    m_queuedTracks.push_back(track);
+    const AnalyzerPriority priority = track.getPriority();
+    m_queuedTracks.enqueue(std::move(track));
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
     // of multiple tracks with resume().
+    maybePreemptWorker(priority);
     return true;
 }
 
+void TrackAnalysisScheduler::maybePreemptWorker(AnalyzerPriority priority) {
+    // Workers that have already exited are ignored
+    std::vector<Worker*> workers;
+    std::vector<std::optional<AnalyzerPriority>> workerPriorities;
+    workers.reserve(m_workers.size());
+    workerPriorities.reserve(m_workers.size());
+    for (auto& worker : m_workers) {
+        if (!worker) {
+            continue;
+        }
+        workers.push_back(&worker);
+        if (worker.currentTrack() && !worker.isPreempted()) {
+            workerPriorities.push_back(worker.currentTrack()->getPriority());
+        } else {
+            workerPriorities.push_back(std::nullopt);
+        }
+    }
+    const auto preemptedWorker = m_queuedTracks.workerToPreempt(priority, workerPriorities);
+    if (!preemptedWorker) {
+        return;
+    }
+    Worker* pPreemptedWorker = workers[*preemptedWorker];
+    kLogger.debug()
+            << "Preempting worker thread"
+            << pPreemptedWorker->thread()->id()
+            << "with track"
+            << pPreemptedWorker->currentTrack()->getTrackId();
+    pPreemptedWorker->preempt();
+}
+
 int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks) {
     int scheduledCount = 0;
     for (auto track : tracks) {
@@ -277,8 +351,9 @@ void TrackAnalysisScheduler::resume() {
 
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
     DEBUG_ASSERT(worker);
-    while (!m_queuedTracks.empty()) {
-        AnalyzerScheduledTrack nextScheduledTrack = m_queuedTracks.front();
+    while (!m_queuedTracks.isEmpty()) {
+        const TrackAnalysisQueue::QueuedTrack nextQueuedTrack = m_queuedTracks.front();
+        const AnalyzerScheduledTrack& nextScheduledTrack = nextQueuedTrack.track;
         TrackId nextTrackId = nextScheduledTrack.getTrackId();
         DEBUG_ASSERT(nextTrackId.isValid());
         if (nextTrackId.isValid()) {
@@ -288,8 +363,12 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                 AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
                     if (worker->submitNextTrack(std::move(nextTrack))) {
-                        m_queuedTracks.pop_front();
+                        m_queuedTracks.popFront();
                         ++m_dequeuedTracksCount;
+                        worker->onTrackSubmitted(nextScheduledTrack);
+                        trackQueueLatency(nextScheduledTrack.getPriority(),
+                                std::chrono::duration_cast<std::chrono::milliseconds>(
+                                        Clock::now() - nextQueuedTrack.queuedAt));
                         return true;
                     } else {
                         // The worker may already have been assigned new tasks
@@ -319,7 +398,7 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     << nextTrackId;
         }
         // Skip this track
-        m_queuedTracks.pop_front();
+        m_queuedTracks.popFront();
         ++m_dequeuedTracksCount;
     }
     return false;
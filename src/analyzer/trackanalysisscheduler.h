@@ -1,13 +1,15 @@
 #pragma once
 
 #include <QList>
-#include <deque>
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <set>
 #include <vector>
 
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzerthread.h"
+#include "analyzer/trackanalysisqueue.h"
 #include "util/db/dbconnectionpool.h"
 
 /// Callbacks for triggering side-effects in the outer context of
@@ -50,6 +52,17 @@ class TrackAnalysisScheduler : public QObject {
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
     // the caller must invoke resume() once.
+    //
+    // Tracks are dequeued by priority and in FIFO order within the same
+    // priority. If all workers are busy a worker of this scheduler that
+    // analyzes a track of a lower priority is preempted. The preempted
+    // track is abandoned and rescheduled at the front of its queue.
+    //
+    // Preemption only happens between the tracks of a single scheduler,
+    // e.g. between tracks that are loaded into decks, preview decks,
+    // and by AutoDJ in the scheduler of PlayerManager. The batch analysis
+    // of AnalysisFeature runs in a separate scheduler with its own worker
+    // threads and is never preempted by those tracks.
     bool scheduleTrack(AnalyzerScheduledTrack track);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
@@ -105,6 +118,38 @@ class TrackAnalysisScheduler : public QObject {
             return m_thread->submitNextTrack(std::move(track));
         }
 
+        // The most recently submitted track until it is done
+        const std::optional<AnalyzerScheduledTrack>& currentTrack() const {
+            return m_currentTrack;
+        }
+
+        void onTrackSubmitted(const AnalyzerScheduledTrack& track) {
+            m_currentTrack = track;
+            m_preempted = false;
+        }
+
+        bool isPreempted() const {
+            return m_preempted;
+        }
+
+        void preempt() {
+            DEBUG_ASSERT(m_thread);
+            DEBUG_ASSERT(m_currentTrack);
+            m_preempted = true;
+            m_thread->abortCurrentTrack();
+        }
+
+        // Returns the current track if it has been preempted
+        std::optional<AnalyzerScheduledTrack> onTrackDone() {
+            std::optional<AnalyzerScheduledTrack> preemptedTrack;
+            if (m_preempted) {
+                preemptedTrack = std::move(m_currentTrack);
+            }
+            m_currentTrack.reset();
+            m_preempted = false;
+            return preemptedTrack;
+        }
+
         void suspendThread() {
             if (m_thread) {
                 m_thread->suspend();
@@ -132,18 +177,25 @@ class TrackAnalysisScheduler : public QObject {
             DEBUG_ASSERT(m_thread);
             m_thread.reset();
             m_analyzerProgress = kAnalyzerProgressUnknown;
+            m_currentTrack.reset();
+            m_preempted = false;
         }
 
       private:
         AnalyzerThread::Pointer m_thread;
         AnalyzerProgress m_analyzerProgress;
+        std::optional<AnalyzerScheduledTrack> m_currentTrack;
+        bool m_preempted = false;
     };
 
+    typedef TrackAnalysisQueue::Clock Clock;
+
     bool submitNextTrack(Worker* worker);
+    void maybePreemptWorker(AnalyzerPriority priority);
     void emitProgressOrFinished();
 
     bool allTracksFinished() const {
-        return m_queuedTracks.empty() &&
+        return m_queuedTracks.isEmpty() &&
                 m_pendingTrackIds.empty();
     }
 
@@ -151,7 +203,7 @@ class TrackAnalysisScheduler : public QObject {
 
     std::vector<Worker> m_workers;
 
-    std::deque<AnalyzerScheduledTrack> m_queuedTracks;
+    TrackAnalysisQueue m_queuedTracks;
 
     // Tracks that have already been submitted to workers
     // and not yet reported back as finished.
@@ -163,6 +215,5 @@ class TrackAnalysisScheduler : public QObject {
 
     int m_dequeuedTracksCount;
 
-    typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
 };
@@ -154,7 +154,8 @@ bool BroadcastManager::addConnection(BroadcastProfilePtr profile) {
         return false;
     }
 
-    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig));
+    ShoutConnectionPtr connection(new ShoutConnection(
+            profile, m_pConfig, m_pNetworkStream->sharedEncoders()));
     m_pNetworkStream->addOutputWorker(connection);
 
     connect(profile.data(),
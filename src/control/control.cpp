@@ -25,17 +25,16 @@ constexpr Stat::ComputeFlags kComputeFlags = {Stat::COUNT,
         Stat::MIN,
         Stat::MAX};
 
-/// Mutex guarding access to s_qCOHash and s_qCOAliasHash.
-MMutex s_qCOHashMutex;
+/// Registry of all ControlDoublePrivate instantiations, including aliases.
+ControlRegistry s_controlRegistry;
 
-/// Hash of ControlDoublePrivate instantiations.
-QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> s_qCOHash
-        GUARDED_BY(s_qCOHashMutex);
+/// Mutex guarding access to s_qCOAliasHash and the creation of s_pDefaultCO.
+MMutex s_qCOAliasHashMutex;
 
 /// Hash of aliases between ConfigKeys. Solely used for looking up the first
 /// alias associated with a key.
 QHash<ConfigKey, ConfigKey> s_qCOAliasHash
-        GUARDED_BY(s_qCOHashMutex);
+        GUARDED_BY(s_qCOAliasHashMutex);
 
 /// is used instead of a nullptr, helps to omit null checks everywhere
 QWeakPointer<ControlDoublePrivate> s_pDefaultCO;
@@ -54,6 +53,7 @@ ControlDoublePrivate::ControlDoublePrivate(
         double defaultValue,
         bool confirmRequired = false)
         : m_key(key),
+          m_keyHandle(s_controlRegistry.intern(key)),
           m_pBehavior(nullptr),
           m_name(QString()),
           m_description(QString()),
@@ -80,10 +80,9 @@ ControlDoublePrivate::ControlDoublePrivate(
 }
 
 ControlDoublePrivate::~ControlDoublePrivate() {
-    s_qCOHashMutex.lock();
-    //qDebug() << "ControlDoublePrivate::s_qCOHash.remove(" << m_key.group << "," << m_key.item << ")";
-    s_qCOHash.remove(m_key);
-    s_qCOHashMutex.unlock();
+    if (m_keyHandle.isValid()) {
+        s_controlRegistry.removeExpired(m_keyHandle);
+    }
 
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = s_pUserConfig;
@@ -102,26 +101,32 @@ void ControlDoublePrivate::setUserConfig(const UserSettingsPointer& pConfig) {
 
 // static
 void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey& key) {
-    MMutexLocker locker(&s_qCOHashMutex);
     VERIFY_OR_DEBUG_ASSERT(alias != key) {
         qWarning() << "cannot create alias with identical key" << key;
         return;
     }
 
-    auto it = s_qCOHash.constFind(key);
-    VERIFY_OR_DEBUG_ASSERT(it != s_qCOHash.constEnd()) {
+    const ControlKeyHandle handle = s_controlRegistry.find(key);
+    VERIFY_OR_DEBUG_ASSERT(handle.isValid()) {
         qWarning() << "cannot create alias for null control" << key;
         return;
     }
 
-    QSharedPointer<ControlDoublePrivate> pControl = it.value();
+    QSharedPointer<ControlDoublePrivate> pControl = s_controlRegistry.lookup(handle);
     VERIFY_OR_DEBUG_ASSERT(!pControl.isNull()) {
         qWarning() << "cannot create alias for expired control" << key;
         return;
     }
 
+    const ControlKeyHandle aliasHandle = s_controlRegistry.intern(alias);
+    VERIFY_OR_DEBUG_ASSERT(aliasHandle.isValid()) {
+        qWarning() << "cannot create alias with invalid key" << alias;
+        return;
+    }
+
+    MMutexLocker locker(&s_qCOAliasHashMutex);
     s_qCOAliasHash.insert(key, alias);
-    s_qCOHash.insert(alias, pControl);
+    s_controlRegistry.insert(aliasHandle, pControl);
 }
 
 // static
@@ -142,41 +147,38 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
         return nullptr;
     }
 
-    // Scope for MMutexLocker.
-    {
-        const MMutexLocker locker(&s_qCOHashMutex);
-        const auto it = s_qCOHash.constFind(key);
-        if (it != s_qCOHash.constEnd()) {
-            auto pControl = it.value().lock();
-            if (pControl) {
-                auto actualKey = pControl->getKey();
-                if (actualKey != key) {
-                    qWarning()
-                            << "ControlObject accessed via deprecated key"
-                            << key.group << key.item
-                            << "- use"
-                            << actualKey.group << actualKey.item
-                            << "instead";
-                }
-
-                // Control object already exists
-                if (pCreatorCO) {
-                    qWarning()
-                            << "ControlObject"
-                            << key.group << key.item
-                            << "already created";
-                    DEBUG_ASSERT(!"pCreatorCO != nullptr, ControlObject already created");
-                    return nullptr;
-                }
-                return pControl;
-            } else {
-                // The weak pointer has become invalid and can be cleaned up
-                s_qCOHash.erase(it);
+    // Lookups don't intern the key, otherwise mappings and skins that
+    // probe for non-existing controls would fill up the registry.
+    const ControlKeyHandle handle = pCreatorCO
+            ? s_controlRegistry.intern(key)
+            : s_controlRegistry.find(key);
+    if (handle.isValid()) {
+        auto pControl = s_controlRegistry.lookup(handle);
+        if (pControl) {
+            auto actualKey = pControl->getKey();
+            if (actualKey != key) {
+                qWarning()
+                        << "ControlObject accessed via deprecated key"
+                        << key.group << key.item
+                        << "- use"
+                        << actualKey.group << actualKey.item
+                        << "instead";
+            }
+
+            // Control object already exists
+            if (pCreatorCO) {
+                qWarning()
+                        << "ControlObject"
+                        << key.group << key.item
+                        << "already created";
+                DEBUG_ASSERT(!"pCreatorCO != nullptr, ControlObject already created");
+                return nullptr;
             }
+            return pControl;
         }
     }
 
-    if (pCreatorCO) {
+    if (pCreatorCO && handle.isValid()) {
         auto pControl = QSharedPointer<ControlDoublePrivate>(
                 new ControlDoublePrivate(key,
                         pCreatorCO,
@@ -184,9 +186,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
                         bTrack,
                         bPersist,
                         defaultValue));
-        const MMutexLocker locker(&s_qCOHashMutex);
-        //qDebug() << "ControlDoublePrivate::s_qCOHash.insert(" << key.group << "," << key.item << ")";
-        s_qCOHash.insert(key, pControl);
+        s_controlRegistry.insert(handle, pControl);
         return pControl;
     }
 
@@ -205,7 +205,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
         // Try again with the mutex locked to protect against creating two
         // ControlDoublePrivateConst objects. Access to s_defaultCO itself is
         // thread save.
-        MMutexLocker locker(&s_qCOHashMutex);
+        MMutexLocker locker(&s_qCOAliasHashMutex);
         defaultCO = s_pDefaultCO.lock();
         if (!defaultCO) {
             defaultCO = QSharedPointer<ControlDoublePrivate>(new ControlDoublePrivateConst());
@@ -217,39 +217,17 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
 
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstances() {
-    QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.constBegin(); it != s_qCOHash.constEnd(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        } else {
-            // The weak pointer has become invalid and can be cleaned up
-            s_qCOHash.erase(it);
-        }
-    }
-    return result;
+    return s_controlRegistry.getAll();
 }
 
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::takeAllInstances() {
-    QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        }
-    }
-    s_qCOHash.clear();
-    return result;
+    return s_controlRegistry.takeAll();
 }
 
 //static
 QHash<ConfigKey, ConfigKey> ControlDoublePrivate::getControlAliases() {
-    MMutexLocker locker(&s_qCOHashMutex);
+    MMutexLocker locker(&s_qCOAliasHashMutex);
     // lock thread-unsafe copy constructors of QHash
     return s_qCOAliasHash;
 }
@@ -7,6 +7,7 @@
 #include <QString>
 
 #include "control/controlbehavior.h"
+#include "control/controlregistry.h"
 #include "control/controlvalue.h"
 #include "preferences/usersettings.h"
 
@@ -185,6 +186,7 @@ class ControlDoublePrivate : public QObject {
     virtual void setInner(double value, QObject* pSender);
 
     const ConfigKey m_key;
+    const ControlKeyHandle m_keyHandle;
 
     QSharedPointer<ControlNumericBehavior> m_pBehavior;
 
@@ -0,0 +1,196 @@
+#include "control/controlregistry.h"
+
+#include <thread>
+
+#include "control/control.h"
+#include "util/assert.h"
+
+ControlRegistry::ControlRegistry()
+        : m_size(0) {
+    for (auto& bucket : m_buckets) {
+        bucket.store(nullptr, std::memory_order_relaxed);
+    }
+    for (auto& segment : m_segments) {
+        segment.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ControlRegistry::~ControlRegistry() {
+    for (auto& segment : m_segments) {
+        Slot* pSegment = segment.load(std::memory_order_acquire);
+        if (!pSegment) {
+            continue;
+        }
+        for (int i = 0; i < kSegmentSize; ++i) {
+            delete pSegment[i].pEntry.load(std::memory_order_acquire);
+        }
+        delete[] pSegment;
+    }
+    for (auto& bucket : m_buckets) {
+        const KeyNode* pNode = bucket.load(std::memory_order_acquire);
+        while (pNode) {
+            const KeyNode* pNext = pNode->pNext;
+            delete pNode;
+            pNode = pNext;
+        }
+    }
+}
+
+//static
+std::size_t ControlRegistry::bucketIndex(const ConfigKey& key) {
+    return static_cast<std::size_t>(qHash(key)) % kNumBuckets;
+}
+
+//static
+const ControlRegistry::KeyNode* ControlRegistry::findNode(
+        const KeyNode* pNode, const ConfigKey& key) {
+    while (pNode && pNode->key != key) {
+        pNode = pNode->pNext;
+    }
+    return pNode;
+}
+
+ControlKeyHandle ControlRegistry::find(const ConfigKey& key) const {
+    if (!key.isValid()) {
+        return ControlKeyHandle();
+    }
+    const KeyNode* pNode = findNode(
+            m_buckets[bucketIndex(key)].load(std::memory_order_acquire),
+            key);
+    if (!pNode) {
+        return ControlKeyHandle();
+    }
+    return ControlKeyHandle(pNode->id);
+}
+
+ControlKeyHandle ControlRegistry::intern(const ConfigKey& key) {
+    const ControlKeyHandle handle = find(key);
+    if (handle.isValid() || !key.isValid()) {
+        return handle;
+    }
+
+    const MMutexLocker locker(&m_internMutex);
+    auto& bucket = m_buckets[bucketIndex(key)];
+    const KeyNode* pHead = bucket.load(std::memory_order_relaxed);
+    // Another thread might have interned the key in the meantime
+    if (const KeyNode* pNode = findNode(pHead, key)) {
+        return ControlKeyHandle(pNode->id);
+    }
+
+    const int id = m_size.load(std::memory_order_relaxed);
+    VERIFY_OR_DEBUG_ASSERT(id < kSegmentSize * kMaxSegments) {
+        qWarning() << "ControlRegistry: Too many controls, cannot intern" << key;
+        return ControlKeyHandle();
+    }
+    auto& segment = m_segments[id / kSegmentSize];
+    if (!segment.load(std::memory_order_relaxed)) {
+        segment.store(new Slot[kSegmentSize], std::memory_order_release);
+    }
+    m_size.store(id + 1, std::memory_order_release);
+    // Publish the key after its slot has been allocated
+    bucket.store(new KeyNode{key, id, pHead}, std::memory_order_release);
+    return ControlKeyHandle(id);
+}
+
+ControlRegistry::Slot* ControlRegistry::slot(int id) const {
+    if (id < 0 || id >= kSegmentSize * kMaxSegments) {
+        return nullptr;
+    }
+    Slot* pSegment = m_segments[id / kSegmentSize].load(std::memory_order_acquire);
+    if (!pSegment) {
+        return nullptr;
+    }
+    return &pSegment[id % kSegmentSize];
+}
+
+QSharedPointer<ControlDoublePrivate> ControlRegistry::lookupSlot(const Slot& slot) const {
+    // The reader count must be incremented before loading the entry,
+    // otherwise replaceEntry() might delete it while still in use.
+    // Both operations are sequentially consistent on purpose.
+    slot.readers.fetch_add(1);
+    const Entry* pEntry = slot.pEntry.load();
+    QSharedPointer<ControlDoublePrivate> pControl;
+    if (pEntry) {
+        pControl = pEntry->pControl.toStrongRef();
+    }
+    slot.readers.fetch_sub(1, std::memory_order_release);
+    return pControl;
+}
+
+//static
+void ControlRegistry::replaceEntry(Slot* pSlot, const Entry* pEntry) {
+    const Entry* pOldEntry = pSlot->pEntry.exchange(pEntry);
+    if (!pOldEntry) {
+        return;
+    }
+    // Readers only access the entry for a few instructions. Waiting
+    // for them is rare and short, because controls are created and
+    // destroyed infrequently compared to how often they are resolved.
+    while (pSlot->readers.load() > 0) {
+        std::this_thread::yield();
+    }
+    delete pOldEntry;
+}
+
+QSharedPointer<ControlDoublePrivate> ControlRegistry::lookup(ControlKeyHandle handle) const {
+    const Slot* pSlot = slot(handle.id());
+    if (!pSlot) {
+        return nullptr;
+    }
+    return lookupSlot(*pSlot);
+}
+
+void ControlRegistry::insert(
+        ControlKeyHandle handle,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    Slot* pSlot = slot(handle.id());
+    VERIFY_OR_DEBUG_ASSERT(pSlot) {
+        return;
+    }
+    const MMutexLocker locker(&m_shardMutexes[handle.id() % kNumShards]);
+    replaceEntry(pSlot, new Entry{pControl.toWeakRef()});
+}
+
+void ControlRegistry::removeExpired(ControlKeyHandle handle) {
+    Slot* pSlot = slot(handle.id());
+    if (!pSlot) {
+        return;
+    }
+    const MMutexLocker locker(&m_shardMutexes[handle.id() % kNumShards]);
+    const Entry* pEntry = pSlot->pEntry.load(std::memory_order_relaxed);
+    // The slot might already refer to a new control for the same key
+    if (pEntry && pEntry->pControl.isNull()) {
+        replaceEntry(pSlot, nullptr);
+    }
+}
+
+QList<QSharedPointer<ControlDoublePrivate>> ControlRegistry::getAll() const {
+    QList<QSharedPointer<ControlDoublePrivate>> result;
+    const int size = m_size.load(std::memory_order_acquire);
+    result.reserve(size);
+    for (int id = 0; id < size; ++id) {
+        auto pControl = lookupSlot(*slot(id));
+        if (pControl) {
+            result.append(std::move(pControl));
+        }
+    }
+    return result;
+}
+
+QList<QSharedPointer<ControlDoublePrivate>> ControlRegistry::takeAll() {
+    QList<QSharedPointer<ControlDoublePrivate>> result;
+    const int size = m_size.load(std::memory_order_acquire);
+    result.reserve(size);
+    for (int id = 0; id < size; ++id) {
+        Slot* pSlot = slot(id);
+        const MMutexLocker locker(&m_shardMutexes[id % kNumShards]);
+        auto pControl = lookupSlot(*pSlot);
+        replaceEntry(pSlot, nullptr);
+        if (pControl) {
+            // The controls are released by the caller, i.e. not
+            // while the shard is locked.
+            result.append(std::move(pControl));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <QList>
+#include <QSharedPointer>
+#include <QtDebug>
+#include <array>
+#include <atomic>
+
+#include "preferences/configobject.h"
+#include "util/compatibility/qhash.h"
+#include "util/mutex.h"
+
+class ControlDoublePrivate;
+
+/// A stable integer handle of an interned ConfigKey.
+///
+/// Each control keeps the handle of its key to unregister itself
+/// without resolving the key again. Handles are never reused and stay
+/// valid for the lifetime of the process, even if the corresponding
+/// control is deleted and created again.
+class ControlKeyHandle {
+  public:
+    ControlKeyHandle()
+            : m_id(-1) {
+    }
+
+    bool isValid() const {
+        return m_id >= 0;
+    }
+
+    int id() const {
+        return m_id;
+    }
+
+  private:
+    explicit ControlKeyHandle(int id)
+            : m_id(id) {
+    }
+
+    int m_id;
+
+    friend class ControlRegistry;
+};
+
+inline bool operator==(const ControlKeyHandle& lhs, const ControlKeyHandle& rhs) {
+    return lhs.id() == rhs.id();
+}
+
+inline bool operator!=(const ControlKeyHandle& lhs, const ControlKeyHandle& rhs) {
+    return lhs.id() != rhs.id();
+}
+
+inline qhash_seed_t qHash(
+        const ControlKeyHandle& handle,
+        qhash_seed_t seed = 0) {
+    return qHash(handle.id(), seed);
+}
+
+inline QDebug operator<<(QDebug stream, const ControlKeyHandle& handle) {
+    stream << "ControlKeyHandle(" << handle.id() << ")";
+    return stream;
+}
+
+/// Read-mostly registry of all ControlDoublePrivate instances.
+///
+/// Lookups by key or handle are lock-free and never block each other,
+/// which matters during skin loading and controller script initialization
+/// when tens of thousands of controls are resolved, possibly concurrently
+/// with the engine creating new controls.
+///
+/// Interned keys are stored in a fixed number of hash buckets with
+/// immutable, append-only chains. Each handle refers to a slot in a
+/// segmented array that is never reallocated. A slot points to an
+/// immutable entry with a weak reference to the control. Writers replace
+/// the entry while holding the mutex of the slot's shard and then wait
+/// for concurrent readers of that slot before deleting the old entry.
+class ControlRegistry final {
+  public:
+    ControlRegistry();
+    ~ControlRegistry();
+
+    /// Returns the handle of the key, which is interned on first use.
+    /// Returns an invalid handle if the key is invalid or the registry
+    /// is exhausted.
+    ControlKeyHandle intern(const ConfigKey& key);
+    /// Returns the handle of the key if it has already been interned.
+    ControlKeyHandle find(const ConfigKey& key) const;
+
+    /// Returns the control registered for the handle or nullptr if it
+    /// does not exist (anymore).
+    QSharedPointer<ControlDoublePrivate> lookup(ControlKeyHandle handle) const;
+
+    /// Registers the control for the handle, replacing any previous one.
+    void insert(
+            ControlKeyHandle handle,
+            const QSharedPointer<ControlDoublePrivate>& pControl);
+    /// Unregisters the control for the handle if it has expired.
+    void removeExpired(ControlKeyHandle handle);
+
+    /// Returns all registered controls, including duplicates for aliases.
+    QList<QSharedPointer<ControlDoublePrivate>> getAll() const;
+    /// Unregisters all controls and returns them.
+    QList<QSharedPointer<ControlDoublePrivate>> takeAll();
+
+  private:
+    ControlRegistry(const ControlRegistry&) = delete;
+    ControlRegistry& operator=(const ControlRegistry&) = delete;
+
+    static constexpr int kNumBuckets = 1 << 14;
+    static constexpr int kSegmentSize = 1024;
+    static constexpr int kMaxSegments = 1024;
+    static constexpr int kNumShards = 64;
+
+    struct KeyNode {
+        const ConfigKey key;
+        const int id;
+        const KeyNode* const pNext;
+    };
+
+    struct Entry {
+        const QWeakPointer<ControlDoublePrivate> pControl;
+    };
+
+    struct Slot {
+        std::atomic<const Entry*> pEntry{nullptr};
+        mutable std::atomic<int> readers{0};
+    };
+
+    static std::size_t bucketIndex(const ConfigKey& key);
+    static const KeyNode* findNode(const KeyNode* pNode, const ConfigKey& key);
+
+    Slot* slot(int id) const;
+    QSharedPointer<ControlDoublePrivate> lookupSlot(const Slot& slot) const;
+    static void replaceEntry(Slot* pSlot, const Entry* pEntry);
+
+    MMutex m_internMutex;
+    std::array<std::atomic<const KeyNode*>, kNumBuckets> m_buckets;
+    std::array<std::atomic<Slot*>, kMaxSegments> m_segments;
+    std::atomic<int> m_size;
+
+    mutable std::array<MMutex, kNumShards> m_shardMutexes;
+};
@@ -122,6 +122,8 @@ class LegacyControllerMapping {
         bool reversedColor;         // Whether or not the RGB is swapped BGR.
         bool rawData;               // Whether or not the screen is allowed to receive bare
                                     // data, not transformed.
+        bool partialUpdate;         // Whether or not the transform function receives the
+                                    // damaged regions of the frame to send partial updates.
     };
 #endif
 
@@ -218,6 +220,7 @@ class LegacyControllerMapping {
     /// @param endian the pixel endian format
     /// @param reversedColor whether or not the RGB is swapped BGR
     /// @param rawData whether or not the screen is allowed to reserve bare data, not transformed
+    /// @param partialUpdate whether or not the transform function receives the damaged regions
     virtual void addScreenInfo(ScreenInfo info) {
         m_screens.append(std::move(info));
         setDirty(true);
@@ -110,6 +110,9 @@ bool parseAndAddScreenDefinition(const QDomElement& screen, LegacyControllerMapp
     LOG_IF_NOT_OK("reversed", "a boolean");
     bool rawData = parseHumanBoolean(screen.attribute("raw", "false").toLower().trimmed(), &ok);
     LOG_IF_NOT_OK("raw", "a boolean");
+    bool partialUpdate = parseHumanBoolean(
+            screen.attribute("partialUpdate", "false").toLower().trimmed(), &ok);
+    LOG_IF_NOT_OK("partialUpdate", "a boolean");
     uint splashOff = screen.attribute("splashoff", "0").toUInt(&ok);
     LOG_IF_NOT_OK("splashoff", "an unsigned integer");
 
@@ -176,7 +179,8 @@ bool parseAndAddScreenDefinition(const QDomElement& screen, LegacyControllerMapp
             pixelFormat,
             endian,
             reversedColor,
-            rawData});
+            rawData,
+            partialUpdate});
     return true;
 }
 #endif
@@ -44,6 +44,7 @@ ControllerRenderingEngine::ControllerRenderingEngine(
           m_screenInfo(info),
           m_GLDataFormat(GL_RGBA),
           m_GLDataType(GL_UNSIGNED_BYTE),
+          m_sceneChanged(true),
           m_isValid(true),
           m_pEngineThreadControl(engineThreadControl) {
     switch (m_screenInfo.pixelFormat) {
@@ -215,6 +216,21 @@ void ControllerRenderingEngine::setup(std::shared_ptr<QQmlEngine> qmlEngine) {
     m_renderControl = std::make_unique<QQuickRenderControl>(this);
     m_quickWindow = std::make_unique<QQuickWindow>(m_renderControl.get());
 
+    // A frame is only rendered once the scene has changed
+    const auto markSceneChanged = [this]() {
+        m_sceneChanged = true;
+    };
+    connect(m_renderControl.get(),
+            &QQuickRenderControl::sceneChanged,
+            this,
+            markSceneChanged,
+            Qt::DirectConnection);
+    connect(m_renderControl.get(),
+            &QQuickRenderControl::renderRequested,
+            this,
+            markSceneChanged,
+            Qt::DirectConnection);
+
     if (!qmlEngine->incubationController()) {
         qmlEngine->setIncubationController(m_quickWindow->incubationController());
     }
@@ -259,6 +275,13 @@ void ControllerRenderingEngine::renderFrame() {
         return;
     }
 
+    if (!m_sceneChanged.exchange(false)) {
+        // Nothing to render, check again with the next frame
+        m_nextFrameStart = Clock::now();
+        scheduleNextFrame();
+        return;
+    }
+
     VERIFY_OR_TERMINATE(m_offscreenSurface->isValid(), "OffscreenSurface isn't valid anymore.");
     VERIFY_OR_TERMINATE(m_context->isValid(), "GLContext isn't valid anymore.");
     VERIFY_OR_TERMINATE(m_context->makeCurrent(m_offscreenSurface.get()),
@@ -365,9 +388,16 @@ void ControllerRenderingEngine::renderFrame() {
     fboImage.mirror(false, true);
 #endif
 
-    emit frameRendered(m_screenInfo, fboImage.copy(), timestamp);
+    // Animations may change the scene without changing any pixel
+    const QList<QRect> damage = m_damageTracker.update(fboImage);
 
     m_context->doneCurrent();
+
+    if (damage.isEmpty()) {
+        scheduleNextFrame();
+        return;
+    }
+    emit frameRendered(m_screenInfo, fboImage.copy(), timestamp, damage);
 }
 
 bool ControllerRenderingEngine::stop() {
@@ -393,6 +423,10 @@ void ControllerRenderingEngine::send(Controller* controller, const QByteArray& f
                 << "milliseconds and frame has" << frame.size() << "bytes";
     }
 
+    scheduleNextFrame();
+}
+
+void ControllerRenderingEngine::scheduleNextFrame() {
     m_nextFrameStart += std::chrono::microseconds(1000000 / m_screenInfo.target_fps);
 
     auto durationToWaitBeforeFrame =
@@ -3,10 +3,13 @@
 #include <QObject>
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
+#include <QRect>
+#include <atomic>
 #include <chrono>
 #include <gsl/pointers>
 
 #include "controllers/legacycontrollermapping.h"
+#include "controllers/rendering/framedamagetracker.h"
 #include "preferences/configobject.h"
 #include "util/time.h"
 
@@ -72,9 +75,12 @@ class ControllerRenderingEngine : public QObject {
     void send(Controller* controller, const QByteArray& frame);
 
   signals:
+    /// Only emitted for frames that differ from the previous one.
+    /// @param damage the regions of the frame that have changed.
     void frameRendered(const LegacyControllerMapping::ScreenInfo& screeninfo,
             QImage frame,
-            const QDateTime& timestamp);
+            const QDateTime& timestamp,
+            const QList<QRect>& damage);
     void stopping();
     /// @brief Request the screen thread to send a frame to the device.
     /// @param controller the controller to send the frame to.
@@ -83,6 +89,7 @@ class ControllerRenderingEngine : public QObject {
 
   private:
     virtual void prepare();
+    void scheduleNextFrame();
 
     std::chrono::time_point<std::chrono::steady_clock> m_nextFrameStart;
 
@@ -100,6 +107,11 @@ class ControllerRenderingEngine : public QObject {
     GLenum m_GLDataFormat;
     GLenum m_GLDataType;
 
+    // Set by the render control whenever the scene has changed, which can
+    // happen in the thread of the QML engine
+    std::atomic<bool> m_sceneChanged;
+    FrameDamageTracker m_damageTracker;
+
     bool m_isValid;
     // Engine control is owned by ControllerScriptEngineBase. The assumption is
     // made that ControllerScriptEngineBase always outlive
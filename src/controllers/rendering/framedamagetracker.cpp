@@ -0,0 +1,96 @@
+#include "controllers/rendering/framedamagetracker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "util/assert.h"
+
+FrameDamageTracker::FrameDamageTracker(int tileSize)
+        : m_tileSize(tileSize) {
+    DEBUG_ASSERT(m_tileSize > 0);
+}
+
+QList<QRect> FrameDamageTracker::update(const QImage& frame) {
+    if (frame.isNull()) {
+        reset();
+        return {};
+    }
+    const QImage previousFrame = std::exchange(m_previousFrame, frame);
+    if (previousFrame.size() != frame.size() ||
+            previousFrame.format() != frame.format() ||
+            frame.depth() % 8 != 0) {
+        return {frame.rect()};
+    }
+
+    const int bytesPerPixel = frame.depth() / 8;
+    const int lineBytes = frame.width() * bytesPerPixel;
+    const int tileBytes = m_tileSize * bytesPerPixel;
+    const int numTileColumns = (frame.width() + m_tileSize - 1) / m_tileSize;
+
+    QList<QRect> damage;
+    // The rectangles that have been damaged in the previous row of tiles and
+    // may still be extended downwards
+    QList<QRect> openRects;
+    QList<QRect> extendedRects;
+    for (int tileTop = 0; tileTop < frame.height(); tileTop += m_tileSize) {
+        const int tileBottom = std::min(tileTop + m_tileSize, frame.height());
+        m_damagedTiles.assign(numTileColumns, false);
+        bool isRowDamaged = false;
+        for (int y = tileTop; y < tileBottom; ++y) {
+            const uchar* pLine = frame.constScanLine(y);
+            const uchar* pPreviousLine = previousFrame.constScanLine(y);
+            // memcmp is vectorized by the C libraries, so most of the
+            // unchanged lines are skipped with a single wide comparison
+            if (std::memcmp(pLine, pPreviousLine, lineBytes) == 0) {
+                continue;
+            }
+            for (int column = 0; column < numTileColumns; ++column) {
+                if (m_damagedTiles[column]) {
+                    continue;
+                }
+                const int offset = column * tileBytes;
+                const int size = std::min(tileBytes, lineBytes - offset);
+                if (std::memcmp(pLine + offset, pPreviousLine + offset, size) != 0) {
+                    m_damagedTiles[column] = true;
+                    isRowDamaged = true;
+                }
+            }
+        }
+
+        if (isRowDamaged) {
+            for (int column = 0; column < numTileColumns;) {
+                if (!m_damagedTiles[column]) {
+                    ++column;
+                    continue;
+                }
+                const int firstColumn = column;
+                while (column < numTileColumns && m_damagedTiles[column]) {
+                    ++column;
+                }
+                const int left = firstColumn * m_tileSize;
+                const int right = std::min(column * m_tileSize, frame.width());
+                const QRect run(left, tileTop, right - left, tileBottom - tileTop);
+                const auto it = std::find_if(openRects.begin(),
+                        openRects.end(),
+                        [&run](const QRect& rect) {
+                            return rect.left() == run.left() && rect.width() == run.width();
+                        });
+                if (it != openRects.end()) {
+                    QRect extendedRect = *it;
+                    extendedRect.setBottom(run.bottom());
+                    extendedRects.append(extendedRect);
+                    openRects.erase(it);
+                } else {
+                    extendedRects.append(run);
+                }
+            }
+        }
+        // Rectangles that have not been continued in this row are complete
+        damage.append(openRects);
+        openRects.swap(extendedRects);
+        extendedRects.clear();
+    }
+    damage.append(openRects);
+    return damage;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <vector>
+
+/// Finds the parts of a controller screen frame that have changed since the
+/// previous frame, so that unchanged frames don't need to be transformed and
+/// sent to the device, and mappings can send partial updates.
+///
+/// The frame is divided into square tiles and the damage is reported as
+/// rectangles covering the changed tiles. Adjacent changed tiles of a row are
+/// merged, and so are rectangles of consecutive rows with the same span.
+class FrameDamageTracker {
+  public:
+    static constexpr int kDefaultTileSize = 16;
+
+    explicit FrameDamageTracker(int tileSize = kDefaultTileSize);
+
+    /// Compares the frame to the previous one and keeps it for the next call.
+    /// Returns the whole frame if the previous frame has another size or
+    /// format, and an empty list if nothing has changed.
+    QList<QRect> update(const QImage& frame);
+
+    /// Forgets the previous frame, so that the next frame is damaged entirely.
+    void reset() {
+        m_previousFrame = QImage();
+    }
+
+  private:
+    const int m_tileSize;
+    QImage m_previousFrame;
+    // The changed tiles of the current row of tiles
+    std::vector<bool> m_damagedTiles;
+};
@@ -14,6 +14,7 @@
 #include "qml/asyncimageprovider.h"
 #endif
 #include "util/cmdlineargs.h"
+#include "util/tracerecorder.h"
 
 ControllerScriptEngineBase::ControllerScriptEngineBase(
         Controller* controller, const RuntimeLoggingCategory& logger)
@@ -141,6 +142,7 @@ QObject* ControllerScriptEngineBase::getPlayer(const QString& group) {
 
 bool ControllerScriptEngineBase::executeFunction(
         QJSValue* pFunctionObject, const QJSValueList& args) {
+    mixxx::ScopedTraceEvent traceEvent("ControllerScriptEngineBase::executeFunction");
     // This function is called from outside the controller engine, so we can't
     // use VERIFY_OR_DEBUG_ASSERT here
     if (!m_pJSEngine) {
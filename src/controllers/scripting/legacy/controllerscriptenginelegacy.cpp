@@ -502,7 +502,8 @@ bool ControllerScriptEngineLegacy::bindSceneToScreen(
 void ControllerScriptEngineLegacy::handleScreenFrame(
         const LegacyControllerMapping::ScreenInfo& screenInfo,
         const QImage& frame,
-        const QDateTime& timestamp) {
+        const QDateTime& timestamp,
+        const QList<QRect>& damage) {
     VERIFY_OR_DEBUG_ASSERT(
             m_renderingScreens.contains(screenInfo.identifier)) {
         qCWarning(m_logger) << "Unable to find transform function info for the given screen";
@@ -561,11 +562,25 @@ void ControllerScriptEngineLegacy::handleScreenFrame(
         qCWarning(m_logger) << "Controller JS engine has an unhandled error. Discarding.";
         qCDebug(m_logger) << "Controller JS error is:" << m_pJSEngine->catchError().toString();
     }
+    QJSValueList transformArgs{m_pJSEngine->toScriptValue(input),
+            m_pJSEngine->toScriptValue(timestamp)};
+    if (screenInfo.partialUpdate) {
+        // The mapping may only send the damaged regions, which are passed as
+        // an array of {x, y, width, height} objects
+        QJSValue damagedRegions = m_pJSEngine->newArray(static_cast<uint>(damage.size()));
+        for (int i = 0; i < damage.size(); ++i) {
+            QJSValue region = m_pJSEngine->newObject();
+            region.setProperty(QStringLiteral("x"), damage[i].x());
+            region.setProperty(QStringLiteral("y"), damage[i].y());
+            region.setProperty(QStringLiteral("width"), damage[i].width());
+            region.setProperty(QStringLiteral("height"), damage[i].height());
+            damagedRegions.setProperty(static_cast<quint32>(i), region);
+        }
+        transformArgs.append(damagedRegions);
+    }
     // During the frame transformation, any QML errors are considered fatal.
     setErrorsAreFatal(true);
-    auto result = pScreen->getTransform().call(
-            QJSValueList{m_pJSEngine->toScriptValue(input),
-                    m_pJSEngine->toScriptValue(timestamp)});
+    auto result = pScreen->getTransform().call(transformArgs);
     if (result.isError()) {
         qCWarning(m_logger) << "Could not transform rendering buffer for screen"
                             << screenInfo.identifier;
@@ -7,6 +7,7 @@
 #include <memory>
 #ifdef MIXXX_USE_QML
 #include <QMetaMethod>
+#include <QRect>
 #include <unordered_map>
 #endif
 
@@ -67,7 +68,8 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     void handleScreenFrame(
             const LegacyControllerMapping::ScreenInfo& screeninfo,
             const QImage& frame,
-            const QDateTime& timestamp);
+            const QDateTime& timestamp,
+            const QList<QRect>& damage);
 
   signals:
     /// Emitted when a screen has been rendered.
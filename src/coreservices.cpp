@@ -55,6 +55,7 @@
 #include "util/screensavermanager.h"
 #include "util/statsmanager.h"
 #include "util/time.h"
+#include "util/tracerecorder.h"
 #include "util/translations.h"
 #include "util/versionstore.h"
 #include "vinylcontrol/vinylcontrolmanager.h"
@@ -366,6 +367,9 @@ CoreServices::CoreServices(const CmdlineArgs& args, QApplication* pApp)
     if (m_cmdlineArgs.getDeveloper()) {
         StatsManager::createInstance();
     }
+    if (m_cmdlineArgs.getTracingEnabled()) {
+        mixxx::TraceRecorder::enable(m_cmdlineArgs.getTracePath());
+    }
     mixxx::Translations::initializeTranslations(
             m_pSettingsManager->settings(), pApp, m_cmdlineArgs.getLocale());
     initializeKeyboard();
@@ -381,6 +385,9 @@ CoreServices::~CoreServices() {
     CLEAR_AND_CHECK_DELETED(m_pKbdConfig);
     CLEAR_AND_CHECK_DELETED(m_pKbdConfigEmpty);
 
+    if (m_cmdlineArgs.getTracingEnabled()) {
+        mixxx::TraceRecorder::disable();
+    }
     if (m_cmdlineArgs.getDeveloper()) {
         StatsManager::destroy();
     }
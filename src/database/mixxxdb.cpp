@@ -6,6 +6,7 @@
 #include "moc_mixxxdb.cpp"
 #include "util/assert.h"
 #include "util/logger.h"
+#include "util/math.h"
 
 // The schema XML is baked into the binary via Qt resources.
 //static
@@ -14,6 +15,19 @@ const QString MixxxDb::kDefaultSchemaFile(":/schema.xml");
 //static
 const int MixxxDb::kRequiredSchemaVersion = 39;
 
+//static
+const ConfigKey MixxxDb::kWriteAheadLogConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("DbWriteAheadLog"));
+//static
+const ConfigKey MixxxDb::kMmapSizeMBConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("DbMmapSizeMB"));
+//static
+const ConfigKey MixxxDb::kCacheSizeMBConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("DbCacheSizeMB"));
+//static
+const ConfigKey MixxxDb::kStatementCacheSizeConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("DbStatementCacheSize"));
+
 namespace {
 
 const mixxx::Logger kLogger("MixxxDb");
@@ -30,6 +44,21 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+mixxx::DbConnection::PerformanceProfile dbPerformanceProfile(
+        const UserSettingsPointer& pConfig) {
+    mixxx::DbConnection::PerformanceProfile profile;
+    profile.writeAheadLog = pConfig->getValue(
+            MixxxDb::kWriteAheadLogConfigKey, profile.writeAheadLog);
+    profile.mmapSizeMB = math_max(0,
+            pConfig->getValue(MixxxDb::kMmapSizeMBConfigKey, profile.mmapSizeMB));
+    profile.cacheSizeMB = math_max(0,
+            pConfig->getValue(MixxxDb::kCacheSizeMBConfigKey, profile.cacheSizeMB));
+    profile.statementCacheSize = math_max(0,
+            pConfig->getValue(MixxxDb::kStatementCacheSizeConfigKey,
+                    profile.statementCacheSize));
+    return profile;
+}
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -58,6 +87,7 @@ mixxx::DbConnection::Params dbConnectionParams(
     }
     params.userName = kUserName;
     params.password = kPassword;
+    params.performanceProfile = dbPerformanceProfile(pConfig);
     return params;
 }
 
@@ -13,6 +13,13 @@ class MixxxDb : public QObject {
 
     static const int kRequiredSchemaVersion;
 
+    // Tuning of the database connections, see
+    // mixxx::DbConnection::PerformanceProfile
+    static const ConfigKey kWriteAheadLogConfigKey;
+    static const ConfigKey kMmapSizeMBConfigKey;
+    static const ConfigKey kCacheSizeMBConfigKey;
+    static const ConfigKey kStatementCacheSizeConfigKey;
+
     static bool initDatabaseSchema(
             const QSqlDatabase& database,
             int schemaVersion = kRequiredSchemaVersion,
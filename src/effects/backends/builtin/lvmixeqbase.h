@@ -2,6 +2,7 @@
 
 #include "effects/backends/effectprocessor.h"
 #include "engine/filters/enginefilterdelay.h"
+#include "engine/filters/enginefilteriirbank.h"
 #include "util/defs.h"
 #include "util/math.h"
 #include "util/sample.h"
@@ -103,12 +104,21 @@ class LVMixEQEffectGroupState : public EffectState {
             m_delay3->process(pInput, m_pHighBuf, numSamples);
         }
 
-        if (fMid != 0 || m_oldMid != 0) {
+        const bool processMid = fMid != 0 || m_oldMid != 0;
+        const bool processLow = fLow != 0 || m_oldLow != 0;
+        if (processMid) {
             m_delay2->process(pInput, m_pBandBuf, numSamples);
-            m_low2->process(m_pBandBuf, m_pBandBuf, numSamples);
         }
-
-        if (fLow != 0 || m_oldLow != 0) {
+        if (processMid && processLow) {
+            // Both low passes are of the same kind, run them in parallel lanes
+            EngineFilterIIRBank<LPF::kSize, LPF::kPass, 2>::process(
+                    {m_low1, m_low2},
+                    {pInput, m_pBandBuf},
+                    {m_pLowBuf, m_pBandBuf},
+                    numSamples);
+        } else if (processMid) {
+            m_low2->process(m_pBandBuf, m_pBandBuf, numSamples);
+        } else if (processLow) {
             m_low1->process(pInput, m_pLowBuf, numSamples);
         }
 
@@ -1,5 +1,6 @@
 #include "effects/effectsmessenger.h"
 
+#include "engine/effects/effectsprocessingplan.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
 #include "util/make_const_iterator.h"
@@ -13,6 +14,9 @@ EffectsMessenger::EffectsMessenger(
 
 EffectsMessenger::~EffectsMessenger() {
     for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); it++) {
+        if (it.value()->type == EffectsRequest::SET_PROCESSING_PLAN) {
+            collectGarbage(it.value());
+        }
         delete it.value();
     }
 }
@@ -33,6 +37,15 @@ bool EffectsMessenger::writeRequest(EffectsRequest* request) {
     processEffectsResponses();
 
     request->request_id = m_nextRequestId++;
+    // The new plan must be active before the request is processed, otherwise
+    // the engine could process a chain that is about to be deleted.
+    if (m_processingPlanner.onRequestSent(*request)) {
+        writeProcessingPlan();
+    }
+    return writeRequestInner(request);
+}
+
+bool EffectsMessenger::writeRequestInner(EffectsRequest* request) {
     // TODO(XXX) use preallocated requests to avoid delete calls from engine
     if (m_requestPipe.writeMessage(request)) {
         m_activeRequests[request->request_id] = request;
@@ -42,9 +55,29 @@ bool EffectsMessenger::writeRequest(EffectsRequest* request) {
     return false;
 }
 
+void EffectsMessenger::writeProcessingPlan() {
+    EffectsRequest* request = new EffectsRequest();
+    request->type = EffectsRequest::SET_PROCESSING_PLAN;
+    request->request_id = m_nextRequestId++;
+    auto pPlan = m_processingPlanner.createPlan();
+    request->SetProcessingPlan.pPlan = pPlan.get();
+    if (writeRequestInner(request)) {
+        // Owned by the request now
+        pPlan.release();
+    } else {
+        qWarning() << debugString()
+                   << "WARNING: Failed to send the effects processing plan";
+    }
+}
+
 void EffectsMessenger::processEffectsResponses() {
     EffectsResponse response;
+    bool processingPlanChanged = false;
     while (m_requestPipe.readMessage(&response)) {
+        if (m_processingPlanner.onResponseReceived(response.request_id)) {
+            processingPlanChanged = true;
+        }
+
         auto it = m_activeRequests.constFind(response.request_id);
 
         VERIFY_OR_DEBUG_ASSERT(it != m_activeRequests.constEnd()) {
@@ -67,6 +100,10 @@ void EffectsMessenger::processEffectsResponses() {
             it = constErase(&m_activeRequests, it);
         }
     }
+    if (processingPlanChanged && !m_bShuttingDown) {
+        // Chains that have been faded out are not processed anymore
+        writeProcessingPlan();
+    }
 }
 
 void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest) {
@@ -80,5 +117,7 @@ void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest) {
             qDebug() << debugString() << "delete" << pRequest->RemoveEffectChain.pChain;
         }
         delete pRequest->RemoveEffectChain.pChain;
+    } else if (pRequest->type == EffectsRequest::SET_PROCESSING_PLAN) {
+        delete pRequest->SetProcessingPlan.pPlan;
     }
 }
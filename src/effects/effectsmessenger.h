@@ -1,5 +1,6 @@
 #pragma once
 
+#include "effects/effectsprocessingplanner.h"
 #include "engine/effects/message.h"
 
 /// EffectsMessenger sends EffectsRequests from the main thread and receives
@@ -25,6 +26,9 @@ class EffectsMessenger {
     void processEffectsResponses();
 
   private:
+    bool writeRequestInner(EffectsRequest* request);
+    /// Sends the current EffectsProcessingPlan to the EngineEffectsManager
+    void writeProcessingPlan();
     void collectGarbage(const EffectsRequest* pRequest);
 
     QString debugString() const {
@@ -32,6 +36,7 @@ class EffectsMessenger {
     }
 
     QHash<qint64, EffectsRequest*> m_activeRequests;
+    EffectsProcessingPlanner m_processingPlanner;
     EffectsRequestPipe m_requestPipe;
     qint64 m_nextRequestId;
     bool m_bShuttingDown;
@@ -0,0 +1,168 @@
+#include "effects/effectsprocessingplanner.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "util/assert.h"
+
+bool EffectsProcessingPlanner::ChainRouting::isProcessedForInputChannel(
+        int inputChannel) const {
+    if (numEffects <= 0 || (!active && fadeOutRequestId == kNoFadeOut)) {
+        return false;
+    }
+    return inputChannels.contains(inputChannel) ||
+            fadingOutInputChannels.contains(inputChannel);
+}
+
+EffectsProcessingPlanner::ChainRouting* EffectsProcessingPlanner::findChain(
+        const EngineEffectChain* pChain) {
+    for (auto& chain : m_chains) {
+        if (chain.pChain == pChain) {
+            return &chain;
+        }
+    }
+    return nullptr;
+}
+
+bool EffectsProcessingPlanner::onRequestSent(const EffectsRequest& request) {
+    switch (request.type) {
+    case EffectsRequest::ADD_EFFECT_CHAIN: {
+        VERIFY_OR_DEBUG_ASSERT(!findChain(request.AddEffectChain.pChain)) {
+            return false;
+        }
+        // A new EngineEffectChain is inactive until its parameters are set
+        m_chains.append(ChainRouting{request.AddEffectChain.pChain,
+                request.AddEffectChain.signalProcessingStage,
+                false,
+                kNoFadeOut,
+                0,
+                {},
+                {}});
+        return false;
+    }
+    case EffectsRequest::REMOVE_EFFECT_CHAIN: {
+        const auto it = std::find_if(m_chains.begin(),
+                m_chains.end(),
+                [pChain = request.RemoveEffectChain.pChain](const ChainRouting& chain) {
+                    return chain.pChain == pChain;
+                });
+        VERIFY_OR_DEBUG_ASSERT(it != m_chains.end()) {
+            return false;
+        }
+        m_chains.erase(it);
+        return true;
+    }
+    case EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS: {
+        ChainRouting* pChain = findChain(request.pTargetChain);
+        VERIFY_OR_DEBUG_ASSERT(pChain) {
+            return false;
+        }
+        // EngineEffectChain disables the effects of a fully dry chain
+        const bool active = request.SetEffectChainParameters.enabled &&
+                request.SetEffectChainParameters.mix > 0;
+        if (active == pChain->active) {
+            return false;
+        }
+        pChain->active = active;
+        pChain->fadeOutRequestId = active ? kNoFadeOut : request.request_id;
+        // The plan only changes when the chain is activated. Deactivated
+        // chains are removed after fading out.
+        return active;
+    }
+    case EffectsRequest::ADD_EFFECT_TO_CHAIN: {
+        ChainRouting* pChain = findChain(request.pTargetChain);
+        VERIFY_OR_DEBUG_ASSERT(pChain) {
+            return false;
+        }
+        return ++pChain->numEffects == 1;
+    }
+    case EffectsRequest::REMOVE_EFFECT_FROM_CHAIN: {
+        ChainRouting* pChain = findChain(request.pTargetChain);
+        VERIFY_OR_DEBUG_ASSERT(pChain && pChain->numEffects > 0) {
+            return false;
+        }
+        return --pChain->numEffects == 0;
+    }
+    case EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL: {
+        ChainRouting* pChain = findChain(request.pTargetChain);
+        VERIFY_OR_DEBUG_ASSERT(pChain) {
+            return false;
+        }
+        const int inputChannel = request.EnableInputChannelForChain.channelHandle.handle();
+        const bool wasFadingOut = pChain->fadingOutInputChannels.remove(inputChannel);
+        pChain->inputChannels.insert(inputChannel);
+        return !wasFadingOut;
+    }
+    case EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL: {
+        ChainRouting* pChain = findChain(request.pTargetChain);
+        VERIFY_OR_DEBUG_ASSERT(pChain) {
+            return false;
+        }
+        const int inputChannel = request.DisableInputChannelForChain.channelHandle.handle();
+        if (pChain->inputChannels.remove(inputChannel)) {
+            pChain->fadingOutInputChannels.insert(inputChannel, request.request_id);
+        }
+        return false;
+    }
+    default:
+        return false;
+    }
+}
+
+bool EffectsProcessingPlanner::onResponseReceived(qint64 requestId) {
+    bool changed = false;
+    for (auto& chain : m_chains) {
+        if (chain.fadeOutRequestId == requestId) {
+            chain.fadeOutRequestId = kNoFadeOut;
+            changed = true;
+        }
+        for (auto it = chain.fadingOutInputChannels.begin();
+                it != chain.fadingOutInputChannels.end();) {
+            if (it.value() == requestId) {
+                it = chain.fadingOutInputChannels.erase(it);
+                changed = true;
+            } else {
+                ++it;
+            }
+        }
+    }
+    return changed;
+}
+
+std::unique_ptr<EffectsProcessingPlan> EffectsProcessingPlanner::createPlan() const {
+    int numChannels = 0;
+    for (const auto& chain : m_chains) {
+        for (const int inputChannel : chain.inputChannels) {
+            numChannels = std::max(numChannels, inputChannel + 1);
+        }
+        for (auto it = chain.fadingOutInputChannels.constBegin();
+                it != chain.fadingOutInputChannels.constEnd();
+                ++it) {
+            numChannels = std::max(numChannels, it.key() + 1);
+        }
+    }
+
+    std::vector<EngineEffectChain*> chains;
+    std::vector<int> chainIndices;
+    std::vector<int> offsets;
+    offsets.reserve(kNumSignalProcessingStages * numChannels + 1);
+    offsets.push_back(0);
+    for (int stage = 0; stage < kNumSignalProcessingStages; ++stage) {
+        for (int channel = 0; channel < numChannels; ++channel) {
+            for (int i = 0; i < m_chains.size(); ++i) {
+                const auto& chain = m_chains[i];
+                if (static_cast<int>(chain.stage) == stage &&
+                        chain.isProcessedForInputChannel(channel)) {
+                    chains.push_back(chain.pChain);
+                    chainIndices.push_back(i);
+                }
+            }
+            offsets.push_back(static_cast<int>(chains.size()));
+        }
+    }
+    return std::make_unique<EffectsProcessingPlan>(numChannels,
+            static_cast<int>(m_chains.size()),
+            std::move(chains),
+            std::move(chainIndices),
+            std::move(offsets));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <memory>
+
+#include "effects/defs.h"
+#include "engine/effects/effectsprocessingplan.h"
+#include "engine/effects/message.h"
+
+/// EffectsProcessingPlanner tracks the routing of all EngineEffectChains
+/// in the main thread by following the EffectsRequests that are sent to
+/// the engine and creates the corresponding EffectsProcessingPlans.
+///
+/// Chains that are disabled, fully dry (mix 0) or empty are not part of the
+/// plan. Chains that have been disabled or turned fully dry, or that have
+/// been disabled for a channel, need to be processed once more to fade out
+/// their effects. They are kept in the plan until the engine has responded
+/// to the request that deactivated them, which ensures that the plan
+/// without them is only swapped in after the next callback.
+class EffectsProcessingPlanner final {
+  public:
+    /// Updates the routing for a request that is sent to the engine.
+    /// Returns true if the plan has changed.
+    bool onRequestSent(const EffectsRequest& request);
+    /// Returns true if the plan has changed, i.e. if chains that have
+    /// been fading out are not processed anymore.
+    bool onResponseReceived(qint64 requestId);
+
+    std::unique_ptr<EffectsProcessingPlan> createPlan() const;
+
+  private:
+    // Marks chains that need to be processed until the engine has
+    // responded to this request.
+    using FadeOutRequestId = qint64;
+    static constexpr FadeOutRequestId kNoFadeOut = -1;
+
+    struct ChainRouting {
+        EngineEffectChain* pChain;
+        SignalProcessingStage stage;
+        // The chain is enabled and not fully dry
+        bool active;
+        FadeOutRequestId fadeOutRequestId;
+        int numEffects;
+        // Indexed by ChannelHandle::handle()
+        QSet<int> inputChannels;
+        QHash<int, FadeOutRequestId> fadingOutInputChannels;
+
+        bool isProcessedForInputChannel(int inputChannel) const;
+    };
+
+    ChainRouting* findChain(const EngineEffectChain* pChain);
+
+    // In the order in which the chains have been added to the engine, which
+    // is also the order in which they are processed per stage.
+    QList<ChainRouting> m_chains;
+};
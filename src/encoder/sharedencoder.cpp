@@ -0,0 +1,171 @@
+#include "encoder/sharedencoder.h"
+
+#include <QStringList>
+
+#include "recording/defs_recording.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/time.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedEncoder");
+
+// Another subscriber takes over if the feeder has not submitted any samples
+// for this long. This is well below the latency of the network stream, so
+// the other connections keep streaming if the server of the feeder is slow.
+constexpr mixxx::Duration kFeederTimeout = mixxx::Duration::fromMillis(100);
+
+} // namespace
+
+SharedEncoder::SharedEncoder()
+        : m_pFeeder(nullptr) {
+}
+
+SharedEncoder::~SharedEncoder() {
+    DEBUG_ASSERT(m_subscribers.isEmpty());
+    m_subscribers.clear();
+    // Deleting the encoder may flush it, which calls write() without
+    // any subscribers
+    m_pEncoder.reset();
+}
+
+//static
+bool SharedEncoder::isShareable(const EncoderSettings& settings) {
+    const QString format = settings.getFormat();
+    return format == ENCODING_MP3 ||
+            format == ENCODING_AAC ||
+            format == ENCODING_HEAAC ||
+            format == ENCODING_HEAACV2;
+}
+
+void SharedEncoder::subscribe(Subscriber* pSubscriber) {
+    const auto locker = lockMutex(&m_lock);
+    DEBUG_ASSERT(!m_subscribers.contains(pSubscriber));
+    m_subscribers.append(pSubscriber);
+}
+
+void SharedEncoder::unsubscribe(Subscriber* pSubscriber) {
+    const auto locker = lockMutex(&m_lock);
+    m_subscribers.removeAll(pSubscriber);
+    if (m_pFeeder == pSubscriber) {
+        // The next subscriber that submits audio takes over
+        m_pFeeder = nullptr;
+    }
+}
+
+int SharedEncoder::subscriberCount() const {
+    const auto locker = lockMutex(&m_lock);
+    return m_subscribers.size();
+}
+
+bool SharedEncoder::encodeBuffer(Subscriber* pSubscriber,
+        const CSAMPLE* pBuffer,
+        const std::size_t bufferSize) {
+    const auto locker = lockMutex(&m_lock);
+    VERIFY_OR_DEBUG_ASSERT(m_subscribers.contains(pSubscriber)) {
+        return false;
+    }
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    if (m_pFeeder && m_pFeeder != pSubscriber) {
+        if (now - m_lastFedTime < kFeederTimeout) {
+            return false;
+        }
+        kLogger.info() << "The feeder has fallen behind, another subscriber takes over";
+    }
+    m_pFeeder = pSubscriber;
+    m_lastFedTime = now;
+    // The encoded packets are received by the write() callback
+    m_pEncoder->encodeBuffer(pBuffer, bufferSize);
+    return true;
+}
+
+void SharedEncoder::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    if (m_subscribers.isEmpty() || headerLen + bodyLen <= 0) {
+        return;
+    }
+    // The only copy of the packet, the subscribers share it
+    QByteArray packet;
+    packet.reserve(headerLen + bodyLen);
+    if (headerLen > 0) {
+        packet.append(reinterpret_cast<const char*>(header), headerLen);
+    }
+    if (bodyLen > 0) {
+        packet.append(reinterpret_cast<const char*>(body), bodyLen);
+    }
+    for (Subscriber* pSubscriber : std::as_const(m_subscribers)) {
+        pSubscriber->receivePacket(packet);
+    }
+}
+
+int SharedEncoder::tell() {
+    return -1;
+}
+
+void SharedEncoder::seek(int pos) {
+    Q_UNUSED(pos)
+}
+
+int SharedEncoder::filelen() {
+    return 0;
+}
+
+SharedEncoderPointer SharedEncoderRegistry::subscribe(
+        const EncoderSettingsPointer& pSettings,
+        mixxx::audio::SampleRate sampleRate,
+        SharedEncoder::Subscriber* pSubscriber,
+        QString* pUserErrorMessage) {
+    VERIFY_OR_DEBUG_ASSERT(pSettings && SharedEncoder::isShareable(*pSettings)) {
+        return nullptr;
+    }
+    const QString key = settingsKey(*pSettings, sampleRate);
+
+    const auto locker = lockMutex(&m_lock);
+    SharedEncoderPointer pSharedEncoder = m_encoders.value(key).lock();
+    if (!pSharedEncoder) {
+        pSharedEncoder = std::make_shared<SharedEncoder>();
+        pSharedEncoder->m_pEncoder = EncoderFactory::getFactory().createEncoder(
+                pSettings, pSharedEncoder.get());
+        if (!pSharedEncoder->m_pEncoder ||
+                pSharedEncoder->m_pEncoder->initEncoder(
+                        sampleRate, pUserErrorMessage) < 0) {
+            return nullptr;
+        }
+        // Forget the encoders that have been released in the meantime
+        for (auto it = m_encoders.begin(); it != m_encoders.end();) {
+            if (it.value().expired()) {
+                it = m_encoders.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_encoders.insert(key, pSharedEncoder);
+        kLogger.debug() << "Created encoder" << key;
+    }
+    pSharedEncoder->subscribe(pSubscriber);
+    return pSharedEncoder;
+}
+
+//static
+QString SharedEncoderRegistry::settingsKey(
+        const EncoderSettings& settings,
+        mixxx::audio::SampleRate sampleRate) {
+    QStringList key = {
+            settings.getFormat(),
+            QString::number(sampleRate.value()),
+            QString::number(settings.getQuality()),
+            QString::number(settings.getQualityIndex()),
+            QString::number(settings.getCompression()),
+            QString::number(static_cast<int>(settings.getChannelMode())),
+    };
+    const QList<EncoderSettings::OptionsGroup> optionGroups = settings.getOptionGroups();
+    for (const EncoderSettings::OptionsGroup& group : optionGroups) {
+        key.append(group.groupCode + QChar('=') +
+                QString::number(settings.getSelectedOption(group.groupCode)));
+    }
+    return key.join(QChar('/'));
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <memory>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "encoder/encodersettings.h"
+#include "util/duration.h"
+#include "util/types.h"
+
+/// An encoder that is shared by all outputs with identical encoder settings,
+/// e.g. several broadcast connections to different servers. The audio is
+/// encoded only once and each encoded packet is passed to all subscribers as
+/// the same implicitly shared QByteArray.
+///
+/// The subscribers receive the same audio, but each in its own thread. Only
+/// the audio that is submitted by one of them, the feeder, is encoded. The
+/// first subscriber that submits audio becomes the feeder, and another one
+/// takes over when it unsubscribes or falls behind, e.g. because its thread
+/// is blocked while sending to a slow server.
+///
+/// Subscribers may join a running stream, so only formats that consist of
+/// self-contained frames can be shared.
+class SharedEncoder : public EncoderCallback {
+  public:
+    class Subscriber {
+      public:
+        virtual ~Subscriber() = default;
+        /// Called from the thread of the feeder while encoding. Must not
+        /// block and must not call back into the SharedEncoder.
+        virtual void receivePacket(const QByteArray& packet) = 0;
+    };
+
+    SharedEncoder();
+    ~SharedEncoder() override;
+
+    /// MP3 and ADTS framed AAC streams can be joined at any frame, while
+    /// Ogg streams start with headers that are only written once.
+    static bool isShareable(const EncoderSettings& settings);
+
+    /// Thread-safe, blocking.
+    void subscribe(Subscriber* pSubscriber);
+    /// Thread-safe, blocking. The subscriber will not receive any packets
+    /// after it has been unsubscribed.
+    void unsubscribe(Subscriber* pSubscriber);
+    int subscriberCount() const;
+
+    /// Thread-safe, blocking. Encodes the samples if pSubscriber is the feeder
+    /// and returns false if they have been ignored. pSubscriber becomes the
+    /// feeder if the current one has not submitted any samples recently.
+    bool encodeBuffer(Subscriber* pSubscriber,
+            const CSAMPLE* pBuffer,
+            const std::size_t bufferSize);
+
+    // Called by the encoder while encoding, fans out the packet
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    // These are not used for streaming, but the interface requires them
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    friend class SharedEncoderRegistry;
+
+    // Guards the subscribers and the encoder, which is only called while
+    // holding the lock
+    mutable QMutex m_lock;
+    EncoderPointer m_pEncoder;
+    QList<Subscriber*> m_subscribers;
+    Subscriber* m_pFeeder;
+    // When the feeder has submitted samples the last time
+    mixxx::Duration m_lastFedTime;
+};
+
+typedef std::shared_ptr<SharedEncoder> SharedEncoderPointer;
+
+/// Keeps track of the shared encoders that are currently in use. An encoder
+/// is deleted as soon as the last output has released it.
+class SharedEncoderRegistry {
+  public:
+    /// Thread-safe, blocking. Subscribes to the encoder with the given settings
+    /// and sample rate, or creates and initializes a new one. Returns nullptr
+    /// if the encoder could not be initialized.
+    SharedEncoderPointer subscribe(
+            const EncoderSettingsPointer& pSettings,
+            mixxx::audio::SampleRate sampleRate,
+            SharedEncoder::Subscriber* pSubscriber,
+            QString* pUserErrorMessage);
+
+  private:
+    static QString settingsKey(
+            const EncoderSettings& settings,
+            mixxx::audio::SampleRate sampleRate);
+
+    QMutex m_lock;
+    QHash<QString, std::weak_ptr<SharedEncoder>> m_encoders;
+};
+
+typedef std::shared_ptr<SharedEncoderRegistry> SharedEncoderRegistryPointer;
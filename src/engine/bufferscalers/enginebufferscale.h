@@ -64,6 +64,13 @@ class EngineBufferScale : public QObject {
             CSAMPLE* pOutputBuffer,
             SINT iOutputBufferSize) = 0;
 
+    // Called after scaleBuffer() if the deck plays steadily, i.e. without
+    // a crossfade, with the size of the next output buffer. A scaler may
+    // start processing the next buffer in the background.
+    virtual void prefetch(SINT iOutputBufferSize) {
+        Q_UNUSED(iOutputBufferSize);
+    }
+
   private:
     mixxx::audio::SignalInfo m_signal;
 
@@ -24,18 +24,32 @@ EngineBufferScaleRubberBand::EngineBufferScaleRubberBand(
           m_bufferPtrs(),
           m_interleavedReadBuffer(MAX_BUFFER_LEN),
           m_bBackwards(false),
-          m_useEngineFiner(false) {
+          m_useEngineFiner(false),
+          m_prefetchEnabled(false),
+          m_prefetchPending(false),
+          m_parametersChanged(true) {
     // Initialize the internal buffers to prevent re-allocations
     // in the real-time thread.
     onSignalChanged();
 }
 
+EngineBufferScaleRubberBand::~EngineBufferScaleRubberBand() {
+    // The workers must not access the instances after they are gone
+    waitForPrefetch();
+}
+
 void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
                                                      double* pTempoRatio,
                                                      double* pPitchRatio) {
+    waitForPrefetch();
+
     // Negative speed means we are going backwards. pitch does not affect
     // the playback direction.
-    m_bBackwards = *pTempoRatio < 0;
+    const bool backwards = *pTempoRatio < 0;
+    if (backwards != m_bBackwards) {
+        m_parametersChanged = true;
+    }
+    m_bBackwards = backwards;
 
     // Due to a bug in RubberBand, setting the timeRatio to a large value can
     // cause division-by-zero SIGFPEs. We limit the minimum seek speed to
@@ -88,6 +102,11 @@ void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
             *pTempoRatio = m_bBackwards ? -speed_abs : speed_abs;
         }
     }
+    if (base_rate != m_dBaseRate ||
+            speed_abs != m_dTempoRatio ||
+            *pPitchRatio != m_dPitchRatio) {
+        m_parametersChanged = true;
+    }
     // Used by other methods so we need to keep them up to date.
     m_dBaseRate = base_rate;
     m_dTempoRatio = speed_abs;
@@ -98,6 +117,7 @@ void EngineBufferScaleRubberBand::onSignalChanged() {
     // TODO: Resetting the sample rate will cause internal
     // memory allocations that may block the real-time thread.
     // When is this function actually invoked??
+    waitForPrefetch();
     if (!getOutputSignal().isValid()) {
         return;
     }
@@ -148,9 +168,20 @@ void EngineBufferScaleRubberBand::clear() {
     VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
         return;
     }
+    // The prefetched output belongs to the previous position, reset() drops it
+    waitForPrefetch();
+    m_parametersChanged = true;
     reset();
 }
 
+void EngineBufferScaleRubberBand::waitForPrefetch() {
+    if (!m_prefetchPending) {
+        return;
+    }
+    m_rubberBand.waitReady();
+    m_prefetchPending = false;
+}
+
 SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
         CSAMPLE* pBuffer,
         SINT frames) {
@@ -224,12 +255,9 @@ SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
     return received_frames;
 }
 
-void EngineBufferScaleRubberBand::deinterleaveAndProcess(
+void EngineBufferScaleRubberBand::deinterleave(
         const CSAMPLE* pBuffer,
         SINT frames) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
-        return;
-    }
     DEBUG_ASSERT(frames <= static_cast<SINT>(m_buffers[0].size()));
 
     switch (getOutputSignal().getChannelCount()) {
@@ -274,6 +302,15 @@ void EngineBufferScaleRubberBand::deinterleaveAndProcess(
         }
     } break;
     }
+}
+
+void EngineBufferScaleRubberBand::deinterleaveAndProcess(
+        const CSAMPLE* pBuffer,
+        SINT frames) {
+    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+        return;
+    }
+    deinterleave(pBuffer, frames);
 
     {
         ScopedTimer t(QStringLiteral("RubberBand::process"));
@@ -290,6 +327,7 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         return 0.0;
     }
     ScopedTimer t(QStringLiteral("EngineBufferScaleRubberBand::scaleBuffer"));
+    waitForPrefetch();
     if (m_dBaseRate == 0.0 || m_dTempoRatio == 0.0) {
         SampleUtil::clear(pOutputBuffer, iOutputBufferSize);
         // No actual samples/frames have been read from the
@@ -365,6 +403,52 @@ double EngineBufferScaleRubberBand::scaleBuffer(
     return readFramesProcessed;
 }
 
+void EngineBufferScaleRubberBand::prefetch(SINT iOutputBufferSize) {
+    const bool parametersChanged = m_parametersChanged;
+    m_parametersChanged = false;
+    if (!m_prefetchEnabled || parametersChanged || m_prefetchPending) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+        return;
+    }
+    if (m_dBaseRate == 0.0 || m_dTempoRatio == 0.0 || m_remainingPaddingInOutput > 0) {
+        return;
+    }
+
+    // Only feed the input for the output that is still missing for the next
+    // buffer, so the amount of prefetched audio does not grow
+    const SINT missing_frames = getOutputSignal().samples2frames(iOutputBufferSize) -
+            m_rubberBand.available();
+    if (missing_frames <= 0) {
+        return;
+    }
+    const SINT required_frames = std::max(
+            static_cast<SINT>(std::ceil(missing_frames * m_dBaseRate * m_dTempoRatio)),
+            static_cast<SINT>(m_rubberBand.getSamplesRequired()));
+    const SINT read_frames = std::min(required_frames,
+            getOutputSignal().samples2frames(m_interleavedReadBuffer.size()));
+
+    // The read position of the ReadAheadManager advances like it would in
+    // the next callback. The play position is tracked by the frames that
+    // are retrieved from Rubber Band, so it is not affected.
+    const SINT available_samples = m_pReadAheadManager->getNextSamples(
+            (m_bBackwards ? -1.0 : 1.0) * m_dBaseRate * m_dTempoRatio,
+            m_interleavedReadBuffer.data(),
+            getOutputSignal().frames2samples(read_frames),
+            getOutputSignal().getChannelCount());
+    const SINT available_frames = getOutputSignal().samples2frames(available_samples);
+    if (available_frames <= 0) {
+        // e.g. at a loop boundary, scaleBuffer() handles it
+        return;
+    }
+
+    m_effectiveRate = m_dBaseRate * m_dTempoRatio;
+    deinterleave(m_interleavedReadBuffer.data(), available_frames);
+    m_rubberBand.submit(m_bufferPtrs.data(), available_frames, false);
+    m_prefetchPending = true;
+}
+
 // static
 bool EngineBufferScaleRubberBand::isEngineFinerAvailable() {
     return RUBBERBANDV3;
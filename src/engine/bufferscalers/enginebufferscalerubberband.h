@@ -18,6 +18,8 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     explicit EngineBufferScaleRubberBand(
             ReadAheadManager* pReadAheadManager);
 
+    ~EngineBufferScaleRubberBand() override;
+
     EngineBufferScaleRubberBand(const EngineBufferScaleRubberBand&) = delete;
     EngineBufferScaleRubberBand& operator=(const EngineBufferScaleRubberBand&) = delete;
 
@@ -30,6 +32,13 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     // Enable engine v3 if available
     void useEngineFiner(bool enable);
 
+    /// Enables stretching the next buffer in the background between two
+    /// callbacks, see prefetch(). This allows to use the more expensive
+    /// finer engine with small buffer sizes.
+    void setPrefetchEnabled(bool enable) {
+        m_prefetchEnabled = enable;
+    }
+
     void setScaleParameters(double base_rate,
                             double* pTempoRatio,
                             double* pPitchRatio) override;
@@ -38,6 +47,13 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
             CSAMPLE* pOutputBuffer,
             SINT iOutputBufferSize) override;
 
+    /// Feeds the input that is needed for the next buffer to Rubber Band and
+    /// processes it on the RubberBandWorkerPool, while the callback returns.
+    /// The next scaleBuffer() only needs to retrieve the result. Skipped after
+    /// a seek or a change of the rate or pitch, the following buffer is then
+    /// processed in the callback as usual.
+    void prefetch(SINT iOutputBufferSize) override;
+
     // Flush buffer.
     void clear() override;
 
@@ -57,6 +73,11 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     /// `m_pRubberBand->reset()` directly.
     void reset();
 
+    /// Waits for a pending prefetch. Must be called before accessing
+    /// `m_rubberBand` or `m_buffers`.
+    void waitForPrefetch();
+
+    void deinterleave(const CSAMPLE* pBuffer, SINT frames);
     void deinterleaveAndProcess(const CSAMPLE* pBuffer, SINT frames);
     SINT retrieveAndDeinterleave(CSAMPLE* pBuffer, SINT frames);
 
@@ -85,4 +106,11 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     SINT m_remainingPaddingInOutput = 0;
 
     bool m_useEngineFiner;
+
+    bool m_prefetchEnabled;
+    /// Whether the workers process the input of a prefetch
+    bool m_prefetchPending;
+    /// Whether the rate, pitch or direction has changed since the last
+    /// prefetch() and the next buffer must not be prefetched
+    bool m_parametersChanged;
 };
@@ -1,42 +1,73 @@
 #include "engine/bufferscalers/rubberbandtask.h"
 
+#include "engine/bufferscalers/rubberbandworkerpool.h"
 #include "engine/engine.h"
 #include "util/assert.h"
-#include "util/compatibility/qmutex.h"
+#include "util/time.h"
 
 RubberBandTask::RubberBandTask(
         size_t sampleRate, size_t channels, Options options)
         : RubberBand::RubberBandStretcher(sampleRate, channels, options),
-          QRunnable(),
+          m_completed(true),
+          m_waiting(false),
           m_completedSema(0),
           m_input(nullptr),
           m_samples(0),
-          m_isFinal(false) {
-    setAutoDelete(false);
+          m_isFinal(false),
+          m_submittedNanos(0),
+          m_deadlineNanos(0) {
 }
 
 void RubberBandTask::set(const float* const* input,
         size_t samples,
-        bool isFinal) {
-    DEBUG_ASSERT(m_completedSema.available() == 0);
+        bool isFinal,
+        qint64 deadlineNanos) {
+    DEBUG_ASSERT(isCompleted());
     m_input = input;
     m_samples = samples;
     m_isFinal = isFinal;
+    m_submittedNanos = mixxx::Time::elapsed().toIntegerNanos();
+    m_deadlineNanos = deadlineNanos;
+    m_completed.store(false, std::memory_order_relaxed);
 }
 
 void RubberBandTask::waitReady() {
     VERIFY_OR_DEBUG_ASSERT(m_input && m_samples) {
         return;
     };
+    if (isCompleted()) {
+        return;
+    }
+    RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
+    VERIFY_OR_DEBUG_ASSERT(pPool) {
+        return;
+    }
+    pPool->waitReady(this);
+}
+
+void RubberBandTask::waitCompleted() {
+    // Announce the waiting thread before checking again, because the
+    // task might have been completed before.
+    m_waiting.store(true, std::memory_order_seq_cst);
+    if (m_completed.load(std::memory_order_seq_cst)) {
+        if (!m_waiting.exchange(false, std::memory_order_acq_rel)) {
+            // Consume the wake-up of run()
+            m_completedSema.acquire();
+        }
+        return;
+    }
     m_completedSema.acquire();
 }
 
 void RubberBandTask::run() {
-    VERIFY_OR_DEBUG_ASSERT(m_completedSema.available() == 0 && m_input && m_samples) {
+    VERIFY_OR_DEBUG_ASSERT(!isCompleted() && m_input && m_samples) {
         return;
     };
     process(m_input,
             m_samples,
             m_isFinal);
-    m_completedSema.release();
+    m_completed.store(true, std::memory_order_seq_cst);
+    if (m_waiting.exchange(false, std::memory_order_acq_rel)) {
+        m_completedSema.release();
+    }
 }
@@ -2,15 +2,15 @@
 
 #include <rubberband/RubberBandStretcher.h>
 
-#include <QRunnable>
 #include <QSemaphore>
+#include <QtGlobal>
 #include <atomic>
 
 #include "audio/types.h"
 
 using RubberBand::RubberBandStretcher;
 
-class RubberBandTask : public RubberBandStretcher, public QRunnable {
+class RubberBandTask : public RubberBandStretcher {
   public:
     RubberBandTask(size_t sampleRate,
             size_t channels,
@@ -22,20 +22,47 @@ class RubberBandTask : public RubberBandStretcher, public QRunnable {
     /// @param input The samples buffer
     /// @param samples the samples count
     /// @param final whether or not this is the final buffer
+    /// @param deadlineNanos the time when the result is needed, see
+    /// mixxx::Time::elapsed(), or 0 if unknown
     void set(const float* const* input,
             size_t samples,
-            bool isFinal);
+            bool isFinal,
+            qint64 deadlineNanos);
 
-    // Wait for the current task to complete.
+    // Wait for the current task to complete. Pending tasks of the
+    // RubberBandWorkerPool are run by the calling thread meanwhile.
     void waitReady();
 
+    bool isCompleted() const {
+        return m_completed.load(std::memory_order_acquire);
+    }
+
+    /// Blocks until the task has been completed by another thread.
+    /// Used by the RubberBandWorkerPool if there are no pending tasks
+    /// left to run meanwhile.
+    void waitCompleted();
+
+    /// The time when the task has been set, see mixxx::Time::elapsed()
+    qint64 submittedNanos() const {
+        return m_submittedNanos;
+    }
+
+    qint64 deadlineNanos() const {
+        return m_deadlineNanos;
+    }
+
     void run();
 
   private:
     // Whether or not the scheduled job as completed
+    std::atomic<bool> m_completed;
+    // Set by a thread that blocks in waitCompleted()
+    std::atomic<bool> m_waiting;
     QSemaphore m_completedSema;
 
     const float* const* m_input;
     size_t m_samples;
     bool m_isFinal;
+    qint64 m_submittedNanos;
+    qint64 m_deadlineNanos;
 };
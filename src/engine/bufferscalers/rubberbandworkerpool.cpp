@@ -2,11 +2,102 @@
 
 #include <rubberband/RubberBandStretcher.h>
 
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "engine/bufferscalers/rubberbandtask.h"
 #include "engine/engine.h"
 #include "util/assert.h"
+#include "util/time.h"
+
+namespace {
+
+// How long a worker keeps polling for new tasks before it parks. The
+// jobs of the next deck are usually submitted within this time.
+constexpr qint64 kWorkerSpinNanos = 100 * 1000;
+// Number of polls before a waiting thread blocks until a worker has
+// completed the task
+constexpr int kWaitSpinCount = 1024;
+
+void setRealtimeScheduling() {
+#ifdef __LINUX__
+    // Same as the EngineChannelWorkerPool
+    struct sched_param spm = {0};
+    spm.sched_priority = 1;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &spm)) {
+        qWarning() << "RubberBandWorkerPool: Failed bumping priority";
+    }
+#endif
+}
+
+} // anonymous namespace
+
+RubberBandWorkerPool::Worker::Worker(RubberBandWorkerPool* pPool, int index)
+        : m_pPool(pPool),
+          m_index(index),
+          m_parked(false),
+          m_stop(false),
+          m_wakeSema(0) {
+    setObjectName(QStringLiteral("RubberBandWorker %1").arg(index));
+}
+
+void RubberBandWorkerPool::Worker::wake() {
+    if (m_parked.exchange(false, std::memory_order_acq_rel)) {
+        m_wakeSema.release();
+    }
+}
+
+void RubberBandWorkerPool::Worker::stop() {
+    m_stop.store(true, std::memory_order_release);
+    m_parked.store(false, std::memory_order_release);
+    m_wakeSema.release();
+}
+
+void RubberBandWorkerPool::Worker::run() {
+    setRealtimeScheduling();
 
-RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
-        : QThreadPool() {
+    qint64 idleSinceNanos = -1;
+    while (!m_stop.load(std::memory_order_acquire)) {
+        RubberBandTask* pTask = m_pPool->takeTask(m_index, true);
+        if (pTask) {
+            m_pPool->runTask(pTask);
+            idleSinceNanos = -1;
+            continue;
+        }
+        const qint64 nowNanos = mixxx::Time::elapsed().toIntegerNanos();
+        if (idleSinceNanos < 0) {
+            idleSinceNanos = nowNanos;
+        }
+        if (nowNanos - idleSinceNanos < kWorkerSpinNanos) {
+            // Let other threads of the same priority run meanwhile
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        // Park until new tasks are submitted. Check the queues again after
+        // announcing it, because a task might have been submitted before.
+        m_parked.store(true, std::memory_order_seq_cst);
+        pTask = m_pPool->takeTask(m_index, true);
+        if (pTask) {
+            if (!m_parked.exchange(false, std::memory_order_acq_rel)) {
+                // Consume the wake-up of the submitter
+                m_wakeSema.acquire();
+            }
+            m_pPool->runTask(pTask);
+        } else {
+            m_wakeSema.acquire();
+        }
+        idleSinceNanos = -1;
+    }
+}
+
+RubberBandWorkerPool::RubberBandWorkerPool(
+        UserSettingsPointer pConfig, std::optional<int> numWorkers)
+        : m_nextQueue(0),
+          m_queueLatency(QStringLiteral("RubberBandWorkerPool queue")),
+          m_processLatency(QStringLiteral("RubberBandWorkerPool process")),
+          m_deadlineMissed(QStringLiteral("RubberBandWorkerPool deadline missed")) {
     bool multiThreadedOnStereo = pConfig &&
             pConfig->getValue(ConfigKey(QStringLiteral("[App]"),
                                       QStringLiteral("keylock_multithreading")),
@@ -16,21 +107,113 @@ RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
             : mixxx::audio::ChannelCount::stereo();
     DEBUG_ASSERT(mixxx::kMaxEngineChannelInputCount % m_channelPerWorker == 0);
 
-    int numCore = QThread::idealThreadCount();
-    int numRBTasks = qMin(numCore, mixxx::kMaxEngineChannelInputCount / m_channelPerWorker);
+    if (!numWorkers) {
+        int numCore = QThread::idealThreadCount();
+        int numRBTasks = qMin(numCore,
+                mixxx::kMaxEngineChannelInputCount / m_channelPerWorker);
 
-    qDebug() << "RubberBand will use" << numRBTasks << "tasks to scale the audio signal";
+        qDebug() << "RubberBand will use" << numRBTasks << "tasks to scale the audio signal";
+
+        // The engine thread also performs stretching operations while it waits
+        // for the workers to complete, so one worker less than the number of
+        // tasks is needed. The stretching jobs of all decks share the workers.
+        numWorkers = qMax(numRBTasks - 1, 0);
+    }
+    DEBUG_ASSERT(*numWorkers >= 0);
 
-    setThreadPriority(QThread::HighPriority);
-    // The RB pool will only be used to scale n-1 buffer sample, so the engine
-    // thread takes care of the last buffer and doesn't have to be idle.
-    setMaxThreadCount(numRBTasks - 1);
+    m_queues.reserve(qMax(*numWorkers, 1));
+    m_prefetchQueues.reserve(qMax(*numWorkers, 1));
+    for (int i = 0; i < qMax(*numWorkers, 1); ++i) {
+        m_queues.push_back(std::make_unique<TaskQueue>());
+        m_prefetchQueues.push_back(std::make_unique<TaskQueue>());
+    }
+    m_workers.reserve(*numWorkers);
+    for (int i = 0; i < *numWorkers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>(this, i));
+        m_workers.back()->start(QThread::TimeCriticalPriority);
+    }
+}
+
+RubberBandWorkerPool::~RubberBandWorkerPool() {
+    for (auto& pWorker : m_workers) {
+        pWorker->stop();
+    }
+    for (auto& pWorker : m_workers) {
+        pWorker->wait();
+    }
+    // The owners of all tasks must have waited for them
+    RubberBandTask* pPendingTask = takeTask(0, true);
+    DEBUG_ASSERT(!pPendingTask);
+}
+
+bool RubberBandWorkerPool::trySubmit(RubberBandTask* pTask) {
+    if (m_workers.empty()) {
+        return false;
+    }
+    // Distribute the tasks round-robin, idle workers steal them anyway
+    const auto index = m_nextQueue.fetch_add(1, std::memory_order_relaxed) %
+            m_workers.size();
+    // The result of a task without a deadline is needed in a later callback
+    TaskQueue* pQueue = pTask->deadlineNanos() > 0
+            ? m_queues[index].get()
+            : m_prefetchQueues[index].get();
+    // Fails if the queue is full, then the caller runs the task inline
+    if (!pQueue->tryPush(pTask)) {
+        return false;
+    }
+    m_workers[index]->wake();
+    return true;
+}
+
+RubberBandTask* RubberBandWorkerPool::takeTask(int workerIndex, bool includePrefetch) {
+    const int numQueues = static_cast<int>(m_queues.size());
+    RubberBandTask* pTask;
+    for (int i = 0; i < numQueues; ++i) {
+        if (m_queues[(workerIndex + i) % numQueues]->tryPop(&pTask)) {
+            return pTask;
+        }
+    }
+    if (!includePrefetch) {
+        return nullptr;
+    }
+    for (int i = 0; i < numQueues; ++i) {
+        if (m_prefetchQueues[(workerIndex + i) % numQueues]->tryPop(&pTask)) {
+            return pTask;
+        }
+    }
+    return nullptr;
+}
+
+void RubberBandWorkerPool::runTask(RubberBandTask* pTask) {
+    const qint64 startNanos = mixxx::Time::elapsed().toIntegerNanos();
+    m_queueLatency.record(startNanos - pTask->submittedNanos());
+    // Read before running the task, afterwards it may be resubmitted
+    const qint64 deadlineNanos = pTask->deadlineNanos();
+    pTask->run();
+    const qint64 endNanos = mixxx::Time::elapsed().toIntegerNanos();
+    m_processLatency.record(endNanos - startNanos);
+    if (deadlineNanos > 0 && endNanos > deadlineNanos) {
+        m_deadlineMissed.increment();
+    }
+}
 
-    // We allocate one runner less than the total of maximum supported channel,
-    // so the engine thread will also perform a stretching operation, instead of
-    // waiting all workers to complete. During performance testing, this ahas
-    // show better results
-    for (int w = 0; w < maxThreadCount(); w++) {
-        reserveThread();
+void RubberBandWorkerPool::waitReady(RubberBandTask* pTask) {
+    // Help processing the pending tasks of this and other decks that are
+    // needed in this callback, which might include the task itself.
+    // Prefetch tasks are left to the workers, which have been woken up
+    // when they were submitted.
+    int spins = 0;
+    while (!pTask->isCompleted()) {
+        RubberBandTask* pPendingTask = takeTask(0, false);
+        if (pPendingTask) {
+            runTask(pPendingTask);
+            spins = 0;
+        } else if (++spins >= kWaitSpinCount) {
+            // The task is run or prefetched by a worker. Spinning any longer might keep
+            // the worker from running if it shares the core with this
+            // thread, which has a higher priority.
+            pTask->waitCompleted();
+            spins = 0;
+        }
     }
 }
@@ -1,26 +1,112 @@
 #pragma once
 
-#include <QThreadPool>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
 
 #include "audio/types.h"
 #include "preferences/usersettings.h"
+#include "util/counter.h"
+#include "util/latencyhistogram.h"
+#include "util/mpmcqueue.h"
 #include "util/singleton.h"
 
+class RubberBandTask;
+
 // RubberBandWorkerPool is a global pool manager for RubberBandWorkerPool. It
 // allows a the Engine thread to use a pool of agnostic RubberBandWorker which
 // can be distributed stretching job
-class RubberBandWorkerPool : public QThreadPool, public Singleton<RubberBandWorkerPool> {
+//
+// The stretching jobs of all decks are submitted to the same pool. Each
+// worker has its own queue and steals jobs from the other queues when its
+// own queue is empty. A thread that waits for a job to complete, e.g. the
+// engine thread, runs pending jobs with a deadline itself instead of
+// blocking, so no job ever waits for a worker to wake up. Only when the job
+// has already been taken by a worker, the waiting thread blocks after
+// spinning briefly, because the worker might have been preempted by the
+// waiting thread.
+//
+// Jobs without a deadline, i.e. prefetching for a later callback, are kept
+// in separate queues that only the workers drain, after the jobs with a
+// deadline. Otherwise the engine thread would run them within the callback.
+//
+// The queues are lock-free, so the real-time workers never wait for a
+// thread of a lower priority. The workers yield for a short while after
+// running out of jobs before they park, so they respond immediately to
+// the jobs of the next deck within the same callback without burning a
+// core while no callback runs.
+class RubberBandWorkerPool : public Singleton<RubberBandWorkerPool> {
   public:
+    ~RubberBandWorkerPool();
+
     const mixxx::audio::ChannelCount& channelPerWorker() const {
         return m_channelPerWorker;
     }
 
+    /// The number of worker threads, not including the engine thread
+    int numWorkers() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    /// Queues the task for processing by a worker. Returns false if the
+    /// task could not be queued, then the caller must run it itself.
+    /// Tasks without a deadline are only run by the workers.
+    bool trySubmit(RubberBandTask* pTask);
+
+    /// Runs pending tasks with a deadline in the calling thread until the
+    /// task has completed
+    void waitReady(RubberBandTask* pTask);
+
   protected:
-    RubberBandWorkerPool(UserSettingsPointer pConfig = nullptr);
+    /// The number of workers is derived from the number of cores
+    /// unless numWorkers is given, e.g. by tests.
+    RubberBandWorkerPool(UserSettingsPointer pConfig = nullptr,
+            std::optional<int> numWorkers = std::nullopt);
 
   private:
-    ;
+    static constexpr std::size_t kQueueCapacity = 64;
+
+    typedef MpmcQueue<RubberBandTask*, kQueueCapacity> TaskQueue;
+
+    class Worker : public QThread {
+      public:
+        Worker(RubberBandWorkerPool* pPool, int index);
+        void wake();
+        void stop();
+
+      protected:
+        void run() override;
+
+      private:
+        RubberBandWorkerPool* const m_pPool;
+        const int m_index;
+        std::atomic<bool> m_parked;
+        std::atomic<bool> m_stop;
+        QSemaphore m_wakeSema;
+    };
+
+    // Returns a pending task, preferably from the queue of the worker.
+    // Tasks without a deadline are only returned if includePrefetch is true
+    // and no task with a deadline is pending.
+    RubberBandTask* takeTask(int workerIndex, bool includePrefetch);
+    void runTask(RubberBandTask* pTask);
+
     mixxx::audio::ChannelCount m_channelPerWorker;
 
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+    // The tasks without a deadline, one queue per worker
+    std::vector<std::unique_ptr<TaskQueue>> m_prefetchQueues;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<unsigned int> m_nextQueue;
+
+    // The time between submitting and starting a task
+    mixxx::LatencyHistogram m_queueLatency;
+    mixxx::LatencyHistogram m_processLatency;
+    // Tasks that completed after their deadline
+    Counter m_deadlineMissed;
+
     friend class Singleton<RubberBandWorkerPool>;
 };
@@ -2,6 +2,7 @@
 
 #include "engine/bufferscalers/rubberbandworkerpool.h"
 #include "engine/engine.h"
+#include "engine/engineprofiler.h"
 #include "util/assert.h"
 #include "util/sample.h"
 
@@ -53,7 +54,7 @@ mixxx::audio::ChannelCount getChannelPerWorker(mixxx::audio::ChannelCount chCoun
     }
     auto channelPerWorker = pPool->channelPerWorker();
     // The task count includes all the thread in the pool + the engine thread
-    auto maxThreadCount = pPool->maxThreadCount() + 1;
+    auto maxThreadCount = pPool->numWorkers() + 1;
     VERIFY_OR_DEBUG_ASSERT(chCount % channelPerWorker == 0) {
         return mixxx::kEngineChannelOutputCount;
     }
@@ -182,23 +183,45 @@ void RubberBandWrapper::process(const float* const* input, size_t samples, bool
         return m_pInstances[0]->process(input, samples, isFinal);
     } else {
         RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
+        const auto& pLastInstance = m_pInstances.back();
+        const qint64 deadlineNanos = EngineProfiler::callbackDeadlineNanos();
         for (auto& pInstance : m_pInstances) {
-            pInstance->set(input, samples, isFinal);
-            // We try to get the stretching job ran by the RBPool if there is a
-            // worker slot available
-            if (!pPool->tryStart(pInstance.get())) {
-                // Otherwise, it means the main thread should take care of the stretching
+            pInstance->set(input, samples, isFinal, deadlineNanos);
+            // The job of the last instance is always ran by the engine thread,
+            // the others are queued for the workers if possible. Workers
+            // that are done with the jobs of other decks pick them up.
+            if (pInstance == pLastInstance || !pPool->trySubmit(pInstance.get())) {
                 pInstance->run();
             }
             input += m_channelPerWorker;
         }
-        // We always perform a wait, even for task that were ran in the main
-        // thread, so it resets the semaphore
+        // Runs the pending jobs in the engine thread until all are completed
         for (auto& pInstance : m_pInstances) {
             pInstance->waitReady();
         }
     }
 }
+void RubberBandWrapper::submit(const float* const* input, size_t samples, bool isFinal) {
+    RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
+    VERIFY_OR_DEBUG_ASSERT(pPool) {
+        process(input, samples, isFinal);
+        return;
+    }
+    for (auto& pInstance : m_pInstances) {
+        // The result is needed in a later callback, which deadline is not
+        // known yet
+        pInstance->set(input, samples, isFinal, 0);
+        if (!pPool->trySubmit(pInstance.get())) {
+            pInstance->run();
+        }
+        input += m_channelPerWorker;
+    }
+}
+void RubberBandWrapper::waitReady() {
+    for (auto& pInstance : m_pInstances) {
+        pInstance->waitReady();
+    }
+}
 void RubberBandWrapper::reset() {
     for (auto& stretcher : m_pInstances) {
         stretcher->reset();
@@ -19,6 +19,11 @@ class RubberBandWrapper {
     size_t getPreferredStartPad() const;
     size_t getStartDelay() const;
     void process(const float* const* input, size_t samples, bool final);
+    /// Like process(), but returns without waiting for the instances. The
+    /// input must remain valid and no other method may be called until
+    /// waitReady() has returned.
+    void submit(const float* const* input, size_t samples, bool final);
+    void waitReady();
     void setPitchScale(double scale);
     void reset();
 
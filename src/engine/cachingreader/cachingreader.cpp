@@ -18,22 +18,27 @@ mixxx::Logger kLogger("CachingReader");
 // TODO() Do we suffer cache misses if we use an audio buffer of above 23 ms?
 constexpr SINT kDefaultHintFrames = 1024;
 
-// With CachingReaderChunk::kFrames = 8192 each chunk consumes
-// 8192 frames * 2 channels/frame * 4-bytes per sample = 65 kB for stereo frame.
-//
-//     80 chunks ->  5120 KB =  5 MB
-//
-// Each deck (including sample decks) will use their own CachingReader.
-// Consequently the total memory required for all allocated chunks depends
-// on the number of decks. The amount of memory reserved for a single
-// CachingReader must be multiplied by the number of decks to calculate
-// the total amount!
-//
-// NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
-// (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
-// to verify that the MRU/LRU cache works as expected. Even though
-// massive drop outs are expected to occur Mixxx should run reliably!
-constexpr SINT kNumberOfCachedChunksInMemory = 80;
+// Limit the number of in-flight requests to the worker. This should
+// prevent to overload the worker when it is not able to fetch those
+// requests from the FIFO timely. Otherwise outdated requests pile up
+// in the FIFO and it would take a long time to process them, just to
+// discard the results that most likely have already become obsolete.
+// TODO(XXX): Ideally the request FIFO would be implemented as a ring
+// buffer, where new requests replace old requests when full. Those
+// old requests need to be returned immediately to the CachingReader
+// that must take ownership and free them!!!
+constexpr SINT kChunkReadRequestFIFOSize = 20;
+
+// The maximum number of chunks per reader that have been handed over to
+// the worker. The capacity of the back channel must be at least this
+// number, because the worker use writeBlocking(). Otherwise the worker
+// could get stuck in a hot loop!!!
+constexpr SINT kMaxPendingChunks = 80;
+
+// Decode the whole track into memory after loading. Disabled by default
+// because it requires a lot of memory for long tracks and many decks.
+const ConfigKey kPreloadWholeTrackConfigKey =
+        ConfigKey(QStringLiteral("[CachingReader]"), QStringLiteral("PreloadWholeTrack"));
 
 } // anonymous namespace
 
@@ -41,43 +46,20 @@ CachingReader::CachingReader(const QString& group,
         UserSettingsPointer config,
         mixxx::audio::ChannelCount maxSupportedChannel)
         : m_pConfig(config),
-          // Limit the number of in-flight requests to the worker. This should
-          // prevent to overload the worker when it is not able to fetch those
-          // requests from the FIFO timely. Otherwise outdated requests pile up
-          // in the FIFO and it would take a long time to process them, just to
-          // discard the results that most likely have already become obsolete.
-          // TODO(XXX): Ideally the request FIFO would be implemented as a ring
-          // buffer, where new requests replace old requests when full. Those
-          // old requests need to be returned immediately to the CachingReader
-          // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
-          // The capacity of the back channel must be equal to the number of
-          // allocated chunks, because the worker use writeBlocking(). Otherwise
-          // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_chunkReadRequestFIFO(kChunkReadRequestFIFOSize),
+          // Reserve additional slots for the track load/unload/preload updates
+          m_readerStatusUpdateFIFO(kMaxPendingChunks + 3),
           m_state(STATE_IDLE),
-          m_mruCachingReaderChunk(nullptr),
-          m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kFrames * maxSupportedChannel *
-                  kNumberOfCachedChunksInMemory),
+          m_pChunkPool(CachingReaderChunkPool::getOrCreateSharedInstance(config)),
+          m_numPendingChunks(0),
+          m_chunkFrames(CachingReaderChunk::kDefaultFrames),
+          m_pPreloadedSamples(nullptr),
           m_worker(group,
                   &m_chunkReadRequestFIFO,
                   &m_readerStatusUpdateFIFO,
                   maxSupportedChannel) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
-    // Divide up the allocated raw memory buffer into total_chunks
-    // chunks. Initialize each chunk to hold nothing and add it to the free
-    // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
-        CachingReaderChunkForOwner* c =
-                new CachingReaderChunkForOwner(
-                        mixxx::SampleBuffer::WritableSlice(
-                                m_sampleBuffer,
-                                CachingReaderChunk::kFrames * maxSupportedChannel * i,
-                                CachingReaderChunk::kFrames * maxSupportedChannel));
-        m_chunks.push_back(c);
-        m_freeChunks.push_back(c);
-    }
+    m_allocatedCachingReaderChunks.reserve(m_pChunkPool->size());
+    m_pChunkPool->addReader(this);
 
     // Forward signals from worker
     connect(&m_worker, &CachingReaderWorker::trackLoading,
@@ -95,71 +77,77 @@ CachingReader::CachingReader(const QString& group,
 
 CachingReader::~CachingReader() {
     m_worker.quitWait();
-    qDeleteAll(m_chunks);
-}
-
-void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
-    pChunk->removeFromList(
-            &m_mruCachingReaderChunk,
-            &m_lruCachingReaderChunk);
-    pChunk->free();
-    m_freeChunks.push_back(pChunk);
+    // Return all chunks including those that are still owned by the
+    // worker to the shared pool.
+    m_pChunkPool->releaseAllChunks(this);
+    m_pChunkPool->removeReader(this);
 }
 
 void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
     DEBUG_ASSERT(pChunk);
     DEBUG_ASSERT(pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING);
+    DEBUG_ASSERT(pChunk->getOwner() == this);
 
-    const int removed = m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
-    Q_UNUSED(removed); // only used in DEBUG_ASSERT
     // We'll tolerate not being in allocatedCachingReaderChunks,
     // because sometime you free a chunk right after you allocated it.
-    DEBUG_ASSERT(removed <= 1);
+    const auto it = m_allocatedCachingReaderChunks.constFind(pChunk->getIndex());
+    if (it != m_allocatedCachingReaderChunks.constEnd() && it.value() == pChunk) {
+        m_allocatedCachingReaderChunks.erase(it);
+    }
 
-    freeChunkFromList(pChunk);
+    m_pChunkPool->freeChunk(pChunk);
 }
 
 void CachingReader::freeAllChunks() {
-    for (const auto& pChunk : std::as_const(m_chunks)) {
-        // We will receive CHUNK_READ_INVALID for all pending chunk reads
-        // which should free the chunks individually.
-        if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
-            continue;
-        }
-
-        if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
-            freeChunkFromList(pChunk);
-        }
-    }
-    DEBUG_ASSERT(!m_mruCachingReaderChunk);
-    DEBUG_ASSERT(!m_lruCachingReaderChunk);
-
+    // We will receive CHUNK_READ_INVALID for all pending chunk reads
+    // which should free the chunks individually.
+    m_pChunkPool->freeAllChunks(this);
     m_allocatedCachingReaderChunks.clear();
 }
 
-CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.empty()) {
-        return nullptr;
-    }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
-
-    pChunk->init(chunkIndex);
-
-    m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
+void CachingReader::resetPreloadedSamples() {
+    m_pPreloadedSamples = nullptr;
+    m_preloadedFrameIndexRange = mixxx::IndexRange();
+}
 
-    return pChunk;
+mixxx::IndexRange CachingReader::readPreloadedSampleFrames(
+        CSAMPLE* buffer,
+        mixxx::audio::ChannelCount channelCount,
+        const mixxx::IndexRange& frameIndexRange,
+        bool reverse) const {
+    DEBUG_ASSERT(isPreloaded());
+    const auto copyableFrameIndexRange =
+            intersect(frameIndexRange, m_preloadedFrameIndexRange);
+    if (copyableFrameIndexRange.empty()) {
+        return copyableFrameIndexRange;
+    }
+    const SINT dstSampleOffset = CachingReaderChunk::frames2samples(
+            copyableFrameIndexRange.start() - frameIndexRange.start(),
+            channelCount);
+    const SINT srcSampleOffset = CachingReaderChunk::frames2samples(
+            copyableFrameIndexRange.start() - m_preloadedFrameIndexRange.start(),
+            channelCount);
+    const SINT sampleCount = CachingReaderChunk::frames2samples(
+            copyableFrameIndexRange.length(), channelCount);
+    if (reverse) {
+        SampleUtil::copyReverse(
+                buffer - dstSampleOffset - sampleCount,
+                m_pPreloadedSamples + srcSampleOffset,
+                sampleCount,
+                channelCount);
+    } else {
+        SampleUtil::copy(
+                buffer + dstSampleOffset,
+                m_pPreloadedSamples + srcSampleOffset,
+                sampleCount);
+    }
+    return copyableFrameIndexRange;
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkIndex) {
-    auto* pChunk = allocateChunk(chunkIndex);
-    if (!pChunk) {
-        if (m_lruCachingReaderChunk) {
-            freeChunk(m_lruCachingReaderChunk);
-            pChunk = allocateChunk(chunkIndex);
-        } else {
-            kLogger.warning() << "No cached LRU chunk available for freeing";
-        }
+    auto* pChunk = m_pChunkPool->allocateChunk(this, chunkIndex, m_chunkFrames);
+    if (pChunk) {
+        m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
     }
     if (kLogger.traceEnabled()) {
         kLogger.trace() << "allocateChunkExpireLRU" << chunkIndex << pChunk;
@@ -167,49 +155,51 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
     return pChunk;
 }
 
-CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
-    // Defaults to nullptr if it's not in the hash.
-    auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
-    DEBUG_ASSERT(!pChunk || pChunk->getIndex() == chunkIndex);
-    return pChunk;
+void CachingReader::freshenChunk(CachingReaderChunkForOwner* pChunk) {
+    m_pChunkPool->freshenChunk(pChunk);
 }
 
-void CachingReader::freshenChunk(CachingReaderChunkForOwner* pChunk) {
-    DEBUG_ASSERT(pChunk);
-    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::READY);
-    if (kLogger.traceEnabled()) {
-        kLogger.trace()
-                << "freshenChunk()"
-                << pChunk->getIndex()
-                << pChunk;
+CachingReaderChunkForOwner* CachingReader::lookupChunkAndFreshen(SINT chunkIndex) {
+    const auto it = m_allocatedCachingReaderChunks.find(chunkIndex);
+    if (it == m_allocatedCachingReaderChunks.end()) {
+        return nullptr;
     }
-
-    // Remove the chunk from the MRU/LRU list
-    pChunk->removeFromList(
-            &m_mruCachingReaderChunk,
-            &m_lruCachingReaderChunk);
-
-    // Reinsert has new head of MRU list
-    pChunk->insertIntoListBefore(
-            &m_mruCachingReaderChunk,
-            &m_lruCachingReaderChunk,
-            m_mruCachingReaderChunk);
+    auto* pChunk = it.value();
+    // Check and freshen atomically, because readers of other channels
+    // that are processed concurrently might evict the chunk in between.
+    if (!m_pChunkPool->freshenChunkIfAllocatedBy(pChunk, this, chunkIndex)) {
+        m_allocatedCachingReaderChunks.erase(it);
+        return nullptr;
+    }
+    return pChunk;
 }
 
-CachingReaderChunkForOwner* CachingReader::lookupChunkAndFreshen(SINT chunkIndex) {
-    auto* pChunk = lookupChunk(chunkIndex);
-    if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
-        freshenChunk(pChunk);
+CachingReaderChunkForOwner* CachingReader::lookupChunkAndPin(SINT chunkIndex) {
+    const auto it = m_allocatedCachingReaderChunks.find(chunkIndex);
+    if (it == m_allocatedCachingReaderChunks.end()) {
+        return nullptr;
+    }
+    auto* pChunk = it.value();
+    if (!m_pChunkPool->pinChunkIfAllocatedBy(pChunk, this, chunkIndex)) {
+        m_allocatedCachingReaderChunks.erase(it);
+        return nullptr;
     }
     return pChunk;
 }
 
+void CachingReader::unpinChunk(CachingReaderChunkForOwner* pChunk) {
+    m_pChunkPool->unpinChunk(pChunk);
+}
+
 // Invoked from the UI thread!!
 #ifdef __STEM__
 void CachingReader::newTrack(TrackPointer pTrack, mixxx::StemChannelSelection stemMask) {
 #else
 void CachingReader::newTrack(TrackPointer pTrack) {
 #endif
+    m_worker.setPreloadWholeTrack(
+            m_pConfig && m_pConfig->getValue(kPreloadWholeTrackConfigKey, false));
+
     auto newState = pTrack ? STATE_TRACK_LOADING : STATE_TRACK_UNLOADING;
     auto oldState = m_state.fetchAndStoreAcquire(newState);
 
@@ -238,6 +228,8 @@ void CachingReader::process() {
         auto* pChunk = update.takeFromWorker();
         if (pChunk) {
             // Result of a read request (with a chunk)
+            DEBUG_ASSERT(m_numPendingChunks > 0);
+            --m_numPendingChunks;
             DEBUG_ASSERT(atomicLoadRelaxed(m_state) != STATE_IDLE);
             DEBUG_ASSERT(
                     update.status == CHUNK_READ_SUCCESS ||
@@ -251,12 +243,13 @@ void CachingReader::process() {
                 continue;
             }
             DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADED);
-            if (update.status == CHUNK_READ_SUCCESS) {
+            if (update.status == CHUNK_READ_SUCCESS && !isPreloaded()) {
                 // Insert or freshen the chunk in the MRU/LRU list after
                 // obtaining ownership from the worker.
                 freshenChunk(pChunk);
             } else {
-                // Discard chunks that don't carry any data
+                // Discard chunks that don't carry any data or that
+                // are not needed anymore after preloading the track.
                 freeChunk(pChunk);
             }
             // Adjust the readable frame index range (if available)
@@ -276,17 +269,34 @@ void CachingReader::process() {
                 // TRACK_LOADED without a chunk in between, assert this here.
                 DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADING ||
                         (atomicLoadRelaxed(m_state) == STATE_TRACK_LOADED &&
-                                !m_mruCachingReaderChunk && !m_lruCachingReaderChunk));
-                // now purge also the recently used chunk list from the old track.
-                if (m_mruCachingReaderChunk || m_lruCachingReaderChunk) {
+                                m_allocatedCachingReaderChunks.isEmpty()));
+                // now purge also the recently used chunks from the old track.
+                if (!m_allocatedCachingReaderChunks.isEmpty()) {
                     DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADING);
                     freeAllChunks();
                 }
-                // Reset the readable frame index range
+                // Reset the readable frame index range and adopt the chunk
+                // size that has been chosen by the worker for the new track.
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                m_chunkFrames = update.chunkFrames();
+                resetPreloadedSamples();
+                // The worker may free the samples of the previous track now
+                m_worker.acknowledgeTrackChange();
                 m_state.storeRelease(STATE_TRACK_LOADED);
+            } else if (update.status == TRACK_PRELOADED) {
+                // Ignore the preloaded samples of a previous track
+                if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
+                    continue;
+                }
+                m_pPreloadedSamples = update.preloadedSamples();
+                m_preloadedFrameIndexRange = update.readableFrameIndexRange();
+                // All chunks of this track are obsolete now and could
+                // be reused by other readers.
+                freeAllChunks();
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
+                resetPreloadedSamples();
+                m_worker.acknowledgeTrackChange();
                 // This message could be processed later when a new
                 // track is already loading! In this case the TRACK_LOADED will
                 // be the very next status update.
@@ -405,16 +415,35 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
         // buffer. The buffer will be filled with silence for every
         // unreadable sample or samples outside of the track region
         // later at the end of this function.
-        if (!remainingFrameIndexRange.empty()) {
+        if (!remainingFrameIndexRange.empty() && isPreloaded()) {
+            // The whole track is available in memory, no need to
+            // look up any chunks.
+            const auto preloadedFrameIndexRange = readPreloadedSampleFrames(
+                    reverse ? &buffer[samplesRemaining] : buffer,
+                    channelCount,
+                    remainingFrameIndexRange,
+                    reverse);
+            if (!preloadedFrameIndexRange.empty()) {
+                DEBUG_ASSERT(preloadedFrameIndexRange.start() ==
+                        remainingFrameIndexRange.start());
+                const SINT preloadedSamples = CachingReaderChunk::frames2samples(
+                        preloadedFrameIndexRange.length(), channelCount);
+                if (!reverse) {
+                    buffer += preloadedSamples;
+                }
+                DEBUG_ASSERT(samplesRemaining >= preloadedSamples);
+                samplesRemaining -= preloadedSamples;
+            }
+        } else if (!remainingFrameIndexRange.empty()) {
             // The intersection between the readable samples from the track
             // and the requested samples is not empty, so start reading.
             DEBUG_ASSERT(!intersect(remainingFrameIndexRange, m_readableFrameIndexRange).empty());
             DEBUG_ASSERT(remainingFrameIndexRange.start() >= m_readableFrameIndexRange.start());
 
-            const SINT firstChunkIndex =
-                    CachingReaderChunk::indexForFrame(remainingFrameIndexRange.start());
-            SINT lastChunkIndex =
-                    CachingReaderChunk::indexForFrame(remainingFrameIndexRange.end() - 1);
+            const SINT firstChunkIndex = CachingReaderChunk::indexForFrame(
+                    remainingFrameIndexRange.start(), m_chunkFrames);
+            SINT lastChunkIndex = CachingReaderChunk::indexForFrame(
+                    remainingFrameIndexRange.end() - 1, m_chunkFrames);
             for (SINT chunkIndex = firstChunkIndex;
                     chunkIndex <= lastChunkIndex;
                     ++chunkIndex) {
@@ -438,8 +467,8 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                     kLogger.warning() << "Failed to read more sample data";
                     break;
                 }
-                lastChunkIndex =
-                        CachingReaderChunk::indexForFrame(remainingFrameIndexRange.end() - 1);
+                lastChunkIndex = CachingReaderChunk::indexForFrame(
+                        remainingFrameIndexRange.end() - 1, m_chunkFrames);
                 if (lastChunkIndex < chunkIndex) {
                     // No more readable data available. Exit the loop and
                     // fill the remaining buffer with silence.
@@ -448,8 +477,12 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                 }
 
                 mixxx::IndexRange bufferedFrameIndexRange;
-                const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
+                // Ready chunks are pinned while reading from them
+                CachingReaderChunkForOwner* const pChunk = lookupChunkAndPin(chunkIndex);
                 if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    static Counter s_cacheHitCounter(
+                            QStringLiteral("CachingReader::read(): Chunk cache hit"));
+                    s_cacheHitCounter.increment();
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -463,6 +496,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                                         channelCount,
                                         remainingFrameIndexRange);
                     }
+                    unpinChunk(pChunk);
                 } else {
                     // This will happen regularly when jumping to a new position
                     // within the file and decoding of the audio data is still
@@ -542,6 +576,11 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
         return;
     }
 
+    // Every frame of a preloaded track is available, nothing to do.
+    if (isPreloaded()) {
+        return;
+    }
+
     // For every chunk that the hints indicated, check if it is in the cache. If
     // any are not, then wake.
     bool shouldWake = false;
@@ -577,12 +616,18 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
             continue;
         }
 
-        const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
-        const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
+        const int firstChunkIndex = CachingReaderChunk::indexForFrame(
+                readableFrameIndexRange.start(), m_chunkFrames);
+        const int lastChunkIndex = CachingReaderChunk::indexForFrame(
+                readableFrameIndexRange.end() - 1, m_chunkFrames);
         for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
-            CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
+            CachingReaderChunkForOwner* pChunk = lookupChunkAndFreshen(chunkIndex);
             if (!pChunk) {
                 shouldWake = true;
+                if (m_numPendingChunks >= kMaxPendingChunks) {
+                    // Wait until the worker has caught up
+                    continue;
+                }
                 pChunk = allocateChunkExpireLRU(chunkIndex);
                 if (!pChunk) {
                     kLogger.warning()
@@ -607,11 +652,9 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                     // Revoke the chunk from the worker and free it
                     pChunk->takeFromWorker();
                     freeChunk(pChunk);
+                } else {
+                    ++m_numPendingChunks;
                 }
-            } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
-                // This will cause the chunk to be 'freshened' in the cache. The
-                // chunk will be moved to the end of the LRU list.
-                freshenChunk(pChunk);
             }
         }
     }
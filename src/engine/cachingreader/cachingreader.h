@@ -4,9 +4,9 @@
 #include <QHash>
 #include <QList>
 #include <QVarLengthArray>
-#include <QVector>
-#include <list>
+#include <memory>
 
+#include "engine/cachingreader/cachingreaderchunkpool.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -63,19 +63,26 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // from a file. Since we cannot do file I/O in the audio callback thread
 // CachingReader and CachingReaderWorker (a worker thread) work in concert to
 // read and decode relevant sections of a track in a background thread. The
-// decoded chunks are kept in a cache by CachingReader with a
-// least-recently-used (LRU) eviction policy. CachingReader exposes a method for
+// decoded chunks are kept in a cache that is shared by all CachingReaders
+// (see CachingReaderChunkPool) with a least-recently-used (LRU) eviction
+// policy. CachingReader exposes a method for
 // indicating which chunks should be kept fresh in the cache (see
 // hintAndMaybeWake). For example, the chunks around the playhead, the hotcue
 // positions, and loop points are all portions of the track that the user is
 // likely to dynamically jump to so we should keep them ready.
 //
+// Optionally the worker decodes the whole track into a contiguous buffer in
+// the background after loading (see kPreloadWholeTrackConfigKey). Reads are
+// served from the chunks until preloading has finished. Afterwards all reads
+// are served from the preloaded buffer and no hints are needed anymore.
+//
 // The least recently used policy is implemented by keeping a linked list of the
-// least recently used chunks. When a chunk is "freshened" (i.e. accessed via
-// read or hinted via hintAndMaybeWake) then it is moved to the back of the
-// least-recently-used list. When a chunk needs to be allocated and there are no
-// free chunks then the least recently used chunk is free'd (see
-// allocateChunkExpireLRU).
+// least recently used chunks of all readers. When a chunk is "freshened" (i.e.
+// accessed via read or hinted via hintAndMaybeWake) then it is moved to the
+// back of the least-recently-used list. When a chunk needs to be allocated and
+// there are no free chunks then the least recently used chunk is free'd, even
+// if it belongs to a different reader, unless that reader would fall below
+// its reserved number of chunks (see allocateChunkExpireLRU).
 class CachingReader : public QObject {
     Q_OBJECT
 
@@ -148,22 +155,36 @@ class CachingReader : public QObject {
     // freshenChunk is called on the chunk to make it the MRU chunk.
     CachingReaderChunkForOwner* lookupChunkAndFreshen(SINT chunkIndex);
 
-    // Looks for the provided chunk number in the index of in-memory chunks and
-    // returns it if it is present. If not, returns nullptr.
-    CachingReaderChunkForOwner* lookupChunk(SINT chunkIndex);
+    // Like lookupChunkAndFreshen(), but additionally pins the chunk if it
+    // is ready. A pinned chunk is not evicted by the readers of other
+    // channels that are processed concurrently and must be unpinned
+    // after reading.
+    CachingReaderChunkForOwner* lookupChunkAndPin(SINT chunkIndex);
+    void unpinChunk(CachingReaderChunkForOwner* pChunk);
 
     // Moves the provided chunk to the MRU position.
     void freshenChunk(CachingReaderChunkForOwner* pChunk);
 
     // Returns a CachingReaderChunk to the free list
     void freeChunk(CachingReaderChunkForOwner* pChunk);
-    void freeChunkFromList(CachingReaderChunkForOwner* pChunk);
 
     // Returns all allocated chunks to the free list
     void freeAllChunks();
 
-    // Gets a chunk from the free list. Returns nullptr if none available.
-    CachingReaderChunkForOwner* allocateChunk(SINT chunkIndex);
+    // Discards the samples of a preloaded track
+    void resetPreloadedSamples();
+
+    bool isPreloaded() const {
+        return m_pPreloadedSamples != nullptr;
+    }
+
+    // Reads the requested range of frames from the preloaded samples and
+    // returns the range of frames that have been read.
+    mixxx::IndexRange readPreloadedSampleFrames(
+            CSAMPLE* buffer,
+            mixxx::audio::ChannelCount channelCount,
+            const mixxx::IndexRange& frameIndexRange,
+            bool reverse) const;
 
     // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
@@ -176,26 +197,30 @@ class CachingReader : public QObject {
     };
     QAtomicInt m_state;
 
-    // Keeps track of all CachingReaderChunks we've allocated.
-    QVector<CachingReaderChunkForOwner*> m_chunks;
-
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    std::list<CachingReaderChunkForOwner*> m_freeChunks;
+    // The pool of chunks that is shared by all readers.
+    const std::shared_ptr<CachingReaderChunkPool> m_pChunkPool;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
-    // chunk number they are allocated to.
+    // chunk number they are allocated to. Chunks that have been evicted by the pool
+    // in favor of another reader are removed lazily in lookupChunkAndFreshen().
     QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
 
-    // The linked list of recently-used chunks.
-    CachingReaderChunkForOwner* m_mruCachingReaderChunk;
-    CachingReaderChunkForOwner* m_lruCachingReaderChunk;
+    // The number of chunks that have been handed over to the worker
+    // and not yet been returned.
+    SINT m_numPendingChunks;
 
-    // The raw memory buffer which is divided up into chunks.
-    mixxx::SampleBuffer m_sampleBuffer;
+    // The number of frames per chunk of the current track as reported
+    // by the worker.
+    SINT m_chunkFrames;
 
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The samples of the whole track as decoded by the worker. The
+    // buffer is owned by the worker and remains valid until the reader
+    // has acknowledged that the next track has been loaded or unloaded.
+    const CSAMPLE* m_pPreloadedSamples;
+    mixxx::IndexRange m_preloadedFrameIndexRange;
+
     CachingReaderWorker m_worker;
 };
@@ -4,8 +4,9 @@
 
 #include "sources/audiosourcestereoproxy.h"
 #include "engine/engine.h"
-#include "util/sample.h"
 #include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
 
 
 namespace {
@@ -14,17 +15,104 @@ mixxx::Logger kLogger("CachingReaderChunk");
 
 constexpr SINT kInvalidChunkIndex = -1;
 
+// Number of frames that are decoded at once by lossy codecs
+constexpr SINT kMp3FramesPerCodecFrame = 1152;
+constexpr SINT kAacFramesPerCodecFrame = 1024;
+constexpr SINT kOpusFramesPerCodecFrame = 960; // 20 ms at 48 kHz
+
+bool isUncompressedOrLosslessFileType(const QString& fileType) {
+    return fileType == QLatin1String("wav") ||
+            fileType == QLatin1String("aif") ||
+            fileType == QLatin1String("aiff") ||
+            fileType == QLatin1String("flac") ||
+            fileType == QLatin1String("wv");
+}
+
+SINT framesPerCodecFrame(const QString& fileType) {
+    if (fileType == QLatin1String("mp3")) {
+        return kMp3FramesPerCodecFrame;
+    }
+    if (fileType == QLatin1String("aac") ||
+            fileType == QLatin1String("m4a") ||
+            fileType == QLatin1String("mp4") ||
+            fileType == QLatin1String("stem.mp4")) {
+        return kAacFramesPerCodecFrame;
+    }
+    if (fileType == QLatin1String("opus")) {
+        return kOpusFramesPerCodecFrame;
+    }
+    return 0; // unknown
+}
+
 } // anonymous namespace
 
+// static
+SINT CachingReaderChunk::framesForAudioSource(
+        const QString& fileType,
+        mixxx::audio::ChannelCount channelCount) {
+    const SINT maxFrames = kSamples / bufferedChannelCount(channelCount);
+    if (isUncompressedOrLosslessFileType(fileType)) {
+        return maxFrames;
+    }
+    const SINT defaultFrames = math_min(kDefaultFrames, maxFrames);
+    const SINT codecFrames = framesPerCodecFrame(fileType);
+    if (codecFrames <= 0 || codecFrames > defaultFrames) {
+        return defaultFrames;
+    }
+    return (defaultFrames / codecFrames) * codecFrames;
+}
+
+// static
+mixxx::audio::ChannelCount CachingReaderChunk::bufferedChannelCount(
+        mixxx::audio::ChannelCount channelCount) {
+    DEBUG_ASSERT(channelCount.isValid());
+    if (channelCount % mixxx::audio::ChannelCount::stereo() != 0) {
+        return mixxx::audio::ChannelCount::stereo();
+    }
+    return channelCount;
+}
+
+// static
+mixxx::ReadableSampleFrames CachingReaderChunk::readSampleFrames(
+        const mixxx::AudioSourcePointer& pAudioSource,
+        const mixxx::IndexRange& frameIndexRange,
+        mixxx::SampleBuffer::WritableSlice outputBuffer,
+        mixxx::SampleBuffer::WritableSlice tempOutputBuffer) {
+    if (pAudioSource->getSignalInfo().getChannelCount() %
+                    mixxx::audio::ChannelCount::stereo() !=
+            0) {
+        // This happens if the audio source only contain a mono channel, or an
+        // odd number of channel
+        mixxx::AudioSourceStereoProxy audioSourceProxy(
+                pAudioSource,
+                tempOutputBuffer);
+        DEBUG_ASSERT(
+                audioSourceProxy.getSignalInfo().getChannelCount() ==
+                mixxx::audio::ChannelCount::stereo());
+        return audioSourceProxy.readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        frameIndexRange,
+                        outputBuffer));
+    } else {
+        return pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        frameIndexRange,
+                        outputBuffer));
+    }
+}
+
 CachingReaderChunk::CachingReaderChunk(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : m_index(kInvalidChunkIndex),
+          m_frames(0),
           m_sampleBuffer(std::move(sampleBuffer)) {
 }
 
-void CachingReaderChunk::init(SINT index) {
+void CachingReaderChunk::init(SINT index, SINT frames) {
     DEBUG_ASSERT(m_index == kInvalidChunkIndex || index == kInvalidChunkIndex);
+    DEBUG_ASSERT(index == kInvalidChunkIndex || frames > 0);
     m_index = index;
+    m_frames = frames;
     m_bufferedSampleFrames.frameIndexRange() = mixxx::IndexRange();
 }
 
@@ -39,7 +127,7 @@ mixxx::IndexRange CachingReaderChunk::frameIndexRange(
             pAudioSource->frameIndexMin() +
             frameIndexOffset();
     return intersect(
-            mixxx::IndexRange::forward(minFrameIndex, kFrames),
+            mixxx::IndexRange::forward(minFrameIndex, m_frames),
             pAudioSource->frameIndexRange());
 }
 
@@ -49,29 +137,11 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
     DEBUG_ASSERT(m_index != kInvalidChunkIndex);
     const auto sourceFrameIndexRange = frameIndexRange(pAudioSource);
 
-    if (pAudioSource->getSignalInfo().getChannelCount() %
-                    mixxx::audio::ChannelCount::stereo() !=
-            0) {
-        // This happens if the audio source only contain a mono channel, or an
-        // odd number of channel
-        mixxx::AudioSourceStereoProxy audioSourceProxy(
-                pAudioSource,
-                tempOutputBuffer);
-        DEBUG_ASSERT(
-                audioSourceProxy.getSignalInfo().getChannelCount() ==
-                mixxx::audio::ChannelCount::stereo());
-        m_bufferedSampleFrames =
-                audioSourceProxy.readSampleFrames(
-                        mixxx::WritableSampleFrames(
-                                sourceFrameIndexRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
-    } else {
-        m_bufferedSampleFrames =
-                pAudioSource->readSampleFrames(
-                        mixxx::WritableSampleFrames(
-                                sourceFrameIndexRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
-    }
+    m_bufferedSampleFrames = readSampleFrames(
+            pAudioSource,
+            sourceFrameIndexRange,
+            mixxx::SampleBuffer::WritableSlice(m_sampleBuffer),
+            std::move(tempOutputBuffer));
     DEBUG_ASSERT(m_bufferedSampleFrames.frameIndexRange().empty() ||
             m_bufferedSampleFrames.frameIndexRange().isSubrangeOf(sourceFrameIndexRange));
     return m_bufferedSampleFrames.frameIndexRange();
@@ -130,30 +200,39 @@ mixxx::IndexRange CachingReaderChunk::readBufferedSampleFramesReverse(
 CachingReaderChunkForOwner::CachingReaderChunkForOwner(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : CachingReaderChunk(std::move(sampleBuffer)),
+          m_pOwner(nullptr),
           m_state(FREE),
+          m_pinCount(0),
           m_pPrev(nullptr),
           m_pNext(nullptr) {
 }
 
-void CachingReaderChunkForOwner::init(SINT index) {
+void CachingReaderChunkForOwner::init(
+        const CachingReader* pOwner, SINT index, SINT frames) {
     // Must not be accessed by a worker!
     DEBUG_ASSERT(m_state != READ_PENDING);
     // Must not be referenced in MRU/LRU list!
     DEBUG_ASSERT(!m_pNext);
     DEBUG_ASSERT(!m_pPrev);
+    DEBUG_ASSERT(pOwner);
+    DEBUG_ASSERT(frames2samples(frames, mixxx::audio::ChannelCount::stereo()) <= kSamples);
 
-    CachingReaderChunk::init(index);
+    CachingReaderChunk::init(index, frames);
+    m_pOwner = pOwner;
     m_state = READY;
 }
 
 void CachingReaderChunkForOwner::free() {
     // Must not be accessed by a worker!
     DEBUG_ASSERT(m_state != READ_PENDING);
+    // Must not be read by the owner!
+    DEBUG_ASSERT(!isPinned());
     // Must not be referenced in MRU/LRU list!
     DEBUG_ASSERT(!m_pNext);
     DEBUG_ASSERT(!m_pPrev);
 
-    CachingReaderChunk::init(kInvalidChunkIndex);
+    CachingReaderChunk::init(kInvalidChunkIndex, 0);
+    m_pOwner = nullptr;
     m_state = FREE;
 }
 
@@ -2,9 +2,13 @@
 
 #include "sources/audiosource.h"
 
+class CachingReader;
+
 // A Chunk is a memory-resident section of audio that has been cached.
-// Each chunk holds a fixed number kFrames of frames with samples for
-// kChannels.
+// Each chunk holds a number of frames with samples for all channels.
+// The memory of each chunk is a fixed number of kSamples, the number
+// of frames per chunk is chosen per track depending on the file type
+// and the number of channels (see framesForAudioSource()).
 //
 // The class is not thread-safe although it is shared between CachingReader
 // and CachingReaderWorker! A lock-free FIFO ensures that only a single
@@ -19,11 +23,42 @@ public:
   // 8192 frames contain about 170 ms of audio at 48 kHz, which
   // is well above (hopefully) the latencies people are seeing.
   // At 10 ms latency one chunk is enough for 17 callbacks.
-  // Additionally the chunk size should be a power of 2 for
-  // easier memory alignment.
-  // TODO(XXX): The optimum value of the "constant" kFrames depends
-  // on the properties of the AudioSource as the remarks above suggest!
-  static constexpr SINT kFrames = 8192; // ~ 170 ms at 48 kHz
+  static constexpr SINT kDefaultFrames = 8192; // ~ 170 ms at 48 kHz
+
+  // The maximum number of stereo frames per chunk. Decoding of
+  // uncompressed and lossless formats is cheap and mostly bound by
+  // I/O, so larger chunks are used for those.
+  static constexpr SINT kMaxFrames = 2 * kDefaultFrames; // ~ 340 ms at 48 kHz
+
+  // The fixed memory size of each chunk. Tracks with more than 2 channels,
+  // i.e. stems, use correspondingly less frames per chunk. The chunk size
+  // should be a power of 2 for easier memory alignment.
+  static constexpr SINT kSamples = kMaxFrames * mixxx::audio::ChannelCount::stereo();
+
+  // Returns the number of frames per chunk for an audio source with the
+  // given file type and number of channels.
+  //
+  // Lossy codecs decode audio in fixed-size frames. Chunks of those formats
+  // are aligned to the codec's frame size to avoid decoding the same
+  // codec frame twice at the chunk boundaries.
+  static SINT framesForAudioSource(
+          const QString& fileType,
+          mixxx::audio::ChannelCount channelCount);
+
+  // The number of channels of the buffered sample frames. Sources with
+  // an odd number of channels are buffered as stereo.
+  static mixxx::audio::ChannelCount bufferedChannelCount(
+          mixxx::audio::ChannelCount channelCount);
+
+  // Read sample frames from the audio source into the output buffer,
+  // converting sources with an odd number of channels to stereo. The
+  // temporary buffer must be able to hold all frames with the number
+  // of channels of the source.
+  static mixxx::ReadableSampleFrames readSampleFrames(
+          const mixxx::AudioSourcePointer& pAudioSource,
+          const mixxx::IndexRange& frameIndexRange,
+          mixxx::SampleBuffer::WritableSlice outputBuffer,
+          mixxx::SampleBuffer::WritableSlice tempOutputBuffer);
 
   // Converts frames to samples
   static constexpr SINT frames2samples(
@@ -39,10 +74,12 @@ public:
     // Returns the corresponding chunk index for a frame index
     static SINT indexForFrame(
             /*const mixxx::AudioSourcePointer& pAudioSource,*/
-            SINT frameIndex) {
+            SINT frameIndex,
+            SINT chunkFrames) {
         // DEBUG_ASSERT(pAudioSource->frameIndexRange().contains(frameIndex));
+        DEBUG_ASSERT(chunkFrames > 0);
         const SINT frameIndexOffset = frameIndex /*- pAudioSource->frameIndexMin()*/;
-        return frameIndexOffset / kFrames;
+        return frameIndexOffset / chunkFrames;
     }
 
     // Disable copy and move constructors
@@ -53,6 +90,10 @@ public:
         return m_index;
     }
 
+    SINT getFrames() const noexcept {
+        return m_frames;
+    }
+
     // Frame index range of this chunk for the given audio source.
     mixxx::IndexRange frameIndexRange(
             const mixxx::AudioSourcePointer& pAudioSource) const;
@@ -76,14 +117,15 @@ public:
             mixxx::SampleBuffer::WritableSlice sampleBuffer);
     virtual ~CachingReaderChunk() = default;
 
-    void init(SINT index);
+    void init(SINT index, SINT frames);
 
   private:
     SINT frameIndexOffset() const noexcept {
-        return m_index * kFrames;
+        return m_index * m_frames;
     }
 
     SINT m_index;
+    SINT m_frames;
 
     // The worker thread will fill the sample buffer and
     // set the corresponding frame index range.
@@ -94,15 +136,28 @@ public:
 // This derived class is only accessible for the cache as the owner,
 // but not the worker thread. The state READ_PENDING indicates that
 // the worker thread is in control.
+//
+// All chunks are managed by CachingReaderChunkPool and shared between
+// all CachingReaders. Each allocated chunk is owned by a single reader.
 class CachingReaderChunkForOwner: public CachingReaderChunk {
 public:
   explicit CachingReaderChunkForOwner(
           mixxx::SampleBuffer::WritableSlice sampleBuffer);
   ~CachingReaderChunkForOwner() override = default;
 
-  void init(SINT index);
+  void init(const CachingReader* pOwner, SINT index, SINT frames);
   void free();
 
+  const CachingReader* getOwner() const noexcept {
+      return m_pOwner;
+  }
+
+  // Checks if the chunk is still allocated by the given owner for the
+  // given index. The pool might have evicted and reassigned the chunk.
+  bool isAllocatedBy(const CachingReader* pOwner, SINT index) const noexcept {
+      return m_state != FREE && m_pOwner == pOwner && getIndex() == index;
+  }
+
   enum State {
       FREE,
       READY,
@@ -113,6 +168,20 @@ public:
         return m_state;
   }
 
+    // A pinned chunk is currently read by its owner and must not be
+    // evicted. Pinning is controlled by CachingReaderChunkPool.
+    bool isPinned() const noexcept {
+        return m_pinCount > 0;
+    }
+    void pin() {
+        DEBUG_ASSERT(m_state == READY);
+        ++m_pinCount;
+    }
+    void unpin() {
+        DEBUG_ASSERT(m_pinCount > 0);
+        --m_pinCount;
+    }
+
     // The state is controlled by the cache as the owner of each chunk!
     void giveToWorker() {
         // Must not be referenced in MRU/LRU list!
@@ -143,8 +212,16 @@ public:
             CachingReaderChunkForOwner** ppHead,
             CachingReaderChunkForOwner** ppTail);
 
+    // The previous item in the double-linked list, i.e. the next
+    // more recently used chunk when traversing from the tail.
+    CachingReaderChunkForOwner* getPrev() const noexcept {
+        return m_pPrev;
+    }
+
 private:
+  const CachingReader* m_pOwner;
   State m_state;
+  int m_pinCount;
 
   CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
   CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
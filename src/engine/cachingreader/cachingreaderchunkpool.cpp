@@ -0,0 +1,347 @@
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+
+#include <QMutex>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/counter.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderChunkPool");
+
+const ConfigKey kMemoryBudgetConfigKey =
+        ConfigKey(QStringLiteral("[CachingReader]"), QStringLiteral("MemoryBudgetMB"));
+
+// With CachingReaderChunk::kSamples = 32768 each chunk consumes
+// 32768 samples * 4-bytes per sample = 128 KB.
+//
+//     64 MB -> 512 chunks
+//
+// The pool is shared by all decks (including sample decks and the
+// preview deck). Previously each deck reserved 80 chunks with 8192
+// stereo frames, i.e. 5 MB per deck. The default budget provides
+// roughly the same amount of audio per deck for a setup with 4 decks,
+// 4 samplers, and the preview deck while allowing busy decks to
+// occupy more memory than idle decks.
+constexpr int kMemoryBudgetMBDefault = 64;
+constexpr int kMemoryBudgetMBMin = 8;
+
+constexpr SINT kBytesPerChunk = CachingReaderChunk::kSamples * sizeof(CSAMPLE);
+
+SINT numChunksForMemoryBudget(int memoryBudgetMB) {
+    const qint64 memoryBudgetBytes =
+            static_cast<qint64>(math_max(memoryBudgetMB, kMemoryBudgetMBMin)) *
+            1024 * 1024;
+    return static_cast<SINT>(memoryBudgetBytes / kBytesPerChunk);
+}
+
+QMutex s_sharedInstanceMutex;
+std::weak_ptr<CachingReaderChunkPool> s_sharedInstance;
+
+} // anonymous namespace
+
+class CachingReaderChunkPool::SpinLocker {
+  public:
+    explicit SpinLocker(std::atomic_flag* pLock)
+            : m_pLock(pLock) {
+        while (m_pLock->test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    ~SpinLocker() {
+        m_pLock->clear(std::memory_order_release);
+    }
+
+  private:
+    std::atomic_flag* const m_pLock;
+};
+
+// static
+std::shared_ptr<CachingReaderChunkPool> CachingReaderChunkPool::getOrCreateSharedInstance(
+        const UserSettingsPointer& pConfig) {
+    const auto locker = lockMutex(&s_sharedInstanceMutex);
+    auto pInstance = s_sharedInstance.lock();
+    if (!pInstance) {
+        int memoryBudgetMB = kMemoryBudgetMBDefault;
+        if (pConfig) {
+            memoryBudgetMB = pConfig->getValue(kMemoryBudgetConfigKey, kMemoryBudgetMBDefault);
+        }
+        pInstance = std::make_shared<CachingReaderChunkPool>(
+                numChunksForMemoryBudget(memoryBudgetMB));
+        s_sharedInstance = pInstance;
+    }
+    return pInstance;
+}
+
+CachingReaderChunkPool::CachingReaderChunkPool(SINT numChunks)
+        : m_sampleBuffer(CachingReaderChunk::kSamples * numChunks),
+          m_mruChunk(nullptr),
+          m_lruChunk(nullptr) {
+    kLogger.info()
+            << "Allocating"
+            << numChunks
+            << "chunks with"
+            << kBytesPerChunk * numChunks / (1024 * 1024)
+            << "MB";
+    m_chunks.reserve(numChunks);
+    m_freeChunks.reserve(numChunks);
+    m_readers.reserve(kMaxReaders);
+    // Divide up the allocated raw memory buffer into chunks. Initialize
+    // each chunk to hold nothing and add it to the free list.
+    for (SINT i = 0; i < numChunks; ++i) {
+        m_chunks.push_back(std::make_unique<CachingReaderChunkForOwner>(
+                mixxx::SampleBuffer::WritableSlice(
+                        m_sampleBuffer,
+                        CachingReaderChunk::kSamples * i,
+                        CachingReaderChunk::kSamples)));
+        m_freeChunks.push_back(m_chunks.back().get());
+    }
+}
+
+CachingReaderChunkPool::~CachingReaderChunkPool() {
+    // All readers must have released their chunks
+    DEBUG_ASSERT(numFreeChunks() == size());
+    DEBUG_ASSERT(m_readers.empty());
+}
+
+void CachingReaderChunkPool::addReader(const CachingReader* pReader) {
+    DEBUG_ASSERT(pReader);
+    SpinLocker locker(&m_lock);
+    DEBUG_ASSERT(!findReaderLocked(pReader));
+    // Never reallocate while the lock is held
+    VERIFY_OR_DEBUG_ASSERT(m_readers.size() < m_readers.capacity()) {
+        return;
+    }
+    m_readers.push_back(ReaderChunks{pReader, 0});
+}
+
+void CachingReaderChunkPool::removeReader(const CachingReader* pReader) {
+    SpinLocker locker(&m_lock);
+    ReaderChunks* pReaderChunks = findReaderLocked(pReader);
+    if (!pReaderChunks) {
+        return;
+    }
+    DEBUG_ASSERT(pReaderChunks->numChunks == 0);
+    *pReaderChunks = m_readers.back();
+    m_readers.pop_back();
+}
+
+SINT CachingReaderChunkPool::reservedChunksPerReader() const {
+    SpinLocker locker(&m_lock);
+    return reservedChunksPerReaderLocked();
+}
+
+SINT CachingReaderChunkPool::numChunksAllocatedBy(const CachingReader* pReader) const {
+    SpinLocker locker(&m_lock);
+    const ReaderChunks* pReaderChunks = findReaderLocked(pReader);
+    return pReaderChunks ? pReaderChunks->numChunks : 0;
+}
+
+CachingReaderChunkPool::ReaderChunks* CachingReaderChunkPool::findReaderLocked(
+        const CachingReader* pReader) {
+    for (auto& readerChunks : m_readers) {
+        if (readerChunks.pReader == pReader) {
+            return &readerChunks;
+        }
+    }
+    return nullptr;
+}
+
+const CachingReaderChunkPool::ReaderChunks* CachingReaderChunkPool::findReaderLocked(
+        const CachingReader* pReader) const {
+    return const_cast<CachingReaderChunkPool*>(this)->findReaderLocked(pReader);
+}
+
+SINT CachingReaderChunkPool::reservedChunksPerReaderLocked() const {
+    if (m_readers.empty()) {
+        return 0;
+    }
+    const SINT numReaders = static_cast<SINT>(m_readers.size());
+    return math_min(kMaxReservedChunksPerReader, size() / (2 * numReaders));
+}
+
+CachingReaderChunkForOwner* CachingReaderChunkPool::findChunkToEvictLocked(
+        const CachingReader* pOwner) {
+    const SINT reservedChunks = reservedChunksPerReaderLocked();
+    // Traverse from the least towards the most recently used chunk
+    for (auto* pChunk = m_lruChunk; pChunk; pChunk = pChunk->getPrev()) {
+        if (pChunk->isPinned()) {
+            continue;
+        }
+        if (pChunk->getOwner() == pOwner) {
+            // Readers may always replace their own chunks
+            return pChunk;
+        }
+        const ReaderChunks* pReaderChunks = findReaderLocked(pChunk->getOwner());
+        if (!pReaderChunks || pReaderChunks->numChunks > reservedChunks) {
+            return pChunk;
+        }
+    }
+    // All chunks in the list are reserved or pinned. This only happens if
+    // most chunks are processed by the workers.
+    for (auto* pChunk = m_lruChunk; pChunk; pChunk = pChunk->getPrev()) {
+        if (!pChunk->isPinned()) {
+            return pChunk;
+        }
+    }
+    return nullptr;
+}
+
+void CachingReaderChunkPool::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
+    pChunk->removeFromList(
+            &m_mruChunk,
+            &m_lruChunk);
+    ReaderChunks* pReaderChunks = findReaderLocked(pChunk->getOwner());
+    if (pReaderChunks) {
+        DEBUG_ASSERT(pReaderChunks->numChunks > 0);
+        --pReaderChunks->numChunks;
+    }
+    pChunk->free();
+    DEBUG_ASSERT(m_freeChunks.size() < m_freeChunks.capacity());
+    m_freeChunks.push_back(pChunk);
+}
+
+CachingReaderChunkForOwner* CachingReaderChunkPool::allocateChunk(
+        const CachingReader* pOwner,
+        SINT chunkIndex,
+        SINT chunkFrames) {
+    bool evicted = false;
+    CachingReaderChunkForOwner* pChunk;
+    {
+        SpinLocker locker(&m_lock);
+        if (m_freeChunks.empty()) {
+            CachingReaderChunkForOwner* pEvictedChunk = findChunkToEvictLocked(pOwner);
+            if (!pEvictedChunk) {
+                return nullptr;
+            }
+            // The previous owner will notice that the chunk has been
+            // reassigned on the next lookup.
+            freeChunkFromList(pEvictedChunk);
+            evicted = true;
+        }
+        DEBUG_ASSERT(!m_freeChunks.empty());
+        pChunk = m_freeChunks.back();
+        m_freeChunks.pop_back();
+
+        pChunk->init(pOwner, chunkIndex, chunkFrames);
+        ReaderChunks* pReaderChunks = findReaderLocked(pOwner);
+        if (pReaderChunks) {
+            ++pReaderChunks->numChunks;
+        }
+    }
+    if (evicted) {
+        static Counter s_evictionCounter(
+                QStringLiteral("CachingReaderChunkPool: Chunk evicted"));
+        s_evictionCounter++;
+    }
+    return pChunk;
+}
+
+void CachingReaderChunkPool::freeChunk(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    DEBUG_ASSERT(pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING);
+    SpinLocker locker(&m_lock);
+    freeChunkFromList(pChunk);
+}
+
+void CachingReaderChunkPool::freshenChunk(CachingReaderChunkForOwner* pChunk) {
+    SpinLocker locker(&m_lock);
+    freshenChunkLocked(pChunk);
+}
+
+bool CachingReaderChunkPool::isChunkAllocatedBy(
+        const CachingReaderChunkForOwner* pChunk,
+        const CachingReader* pOwner,
+        SINT chunkIndex) const {
+    DEBUG_ASSERT(pChunk);
+    SpinLocker locker(&m_lock);
+    return pChunk->isAllocatedBy(pOwner, chunkIndex);
+}
+
+bool CachingReaderChunkPool::freshenChunkIfAllocatedBy(
+        CachingReaderChunkForOwner* pChunk,
+        const CachingReader* pOwner,
+        SINT chunkIndex) {
+    DEBUG_ASSERT(pChunk);
+    SpinLocker locker(&m_lock);
+    if (!pChunk->isAllocatedBy(pOwner, chunkIndex)) {
+        return false;
+    }
+    if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+        freshenChunkLocked(pChunk);
+    }
+    return true;
+}
+
+bool CachingReaderChunkPool::pinChunkIfAllocatedBy(
+        CachingReaderChunkForOwner* pChunk,
+        const CachingReader* pOwner,
+        SINT chunkIndex) {
+    DEBUG_ASSERT(pChunk);
+    SpinLocker locker(&m_lock);
+    if (!pChunk->isAllocatedBy(pOwner, chunkIndex)) {
+        return false;
+    }
+    if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+        freshenChunkLocked(pChunk);
+        pChunk->pin();
+    }
+    return true;
+}
+
+void CachingReaderChunkPool::unpinChunk(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    SpinLocker locker(&m_lock);
+    pChunk->unpin();
+}
+
+void CachingReaderChunkPool::freshenChunkLocked(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::READY);
+
+    // Remove the chunk from the MRU/LRU list
+    pChunk->removeFromList(
+            &m_mruChunk,
+            &m_lruChunk);
+
+    // Reinsert has new head of MRU list
+    pChunk->insertIntoListBefore(
+            &m_mruChunk,
+            &m_lruChunk,
+            m_mruChunk);
+}
+
+void CachingReaderChunkPool::freeAllChunks(const CachingReader* pOwner) {
+    SpinLocker locker(&m_lock);
+    for (const auto& pChunk : m_chunks) {
+        if (pChunk->getOwner() != pOwner) {
+            continue;
+        }
+        // The owner will receive CHUNK_READ_INVALID for all pending chunk
+        // reads which should free the chunks individually.
+        if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+            continue;
+        }
+        if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
+            freeChunkFromList(pChunk.get());
+        }
+    }
+}
+
+void CachingReaderChunkPool::releaseAllChunks(const CachingReader* pOwner) {
+    SpinLocker locker(&m_lock);
+    for (const auto& pChunk : m_chunks) {
+        if (pChunk->getOwner() != pOwner) {
+            continue;
+        }
+        if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+            // The worker has already been stopped
+            pChunk->takeFromWorker();
+        }
+        if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
+            freeChunkFromList(pChunk.get());
+        }
+    }
+}
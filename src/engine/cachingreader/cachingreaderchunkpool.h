@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "preferences/usersettings.h"
+#include "util/samplebuffer.h"
+
+class CachingReader;
+
+// The pool of all chunks that are shared by all CachingReaders of the
+// decks, samplers, and preview decks. The memory for all chunks is
+// allocated upfront according to a global memory budget instead of
+// reserving a fixed number of chunks for each reader.
+//
+// Allocated chunks that are ready for reading are kept in a single
+// MRU/LRU list across all readers. If no free chunks are available the
+// least recently used chunk is evicted. Each registered reader keeps a
+// minimum number of chunks that are not evicted in favor of other
+// readers (see reservedChunksPerReader()), so loading a track into a
+// preview deck or sampler can't evict all chunks of a playing deck.
+// Evicted chunks are not removed from the index of their
+// previous owner. Instead each reader verifies that a chunk is still
+// allocated for it upon lookup (see CachingReaderChunkForOwner::isAllocatedBy()).
+//
+// Chunks are allocated, freshened, and freed from the engine thread or,
+// if parallel channel processing is enabled, from the channel worker
+// threads of EngineMixer. All list operations are guarded by a spin lock.
+// Nothing is logged while the lock is held. Chunks are pinned while their
+// samples are copied, so they can't be evicted by another reader.
+// Readers must only be attached and detached while their worker threads
+// are not running.
+class CachingReaderChunkPool {
+  public:
+    // The number of chunks that are reserved for each reader if the pool
+    // is large enough. Enough for the chunks around the play position
+    // and a few cue points.
+    static constexpr SINT kMaxReservedChunksPerReader = 8;
+    // The upper bound for the number of registered readers. The memory
+    // for their bookkeeping is reserved upfront.
+    static constexpr SINT kMaxReaders = 256;
+
+    // Returns the shared pool instance and creates it on first use with
+    // the memory budget configured in the settings. The instance is
+    // destroyed when the last reader has released its reference.
+    static std::shared_ptr<CachingReaderChunkPool> getOrCreateSharedInstance(
+            const UserSettingsPointer& pConfig);
+
+    explicit CachingReaderChunkPool(SINT numChunks);
+    ~CachingReaderChunkPool();
+
+    SINT size() const {
+        return static_cast<SINT>(m_chunks.size());
+    }
+
+    SINT numFreeChunks() const {
+        return static_cast<SINT>(m_freeChunks.size());
+    }
+
+    // Registers a reader for the reservation of chunks. Readers that
+    // are not registered may allocate chunks, but don't have any
+    // reserved chunks.
+    void addReader(const CachingReader* pReader);
+    // Unregisters a reader after all of its chunks have been released.
+    void removeReader(const CachingReader* pReader);
+
+    // The number of chunks that are protected from eviction in favor
+    // of other readers. At most half of the pool is reserved.
+    SINT reservedChunksPerReader() const;
+
+    // The number of chunks that are currently allocated by a registered
+    // reader, including chunks that are processed by its worker.
+    SINT numChunksAllocatedBy(const CachingReader* pReader) const;
+
+    // Gets a chunk from the free list or evicts the least recently used
+    // chunk if none is available. Chunks of other readers that don't
+    // exceed their reservation are skipped unless there is no other
+    // choice. Pinned chunks are always skipped. Returns nullptr if all
+    // chunks are currently in use by the workers or pinned.
+    CachingReaderChunkForOwner* allocateChunk(
+            const CachingReader* pOwner,
+            SINT chunkIndex,
+            SINT chunkFrames);
+
+    // Returns a chunk to the free list
+    void freeChunk(CachingReaderChunkForOwner* pChunk);
+
+    // Moves the provided chunk to the MRU position.
+    void freshenChunk(CachingReaderChunkForOwner* pChunk);
+
+    // Checks if the chunk has not been evicted in the meantime.
+    bool isChunkAllocatedBy(
+            const CachingReaderChunkForOwner* pChunk,
+            const CachingReader* pOwner,
+            SINT chunkIndex) const;
+
+    // Atomically checks if the chunk has not been evicted in the meantime
+    // and moves it to the MRU position if it is ready.
+    bool freshenChunkIfAllocatedBy(
+            CachingReaderChunkForOwner* pChunk,
+            const CachingReader* pOwner,
+            SINT chunkIndex);
+
+    // Like freshenChunkIfAllocatedBy(), but additionally pins a ready
+    // chunk. Pinned chunks are never evicted by concurrent readers until
+    // the owner has finished reading and unpinned the chunk again.
+    bool pinChunkIfAllocatedBy(
+            CachingReaderChunkForOwner* pChunk,
+            const CachingReader* pOwner,
+            SINT chunkIndex);
+    void unpinChunk(CachingReaderChunkForOwner* pChunk);
+
+    // Returns all chunks of the owner to the free list, except those
+    // that are currently processed by a worker.
+    void freeAllChunks(const CachingReader* pOwner);
+
+    // Returns all chunks of the owner to the free list, including those
+    // that have been handed over to a worker that is no longer running.
+    void releaseAllChunks(const CachingReader* pOwner);
+
+  private:
+    class SpinLocker;
+
+    struct ReaderChunks {
+        const CachingReader* pReader;
+        SINT numChunks;
+    };
+
+    ReaderChunks* findReaderLocked(const CachingReader* pReader);
+    const ReaderChunks* findReaderLocked(const CachingReader* pReader) const;
+    SINT reservedChunksPerReaderLocked() const;
+    CachingReaderChunkForOwner* findChunkToEvictLocked(const CachingReader* pOwner);
+
+    void freeChunkFromList(CachingReaderChunkForOwner* pChunk);
+    void freshenChunkLocked(CachingReaderChunkForOwner* pChunk);
+
+    // The critical sections are short and never block. A spin lock avoids
+    // putting a real-time thread to sleep.
+    mutable std::atomic_flag m_lock = ATOMIC_FLAG_INIT;
+
+    // The raw memory buffer which is divided up into chunks.
+    mixxx::SampleBuffer m_sampleBuffer;
+
+    // Keeps track of all chunks we've allocated.
+    std::vector<std::unique_ptr<CachingReaderChunkForOwner>> m_chunks;
+
+    // Stack of free chunks. The capacity is reserved upfront to avoid
+    // any memory allocations when chunks are returned in the engine thread.
+    std::vector<CachingReaderChunkForOwner*> m_freeChunks;
+
+    // The number of allocated chunks per registered reader. The
+    // capacity is reserved upfront for kMaxReaders.
+    std::vector<ReaderChunks> m_readers;
+
+    // The linked list of recently-used chunks of all readers.
+    CachingReaderChunkForOwner* m_mruChunk;
+    CachingReaderChunkForOwner* m_lruChunk;
+};
@@ -12,6 +12,7 @@
 #include "util/fifo.h"
 #include "util/logger.h"
 #include "util/span.h"
+#include "util/tracerecorder.h"
 
 namespace {
 
@@ -20,6 +21,11 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// Tracks that are longer, e.g. recorded mixes, are not preloaded to
+// limit the memory consumption. 20 minutes of stereo audio at 48 kHz
+// occupy about 440 MB.
+constexpr double kPreloadMaxDurationSeconds = 20 * 60;
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
@@ -31,11 +37,18 @@ CachingReaderWorker::CachingReaderWorker(
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
-          m_maxSupportedChannel(maxSupportedChannel) {
+          m_maxSupportedChannel(maxSupportedChannel),
+          m_chunkFrames(CachingReaderChunk::kDefaultFrames),
+          m_preloadWholeTrack(0),
+          m_preloadPending(false),
+          m_preloadSent(false),
+          m_numTrackChangesSent(0),
+          m_numTrackChangesAcknowledged(0) {
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         const CachingReaderChunkReadRequest& request) {
+    mixxx::ScopedTraceEvent traceEvent("CachingReaderWorker::processReadRequest");
     CachingReaderChunk* pChunk = request.chunk;
     DEBUG_ASSERT(pChunk);
 
@@ -117,9 +130,11 @@ void CachingReaderWorker::run() {
     const auto id = lastId.fetchAndAddRelaxed(1) + 1;
     QThread::currentThread()->setObjectName(
             QStringLiteral("CachingReaderWorker ") + QString::number(id));
+    mixxx::TraceRecorder::registerCurrentThread(QThread::currentThread()->objectName());
 
     Event::start(m_tag);
     while (!m_stop.loadAcquire()) {
+        releaseRetiredPreloadBuffers();
         // Request is initialized by reading from FIFO
         CachingReaderChunkReadRequest request;
         if (m_newTrackAvailable.loadAcquire()) {
@@ -150,6 +165,8 @@ void CachingReaderWorker::run() {
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update = processReadRequest(request);
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        } else if (m_preloadPending) {
+            preloadNextSlice();
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -169,6 +186,10 @@ void CachingReaderWorker::discardAllPendingRequests() {
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
 
+    // The engine might still read the preloaded samples of the previous
+    // track until it receives the track change that follows.
+    resetPreload();
+
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
         m_pAudioSource->close();
@@ -183,7 +204,12 @@ void CachingReaderWorker::closeAudioSource() {
 void CachingReaderWorker::unloadTrack() {
     closeAudioSource();
 
-    const auto update = ReaderStatusUpdate::trackUnloaded();
+    writeTrackChange(ReaderStatusUpdate::trackUnloaded());
+}
+
+void CachingReaderWorker::writeTrackChange(const ReaderStatusUpdate& update) {
+    DEBUG_ASSERT(update.status == TRACK_LOADED || update.status == TRACK_UNLOADED);
+    ++m_numTrackChangesSent;
     m_pReaderStatusFIFO->writeBlocking(&update, 1);
 }
 
@@ -204,8 +230,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << m_group
                 << "File not found"
                 << pTrack->getFileInfo();
-        const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeTrackChange(ReaderStatusUpdate::trackUnloaded());
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be found.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
@@ -223,8 +248,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << m_group
                 << "Failed to open file"
                 << pTrack->getFileInfo();
-        const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeTrackChange(ReaderStatusUpdate::trackUnloaded());
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be loaded.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
@@ -238,8 +262,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             m_pAudioSource->getSignalInfo().getChannelCount() <=
                     m_maxSupportedChannel) {
         m_pAudioSource.reset(); // Close open file handles
-        const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeTrackChange(ReaderStatusUpdate::trackUnloaded());
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be loaded because it contains %2 "
                    "channels, and only 1 to %3 are supported.")
@@ -259,26 +282,26 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << m_group
                 << "Failed to open empty file"
                 << pTrack->getFileInfo();
-        const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeTrackChange(ReaderStatusUpdate::trackUnloaded());
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' is empty and could not be loaded.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
         return;
     }
 
-    // Adjust the internal buffer
+    // Choose the chunk size for the new track and adjust the internal buffer
+    m_chunkFrames = CachingReaderChunk::framesForAudioSource(
+            pTrack->getType(),
+            m_pAudioSource->getSignalInfo().getChannelCount());
     const SINT tempReadBufferSize =
-            m_pAudioSource->getSignalInfo().frames2samples(
-                    CachingReaderChunk::kFrames);
+            m_pAudioSource->getSignalInfo().frames2samples(m_chunkFrames);
     if (m_tempReadBuffer.size() != tempReadBufferSize) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
-    const auto update =
-            ReaderStatusUpdate::trackLoaded(
-                    m_pAudioSource->frameIndexRange());
-    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    writeTrackChange(ReaderStatusUpdate::trackLoaded(
+            m_pAudioSource->frameIndexRange(),
+            m_chunkFrames));
 
     // Emit that the track is loaded.
 
@@ -299,6 +322,114 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             m_pAudioSource->getSignalInfo().getSampleRate(),
             m_pAudioSource->getSignalInfo().getChannelCount(),
             mixxx::audio::FramePos(m_pAudioSource->frameLength()));
+
+    startPreload(pTrack);
+}
+
+void CachingReaderWorker::startPreload(const TrackPointer& pTrack) {
+    DEBUG_ASSERT(!m_preloadPending);
+    if (!m_preloadWholeTrack.loadAcquire()) {
+        return;
+    }
+    if (!m_pAudioSource->hasDuration() ||
+            m_pAudioSource->getDuration() > kPreloadMaxDurationSeconds) {
+        kLogger.info()
+                << m_group
+                << "Not preloading track that exceeds the maximum duration"
+                << pTrack->getFileInfo();
+        return;
+    }
+    m_preloadChannelCount = CachingReaderChunk::bufferedChannelCount(
+            m_pAudioSource->getSignalInfo().getChannelCount());
+    mixxx::SampleBuffer(CachingReaderChunk::frames2samples(
+                                m_pAudioSource->frameLength(),
+                                m_preloadChannelCount))
+            .swap(m_preloadBuffer);
+    m_preloadedFrameIndexRange =
+            mixxx::IndexRange::forward(m_pAudioSource->frameIndexMin(), 0);
+    m_preloadPending = true;
+}
+
+void CachingReaderWorker::preloadNextSlice() {
+    DEBUG_ASSERT(m_preloadPending);
+    DEBUG_ASSERT(m_pAudioSource);
+    // The readable frame range might shrink while decoding
+    const auto sliceFrameIndexRange = intersect(
+            mixxx::IndexRange::forward(
+                    m_preloadedFrameIndexRange.end(), m_chunkFrames),
+            m_pAudioSource->frameIndexRange());
+    if (!sliceFrameIndexRange.empty()) {
+        const SINT sampleOffset = CachingReaderChunk::frames2samples(
+                m_preloadedFrameIndexRange.length(), m_preloadChannelCount);
+        const SINT sampleCount = CachingReaderChunk::frames2samples(
+                sliceFrameIndexRange.length(), m_preloadChannelCount);
+        const auto readableSampleFrames = CachingReaderChunk::readSampleFrames(
+                m_pAudioSource,
+                sliceFrameIndexRange,
+                mixxx::SampleBuffer::WritableSlice(
+                        m_preloadBuffer, sampleOffset, sampleCount),
+                mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+        if (readableSampleFrames.frameIndexRange() != sliceFrameIndexRange) {
+            // Continue with reading chunks on demand that are able
+            // to cope with unreadable regions.
+            kLogger.warning()
+                    << m_group
+                    << "Aborting preload after failing to read frames:"
+                    << "expected =" << sliceFrameIndexRange
+                    << ", actual =" << readableSampleFrames.frameIndexRange();
+            resetPreload();
+            return;
+        }
+        m_preloadedFrameIndexRange.growBack(sliceFrameIndexRange.length());
+        if (m_preloadedFrameIndexRange.end() < m_pAudioSource->frameIndexMax()) {
+            return;
+        }
+    }
+    m_preloadPending = false;
+    if (m_preloadedFrameIndexRange.empty()) {
+        resetPreload();
+        return;
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << m_group
+                << "Preloaded frames"
+                << m_preloadedFrameIndexRange;
+    }
+    const auto update = ReaderStatusUpdate::trackPreloaded(
+            m_preloadBuffer.data(),
+            m_preloadedFrameIndexRange);
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    m_preloadSent = true;
+}
+
+void CachingReaderWorker::resetPreload() {
+    m_preloadPending = false;
+    m_preloadedFrameIndexRange = mixxx::IndexRange();
+    if (m_preloadSent) {
+        // The reader stops accessing the samples after it has received
+        // the next track change, which is sent after this call.
+        m_retiredPreloadBuffers.push_back(RetiredPreloadBuffer{
+                m_numTrackChangesSent + 1,
+                std::move(m_preloadBuffer)});
+        m_preloadSent = false;
+    } else if (m_preloadBuffer.size() > 0) {
+        mixxx::SampleBuffer().swap(m_preloadBuffer);
+    }
+}
+
+void CachingReaderWorker::releaseRetiredPreloadBuffers() {
+    if (m_retiredPreloadBuffers.empty()) {
+        return;
+    }
+    const int numTrackChangesAcknowledged = m_numTrackChangesAcknowledged.loadAcquire();
+    // Sorted by the track change
+    auto it = m_retiredPreloadBuffers.begin();
+    while (it != m_retiredPreloadBuffers.end() &&
+            it->trackChange <= numTrackChangesAcknowledged) {
+        ++it;
+    }
+    m_retiredPreloadBuffers.erase(m_retiredPreloadBuffers.begin(), it);
 }
 
 void CachingReaderWorker::quitWait() {
@@ -313,10 +444,10 @@ void CachingReaderWorker::verifyFirstSound(const CachingReaderChunk* pChunk,
         return;
     }
 
+    const auto firstSoundFrame = static_cast<SINT>(
+            m_firstSoundFrameToVerify.toLowerFrameBoundary().value());
     const int firstSoundIndex =
-            CachingReaderChunk::indexForFrame(static_cast<SINT>(
-                    m_firstSoundFrameToVerify.toLowerFrameBoundary()
-                            .value()));
+            CachingReaderChunk::indexForFrame(firstSoundFrame, pChunk->getFrames());
     if (pChunk->getIndex() == firstSoundIndex) {
         mixxx::SampleBuffer sampleBuffer(kNumSoundFrameToVerify * channelCount);
         SINT end = static_cast<SINT>(m_firstSoundFrameToVerify.toLowerFrameBoundary().value());
@@ -2,6 +2,7 @@
 
 #include <QMutex>
 #include <QString>
+#include <vector>
 
 #include "audio/frame.h"
 #include "audio/types.h"
@@ -27,6 +28,7 @@ typedef struct CachingReaderChunkReadRequest {
 enum ReaderStatus {
     TRACK_LOADED,
     TRACK_UNLOADED,
+    TRACK_PRELOADED,
     CHUNK_READ_SUCCESS,
     CHUNK_READ_EOF,
     CHUNK_READ_INVALID,
@@ -39,6 +41,8 @@ typedef struct ReaderStatusUpdate {
     CachingReaderChunk* chunk;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
+    SINT chunkFramesOfTrack;
+    const CSAMPLE* preloadedSamplesOfTrack;
 
   public:
     ReaderStatus status;
@@ -51,6 +55,8 @@ typedef struct ReaderStatusUpdate {
         chunk = chunkArg;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
+        chunkFramesOfTrack = 0;
+        preloadedSamplesOfTrack = nullptr;
     }
 
     static ReaderStatusUpdate readDiscarded(
@@ -61,10 +67,28 @@ typedef struct ReaderStatusUpdate {
     }
 
     static ReaderStatusUpdate trackLoaded(
-            const mixxx::IndexRange& readableFrameIndexRange) {
+            const mixxx::IndexRange& readableFrameIndexRange,
+            SINT chunkFrames) {
         DEBUG_ASSERT(!readableFrameIndexRange.empty());
+        DEBUG_ASSERT(chunkFrames > 0);
         ReaderStatusUpdate update;
         update.init(TRACK_LOADED, nullptr, readableFrameIndexRange);
+        update.chunkFramesOfTrack = chunkFrames;
+        return update;
+    }
+
+    // The whole track has been decoded into a contiguous buffer that
+    // is owned by the worker. It stays valid until the reader has
+    // acknowledged the next TRACK_LOADED or TRACK_UNLOADED update (see
+    // CachingReaderWorker::acknowledgeTrackChange()).
+    static ReaderStatusUpdate trackPreloaded(
+            const CSAMPLE* preloadedSamples,
+            const mixxx::IndexRange& preloadedFrameIndexRange) {
+        DEBUG_ASSERT(preloadedSamples);
+        DEBUG_ASSERT(!preloadedFrameIndexRange.empty());
+        ReaderStatusUpdate update;
+        update.init(TRACK_PRELOADED, nullptr, preloadedFrameIndexRange);
+        update.preloadedSamplesOfTrack = preloadedSamples;
         return update;
     }
 
@@ -90,6 +114,18 @@ typedef struct ReaderStatusUpdate {
                 readableFrameIndexRangeStart,
                 readableFrameIndexRangeEnd);
     }
+
+    // The number of frames per chunk of a loaded track
+    SINT chunkFrames() const {
+        DEBUG_ASSERT(status == TRACK_LOADED);
+        return chunkFramesOfTrack;
+    }
+
+    // The samples of a preloaded track starting at the first readable frame
+    const CSAMPLE* preloadedSamples() const {
+        DEBUG_ASSERT(status == TRACK_PRELOADED);
+        return preloadedSamplesOfTrack;
+    }
 } ReaderStatusUpdate;
 
 class CachingReaderWorker : public EngineWorker {
@@ -116,6 +152,20 @@ class CachingReaderWorker : public EngineWorker {
 
     void quitWait();
 
+    // Enables or disables decoding of the whole track into memory
+    // after loading. Takes effect when the next track is loaded.
+    void setPreloadWholeTrack(bool preloadWholeTrack) {
+        m_preloadWholeTrack.storeRelease(preloadWholeTrack ? 1 : 0);
+    }
+
+    // Called by the reader from the engine thread after it has processed
+    // a TRACK_LOADED or TRACK_UNLOADED update and won't access the
+    // preloaded samples of the previous track anymore.
+    void acknowledgeTrackChange() {
+        m_numTrackChangesAcknowledged.fetchAndAddRelease(1);
+        workReady();
+    }
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -170,6 +220,26 @@ class CachingReaderWorker : public EngineWorker {
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    /// Sends a TRACK_LOADED or TRACK_UNLOADED update to the reader
+    void writeTrackChange(const ReaderStatusUpdate& update);
+
+    /// Prepare decoding of the whole track into m_preloadBuffer
+    void startPreload(const TrackPointer& pTrack);
+
+    /// Decode the next slice of the track while preloading. Pending read
+    /// requests are processed in between to keep the latency low until the
+    /// whole track is available.
+    void preloadNextSlice();
+
+    /// Discard the preloaded samples. If they have already been sent to
+    /// the reader the buffer is kept until the reader has acknowledged
+    /// the next track change.
+    void resetPreload();
+
+    /// Free the buffers of previous tracks that are no longer accessed
+    /// by the reader.
+    void releaseRetiredPreloadBuffers();
+
     void verifyFirstSound(const CachingReaderChunk* pChunk,
             mixxx::audio::ChannelCount channelCount);
 
@@ -185,5 +255,32 @@ class CachingReaderWorker : public EngineWorker {
     // The maximum number of channel that this reader can support
     mixxx::audio::ChannelCount m_maxSupportedChannel;
 
+    // The number of frames per chunk of the track loaded
+    SINT m_chunkFrames;
+
+    QAtomicInt m_preloadWholeTrack;
+
+    // Contiguous buffer for all samples of the track, only allocated
+    // while preloading is enabled.
+    mixxx::SampleBuffer m_preloadBuffer;
+    mixxx::audio::ChannelCount m_preloadChannelCount;
+    // The range of frames that have already been decoded
+    mixxx::IndexRange m_preloadedFrameIndexRange;
+    bool m_preloadPending;
+    // The buffer has been sent to the reader
+    bool m_preloadSent;
+
+    // A preload buffer of a previous track that might still be accessed
+    // by the reader until it has acknowledged the given track change.
+    struct RetiredPreloadBuffer {
+        int trackChange;
+        mixxx::SampleBuffer buffer;
+    };
+    std::vector<RetiredPreloadBuffer> m_retiredPreloadBuffers;
+
+    // Track changes that have been sent to and acknowledged by the reader
+    int m_numTrackChangesSent;
+    QAtomicInt m_numTrackChangesAcknowledged;
+
     QAtomicInt m_stop;
 };
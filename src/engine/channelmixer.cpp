@@ -24,30 +24,23 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
     // The original channel input buffers are not modified.
     SampleUtil::clear(pOutput, bufferSize);
     ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsAndMixChannels"));
-    for (auto* pChannelInfo : activeChannels) {
-        EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
-        CSAMPLE_GAIN oldGain = gainCache.m_gain;
-        CSAMPLE_GAIN newGain;
-        bool fadeout = gainCache.m_fadeout ||
-                (pChannelInfo->m_pChannel &&
-                        !pChannelInfo->m_pChannel->isActive());
-        if (fadeout) {
-            newGain = 0;
-            gainCache.m_fadeout = false;
-        } else {
-            newGain = gainCalculator.getGain(pChannelInfo);
-        }
-        gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
+    PostFaderChannels channels;
+    calculateGains(gainCalculator, activeChannels, channelGainCache, &channels);
+    if (pEngineEffectsManager->processPostFaderAndMixInParallel(
+                channels, outputHandle, pOutput, bufferSize, sampleRate, false)) {
+        return;
+    }
+    for (const auto& channel : std::as_const(channels)) {
+        pEngineEffectsManager->processPostFaderAndMix(channel.inputHandle,
                 outputHandle,
-                pChannelInfo->m_pBuffer.data(),
+                channel.pBuffer,
                 pOutput,
                 bufferSize,
                 sampleRate,
-                pChannelInfo->m_features,
-                oldGain,
-                newGain,
-                fadeout);
+                *channel.pGroupFeatures,
+                channel.oldGain,
+                channel.newGain,
+                channel.fadeout);
     }
 }
 
@@ -70,6 +63,31 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
     // 4. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
     ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsInPlaceAndMixChannels"));
     SampleUtil::clear(pOutput, bufferSize);
+    PostFaderChannels channels;
+    calculateGains(gainCalculator, activeChannels, channelGainCache, &channels);
+    if (pEngineEffectsManager->processPostFaderAndMixInParallel(
+                channels, outputHandle, pOutput, bufferSize, sampleRate, true)) {
+        return;
+    }
+    for (const auto& channel : std::as_const(channels)) {
+        pEngineEffectsManager->processPostFaderInPlace(channel.inputHandle,
+                outputHandle,
+                channel.pBuffer,
+                bufferSize,
+                sampleRate,
+                *channel.pGroupFeatures,
+                channel.oldGain,
+                channel.newGain,
+                channel.fadeout);
+        SampleUtil::add(pOutput, channel.pBuffer, bufferSize);
+    }
+}
+
+// static
+void ChannelMixer::calculateGains(const EngineMixer::GainCalculator& gainCalculator,
+        const QVarLengthArray<EngineMixer::ChannelInfo*, kPreallocatedChannels>& activeChannels,
+        QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>* channelGainCache,
+        PostFaderChannels* pChannels) {
     for (auto* pChannelInfo : activeChannels) {
         EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
         CSAMPLE_GAIN oldGain = gainCache.m_gain;
@@ -84,15 +102,12 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
             newGain = gainCalculator.getGain(pChannelInfo);
         }
         gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
-                outputHandle,
+        pChannels->append(EngineEffectsManager::PostFaderChannel{
+                pChannelInfo->m_handle,
                 pChannelInfo->m_pBuffer.data(),
-                bufferSize,
-                sampleRate,
-                pChannelInfo->m_features,
+                &pChannelInfo->m_features,
                 oldGain,
                 newGain,
-                fadeout);
-        SampleUtil::add(pOutput, pChannelInfo->m_pBuffer.data(), bufferSize);
+                fadeout});
     }
 }
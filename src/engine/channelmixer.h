@@ -3,6 +3,7 @@
 #include <QVarLengthArray>
 
 #include "audio/types.h"
+#include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginemixer.h"
 #include "util/types.h"
 
@@ -34,4 +35,16 @@ class ChannelMixer {
             std::size_t bufferSize,
             mixxx::audio::SampleRate sampleRate,
             EngineEffectsManager* pEngineEffectsManager);
+
+  private:
+    typedef QVarLengthArray<EngineEffectsManager::PostFaderChannel, kPreallocatedChannels>
+            PostFaderChannels;
+
+    // Calculates the gains of all channels and updates the gain cache
+    static void calculateGains(const EngineMixer::GainCalculator& gainCalculator,
+            const QVarLengthArray<EngineMixer::ChannelInfo*,
+                    kPreallocatedChannels>& activeChannels,
+            QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>*
+                    channelGainCache,
+            PostFaderChannels* pChannels);
 };
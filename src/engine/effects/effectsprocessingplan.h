@@ -0,0 +1,102 @@
+#pragma once
+
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "effects/defs.h"
+#include "engine/channelhandle.h"
+#include "util/assert.h"
+
+class EngineEffectChain;
+
+constexpr int kNumSignalProcessingStages = 2;
+
+/// An immutable list of the EngineEffectChains that need to be processed
+/// for each SignalProcessingStage and input channel, in processing order.
+///
+/// The lists of all stages and channels are stored in a single array, so
+/// looking up and walking the chains of a channel in the audio thread
+/// neither hashes nor touches any Qt container or disabled chain.
+///
+/// A plan is created in the main thread by EffectsProcessingPlanner
+/// whenever the routing of chains changes and swapped in by the
+/// EngineEffectsManager at the start of a callback.
+class EffectsProcessingPlan final {
+  public:
+    using Chains = std::span<EngineEffectChain* const>;
+    using ChainIndices = std::span<const int>;
+
+    /// An empty plan that does not process any chains
+    EffectsProcessingPlan()
+            : m_numChannels(0),
+              m_numChainIndices(0),
+              m_offsets(1, 0) {
+    }
+
+    /// The chains of the stage and channel with index i are stored at
+    /// chains[offsets[i]] to chains[offsets[i + 1] - 1] where
+    /// i = stage * numChannels + channel. Each chain is identified by
+    /// a dense index in the range [0, numChainIndices) that is stored
+    /// at the same position in chainIndices.
+    EffectsProcessingPlan(int numChannels,
+            int numChainIndices,
+            std::vector<EngineEffectChain*> chains,
+            std::vector<int> chainIndices,
+            std::vector<int> offsets)
+            : m_numChannels(numChannels),
+              m_numChainIndices(numChainIndices),
+              m_chains(std::move(chains)),
+              m_chainIndices(std::move(chainIndices)),
+              m_offsets(std::move(offsets)) {
+        DEBUG_ASSERT(m_chainIndices.size() == m_chains.size());
+        DEBUG_ASSERT(m_offsets.size() ==
+                static_cast<std::size_t>(kNumSignalProcessingStages * m_numChannels + 1));
+    }
+
+    Chains chains(SignalProcessingStage stage, const ChannelHandle& inputHandle) const {
+        const int index = offsetIndex(stage, inputHandle);
+        if (index < 0) {
+            return {};
+        }
+        return Chains(m_chains.data() + m_offsets[index],
+                m_chains.data() + m_offsets[index + 1]);
+    }
+
+    /// The indices of the chains(stage, inputHandle)
+    ChainIndices chainIndices(SignalProcessingStage stage,
+            const ChannelHandle& inputHandle) const {
+        const int index = offsetIndex(stage, inputHandle);
+        if (index < 0) {
+            return {};
+        }
+        return ChainIndices(m_chainIndices.data() + m_offsets[index],
+                m_chainIndices.data() + m_offsets[index + 1]);
+    }
+
+    int numChainIndices() const {
+        return m_numChainIndices;
+    }
+
+    bool isEmpty() const {
+        return m_chains.empty();
+    }
+
+  private:
+    EffectsProcessingPlan(const EffectsProcessingPlan&) = delete;
+    EffectsProcessingPlan& operator=(const EffectsProcessingPlan&) = delete;
+
+    int offsetIndex(SignalProcessingStage stage, const ChannelHandle& inputHandle) const {
+        const int channel = inputHandle.handle();
+        if (channel < 0 || channel >= m_numChannels) {
+            return -1;
+        }
+        return static_cast<int>(stage) * m_numChannels + channel;
+    }
+
+    const int m_numChannels;
+    const int m_numChainIndices;
+    const std::vector<EngineEffectChain*> m_chains;
+    const std::vector<int> m_chainIndices;
+    const std::vector<int> m_offsets;
+};
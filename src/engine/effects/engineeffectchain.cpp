@@ -1,6 +1,7 @@
 #include "engine/effects/engineeffectchain.h"
 
 #include "engine/effects/engineeffect.h"
+#include "engine/engineprofiler.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
@@ -12,7 +13,8 @@ EngineEffectChain::EngineEffectChain(const QString& group,
           m_mixMode(EffectChainMixMode::DrySlashWet),
           m_dMix(0),
           m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+          m_buffer2(kMaxEngineSamples),
+          m_processLatency(QStringLiteral("EngineEffectChain::process %1").arg(group)) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 
@@ -79,9 +81,17 @@ bool EngineEffectChain::updateParameters(const EffectsRequest& message) {
     m_mixMode = message.SetEffectChainParameters.mix_mode;
     m_dMix = static_cast<CSAMPLE>(message.SetEffectChainParameters.mix);
 
-    if (m_enableState != EffectEnableState::Disabled && !message.SetEffectParameters.enabled) {
+    // A fully dry chain is not processed, so its effects are disabled like
+    // those of a disabled chain to flush their state, and are enabled again
+    // when the mix knob is turned up.
+    const bool active = message.SetEffectChainParameters.enabled && m_dMix > 0;
+    if (m_enableState != EffectEnableState::Disabled && !active) {
         m_enableState = EffectEnableState::Disabling;
-    } else if (m_enableState == EffectEnableState::Disabled && message.SetEffectParameters.enabled) {
+    } else if ((m_enableState == EffectEnableState::Disabled ||
+                       m_enableState == EffectEnableState::Disabling) &&
+            active) {
+        // The chain might not have been processed since it was disabled,
+        // if it is not enabled for any input channel.
         m_enableState = EffectEnableState::Enabling;
     }
     return true;
@@ -213,6 +223,8 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
 
     bool processingOccured = false;
     if (effectiveChainEnableState != EffectEnableState::Disabled) {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Effects);
+        mixxx::ScopedLatencyRecorder latency(&m_processLatency);
         // Ramping code inside the effects need to access the original samples
         // after writing to the output buffer. This requires not to use the same buffer
         // for in and output: Also, ChannelMixer::applyEffectsAndMixChannels
@@ -8,6 +8,7 @@
 #include "engine/effects/engineeffectsdelay.h"
 #include "engine/effects/message.h"
 #include "util/class.h"
+#include "util/latencyhistogram.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
 
@@ -74,6 +75,8 @@ class EngineEffectChain final : public EffectsRequestHandler {
     mixxx::SampleBuffer m_buffer2;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
     EngineEffectsDelay m_effectsDelay;
+    // Only records the callbacks that actually processed effects
+    mixxx::LatencyHistogram m_processLatency;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectChain);
 };
@@ -1,19 +1,38 @@
 #include "engine/effects/engineeffectsmanager.h"
 
+#include <QThreadPool>
+#include <algorithm>
+
 #include "audio/types.h"
+#include "engine/effects/effectsprocessingplan.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectstask.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
 EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe&& responsePipe)
         : m_responsePipe(std::move(responsePipe)),
+          m_pProcessingPlan(std::make_unique<EffectsProcessingPlan>()),
           m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+          m_buffer2(kMaxEngineSamples),
+          m_pWorkerPool(nullptr) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 }
 
+EngineEffectsManager::~EngineEffectsManager() = default;
+
+void EngineEffectsManager::setWorkerPool(QThreadPool* pWorkerPool) {
+    m_pWorkerPool = pWorkerPool;
+}
+
+void EngineEffectsManager::reserveParallelChannels(int numChannels) {
+    while (static_cast<int>(m_tasks.size()) < numChannels) {
+        m_tasks.push_back(std::make_unique<EngineEffectsTask>(this));
+    }
+}
+
 void EngineEffectsManager::onCallbackStart() {
     EffectsRequest* request = nullptr;
     while (m_responsePipe.readMessage(&request)) {
@@ -22,6 +41,7 @@ void EngineEffectsManager::onCallbackStart() {
         switch (request->type) {
         case EffectsRequest::ADD_EFFECT_CHAIN:
         case EffectsRequest::REMOVE_EFFECT_CHAIN:
+        case EffectsRequest::SET_PROCESSING_PLAN:
             if (processEffectsRequest(*request, &m_responsePipe)) {
                 processed = true;
             }
@@ -169,69 +189,189 @@ void EngineEffectsManager::processInner(
         CSAMPLE_GAIN oldGain,
         CSAMPLE_GAIN newGain,
         bool fadeout) {
-    const QList<EngineEffectChain*>& chains = m_chainsByStage.value(stage);
+    const bool inPlace = pIn == pOut;
+    const CSAMPLE* pResult = processChains(stage,
+            inputHandle,
+            outputHandle,
+            pIn,
+            inPlace,
+            numSamples,
+            sampleRate,
+            groupFeatures,
+            oldGain,
+            newGain,
+            fadeout,
+            m_buffer1.data(),
+            m_buffer2.data(),
+            nullptr);
+    if (!inPlace) {
+        // ChannelMixer::applyEffectsAndMixChannels use this to mix channels
+        // into pOut regardless of whether any effects were processed.
+        SampleUtil::add(pOut, pResult, numSamples);
+    }
+}
 
-    if (pIn == pOut) {
+const CSAMPLE* EngineEffectsManager::processChains(
+        const SignalProcessingStage stage,
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        CSAMPLE* pIn,
+        bool inPlace,
+        std::size_t numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        const GroupFeatureState& groupFeatures,
+        CSAMPLE_GAIN oldGain,
+        CSAMPLE_GAIN newGain,
+        bool fadeout,
+        CSAMPLE* pScratch1,
+        CSAMPLE* pScratch2,
+        EngineEffectsTask* pTask) {
+    // Only contains the chains that are enabled for the input channel
+    const EffectsProcessingPlan::Chains chains =
+            m_pProcessingPlan->chains(stage, inputHandle);
+    const EffectsProcessingPlan::ChainIndices chainIndices =
+            m_pProcessingPlan->chainIndices(stage, inputHandle);
+
+    const auto waitForTurn = [this, pTask, chainIndices](std::size_t i) {
+        if (pTask) {
+            pTask->waitForTurn(i, chainIndices[i], m_chainTurns[chainIndices[i]]);
+        }
+    };
+    const auto finishTurn = [this, pTask, chainIndices](std::size_t i) {
+        if (pTask) {
+            pTask->finishTurn(i, chainIndices[i], m_chainTurns[chainIndices[i]]);
+        }
+    };
+
+    if (inPlace) {
         // Gain and effects are applied to the buffer in place,
         // modifying the original input buffer
         SampleUtil::applyRampingGain(pIn, oldGain, newGain, numSamples);
-        for (EngineEffectChain* pChain : chains) {
-            if (pChain) {
-                if (pChain->process(inputHandle,
-                            outputHandle,
-                            pIn,
-                            pOut,
-                            numSamples,
-                            sampleRate,
-                            groupFeatures,
-                            fadeout)) {
-                }
-            }
+        for (std::size_t i = 0; i < chains.size(); ++i) {
+            waitForTurn(i);
+            chains[i]->process(inputHandle,
+                    outputHandle,
+                    pIn,
+                    pIn,
+                    numSamples,
+                    sampleRate,
+                    groupFeatures,
+                    fadeout);
+            finishTurn(i);
         }
+        return pIn;
+    }
+
+    // Do not modify the input buffer.
+    // 1. Copy input buffer to a temporary buffer
+    // 2. Apply gain to temporary buffer
+    // 2. Process temporary buffer with each effect chain in series
+    CSAMPLE* pIntermediateInput = pScratch1;
+    if (oldGain == CSAMPLE_GAIN_ONE && newGain == CSAMPLE_GAIN_ONE) {
+        // Avoid an unnecessary copy. EngineEffectChain::process does not modify the
+        // input buffer when its input & output buffers are different, so this is okay.
+        pIntermediateInput = pIn;
     } else {
-        // Do not modify the input buffer.
-        // 1. Copy input buffer to a temporary buffer
-        // 2. Apply gain to temporary buffer
-        // 2. Process temporary buffer with each effect chain in series
-        // 3. Mix the temporary buffer into pOut
-        //    ChannelMixer::applyEffectsAndMixChannels use
-        //    this to mix channels into pOut regardless of whether any effects were processed.
-        CSAMPLE* pIntermediateInput = m_buffer1.data();
-        if (oldGain == CSAMPLE_GAIN_ONE && newGain == CSAMPLE_GAIN_ONE) {
-            // Avoid an unnecessary copy. EngineEffectChain::process does not modify the
-            // input buffer when its input & output buffers are different, so this is okay.
-            pIntermediateInput = pIn;
+        SampleUtil::copyWithRampingGain(pIntermediateInput, pIn, oldGain, newGain, numSamples);
+    }
+
+    CSAMPLE* pIntermediateOutput;
+    for (std::size_t i = 0; i < chains.size(); ++i) {
+        // Select an unused intermediate buffer for the next output
+        if (pIntermediateInput == pScratch1) {
+            pIntermediateOutput = pScratch2;
         } else {
-            SampleUtil::copyWithRampingGain(pIntermediateInput, pIn, oldGain, newGain, numSamples);
+            pIntermediateOutput = pScratch1;
         }
 
-        CSAMPLE* pIntermediateOutput;
-        for (EngineEffectChain* pChain : chains) {
-            if (pChain) {
-                // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
-                } else {
-                    pIntermediateOutput = m_buffer1.data();
-                }
+        waitForTurn(i);
+        const bool processed = chains[i]->process(inputHandle,
+                outputHandle,
+                pIntermediateInput,
+                pIntermediateOutput,
+                numSamples,
+                sampleRate,
+                groupFeatures,
+                fadeout);
+        finishTurn(i);
+        if (processed) {
+            // Output of this chain becomes the input of the next chain.
+            pIntermediateInput = pIntermediateOutput;
+        }
+    }
+    // pIntermediateInput is the output of the last processed chain. It would
+    // be the intermediate input of the next chain if there was one.
+    return pIntermediateInput;
+}
 
-                if (pChain->process(inputHandle,
-                            outputHandle,
-                            pIntermediateInput,
-                            pIntermediateOutput,
-                            numSamples,
-                            sampleRate,
-                            groupFeatures,
-                            fadeout)) {
-                    // Output of this chain becomes the input of the next chain.
-                    pIntermediateInput = pIntermediateOutput;
-                }
+bool EngineEffectsManager::processPostFaderAndMixInParallel(
+        std::span<const PostFaderChannel> channels,
+        const ChannelHandle& outputHandle,
+        CSAMPLE* pOut,
+        std::size_t numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        bool inPlace) {
+    if (!m_pWorkerPool ||
+            channels.size() > m_tasks.size() ||
+            m_pProcessingPlan->numChainIndices() > kMaxParallelChains) {
+        return false;
+    }
+    if (channels.empty()) {
+        return true;
+    }
+
+    // Assign each channel its turn for each of its chains, so that every
+    // chain processes the channels in the same order as the serial path.
+    std::fill_n(m_nextChainTickets.begin(), m_pProcessingPlan->numChainIndices(), 0);
+    std::fill_n(m_pLastChainNextTasks.begin(),
+            m_pProcessingPlan->numChainIndices(),
+            nullptr);
+    for (int i = 0; i < m_pProcessingPlan->numChainIndices(); ++i) {
+        m_chainTurns[i].store(0, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        EngineEffectsTask* pTask = m_tasks[i].get();
+        pTask->set(&channels[i], outputHandle, numSamples, sampleRate, inPlace);
+        int* pChainTickets = pTask->chainTickets();
+        EngineEffectsTask** pNextTasks = pTask->nextTasks();
+        for (const int chainIndex : m_pProcessingPlan->chainIndices(
+                     SignalProcessingStage::Postfader, channels[i].inputHandle)) {
+            // Let the previous task of this chain wake up this one
+            if (m_pLastChainNextTasks[chainIndex]) {
+                *m_pLastChainNextTasks[chainIndex] = pTask;
             }
+            m_pLastChainNextTasks[chainIndex] = pNextTasks;
+            *pNextTasks++ = nullptr;
+            *pChainTickets++ = m_nextChainTickets[chainIndex]++;
         }
-        // pIntermediateInput is the output of the last processed chain. It would
-        // be the intermediate input of the next chain if there was one.
-        SampleUtil::add(pOut, pIntermediateInput, numSamples);
     }
+
+    // Tasks are started in order and only wait for tasks that have been
+    // started before, so running a task in the engine thread if no worker
+    // is available can not deadlock. The engine thread processes the last
+    // channel itself.
+    const std::size_t numTasks = channels.size() - 1;
+    for (std::size_t i = 0; i < numTasks; ++i) {
+        EngineEffectsTask* pTask = m_tasks[i].get();
+        if (m_pProcessingPlan->chains(SignalProcessingStage::Postfader,
+                    channels[i].inputHandle)
+                        .empty() ||
+                !m_pWorkerPool->tryStart(pTask)) {
+            // Only the gain needs to be applied or no worker is available
+            pTask->run();
+        }
+    }
+    m_tasks[numTasks]->run();
+
+    // We always perform a wait, even for tasks that were run in the engine
+    // thread, so it resets the semaphore. Mixing in the order of the channels
+    // sums up the samples in the same order as the serial path.
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        EngineEffectsTask* pTask = m_tasks[i].get();
+        pTask->waitReady();
+        SampleUtil::add(pOut, pTask->result(), numSamples);
+    }
+    return true;
 }
 
 bool EngineEffectsManager::addEffectChain(EngineEffectChain* pChain,
@@ -275,6 +415,20 @@ bool EngineEffectsManager::processEffectsRequest(EffectsRequest& message,
         response.success = removeEffectChain(message.RemoveEffectChain.pChain,
                 message.RemoveEffectChain.signalProcessingStage);
         break;
+    case EffectsRequest::SET_PROCESSING_PLAN: {
+        VERIFY_OR_DEBUG_ASSERT(message.SetProcessingPlan.pPlan) {
+            response.success = false;
+            response.status = EffectsResponse::INVALID_REQUEST;
+            break;
+        }
+        // Swap the plans without allocating. The previous plan is returned
+        // to the main thread with the request and deleted there.
+        EffectsProcessingPlan* pPreviousPlan = m_pProcessingPlan.release();
+        m_pProcessingPlan.reset(message.SetProcessingPlan.pPlan);
+        message.SetProcessingPlan.pPlan = pPreviousPlan;
+        response.success = true;
+        break;
+    }
     default:
         return false;
     }
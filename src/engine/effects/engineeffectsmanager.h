@@ -1,13 +1,22 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
+
 #include "audio/types.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
 
+class EffectsProcessingPlan;
 class EngineEffectChain;
 class EngineEffect;
+class EngineEffectsTask;
+class QThreadPool;
 struct GroupFeatureState;
 
 /// EngineEffectsManager is the entry point for processing effects in the audio
@@ -20,9 +29,30 @@ struct GroupFeatureState;
 ///                                      PFL switch --> QuickEffectChains & StandardEffectChains --> mix channels into headphone mix --> headphone effect processing
 class EngineEffectsManager final : public EffectsRequestHandler {
   public:
+    /// The maximum number of chains for processPostFaderAndMixInParallel()
+    static constexpr int kMaxParallelChains = 256;
+
+    /// A channel that is processed by processPostFaderAndMixInParallel()
+    struct PostFaderChannel {
+        ChannelHandle inputHandle;
+        CSAMPLE* pBuffer;
+        const GroupFeatureState* pGroupFeatures;
+        CSAMPLE_GAIN oldGain;
+        CSAMPLE_GAIN newGain;
+        bool fadeout;
+    };
+
     // passing by rvalue-ref because we want to ensure we're the only on with access to that pipe
     EngineEffectsManager(EffectsResponsePipe&& responsePipe);
-    ~EngineEffectsManager() override = default;
+    ~EngineEffectsManager() override;
+
+    /// Enables processing the postfader effects of multiple channels in
+    /// parallel on the threads of pWorkerPool. Called from the main thread
+    /// before the engine is started.
+    void setWorkerPool(QThreadPool* pWorkerPool);
+    /// Preallocates the tasks for processing numChannels channels in
+    /// parallel. Called from the main thread.
+    void reserveParallelChannels(int numChannels);
 
     void onCallbackStart();
 
@@ -65,11 +95,34 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Process the postfader EngineEffectChains of all channels on the
+    /// threads of the worker pool and mix the results into pOut in the
+    /// order of the channels. The result is bit-identical to calling
+    /// processPostFaderAndMix() (or processPostFaderInPlace() and adding
+    /// the channel buffer to pOut if inPlace is true) for each channel.
+    ///
+    /// A chain that is shared by multiple channels processes them one at
+    /// a time in the order of the channels, because chains and effects keep
+    /// state across channels. Channels that do not share any chains are
+    /// processed concurrently.
+    ///
+    /// Returns false without processing any channel if parallel processing
+    /// is not enabled or not possible for these channels.
+    bool processPostFaderAndMixInParallel(
+            std::span<const PostFaderChannel> channels,
+            const ChannelHandle& outputHandle,
+            CSAMPLE* pOut,
+            std::size_t numSamples,
+            mixxx::audio::SampleRate sampleRate,
+            bool inPlace);
+
     bool processEffectsRequest(
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
 
   private:
+    friend class EngineEffectsTask;
+
     QString debugString() const {
         return QString("EngineEffectsManager");
     }
@@ -96,10 +149,45 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    // Applies the gain and all chains to pIn, using the scratch buffers
+    // unless inPlace is true. Returns the buffer with the result.
+    // If pTask is not nullptr, each chain is only processed after the
+    // number of channels given by the ticket of the task have been
+    // processed by it, see processPostFaderAndMixInParallel().
+    const CSAMPLE* processChains(const SignalProcessingStage stage,
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            CSAMPLE* pIn,
+            bool inPlace,
+            std::size_t numSamples,
+            mixxx::audio::SampleRate sampleRate,
+            const GroupFeatureState& groupFeatures,
+            CSAMPLE_GAIN oldGain,
+            CSAMPLE_GAIN newGain,
+            bool fadeout,
+            CSAMPLE* pScratch1,
+            CSAMPLE* pScratch2,
+            EngineEffectsTask* pTask);
+
     EffectsResponsePipe m_responsePipe;
+    // All chains that have been added, only used for validating requests
     QHash<SignalProcessingStage, QList<EngineEffectChain*>> m_chainsByStage;
+    // The chains that are actually processed, replaced by the EffectsMessenger
+    // whenever chains are enabled or disabled.
+    std::unique_ptr<EffectsProcessingPlan> m_pProcessingPlan;
     QList<EngineEffect*> m_effects;
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    QThreadPool* m_pWorkerPool;
+    std::vector<std::unique_ptr<EngineEffectsTask>> m_tasks;
+    // The number of channels of the current parallel batch that each
+    // chain has processed, indexed by EffectsProcessingPlan::chainIndices()
+    std::array<std::atomic<int>, kMaxParallelChains> m_chainTurns;
+    // Only used by the engine thread to assign the tickets
+    std::array<int, kMaxParallelChains> m_nextChainTickets;
+    // The slot in EngineEffectsTask::nextTasks() of the task that was
+    // assigned the last ticket of each chain, only used by the engine thread
+    std::array<EngineEffectsTask**, kMaxParallelChains> m_pLastChainNextTasks;
 };
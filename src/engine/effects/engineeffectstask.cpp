@@ -0,0 +1,118 @@
+#include "engine/effects/engineeffectstask.h"
+
+#include "util/assert.h"
+#include "util/defs.h"
+
+namespace {
+
+// Number of polls before falling back to a blocking wait
+constexpr int kSpinCount = 4096;
+
+} // anonymous namespace
+
+EngineEffectsTask::EngineEffectsTask(EngineEffectsManager* pEngineEffectsManager)
+        : QRunnable(),
+          m_pEngineEffectsManager(pEngineEffectsManager),
+          m_completedSema(0),
+          m_pChannel(nullptr),
+          m_numSamples(0),
+          m_inPlace(false),
+          m_waitingChainIndex(-1),
+          m_turnSema(0),
+          m_chainTickets(EngineEffectsManager::kMaxParallelChains),
+          m_nextTasks(EngineEffectsManager::kMaxParallelChains, nullptr),
+          m_buffer1(kMaxEngineSamples),
+          m_buffer2(kMaxEngineSamples),
+          m_pResult(nullptr) {
+    DEBUG_ASSERT(m_pEngineEffectsManager);
+    setAutoDelete(false);
+}
+
+void EngineEffectsTask::set(const EngineEffectsManager::PostFaderChannel* pChannel,
+        const ChannelHandle& outputHandle,
+        std::size_t numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        bool inPlace) {
+    DEBUG_ASSERT(m_completedSema.available() == 0);
+    m_pChannel = pChannel;
+    m_outputHandle = outputHandle;
+    m_numSamples = numSamples;
+    m_sampleRate = sampleRate;
+    m_inPlace = inPlace;
+    m_pResult = nullptr;
+}
+
+void EngineEffectsTask::waitReady() {
+    VERIFY_OR_DEBUG_ASSERT(m_pChannel && m_numSamples) {
+        return;
+    };
+    for (int i = 0; i < kSpinCount; ++i) {
+        if (m_completedSema.tryAcquire()) {
+            return;
+        }
+    }
+    m_completedSema.acquire();
+}
+
+void EngineEffectsTask::waitForTurn(std::size_t i,
+        int chainIndex,
+        const std::atomic<int>& turn) {
+    const int ticket = m_chainTickets[i];
+    for (int spin = 0; spin < kSpinCount; ++spin) {
+        if (turn.load(std::memory_order_acquire) == ticket) {
+            return;
+        }
+    }
+    // Block until the previous task has finished its turn. Check the turn
+    // again after announcing it, because it might have finished before.
+    m_waitingChainIndex.store(chainIndex, std::memory_order_seq_cst);
+    if (turn.load(std::memory_order_seq_cst) == ticket) {
+        int expected = chainIndex;
+        if (!m_waitingChainIndex.compare_exchange_strong(
+                    expected, -1, std::memory_order_seq_cst)) {
+            // Consume the wake-up of finishTurn()
+            m_turnSema.acquire();
+        }
+        return;
+    }
+    m_turnSema.acquire();
+    DEBUG_ASSERT(turn.load(std::memory_order_acquire) == ticket);
+}
+
+void EngineEffectsTask::finishTurn(std::size_t i,
+        int chainIndex,
+        std::atomic<int>& turn) {
+    turn.store(m_chainTickets[i] + 1, std::memory_order_seq_cst);
+    EngineEffectsTask* pNextTask = m_nextTasks[i];
+    if (!pNextTask) {
+        return;
+    }
+    // The next task might be blocked on another chain, which must not
+    // wake it up
+    int expected = chainIndex;
+    if (pNextTask->m_waitingChainIndex.compare_exchange_strong(
+                expected, -1, std::memory_order_seq_cst)) {
+        pNextTask->m_turnSema.release();
+    }
+}
+
+void EngineEffectsTask::run() {
+    VERIFY_OR_DEBUG_ASSERT(m_completedSema.available() == 0 && m_pChannel && m_numSamples) {
+        return;
+    };
+    m_pResult = m_pEngineEffectsManager->processChains(SignalProcessingStage::Postfader,
+            m_pChannel->inputHandle,
+            m_outputHandle,
+            m_pChannel->pBuffer,
+            m_inPlace,
+            m_numSamples,
+            m_sampleRate,
+            *m_pChannel->pGroupFeatures,
+            m_pChannel->oldGain,
+            m_pChannel->newGain,
+            m_pChannel->fadeout,
+            m_buffer1.data(),
+            m_buffer2.data(),
+            this);
+    m_completedSema.release();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "audio/types.h"
+#include "engine/effects/engineeffectsmanager.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+// Processes the postfader effects of a single channel on a worker thread
+// for EngineEffectsManager::processPostFaderAndMixInParallel(). The task
+// is owned by EngineEffectsManager and reused for every callback.
+class EngineEffectsTask : public QRunnable {
+  public:
+    explicit EngineEffectsTask(EngineEffectsManager* pEngineEffectsManager);
+
+    /// @brief Submit a new processing task
+    /// @param pChannel The channel to process. Must remain valid till
+    /// waitReady() has returned
+    void set(const EngineEffectsManager::PostFaderChannel* pChannel,
+            const ChannelHandle& outputHandle,
+            std::size_t numSamples,
+            mixxx::audio::SampleRate sampleRate,
+            bool inPlace);
+
+    /// The turn of the channel for each of its chains, in the order of
+    /// EffectsProcessingPlan::chains(). Filled in by EngineEffectsManager
+    /// after set().
+    int* chainTickets() {
+        return m_chainTickets.data();
+    }
+
+    /// The task that takes the turn after this one for each of its chains,
+    /// or nullptr, in the same order as chainTickets()
+    EngineEffectsTask** nextTasks() {
+        return m_nextTasks.data();
+    }
+
+    /// Waits until turn reaches the ticket of the i-th chain. Spins for a
+    /// bounded number of polls before blocking until the previous task
+    /// finishes its turn on that chain.
+    void waitForTurn(std::size_t i, int chainIndex, const std::atomic<int>& turn);
+
+    /// Passes the turn of the i-th chain on to the next task and wakes it
+    /// up if it is blocked in waitForTurn()
+    void finishTurn(std::size_t i, int chainIndex, std::atomic<int>& turn);
+
+    /// The processed samples, valid after waitReady() has returned
+    const CSAMPLE* result() const {
+        return m_pResult;
+    }
+
+    // Wait for the current task to complete. Spins for a short while
+    // before blocking, because the task usually completes within a
+    // fraction of the callback period.
+    void waitReady();
+
+    void run() override;
+
+  private:
+    EngineEffectsManager* const m_pEngineEffectsManager;
+
+    // Whether or not the scheduled job has completed
+    QSemaphore m_completedSema;
+
+    const EngineEffectsManager::PostFaderChannel* m_pChannel;
+    ChannelHandle m_outputHandle;
+    std::size_t m_numSamples;
+    mixxx::audio::SampleRate m_sampleRate;
+    bool m_inPlace;
+
+    // The index of the chain this task is blocked on in waitForTurn(),
+    // or -1. Reset by the task that wakes it up.
+    std::atomic<int> m_waitingChainIndex;
+    QSemaphore m_turnSema;
+
+    std::vector<int> m_chainTickets;
+    std::vector<EngineEffectsTask*> m_nextTasks;
+    mixxx::SampleBuffer m_buffer1;
+    mixxx::SampleBuffer m_buffer2;
+    const CSAMPLE* m_pResult;
+};
@@ -12,6 +12,7 @@
 
 class EngineEffectChain;
 class EngineEffect;
+class EffectsProcessingPlan;
 
 struct EffectsRequest {
     enum MessageType {
@@ -30,6 +31,9 @@ struct EffectsRequest {
         SET_EFFECT_PARAMETERS,
         SET_PARAMETER_PARAMETERS,
 
+        // Messages for EngineEffectsManager
+        SET_PROCESSING_PLAN,
+
         // Must come last.
         NUM_REQUEST_TYPES
     };
@@ -96,6 +100,11 @@ struct EffectsRequest {
         struct {
             int iParameter;
         } SetParameterParameters;
+        struct {
+            // Replaced with the previous plan by the EngineEffectsManager,
+            // which is deleted in the main thread with the request.
+            EffectsProcessingPlan* pPlan;
+        } SetProcessingPlan;
     };
 
     // Used by SET_EFFECT_PARAMETER.
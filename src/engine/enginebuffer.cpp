@@ -19,6 +19,7 @@
 #include "engine/controls/quantizecontrol.h"
 #include "engine/controls/ratecontrol.h"
 #include "engine/enginemixer.h"
+#include "engine/engineprofiler.h"
 #include "engine/readaheadmanager.h"
 #include "engine/sync/enginesync.h"
 #include "engine/sync/synccontrol.h"
@@ -90,6 +91,7 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_iSeekPhaseQueued(0),
           m_iEnableSyncQueued(SYNC_REQUEST_NONE),
           m_iSyncModeQueued(static_cast<int>(SyncMode::Invalid)),
+          m_bSyncRequestsDeferred(false),
           m_bPlayAfterLoading(false),
           m_channelCount(mixxx::kEngineChannelOutputCount),
           m_pCrossfadeBuffer(SampleUtil::alloc(
@@ -263,6 +265,10 @@ EngineBuffer::EngineBuffer(const QString& group,
     m_pScaleST = new EngineBufferScaleST(m_pReadAheadManager);
 #ifdef __RUBBERBAND__
     m_pScaleRB = new EngineBufferScaleRubberBand(m_pReadAheadManager);
+    m_pScaleRB->setPrefetchEnabled(m_pConfig &&
+            m_pConfig->getValue(
+                    ConfigKey(kAppGroup, QStringLiteral("keylock_prefetch")),
+                    false));
 #endif
     slotKeylockEngineChanged(m_pKeylockEngine->get());
     m_pScaleVinyl = m_pScaleLinear;
@@ -452,7 +458,10 @@ void EngineBuffer::readToCrossfadeBuffer(const std::size_t bufferSize) {
     if (!m_bCrossfadeReady) {
         // Read buffer, as if there where no parameter change
         // (Must be called only once per callback)
-        m_pScale->scaleBuffer(m_pCrossfadeBuffer, bufferSize);
+        {
+            EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Scaler);
+            m_pScale->scaleBuffer(m_pCrossfadeBuffer, bufferSize);
+        }
         // Restore the original position that was lost due to scaleBuffer() above
         m_pReadAheadManager->notifySeek(m_playPos.toSamplePos(m_channelCount));
         m_bCrossfadeReady = true;
@@ -877,7 +886,9 @@ void EngineBuffer::processTrackLocked(
     }
 
     // Sync requests can affect rate, so process those first.
-    processSyncRequests();
+    if (!m_bSyncRequestsDeferred) {
+        processSyncRequests();
+    }
 
     // Note: play is also active during cue preview
     bool paused = !m_playButton->toBool();
@@ -1096,7 +1107,16 @@ void EngineBuffer::processTrackLocked(
     // If the buffer is not paused, then scale the audio.
     if (!bCurBufferPaused) {
         // Perform scaling of Reader buffer into buffer.
-        const double framesRead = m_pScale->scaleBuffer(pOutput, bufferSize);
+        double framesRead;
+        {
+            EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Scaler);
+            framesRead = m_pScale->scaleBuffer(pOutput, bufferSize);
+            if (!m_bCrossfadeReady) {
+                // Seeks and parameter changes are crossfaded, otherwise
+                // the scaler may already process the next buffer
+                m_pScale->prefetch(bufferSize);
+            }
+        }
 
         // TODO(XXX): The result framesRead might not be an integer value.
         // Converting to samples here does not make sense. All positional
@@ -1294,6 +1314,21 @@ void EngineBuffer::processSlip(std::size_t bufferSize) {
     }
 }
 
+bool EngineBuffer::isSynchronized() const {
+    return m_pSyncControl->isSynchronized();
+}
+
+void EngineBuffer::processDeferredSyncRequests() {
+    DEBUG_ASSERT(m_bSyncRequestsDeferred);
+    // The pause lock prevents that the track is replaced in the meantime,
+    // see process()
+    bool hasStableTrack = m_pTrackLoaded->toBool() && m_iTrackLoading.loadAcquire() == 0;
+    if (hasStableTrack && m_pause.tryLock()) {
+        processSyncRequests();
+        m_pause.unlock();
+    }
+}
+
 void EngineBuffer::processSyncRequests() {
     SyncRequestQueued enable_request =
             static_cast<SyncRequestQueued>(
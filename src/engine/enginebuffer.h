@@ -136,6 +136,18 @@ class EngineBuffer : public EngineObject {
     void requestEnableSync(bool enabled);
     void requestSyncMode(SyncMode mode);
 
+    /// Returns true if the deck participates in sync lock (not thread-safe)
+    bool isSynchronized() const;
+    /// Channels that are processed in parallel must not access EngineSync,
+    /// so EngineMixer applies the sync mode requests of all decks on the
+    /// engine thread before forking and process() skips them (not thread-safe).
+    void setSyncRequestsDeferred(bool deferred) {
+        m_bSyncRequestsDeferred = deferred;
+    }
+    /// Applies pending sync mode requests under the same conditions as
+    /// process(), i.e. only if a track is loaded and not being replaced.
+    void processDeferredSyncRequests();
+
     // The process methods all run in the audio callback.
     void process(CSAMPLE* pOut, const std::size_t bufferSize) override;
     void processSlip(std::size_t bufferSize);
@@ -463,6 +475,7 @@ class EngineBuffer : public EngineObject {
     QAtomicInt m_iSeekPhaseQueued;
     QAtomicInt m_iEnableSyncQueued;
     QAtomicInt m_iSyncModeQueued;
+    bool m_bSyncRequestsDeferred;
     ControlValueAtomic<QueuedSeek> m_queuedSeek;
     bool m_previousBufferSeek = false;
 
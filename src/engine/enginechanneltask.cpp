@@ -0,0 +1,53 @@
+#include "engine/enginechanneltask.h"
+
+#include "engine/channels/enginechannel.h"
+#include "util/assert.h"
+#include "util/latencyhistogram.h"
+
+namespace {
+
+// Number of polls before falling back to a blocking wait
+constexpr int kSpinCount = 4096;
+
+} // anonymous namespace
+
+EngineChannelTask::EngineChannelTask(
+        EngineChannel* pChannel, mixxx::LatencyHistogram* pLatency)
+        : QRunnable(),
+          m_pChannel(pChannel),
+          m_pLatency(pLatency),
+          m_completedSema(0),
+          m_pOut(nullptr),
+          m_bufferSize(0) {
+    DEBUG_ASSERT(m_pChannel);
+    setAutoDelete(false);
+}
+
+void EngineChannelTask::set(CSAMPLE* pOut, std::size_t bufferSize) {
+    DEBUG_ASSERT(m_completedSema.available() == 0);
+    m_pOut = pOut;
+    m_bufferSize = bufferSize;
+}
+
+void EngineChannelTask::waitReady() {
+    VERIFY_OR_DEBUG_ASSERT(m_pOut && m_bufferSize) {
+        return;
+    };
+    for (int i = 0; i < kSpinCount; ++i) {
+        if (m_completedSema.tryAcquire()) {
+            return;
+        }
+    }
+    m_completedSema.acquire();
+}
+
+void EngineChannelTask::run() {
+    VERIFY_OR_DEBUG_ASSERT(m_completedSema.available() == 0 && m_pOut && m_bufferSize) {
+        return;
+    };
+    {
+        mixxx::ScopedLatencyRecorder latency(m_pLatency);
+        m_pChannel->process(m_pOut, m_bufferSize);
+    }
+    m_completedSema.release();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <cstddef>
+
+#include "util/types.h"
+
+class EngineChannel;
+namespace mixxx {
+class LatencyHistogram;
+} // namespace mixxx
+
+// Processes a single EngineChannel on a thread of EngineChannelWorkerPool.
+// The task is owned by EngineMixer and reused for every callback.
+class EngineChannelTask : public QRunnable {
+  public:
+    /// The processing time is recorded in pLatency, if not nullptr
+    EngineChannelTask(EngineChannel* pChannel, mixxx::LatencyHistogram* pLatency);
+
+    /// @brief Submit a new processing task
+    /// @param pOut The output buffer of the channel. Must remain valid till
+    /// waitReady() has returned
+    /// @param bufferSize the number of samples to process
+    void set(CSAMPLE* pOut, std::size_t bufferSize);
+
+    // Wait for the current task to complete. Spins for a short while
+    // before blocking, because the task usually completes within a
+    // fraction of the callback period.
+    void waitReady();
+
+    void run() override;
+
+  private:
+    EngineChannel* const m_pChannel;
+    mixxx::LatencyHistogram* const m_pLatency;
+
+    // Whether or not the scheduled job has completed
+    QSemaphore m_completedSema;
+
+    CSAMPLE* m_pOut;
+    std::size_t m_bufferSize;
+};
@@ -0,0 +1,59 @@
+#include "engine/enginechannelworkerpool.h"
+
+#include <QSemaphore>
+#include <memory>
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "util/assert.h"
+#include "util/tracerecorder.h"
+
+namespace {
+
+void setRealtimeScheduling() {
+#ifdef __LINUX__
+    // Same as the network clock reference thread. The threads only run
+    // while the engine thread is waiting for them, so they must not be
+    // preempted by non real-time threads.
+    struct sched_param spm = {0};
+    spm.sched_priority = 1;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &spm)) {
+        qWarning() << "EngineChannelWorkerPool: Failed bumping priority";
+    }
+#endif
+}
+
+} // anonymous namespace
+
+EngineChannelWorkerPool::EngineChannelWorkerPool(int numThreads)
+        : QThreadPool() {
+    DEBUG_ASSERT(numThreads > 0);
+    qDebug() << "EngineMixer will use" << numThreads
+             << "worker threads to process channels in parallel";
+
+    setThreadPriority(QThread::TimeCriticalPriority);
+    setMaxThreadCount(numThreads);
+    // Idle threads must never expire, because respawning them would
+    // happen in the audio callback.
+    setExpiryTimeout(-1);
+
+    // Spawn all threads now by blocking each warm-up task until all of
+    // them have been started. The semaphores are shared with the tasks,
+    // because they might still be accessed after this constructor returns.
+    auto pStarted = std::make_shared<QSemaphore>(0);
+    auto pProceed = std::make_shared<QSemaphore>(0);
+    for (int i = 0; i < numThreads; ++i) {
+        start([pStarted, pProceed, i] {
+            setRealtimeScheduling();
+            mixxx::TraceRecorder::registerCurrentThread(
+                    QStringLiteral("EngineChannelWorker %1").arg(i + 1));
+            pStarted->release();
+            pProceed->acquire();
+        });
+    }
+    pStarted->acquire(numThreads);
+    pProceed->release(numThreads);
+}
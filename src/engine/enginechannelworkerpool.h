@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QThreadPool>
+
+// EngineChannelWorkerPool is the pool of worker threads that EngineMixer
+// uses to process independent channels in parallel to the engine thread.
+// All threads are spawned upfront and never expire, so no thread is ever
+// created in the audio callback.
+class EngineChannelWorkerPool : public QThreadPool {
+  public:
+    explicit EngineChannelWorkerPool(int numThreads);
+};
@@ -1,6 +1,7 @@
 #include "engine/enginemixer.h"
 
 #include <memory>
+#include <utility>
 
 #include "audio/types.h"
 #include "control/controlaudiotaperpot.h"
@@ -12,7 +13,9 @@
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginebuffer.h"
+#include "engine/enginechannelworkerpool.h"
 #include "engine/enginedelay.h"
+#include "engine/engineprofiler.h"
 #include "engine/enginetalkoverducking.h"
 #include "engine/enginevumeter.h"
 #include "engine/engineworkerscheduler.h"
@@ -27,6 +30,7 @@
 #include "util/parented_ptr.h"
 #include "util/sample.h"
 #include "util/samplebuffer.h"
+#include "util/tracerecorder.h"
 
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
@@ -34,6 +38,10 @@ const QString kLegacyGroup = QStringLiteral("[Master]");
 const QString kMainGroup = QStringLiteral("[Main]");
 
 const ConfigKey kInternalClockBpmKey{QStringLiteral("[InternalClock]"), QStringLiteral("bpm")};
+const ConfigKey kChannelMultithreadingKey{kAppGroup, QStringLiteral("channel_multithreading")};
+const ConfigKey kEffectsMultithreadingKey{kAppGroup, QStringLiteral("effects_multithreading")};
+
+constexpr int kProfilerReportIntervalMillis = 1000;
 } // namespace
 
 EngineMixer::EngineMixer(UserSettingsPointer pConfig,
@@ -61,6 +69,7 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
           m_talkoverHeadphones(kMaxEngineSamples),
           m_sidechainMix(kMaxEngineSamples),
           m_pWorkerScheduler(make_parented<EngineWorkerScheduler>(this)),
+          m_bProcessChannelsInParallel(false),
           m_pEngineSync(std::make_unique<EngineSync>(pConfig)),
           m_pMainGain(std::make_unique<ControlAudioTaperPot>(
                   ConfigKey(group, "gain"), -14, 14, 0.5)),
@@ -209,6 +218,27 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
     m_pBoothEnabled->setReadOnly();
     m_pHeadphoneEnabled->setReadOnly();
 
+    const bool channelMultithreading = pConfig->getValue(kChannelMultithreadingKey, false);
+    const bool effectsMultithreading = m_pEngineEffectsManager &&
+            pConfig->getValue(kEffectsMultithreadingKey, false);
+    if (channelMultithreading || effectsMultithreading) {
+        // The engine thread processes one of the channels itself instead
+        // of waiting for all workers to complete.
+        const int numThreads = QThread::idealThreadCount() - 1;
+        if (numThreads > 0) {
+            m_pChannelWorkerPool = std::make_unique<EngineChannelWorkerPool>(numThreads);
+            m_bProcessChannelsInParallel = channelMultithreading;
+            if (effectsMultithreading) {
+                m_pEngineEffectsManager->setWorkerPool(m_pChannelWorkerPool.get());
+            }
+        }
+    }
+
+    connect(&m_profilerReportTimer, &QTimer::timeout, this, []() {
+        EngineProfiler::report();
+    });
+    m_profilerReportTimer.start(kProfilerReportIntervalMillis);
+
     // Note: the EQ Rack is set in EffectsManager::setupDefaults();
 }
 
@@ -231,8 +261,13 @@ std::span<const CSAMPLE> EngineMixer::getSidechainBuffer() const {
 }
 
 void EngineMixer::processChannels(std::size_t bufferSize) {
-    // Update internal sync lock rate.
-    m_pEngineSync->onCallbackStart(m_sampleRate, bufferSize);
+    mixxx::ScopedTraceEvent traceEvent("EngineMixer::processChannels");
+    EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Channels);
+    {
+        EngineProfiler::ScopedStage syncStage(EngineProfiler::Stage::Sync);
+        // Update internal sync lock rate.
+        m_pEngineSync->onCallbackStart(m_sampleRate, bufferSize);
+    }
 
     m_activeBusChannels[EngineChannel::LEFT].clear();
     m_activeBusChannels[EngineChannel::CENTER].clear();
@@ -242,6 +277,17 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
     m_activeChannels.clear();
 
     // ScopedTimer timer(QStringLiteral("EngineMixer::processChannels"));
+    if (m_bProcessChannelsInParallel) {
+        EngineProfiler::ScopedStage syncStage(EngineProfiler::Stage::Sync);
+        // Channels that are processed in parallel must not modify the
+        // state of EngineSync. Apply all pending sync requests upfront.
+        for (const auto& pChannelInfo : std::as_const(m_channels)) {
+            EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+            if (pBuffer) {
+                pBuffer->processDeferredSyncRequests();
+            }
+        }
+    }
     EngineChannel* pLeaderChannel = m_pEngineSync->getLeaderChannel();
     // Reserve the first place for the main channel which
     // should be processed first
@@ -319,19 +365,24 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        auto& pChannel = pChannelInfo->m_pChannel;
-        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
-        pChannel->process(pChannelInfo->m_pBuffer.data(), bufferSize);
+    if (m_bProcessChannelsInParallel) {
+        processChannelsInParallel(activeChannelsStartIndex, bufferSize);
+    } else {
+        for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
+            processChannel(m_activeChannels[i], bufferSize);
+        }
+    }
 
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
+            ChannelInfo* pChannelInfo = m_activeChannels[i];
             GroupFeatureState features;
-            pChannel->collectFeatures(&features);
+            pChannelInfo->m_pChannel->collectFeatures(&features);
             pChannelInfo->m_features = features;
         }
     }
+    EngineProfiler::ScopedStage syncStage(EngineProfiler::Stage::Sync);
     // Do internal sync lock post-processing before the other
     // channels.
     // Note, because we call this on the internal clock first,
@@ -358,15 +409,67 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
             });
 }
 
+void EngineMixer::processChannel(ChannelInfo* pChannelInfo, std::size_t bufferSize) {
+    mixxx::ScopedTraceEvent traceEvent("EngineMixer::processChannel");
+    DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
+    auto& pChannel = pChannelInfo->m_pChannel;
+    mixxx::ScopedLatencyRecorder latency(pChannelInfo->m_pProcessLatency.get());
+    pChannel->process(pChannelInfo->m_pBuffer.data(), bufferSize);
+}
+
+void EngineMixer::processChannelsInParallel(
+        int activeChannelsStartIndex, std::size_t bufferSize) {
+    // The sync leader and all synchronized decks depend on each other
+    // through EngineSync. They are processed on the engine thread in
+    // order, before all remaining channels are processed in parallel.
+    QVarLengthArray<ChannelInfo*, kPreallocatedChannels> independentChannels;
+    for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        const EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+        if (i == 0 || (pBuffer && pBuffer->isSynchronized())) {
+            processChannel(pChannelInfo, bufferSize);
+        } else {
+            independentChannels.append(pChannelInfo);
+        }
+    }
+    if (independentChannels.isEmpty()) {
+        return;
+    }
+
+    // The engine thread processes the last channel itself
+    const int numTasks = independentChannels.size() - 1;
+    for (int i = 0; i < numTasks; ++i) {
+        ChannelInfo* pChannelInfo = independentChannels[i];
+        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
+        EngineChannelTask* pTask = pChannelInfo->m_pProcessTask.get();
+        pTask->set(pChannelInfo->m_pBuffer.data(), bufferSize);
+        // We try to get the channel processed by the pool if there is a
+        // worker available
+        if (!m_pChannelWorkerPool->tryStart(pTask)) {
+            // Otherwise the engine thread takes care of it
+            pTask->run();
+        }
+    }
+    processChannel(independentChannels.last(), bufferSize);
+    // We always perform a wait, even for tasks that were run in the engine
+    // thread, so it resets the semaphore
+    for (int i = 0; i < numTasks; ++i) {
+        independentChannels[i]->m_pProcessTask->waitReady();
+    }
+}
+
 void EngineMixer::process(const std::size_t bufferSize) {
     DEBUG_ASSERT(bufferSize <= static_cast<int>(kMaxEngineSamples));
 
     static bool haveSetName = false;
     if (!haveSetName) {
         QThread::currentThread()->setObjectName("Engine");
+        mixxx::TraceRecorder::registerCurrentThread(QStringLiteral("Engine"));
         haveSetName = true;
     }
     // Trace t("EngineMixer::process");
+    mixxx::ScopedTraceEvent traceEvent("EngineMixer::process");
+    EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Mixing);
 
     bool mainEnabled = m_pMainEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
@@ -716,6 +819,8 @@ void EngineMixer::process(const std::size_t bufferSize) {
 
                     // Copy the main mix to a separate buffer before delaying it
                     // to avoid delaying the main output.
+                    EngineProfiler::ScopedStage sidechainStage(
+                            EngineProfiler::Stage::Sidechain);
                     m_pLatencyCompensationDelay->process(m_sidechainMix.data(), bufferSize);
                     SampleUtil::add(m_sidechainMix.data(), m_talkover.data(), bufferSize);
                 }
@@ -730,6 +835,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
         // EngineSideChain::receiveBuffer has copied the input buffer to m_pSidechainMix
         // via before (called by SoundManager::pushInputBuffers())
         if (m_pEngineSideChain) {
+            EngineProfiler::ScopedStage sidechainStage(EngineProfiler::Stage::Sidechain);
             m_pEngineSideChain->writeSamples(m_sidechainMix.data(), iFrames);
         }
 
@@ -865,6 +971,13 @@ void EngineMixer::addChannel(std::unique_ptr<EngineChannel> pChannel) {
     pChannelInfo->m_pMuteControl->setButtonMode(mixxx::control::ButtonMode::PowerWindow);
     pChannelInfo->m_pBuffer = mixxx::SampleBuffer(kMaxEngineSamples);
     pChannelInfo->m_pBuffer.clear();
+    pChannelInfo->m_pProcessLatency = std::make_unique<mixxx::LatencyHistogram>(
+            QStringLiteral("EngineChannel::process %1").arg(group));
+    if (m_bProcessChannelsInParallel) {
+        pChannelInfo->m_pProcessTask = std::make_unique<EngineChannelTask>(
+                pChannelInfo->m_pChannel.get(),
+                pChannelInfo->m_pProcessLatency.get());
+    }
     EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
     m_channels.append(std::move(pChannelInfo));
     constexpr GainCache gainCacheDefault = {0, false};
@@ -881,9 +994,13 @@ void EngineMixer::addChannel(std::unique_ptr<EngineChannel> pChannel) {
     m_activeBusChannels[EngineChannel::RIGHT].reserve(m_channels.size());
     m_activeHeadphoneChannels.reserve(m_channels.size());
     m_activeTalkoverChannels.reserve(m_channels.size());
+    if (m_pEngineEffectsManager) {
+        m_pEngineEffectsManager->reserveParallelChannels(m_channels.size());
+    }
 
     if (pBuffer != nullptr) {
         pBuffer->bindWorkers(m_pWorkerScheduler);
+        pBuffer->setSyncRequestsDeferred(m_bProcessChannelsInParallel);
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QObject>
+#include <QTimer>
 #include <QVarLengthArray>
 #include <atomic>
 #include <gsl/pointers>
@@ -12,16 +13,19 @@
 #include "engine/channelhandle.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/groupfeaturestate.h"
+#include "engine/enginechanneltask.h"
 #include "engine/engineobject.h"
 #include "preferences/usersettings.h"
 #include "recording/recordingmanager.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
+#include "util/latencyhistogram.h"
 #include "util/parented_ptr.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
 
 class EngineWorkerScheduler;
+class EngineChannelWorkerPool;
 class EngineVuMeter;
 class ControlPotmeter;
 class ControlPushButton;
@@ -119,6 +123,9 @@ class EngineMixer : public QObject, public AudioSource {
         std::unique_ptr<ControlObject> m_pVolumeControl{nullptr};
         std::unique_ptr<ControlPushButton> m_pMuteControl{nullptr};
         GroupFeatureState m_features{};
+        // Only allocated if channels are processed in parallel
+        std::unique_ptr<EngineChannelTask> m_pProcessTask{nullptr};
+        std::unique_ptr<mixxx::LatencyHistogram> m_pProcessLatency{nullptr};
         int m_index;
     };
 
@@ -254,6 +261,10 @@ class EngineMixer : public QObject, public AudioSource {
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(std::size_t bufferSize);
+    void processChannel(ChannelInfo* pChannelInfo, std::size_t bufferSize);
+    // Forks the processing of all active channels that neither are the sync
+    // leader nor synchronized to worker threads and joins them afterwards.
+    void processChannelsInParallel(int activeChannelsStartIndex, std::size_t bufferSize);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMainEffects(std::size_t bufferSize);
@@ -291,6 +302,11 @@ class EngineMixer : public QObject, public AudioSource {
     mixxx::SampleBuffer m_sidechainMix;
 
     parented_ptr<EngineWorkerScheduler> m_pWorkerScheduler;
+    // Periodically logs xruns and publishes the stage timings of the engine
+    QTimer m_profilerReportTimer;
+    // Only set if the parallel processing of channels or effects is enabled
+    std::unique_ptr<EngineChannelWorkerPool> m_pChannelWorkerPool;
+    bool m_bProcessChannelsInParallel;
     std::unique_ptr<EngineSync> m_pEngineSync;
 
     std::unique_ptr<ControlObject> m_pMainGain;
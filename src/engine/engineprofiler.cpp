@@ -0,0 +1,251 @@
+#include "engine/engineprofiler.h"
+
+#include <QHash>
+#include <QStringList>
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "util/assert.h"
+#include "util/latencyhistogram.h"
+#include "util/logger.h"
+#include "util/stat.h"
+#include "util/statsmanager.h"
+#include "util/time.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineProfiler");
+
+constexpr int kNumStages = EngineProfiler::kNumStages;
+constexpr int kNumRecordedCallbacks = EngineProfiler::kNumRecordedCallbacks;
+
+struct CallbackRecord {
+    qint64 budgetNanos;
+    qint64 totalNanos;
+    std::array<qint64, kNumStages> stageNanos;
+};
+
+class Histograms {
+  public:
+    Histograms()
+            : callback(QStringLiteral("EngineProfiler callback")) {
+        for (int i = 0; i < kNumStages; ++i) {
+            stages[i] = std::make_unique<mixxx::LatencyHistogram>(
+                    QStringLiteral("EngineProfiler %1")
+                            .arg(EngineProfiler::stageName(
+                                    static_cast<EngineProfiler::Stage>(i))));
+        }
+    }
+
+    mixxx::LatencyHistogram callback;
+    std::array<std::unique_ptr<mixxx::LatencyHistogram>, kNumStages> stages;
+};
+
+Histograms s_histograms;
+
+// Accumulated by all engine threads during a callback
+std::array<std::atomic<qint64>, kNumStages> s_stageNanos{};
+
+thread_local EngineProfiler::ScopedStage* t_pCurrentStage = nullptr;
+
+// Only accessed by the thread of the clock reference device
+PerformanceTimer s_callbackTimer;
+qint64 s_budgetNanos = 0;
+std::array<CallbackRecord, kNumRecordedCallbacks> s_callbacks{};
+int s_nextCallback = 0;
+int s_numCallbacks = 0;
+
+// Read by worker threads
+std::atomic<qint64> s_callbackDeadlineNanos{0};
+
+// Written by the audio thread while s_snapshotReady is false and
+// read by the reporting thread while it is true.
+std::array<CallbackRecord, kNumRecordedCallbacks> s_snapshot{};
+int s_snapshotSize = 0;
+std::atomic<bool> s_snapshotRequested{false};
+std::atomic<bool> s_snapshotReady{false};
+
+// Only accessed by the reporting thread
+QHash<QString, mixxx::LatencyHistogram::Snapshot> s_publishedSnapshots;
+
+QString formatMicros(qint64 nanos) {
+    return QString::number(nanos / 1000).rightJustified(7);
+}
+
+void logSnapshot() {
+    QStringList header;
+    header << QStringLiteral("budget").rightJustified(7)
+           << QStringLiteral("total").rightJustified(7);
+    for (int i = 0; i < kNumStages; ++i) {
+        header << EngineProfiler::stageName(static_cast<EngineProfiler::Stage>(i))
+                          .rightJustified(9);
+    }
+    kLogger.warning()
+            << "Audio buffer underflow, stage times of the last"
+            << s_snapshotSize << "callbacks in us, oldest first:";
+    kLogger.warning().noquote() << header.join(' ');
+    for (int i = 0; i < s_snapshotSize; ++i) {
+        const CallbackRecord& record = s_snapshot[i];
+        QStringList line;
+        line << formatMicros(record.budgetNanos)
+             << formatMicros(record.totalNanos);
+        int slowestStage = 0;
+        for (int j = 0; j < kNumStages; ++j) {
+            line << QStringLiteral("  ") + formatMicros(record.stageNanos[j]);
+            if (record.stageNanos[j] > record.stageNanos[slowestStage]) {
+                slowestStage = j;
+            }
+        }
+        if (record.totalNanos > record.budgetNanos) {
+            line << QStringLiteral("overload:") +
+                            EngineProfiler::stageName(
+                                    static_cast<EngineProfiler::Stage>(slowestStage));
+        }
+        kLogger.warning().noquote() << line.join(' ');
+    }
+}
+
+void publishStats() {
+    const Stat::ComputeFlags flags = Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX;
+    mixxx::LatencyHistogram::forEachInstance([flags](const mixxx::LatencyHistogram& histogram) {
+        const auto snapshot = histogram.snapshot();
+        auto interval = snapshot;
+        const auto it = s_publishedSnapshots.constFind(histogram.name());
+        // A histogram with the same name might have been recreated
+        if (it != s_publishedSnapshots.constEnd() && it->count() <= snapshot.count()) {
+            interval = snapshot.since(*it);
+        }
+        s_publishedSnapshots.insert(histogram.name(), snapshot);
+        if (interval.count() == 0) {
+            return;
+        }
+        Stat::track(histogram.name() + QStringLiteral(" p50"),
+                Stat::DURATION_NANOSEC,
+                flags,
+                static_cast<double>(interval.valueAtPercentile(50)));
+        Stat::track(histogram.name() + QStringLiteral(" p99"),
+                Stat::DURATION_NANOSEC,
+                flags,
+                static_cast<double>(interval.valueAtPercentile(99)));
+        Stat::track(histogram.name() + QStringLiteral(" max"),
+                Stat::DURATION_NANOSEC,
+                flags,
+                static_cast<double>(interval.maxValue()));
+    });
+}
+
+} // anonymous namespace
+
+//static
+QString EngineProfiler::stageName(Stage stage) {
+    switch (stage) {
+    case Stage::Input:
+        return QStringLiteral("input");
+    case Stage::Mixing:
+        return QStringLiteral("mixing");
+    case Stage::Channels:
+        return QStringLiteral("channels");
+    case Stage::Sync:
+        return QStringLiteral("sync");
+    case Stage::Scaler:
+        return QStringLiteral("scaler");
+    case Stage::Effects:
+        return QStringLiteral("effects");
+    case Stage::Sidechain:
+        return QStringLiteral("sidechain");
+    case Stage::Output:
+        return QStringLiteral("output");
+    }
+    DEBUG_ASSERT(!"unknown stage");
+    return QString();
+}
+
+//static
+void EngineProfiler::beginCallback(qint64 budgetNanos) {
+    // Discard anything that has been measured outside of a callback
+    for (auto& nanos : s_stageNanos) {
+        nanos.store(0, std::memory_order_relaxed);
+    }
+    s_budgetNanos = budgetNanos;
+    s_callbackTimer.start();
+    s_callbackDeadlineNanos.store(
+            mixxx::Time::elapsed().toIntegerNanos() + budgetNanos,
+            std::memory_order_relaxed);
+}
+
+//static
+void EngineProfiler::endCallback() {
+    if (!s_callbackTimer.running()) {
+        return;
+    }
+    CallbackRecord& record = s_callbacks[s_nextCallback];
+    record.budgetNanos = s_budgetNanos;
+    record.totalNanos = s_callbackTimer.elapsed().toIntegerNanos();
+    s_histograms.callback.record(record.totalNanos);
+    for (int i = 0; i < kNumStages; ++i) {
+        const qint64 nanos = s_stageNanos[i].exchange(0, std::memory_order_relaxed);
+        record.stageNanos[i] = nanos;
+        s_histograms.stages[i]->record(nanos);
+    }
+    s_nextCallback = (s_nextCallback + 1) % kNumRecordedCallbacks;
+    if (s_numCallbacks < kNumRecordedCallbacks) {
+        ++s_numCallbacks;
+    }
+
+    if (s_snapshotRequested.load(std::memory_order_relaxed) &&
+            !s_snapshotReady.load(std::memory_order_acquire)) {
+        // Copy the recorded callbacks, oldest first
+        const int first = (s_nextCallback - s_numCallbacks + kNumRecordedCallbacks) %
+                kNumRecordedCallbacks;
+        for (int i = 0; i < s_numCallbacks; ++i) {
+            s_snapshot[i] = s_callbacks[(first + i) % kNumRecordedCallbacks];
+        }
+        s_snapshotSize = s_numCallbacks;
+        s_snapshotRequested.store(false, std::memory_order_relaxed);
+        s_snapshotReady.store(true, std::memory_order_release);
+    }
+}
+
+//static
+qint64 EngineProfiler::callbackDeadlineNanos() {
+    return s_callbackDeadlineNanos.load(std::memory_order_relaxed);
+}
+
+//static
+void EngineProfiler::addStageTime(Stage stage, qint64 nanos) {
+    s_stageNanos[static_cast<int>(stage)].fetch_add(nanos, std::memory_order_relaxed);
+}
+
+//static
+void EngineProfiler::requestSnapshot() {
+    s_snapshotRequested.store(true, std::memory_order_relaxed);
+}
+
+//static
+void EngineProfiler::report() {
+    if (s_snapshotReady.load(std::memory_order_acquire)) {
+        logSnapshot();
+        s_snapshotReady.store(false, std::memory_order_release);
+    }
+    if (StatsManager::s_bStatsManagerEnabled) {
+        publishStats();
+    }
+}
+
+EngineProfiler::ScopedStage::ScopedStage(Stage stage)
+        : m_stage(stage),
+          m_pParent(t_pCurrentStage),
+          m_childNanos(0) {
+    t_pCurrentStage = this;
+    m_timer.start();
+}
+
+EngineProfiler::ScopedStage::~ScopedStage() {
+    const qint64 nanos = m_timer.elapsed().toIntegerNanos();
+    addStageTime(m_stage, nanos - m_childNanos);
+    if (m_pParent) {
+        m_pParent->m_childNanos += nanos;
+    }
+    t_pCurrentStage = m_pParent;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+#include "util/performancetimer.h"
+
+/// Always-on timing of the stages of the audio callback, which allows
+/// to attribute buffer underflows (xruns) to the stage that overran.
+///
+/// The time spent in each stage is accumulated during a callback and
+/// recorded into a LatencyHistogram per stage when the callback ends.
+/// Stages measure exclusive time, i.e. a nested stage on the same
+/// thread is not counted by the enclosing stage. Time spent in worker
+/// threads is added to the corresponding stage, while the engine thread
+/// waiting for the workers is counted as part of the Channels stage.
+///
+/// The stage times of the most recent callbacks are kept in a ring
+/// buffer. After an xrun this buffer is frozen and later logged by
+/// report(), which also publishes percentiles of all LatencyHistograms
+/// in the StatsManager, e.g. for the developer tools.
+///
+/// Except for report() all functions are lock-free and allocation-free.
+class EngineProfiler final {
+  public:
+    enum class Stage {
+        // Reading from sound card inputs
+        Input = 0,
+        // Mixing the main, headphone, talkover and booth outputs
+        Mixing,
+        // Processing the channels, not including the following stages
+        Channels,
+        // Updating EngineSync before and after processing the channels
+        Sync,
+        // Time stretching and resampling, e.g. with RubberBand
+        Scaler,
+        // Processing of all EngineEffectChains
+        Effects,
+        // Submitting the record/broadcast mix
+        Sidechain,
+        // Writing to sound card outputs
+        Output,
+    };
+    static constexpr int kNumStages = static_cast<int>(Stage::Output) + 1;
+    static constexpr int kNumRecordedCallbacks = 64;
+
+    static QString stageName(Stage stage);
+
+    /// Called by the clock reference device at the start of the
+    /// callback with the duration of the processed buffer.
+    static void beginCallback(qint64 budgetNanos);
+    static void endCallback();
+
+    /// The time when the budget of the current callback runs out, see
+    /// mixxx::Time::elapsed(). 0 before the first callback. Can be read
+    /// from any thread, e.g. to account work that missed the deadline.
+    static qint64 callbackDeadlineNanos();
+
+    static void addStageTime(Stage stage, qint64 nanos);
+
+    /// Freezes the recorded callbacks at the end of the current callback
+    /// until they have been logged. Only sets a flag.
+    static void requestSnapshot();
+
+    /// Logs a pending snapshot and publishes the histograms in the
+    /// StatsManager. Must be called periodically from a non real-time
+    /// thread.
+    static void report();
+
+    /// Measures the exclusive time of the enclosing scope for a stage.
+    class ScopedStage final {
+      public:
+        explicit ScopedStage(Stage stage);
+        ~ScopedStage();
+
+      private:
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+
+        const Stage m_stage;
+        ScopedStage* const m_pParent;
+        qint64 m_childNanos;
+        PerformanceTimer m_timer;
+    };
+};
@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <type_traits>
 
 #define MIXXX
 #include <fidlib.h>
@@ -36,9 +37,15 @@ class EngineFilterIIRBase : public EngineObjectConstIn {
 // length of the 3rd argument to fid_design_coef
 #define FIDSPEC_LENGTH 40
 
+template<unsigned int SIZE, enum IIRPass PASS, int NUM_FILTERS>
+class EngineFilterIIRBank;
+
 template<unsigned int SIZE, enum IIRPass PASS>
 class EngineFilterIIR : public EngineFilterIIRBase {
   public:
+    static constexpr unsigned int kSize = SIZE;
+    static constexpr enum IIRPass kPass = PASS;
+
     EngineFilterIIR()
             : m_doRamping(false),
               m_doStart(false),
@@ -291,7 +298,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    // The kernels are generic over the value type, so that
+    // EngineFilterIIRBank can run them on several lanes at once
+    template<typename T>
+    static inline T processSample(const T* coef, T* buf, std::type_identity_t<T> val);
     inline void pauseFilterInner() {
         // Set the current buffers to 0
         memset(m_buf1, 0, sizeof(m_buf1));
@@ -320,13 +330,16 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     bool m_doStart;
     // Flag set to true if this is a chained filter
     bool m_startFromDry;
+
+    template<unsigned int, enum IIRPass, int>
+    friend class EngineFilterIIRBank;
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -337,10 +350,10 @@ inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_BP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = -tmp;
@@ -351,10 +364,10 @@ inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -365,10 +378,10 @@ inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -384,10 +397,10 @@ inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_BP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -414,10 +427,10 @@ inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir= val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -433,10 +446,10 @@ inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_LP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -463,10 +476,10 @@ inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<16, IIR_BP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
@@ -515,10 +528,10 @@ inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_HP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -546,10 +559,10 @@ inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<5, IIR_BP>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = coef[2] * tmp;
@@ -560,10 +573,10 @@ inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LPMO>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= tmp;
@@ -586,10 +599,10 @@ inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HPMO>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= -tmp;
@@ -611,10 +624,10 @@ inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP2>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -632,10 +645,10 @@ inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP2>::processSample(
+        const T* coef, T* buf, std::type_identity_t<T> val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * -coef[0]; // swap gain to be in phase with LP2
     iir -= coef[1] * tmp; fir = -tmp;
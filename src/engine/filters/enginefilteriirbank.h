@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "engine/filters/enginefilteriir.h"
+#include "util/types.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ENGINE_FILTER_IIR_BANK_VECTORIZED 1
+#else
+#define ENGINE_FILTER_IIR_BANK_VECTORIZED 0
+#endif
+
+#if ENGINE_FILTER_IIR_BANK_VECTORIZED
+// The number of doubles in a native vector register
+#if defined(__AVX__)
+constexpr int kEngineFilterIIRNativeLanes = 4;
+#else
+constexpr int kEngineFilterIIRNativeLanes = 2;
+#endif
+
+/// A vector of doubles, one per SIMD lane. The lanes map to a native vector
+/// type of the compiler, which emits SSE2, AVX or NEON instructions for the
+/// lane-wise arithmetic without any platform specific code.
+template<int LANES>
+struct EngineFilterIIRLanes {
+    static_assert((LANES & (LANES - 1)) == 0, "LANES must be a power of two");
+    typedef double Vector __attribute__((vector_size(LANES * sizeof(double))));
+
+    friend EngineFilterIIRLanes operator+(
+            const EngineFilterIIRLanes& a, const EngineFilterIIRLanes& b) {
+        return {a.v + b.v};
+    }
+
+    friend EngineFilterIIRLanes operator-(
+            const EngineFilterIIRLanes& a, const EngineFilterIIRLanes& b) {
+        return {a.v - b.v};
+    }
+
+    friend EngineFilterIIRLanes operator*(
+            const EngineFilterIIRLanes& a, const EngineFilterIIRLanes& b) {
+        return {a.v * b.v};
+    }
+
+    friend EngineFilterIIRLanes operator-(const EngineFilterIIRLanes& a) {
+        return {-a.v};
+    }
+
+    EngineFilterIIRLanes& operator+=(const EngineFilterIIRLanes& other) {
+        v += other.v;
+        return *this;
+    }
+
+    EngineFilterIIRLanes& operator-=(const EngineFilterIIRLanes& other) {
+        v -= other.v;
+        return *this;
+    }
+
+    Vector v;
+};
+#endif
+
+/// Processes several stereo EngineFilterIIR filters of the same kind in
+/// parallel SIMD lanes. Each filter occupies two lanes, one per channel.
+/// The coefficients and the state are transposed into struct-of-arrays
+/// layout, i.e. one EngineFilterIIRLanes per coefficient and state
+/// variable, and the filters run the same kernel as in
+/// EngineFilterIIR::process().
+///
+/// The filters keep owning their state. It is loaded into the lanes at the
+/// start of process() and stored back at the end, so the filters can be
+/// used with and without the bank interchangeably. A filter that needs to
+/// ramp after a change of its coefficients, or is paused, is processed
+/// by EngineFilterIIR::process() instead.
+///
+/// If the lanes do not fit into a native vector register, e.g. two filters
+/// without AVX, each filter is processed in a separate pass. Without native
+/// vector types, i.e. with MSVC, the filters are processed by
+/// EngineFilterIIR::process(), because emulated lanes are slower than the
+/// scalar kernel.
+template<unsigned int SIZE, enum IIRPass PASS, int NUM_FILTERS>
+class EngineFilterIIRBank {
+  public:
+    static constexpr int kNumLanes = 2 * NUM_FILTERS;
+    using Filter = EngineFilterIIR<SIZE, PASS>;
+
+    EngineFilterIIRBank() = delete;
+
+    /// Same as calling pFilters[i]->process(pIn[i], pOutput[i], bufferSize)
+    /// for each filter. The input and output of a filter may be the same
+    /// buffer.
+    static void process(
+            const std::array<Filter*, NUM_FILTERS>& pFilters,
+            const std::array<const CSAMPLE*, NUM_FILTERS>& pIn,
+            const std::array<CSAMPLE*, NUM_FILTERS>& pOutput,
+            std::size_t bufferSize) {
+#if ENGINE_FILTER_IIR_BANK_VECTORIZED
+        bool ramping = false;
+        for (const Filter* pFilter : pFilters) {
+            ramping |= pFilter->m_doRamping;
+        }
+        if (!ramping) {
+            if constexpr (kNumLanes > kEngineFilterIIRNativeLanes) {
+                // Wider vectors would be emulated, run one pass per filter
+                for (int f = 0; f < NUM_FILTERS; ++f) {
+                    EngineFilterIIRBank<SIZE, PASS, 1>::process(
+                            {pFilters[f]}, {pIn[f]}, {pOutput[f]}, bufferSize);
+                }
+            } else {
+                processLanes(pFilters, pIn, pOutput, bufferSize);
+            }
+            return;
+        }
+#endif
+        for (int f = 0; f < NUM_FILTERS; ++f) {
+            pFilters[f]->process(pIn[f], pOutput[f], bufferSize);
+        }
+    }
+
+#if ENGINE_FILTER_IIR_BANK_VECTORIZED
+  private:
+    using Lanes = EngineFilterIIRLanes<kNumLanes>;
+
+    static void processLanes(
+            const std::array<Filter*, NUM_FILTERS>& pFilters,
+            const std::array<const CSAMPLE*, NUM_FILTERS>& pIn,
+            const std::array<CSAMPLE*, NUM_FILTERS>& pOutput,
+            std::size_t bufferSize) {
+        // Gathered lane by lane into plain arrays, because partial writes
+        // to a vector are read-modify-write operations
+        double coefLanes[SIZE + 1][kNumLanes];
+        double bufLanes[SIZE][kNumLanes];
+        for (int f = 0; f < NUM_FILTERS; ++f) {
+            for (unsigned int k = 0; k < SIZE + 1; ++k) {
+                coefLanes[k][2 * f] = pFilters[f]->m_coef[k];
+                coefLanes[k][2 * f + 1] = pFilters[f]->m_coef[k];
+            }
+            for (unsigned int k = 0; k < SIZE; ++k) {
+                bufLanes[k][2 * f] = pFilters[f]->m_buf1[k];
+                bufLanes[k][2 * f + 1] = pFilters[f]->m_buf2[k];
+            }
+        }
+        Lanes coef[SIZE + 1];
+        Lanes buf[SIZE];
+        std::memcpy(coef, coefLanes, sizeof(coef));
+        std::memcpy(buf, bufLanes, sizeof(buf));
+
+        for (std::size_t i = 0; i < bufferSize; i += 2) {
+            double in[kNumLanes];
+            for (int f = 0; f < NUM_FILTERS; ++f) {
+                in[2 * f] = pIn[f][i];
+                in[2 * f + 1] = pIn[f][i + 1];
+            }
+            Lanes val;
+            std::memcpy(&val, in, sizeof(val));
+            val = Filter::processSample(coef, buf, val);
+            for (int f = 0; f < NUM_FILTERS; ++f) {
+                pOutput[f][i] = static_cast<CSAMPLE>(val.v[2 * f]);
+                pOutput[f][i + 1] = static_cast<CSAMPLE>(val.v[2 * f + 1]);
+            }
+        }
+
+        std::memcpy(bufLanes, buf, sizeof(buf));
+        for (int f = 0; f < NUM_FILTERS; ++f) {
+            for (unsigned int k = 0; k < SIZE; ++k) {
+                pFilters[f]->m_buf1[k] = bufLanes[k][2 * f];
+                pFilters[f]->m_buf2[k] = bufLanes[k][2 * f + 1];
+            }
+        }
+    }
+#endif
+};
@@ -235,7 +235,7 @@ void ReadAheadManager::hintReader(double dRate,
 
     // SoundTouch can read up to 2 chunks ahead. Always keep 2 chunks ahead in
     // cache.
-    SINT frameCountToCache = 2 * CachingReaderChunk::kFrames;
+    SINT frameCountToCache = 2 * CachingReaderChunk::kDefaultFrames;
     current_position.frameCount = frameCountToCache;
 
     // this called after the precious chunk was consumed
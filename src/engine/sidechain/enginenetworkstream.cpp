@@ -45,7 +45,8 @@ EngineNetworkStream::EngineNetworkStream(int numOutputChannels,
           m_inputStreamStartTimeUs(-1),
           m_inputStreamFramesWritten(0),
           m_inputStreamFramesRead(0),
-          m_outputWorkers(BROADCAST_MAX_CONNECTIONS) {
+          m_outputWorkers(BROADCAST_MAX_CONNECTIONS),
+          m_pSharedEncoders(std::make_shared<SharedEncoderRegistry>()) {
     if (numInputChannels) {
         m_pInputFifo = new FIFO<CSAMPLE>(numInputChannels * kBufferFrames);
     }
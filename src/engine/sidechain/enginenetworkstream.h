@@ -2,6 +2,7 @@
 
 #include <QVector>
 
+#include "encoder/sharedencoder.h"
 #include "engine/sidechain/networkoutputstreamworker.h"
 #include "util/types.h"
 
@@ -40,6 +41,12 @@ class EngineNetworkStream {
         return m_outputWorkers;
     }
 
+    // The output workers with identical encoder settings share the encoder
+    // from this registry, so each stream format is only encoded once.
+    SharedEncoderRegistryPointer sharedEncoders() {
+        return m_pSharedEncoders;
+    }
+
   private:
     int nextOutputSlotAvailable();
     void debugOutputSlots();
@@ -60,4 +67,6 @@ class EngineNetworkStream {
     // the workers are then performed on thread-safe QSharedPointers and not
     // onto the thread-unsafe QVector
     QVector<NetworkOutputStreamWorkerPtr> m_outputWorkers;
+
+    SharedEncoderRegistryPointer m_pSharedEncoders;
 };
@@ -25,6 +25,7 @@
 #include "recording/defs_recording.h"
 #include "track/track.h"
 #include "util/compatibility/qatomic.h"
+#include "util/compatibility/qmutex.h"
 #include "util/logger.h"
 
 namespace {
@@ -43,7 +44,8 @@ const mixxx::Logger kLogger("ShoutConnection");
 } // namespace
 
 ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
-        UserSettingsPointer pConfig)
+        UserSettingsPointer pConfig,
+        SharedEncoderRegistryPointer pSharedEncoders)
         : m_pTextCodec(nullptr),
           m_pMetaData(),
           m_pShout(nullptr),
@@ -54,6 +56,9 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_pConfig(pConfig),
           m_pProfile(profile),
           m_encoder(nullptr),
+          m_pSharedEncoders(std::move(pSharedEncoders)),
+          m_packetBytes(0),
+          m_packetsOverflow(false),
           m_mainSamplerate(QStringLiteral("[App]"), QStringLiteral("samplerate")),
           m_broadcastEnabled(BROADCAST_PREF_KEY, "enabled"),
           m_custom_metadata(false),
@@ -123,6 +128,9 @@ ShoutConnection::~ShoutConnection() {
        qWarning() << "ShoutOutput::~ShoutOutput(): Thread didn't die.\
        Ignored but file a bug report if problems rise!";
     }
+
+    // Stop receiving packets from a shared encoder
+    resetEncoder();
 }
 
 bool ShoutConnection::isConnected() {
@@ -186,7 +194,7 @@ void ShoutConnection::updateFromPreferences() {
     // Delete m_encoder if it has been initialized (with maybe) different bitrate.
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    resetEncoder();
 
     m_format_is_mp3 = false;
     m_format_is_ov = false;
@@ -450,23 +458,31 @@ void ShoutConnection::updateFromPreferences() {
         return;
     }
 
-    // Initialize m_encoder
+    // Initialize m_encoder, or subscribe to the encoder that is shared with
+    // the other connections with the same settings
     EncoderSettingsPointer pBroadcastSettings =
             std::make_shared<EncoderBroadcastSettings>(m_pProfile);
-    m_encoder = EncoderFactory::getFactory().createEncoder(
-                    pBroadcastSettings, this);
-
     QString userErrorMsg;
     int ret = -1;
-    if (m_encoder) {
-        ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+    if (m_pSharedEncoders && SharedEncoder::isShareable(*pBroadcastSettings)) {
+        m_pSharedEncoder = m_pSharedEncoders->subscribe(
+                pBroadcastSettings, mainSamplerate, this, &userErrorMsg);
+        if (m_pSharedEncoder) {
+            ret = 0;
+        }
+    } else {
+        m_encoder = EncoderFactory::getFactory().createEncoder(
+                pBroadcastSettings, this);
+        if (m_encoder) {
+            ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+        }
     }
 
     // TODO(XXX): Use mixxx::audio::SampleRate instead of int in initEncoder
     if (ret < 0) {
         // delete m_encoder calls write() make sure it will be exit early
         DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-        m_encoder.reset();
+        resetEncoder();
 
         setState(NETWORKSTREAMWORKER_STATE_ERROR);
 
@@ -499,7 +515,7 @@ bool ShoutConnection::processConnect() {
     // Make sure that we call updateFromPreferences always
     updateFromPreferences();
 
-    if (!m_encoder) {
+    if (!m_encoder && !m_pSharedEncoder) {
         // updateFromPreferences failed
         setStatus(BroadcastProfile::STATUS_FAILURE);
         kLogger.warning() << "ShoutOutput::processConnect() returning false";
@@ -595,6 +611,9 @@ bool ShoutConnection::processConnect() {
             if(m_pOutputFifo->readAvailable()) {
             	m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
             }
+            // Packets of a shared encoder that have been received while
+            // connecting are outdated as well
+            clearReceivedPackets();
             m_threadWaiting = true;
 
             setStatus(BroadcastProfile::STATUS_CONNECTED);
@@ -625,7 +644,7 @@ bool ShoutConnection::processConnect() {
     shout_close(m_pShout);
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    resetEncoder();
     if (m_pProfile->getEnabled()) {
         setStatus(BroadcastProfile::STATUS_FAILURE);
     } else {
@@ -650,7 +669,7 @@ bool ShoutConnection::processDisconnect() {
     }
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    resetEncoder();
     return disconnected;
 }
 
@@ -700,6 +719,58 @@ int ShoutConnection::filelen() {
     return 0;
 }
 
+void ShoutConnection::receivePacket(const QByteArray& packet) {
+    const auto locker = lockMutex(&m_packetsMutex);
+    if (m_packetBytes + packet.size() > kMaxNetworkCache) {
+        // Our thread does not keep up with the connection that
+        // feeds the encoder
+        m_packetsOverflow = true;
+        return;
+    }
+    // Shares the data with the other connections
+    m_packets.append(packet);
+    m_packetBytes += packet.size();
+}
+
+void ShoutConnection::writeReceivedPackets() {
+    QVector<QByteArray> packets;
+    bool overflow;
+    {
+        const auto locker = lockMutex(&m_packetsMutex);
+        packets.swap(m_packets);
+        m_packetBytes = 0;
+        overflow = m_packetsOverflow;
+        m_packetsOverflow = false;
+    }
+    if (overflow) {
+        m_lastErrorStr = tr("Network cache overflow");
+        tryReconnect();
+        return;
+    }
+    for (const QByteArray& packet : std::as_const(packets)) {
+        write(nullptr,
+                reinterpret_cast<const unsigned char*>(packet.constData()),
+                0,
+                packet.size());
+    }
+}
+
+void ShoutConnection::clearReceivedPackets() {
+    const auto locker = lockMutex(&m_packetsMutex);
+    m_packets.clear();
+    m_packetBytes = 0;
+    m_packetsOverflow = false;
+}
+
+void ShoutConnection::resetEncoder() {
+    m_encoder.reset();
+    if (m_pSharedEncoder) {
+        m_pSharedEncoder->unsubscribe(this);
+        m_pSharedEncoder.reset();
+    }
+    clearReceivedPackets();
+}
+
 bool ShoutConnection::writeSingle(const unsigned char* data, std::size_t len) {
     setFunctionCode(8);
     int ret = shout_send_raw(m_pShout, data, len);
@@ -742,12 +813,22 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const std::size_t bufferSi
     // to prevent race conditions when resetting the member
     // pointer while disconnecting in the worker thread!
     const EncoderPointer pEncoder = m_encoder;
+    const SharedEncoderPointer pSharedEncoder = m_pSharedEncoder;
 
     // If we are connected, encode the samples.
     if (bufferSize > 0 && pEncoder) {
         setFunctionCode(6);
         pEncoder->encodeBuffer(pBuffer, bufferSize);
         // the encoded frames are received by the write() callback.
+    } else if (pSharedEncoder) {
+        setFunctionCode(6);
+        if (bufferSize > 0) {
+            // Ignored unless this connection feeds the shared encoder.
+            // The encoded frames are received by all connections in
+            // receivePacket().
+            pSharedEncoder->encodeBuffer(this, pBuffer, bufferSize);
+        }
+        writeReceivedPackets();
     }
 
     // Check if track metadata has changed and if so, update.
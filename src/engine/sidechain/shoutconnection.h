@@ -12,6 +12,7 @@
 #include "control/pollingcontrolproxy.h"
 #include "encoder/encoder.h"
 #include "encoder/encodercallback.h"
+#include "encoder/sharedencoder.h"
 #include "preferences/broadcastprofile.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -25,10 +26,15 @@ typedef struct _util_dict shout_metadata_t;
 class QTextCodec;
 
 class ShoutConnection
-        : public QThread, public EncoderCallback, public NetworkOutputStreamWorker {
+        : public QThread,
+          public EncoderCallback,
+          public SharedEncoder::Subscriber,
+          public NetworkOutputStreamWorker {
     Q_OBJECT
   public:
-    ShoutConnection(BroadcastProfilePtr profile, UserSettingsPointer pConfig);
+    ShoutConnection(BroadcastProfilePtr profile,
+            UserSettingsPointer pConfig,
+            SharedEncoderRegistryPointer pSharedEncoders);
     ~ShoutConnection() override;
 
     // This is called by the Engine implementation for each sample. Encode and
@@ -49,6 +55,10 @@ class ShoutConnection
     // gets stream length
     int filelen() override;
 
+    // Called by the shared encoder from the thread of the connection that
+    // feeds it. The packets are sent by process() in our thread.
+    void receivePacket(const QByteArray& packet) override;
+
     /** connects to server **/
     bool serverConnect();
     bool isConnected();
@@ -97,6 +107,12 @@ class ShoutConnection
     void serverWrite(unsigned char *header, unsigned char *body,
                int headerLen, int bodyLen);
 
+    // Sends the packets that have been received from the shared encoder
+    void writeReceivedPackets();
+    void clearReceivedPackets();
+    // Releases the own or the shared encoder
+    void resetEncoder();
+
 #ifndef __WINDOWS__
     void ignoreSigpipe();
 #endif
@@ -120,6 +136,14 @@ class ShoutConnection
     UserSettingsPointer m_pConfig;
     BroadcastProfilePtr m_pProfile;
     EncoderPointer m_encoder;
+    // Used instead of m_encoder if the format can be shared with
+    // other connections
+    SharedEncoderRegistryPointer m_pSharedEncoders;
+    SharedEncoderPointer m_pSharedEncoder;
+    QMutex m_packetsMutex;
+    QVector<QByteArray> m_packets;
+    int m_packetBytes;
+    bool m_packetsOverflow;
     PollingControlProxy m_mainSamplerate;
     PollingControlProxy m_broadcastEnabled;
     // static metadata according to prefereneces
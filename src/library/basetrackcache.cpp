@@ -1,9 +1,13 @@
 #include "library/basetrackcache.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "library/queryutil.h"
 #include "library/searchquery.h"
 #include "library/searchqueryparser.h"
 #include "library/trackcollection.h"
+#include "library/tracksearchindex.h"
 #include "moc_basetrackcache.cpp"
 #include "track/globaltrackcache.h"
 #include "track/keyutils.h"
@@ -14,6 +18,46 @@ namespace {
 
 constexpr bool sDebug = false;
 
+QVector<TrackColumnStore::SortKind> sortKindsOfColumns(
+        const ColumnCache& columnCache, int columnCount) {
+    // Same order as the ORDER BY clause of ColumnCache::columnSortForFieldIndex(),
+    // e.g. years may be formatted dates like "2005-03-01" and track numbers
+    // may contain the number of tracks like "3/12"
+    const std::initializer_list<ColumnCache::Column> numberColumns = {
+            ColumnCache::COLUMN_LIBRARYTABLE_DURATION,
+            ColumnCache::COLUMN_LIBRARYTABLE_BITRATE,
+            ColumnCache::COLUMN_LIBRARYTABLE_BPM,
+            ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN,
+            ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE,
+            ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS,
+            ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED,
+            ColumnCache::COLUMN_LIBRARYTABLE_RATING,
+            ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION,
+    };
+    QVector<TrackColumnStore::SortKind> sortKinds(
+            columnCount, TrackColumnStore::SortKind::Default);
+    for (const auto column : numberColumns) {
+        const int fieldIdx = columnCache.fieldIndex(column);
+        if (fieldIdx >= 0 && fieldIdx < columnCount) {
+            sortKinds[fieldIdx] = TrackColumnStore::SortKind::Number;
+        }
+    }
+    const int yearFieldIdx = columnCache.fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_YEAR);
+    if (yearFieldIdx >= 0 && yearFieldIdx < columnCount) {
+        sortKinds[yearFieldIdx] = TrackColumnStore::SortKind::Text;
+    }
+    const int trackNumberFieldIdx =
+            columnCache.fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER);
+    if (trackNumberFieldIdx >= 0 && trackNumberFieldIdx < columnCount) {
+        sortKinds[trackNumberFieldIdx] = TrackColumnStore::SortKind::Integer;
+    }
+    const int keyFieldIdx = columnCache.fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY);
+    if (keyFieldIdx >= 0 && keyFieldIdx < columnCount) {
+        sortKinds[keyFieldIdx] = TrackColumnStore::SortKind::Key;
+    }
+    return sortKinds;
+}
+
 }  // namespace
 
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
@@ -31,7 +75,17 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
                   pTrackCollection, std::move(searchColumns))),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
+          m_trackInfo(sortKindsOfColumns(m_columnCache, m_columnCount)),
           m_database(pTrackCollection->database()) {
+    QStringList searchIndexColumns;
+    for (const auto& column : m_pQueryParser->textColumns()) {
+        const int fieldIdx = fieldIndex(column);
+        if (fieldIdx >= 0) {
+            searchIndexColumns.append(column);
+            m_searchIndexFields.append(fieldIdx);
+        }
+    }
+    m_pSearchIndex = std::make_unique<TrackSearchIndex>(std::move(searchIndexColumns));
 }
 
 BaseTrackCache::~BaseTrackCache() {
@@ -82,9 +136,11 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
         qDebug() << this << "slotTracksRemoved" << trackIds.size();
     }
     for (const auto& trackId : std::as_const(trackIds)) {
-        m_trackInfo.remove(trackId);
+        m_trackInfo.removeTrack(trackId);
+        m_pSearchIndex->removeTrack(trackId);
         m_dirtyTracks.remove(trackId);
     }
+    m_unfilteredQueryString.clear();
 }
 
 void BaseTrackCache::slotTrackDirty(TrackId trackId) {
@@ -168,14 +224,13 @@ bool BaseTrackCache::updateTrackInIndex(
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        // preallocate memory for all columns at once
-        record.resize(numColumns);
+        QVector<QVariant> record(numColumns);
         for (int i = 0; i < numColumns; ++i) {
             record[i] = getTrackValueForColumn(pTrack, i);
         }
+        m_trackInfo.setValues(trackId, record);
+        updateTrackInSearchIndex(trackId, record);
+        m_unfilteredQueryString.clear();
         if (m_bIsCaching) {
             replaceRecentTrack(trackId, pTrack);
         }
@@ -209,14 +264,10 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
     int numColumns = columnCount();
     int idColumn = query.record().indexOf(m_idColumn);
 
+    QVector<QVariant> record(numColumns);
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
 
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        record.resize(numColumns);
-
         for (int i = 0; i < numColumns; ++i) {
             if (fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION) == i) {
                 // Database stores all locations with Qt separators: "/"
@@ -227,7 +278,10 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
                 record[i] = query.value(i);
             }
         }
+        m_trackInfo.setValues(trackId, record);
+        updateTrackInSearchIndex(trackId, record);
     }
+    m_unfilteredQueryString.clear();
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
     return true;
@@ -249,6 +303,7 @@ void BaseTrackCache::buildIndex() {
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
     m_trackInfo.clear();
+    m_pSearchIndex->clear();
     if (m_bIsCaching) {
         resetRecentTrack();
     }
@@ -291,6 +346,22 @@ void BaseTrackCache::updateTracksInIndex(const QSet<TrackId>& trackIds) {
     emit tracksChanged(trackIds);
 }
 
+void BaseTrackCache::updateTrackInSearchIndex(
+        TrackId trackId, const QVector<QVariant>& record) {
+    const int locationFieldIdx = fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
+    QStringList values;
+    values.reserve(m_searchIndexFields.size());
+    for (int fieldIdx : std::as_const(m_searchIndexFields)) {
+        QString value = record.value(fieldIdx).toString();
+        if (fieldIdx == locationFieldIdx) {
+            // Search the locations with Qt separators like in the database
+            value = QDir::fromNativeSeparators(value);
+        }
+        values.append(std::move(value));
+    }
+    m_pSearchIndex->updateTrack(trackId, values);
+}
+
 QVariant BaseTrackCache::getTrackValueForColumn(TrackPointer pTrack,
         int column) const {
     if (!pTrack || column < 0) {
@@ -427,20 +498,18 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // TODO(rryan) this code is flawed for columns that contains row-specific
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
-    auto it = m_trackInfo.constFind(trackId);
-    if (it == m_trackInfo.constEnd()) {
+    if (!m_trackInfo.contains(trackId)) {
         return QVariant{};
     }
 
-    const QVector<QVariant>& fields = it.value();
     if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
         // The Key value is determined by either the KEY_ID or KEY column
         const auto columnForKeyId = fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID);
         return KeyUtils::keyFromKeyTextAndIdFields(
-                fields.value(column, QVariant{}),
-                fields.value(columnForKeyId, QVariant{}));
+                m_trackInfo.value(trackId, column),
+                m_trackInfo.value(trackId, columnForKeyId));
     }
-    return fields.value(column, QVariant{});
+    return m_trackInfo.value(trackId, column);
 }
 
 void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
@@ -479,51 +548,81 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
                 .arg(m_idColumn, idStrings.join(","));
     }
 
+    // Sort the tracks in memory instead of by the query, unless they
+    // are shuffled
+    QList<SortColumn> trackSortColumns;
+    const bool sortInMemory = orderByClause.isEmpty() ||
+            (!orderByClause.contains(QStringLiteral("RANDOM()")) &&
+                    mapSortColumns(sortColumns, columnOffset, &trackSortColumns));
+
+    const QString unfilteredFilter = queryFragments.isEmpty()
+            ? QString()
+            : QStringLiteral("WHERE ") + queryFragments.join(" AND ");
+    const QString unfilteredQueryString = QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn,
+                    m_tableName,
+                    unfilteredFilter,
+                    sortInMemory ? QString() : orderByClause);
+
+    // Try to evaluate the search terms with the in-memory index and only
+    // fall back to a full SQL query if that is not possible.
     const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    queryFragments.join(" AND "));
-
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
-
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
-    }
-
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
+            m_pQueryParser->parseQuery(searchQuery, QString());
+    std::vector<TrackId> matchingTrackIds;
+    m_trackOrder.resize(0); // keeps allocated memory
+    if (pQuery->search(*m_pSearchIndex, &matchingTrackIds)) {
+        if (m_unfilteredQueryString != unfilteredQueryString) {
+            if (sDebug) {
+                qDebug() << this << "select() executing:" << unfilteredQueryString;
+            }
+            m_unfilteredTrackOrder.resize(0);
+            if (selectTrackIds(unfilteredQueryString, &m_unfilteredTrackOrder)) {
+                m_unfilteredQueryString = unfilteredQueryString;
+                if (sortInMemory) {
+                    std::sort(m_unfilteredTrackOrder.begin(), m_unfilteredTrackOrder.end());
+                }
+            }
+        }
+        if (sortInMemory) {
+            std::vector<TrackId> filteredTrackIds;
+            filteredTrackIds.reserve(matchingTrackIds.size());
+            std::set_intersection(m_unfilteredTrackOrder.cbegin(),
+                    m_unfilteredTrackOrder.cend(),
+                    matchingTrackIds.cbegin(),
+                    matchingTrackIds.cend(),
+                    std::back_inserter(filteredTrackIds));
+            m_trackOrder = m_trackInfo.sortTracks(
+                    filteredTrackIds, trackSortColumns, m_columnCache.keyNotation());
+        } else {
+            m_trackOrder.reserve(static_cast<int>(matchingTrackIds.size()));
+            for (const auto& trackId : std::as_const(m_unfilteredTrackOrder)) {
+                if (std::binary_search(matchingTrackIds.begin(),
+                            matchingTrackIds.end(),
+                            trackId)) {
+                    m_trackOrder.append(trackId);
+                }
+            }
+        }
+    } else {
+        QString filter = m_pQueryParser->parseQuery(
+                searchQuery, queryFragments.join(" AND "))->toSql();
+        if (!filter.isEmpty()) {
+            filter.prepend("WHERE ");
+        }
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
+        QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+                .arg(m_idColumn, m_tableName, filter, orderByClause);
 
-    if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
+        if (sDebug) {
+            qDebug() << this << "select() executing:" << queryString;
+        }
+        selectTrackIds(queryString, &m_trackOrder);
     }
 
-    m_trackOrder.resize(0); // keeps allocated memory
     trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
-    }
-
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -601,6 +700,53 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+bool BaseTrackCache::selectTrackIds(
+        const QString& queryString, QVector<TrackId>* pTrackIds) const {
+    QSqlQuery query(m_database);
+    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+    // won't allocate a giant in-memory table that we won't use at all.
+    query.setForwardOnly(true);
+    query.prepare(queryString);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    int idColumn = query.record().indexOf(m_idColumn);
+    int rows = query.size();
+
+    if (sDebug) {
+        qDebug() << "Rows returned:" << rows;
+    }
+
+    if (rows > 0) {
+        pTrackIds->reserve(rows);
+    }
+    while (query.next()) {
+        pTrackIds->append(TrackId(query.value(idColumn)));
+    }
+    return true;
+}
+
+bool BaseTrackCache::mapSortColumns(const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QList<SortColumn>* pTrackSortColumns) const {
+    // The same columns as in BaseSqlTableModel::setSort()
+    for (const auto& sc : sortColumns) {
+        if (sc.m_column == 0) {
+            // The id column, i.e. the first column of both tables
+            pTrackSortColumns->append(SortColumn(0, sc.m_order));
+            continue;
+        }
+        const int column = sc.m_column - columnOffset;
+        if (column > 0 && column < columnCount()) {
+            pTrackSortColumns->append(SortColumn(column, sc.m_order));
+        }
+    }
+    return !pTrackSortColumns->isEmpty();
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
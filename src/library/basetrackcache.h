@@ -11,6 +11,8 @@
 #include <memory>
 
 #include "library/columncache.h"
+#include "library/sortcolumn.h"
+#include "library/trackcolumnstore.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
@@ -18,16 +20,7 @@
 
 class SearchQueryParser;
 class TrackCollection;
-
-class SortColumn {
-  public:
-    SortColumn(int column, Qt::SortOrder order)
-        : m_column(column),
-          m_order(order) {
-    }
-    int m_column;
-    Qt::SortOrder m_order;
-};
+class TrackSearchIndex;
 
 // BaseTrackCache is a cache of all of the values in certain table. It supports
 // searching and sorting of tracks by values within the table. The reasoning for
@@ -96,8 +89,14 @@ class BaseTrackCache : public QObject {
     void updateTrackInIndex(TrackId trackId);
     bool updateTrackInIndex(const TrackPointer& pTrack);
     void updateTracksInIndex(const QSet<TrackId>& trackIds);
+    void updateTrackInSearchIndex(TrackId trackId, const QVector<QVariant>& record);
     QVariant getTrackValueForColumn(TrackPointer pTrack, int column) const;
 
+    bool selectTrackIds(const QString& queryString, QVector<TrackId>* pTrackIds) const;
+    bool mapSortColumns(const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QList<SortColumn>* pTrackSortColumns) const;
+
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -116,6 +115,18 @@ class BaseTrackCache : public QObject {
 
     const std::unique_ptr<SearchQueryParser> m_pQueryParser;
 
+    // The text columns of m_trackInfo that are indexed for searching
+    QVector<int> m_searchIndexFields;
+    std::unique_ptr<TrackSearchIndex> m_pSearchIndex;
+
+    // The result of the most recent query without any search terms.
+    // Searches that can be evaluated by the search index only need to
+    // filter this list as long as neither the tracks nor the query have
+    // changed. The tracks are ordered by id if they are sorted in memory
+    // and otherwise by the query.
+    QString m_unfilteredQueryString;
+    QVector<TrackId> m_unfilteredTrackOrder;
+
     const mixxx::StringCollator m_collator;
 
     // Temporary storage for filterAndSort()
@@ -136,7 +147,7 @@ class BaseTrackCache : public QObject {
 
     bool m_bIndexBuilt;
     bool m_bIsCaching;
-    QHash<TrackId, QVector<QVariant>> m_trackInfo;
+    TrackColumnStore m_trackInfo;
     QSqlDatabase m_database;
 
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
@@ -1,8 +1,10 @@
 #include "library/dao/analysisdao.h"
 
+#include <QSaveFile>
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QtDebug>
+#include <limits>
 
 #include "library/queryutil.h"
 #include "preferences/waveformsettings.h"
@@ -17,6 +19,28 @@ const QString AnalysisDao::s_analysisTableName = "track_analysis";
 // CPU time so I think we should stick with the default. rryan 4/3/2012
 constexpr int kCompressionLevel = -1;
 
+namespace {
+
+// Only the header of columnar waveforms is verified when the analyses
+// are fetched. It contains a CRC-32 of the bands that is verified when the
+// waveform is decoded, so the bands of analyses that the caller doesn't
+// decode, e.g. the full resolution waveform when only the summary is
+// needed, are never paged in. The 16-bit checksum of the whole file is
+// only kept for the compressed data that has been stored by previous
+// versions.
+int checksum(const QByteArray& fileData) {
+    if (Waveform::columnarHeaderSize(fileData) > 0) {
+        return static_cast<int>(Waveform::columnarHeaderChecksum(fileData));
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return qChecksum(fileData);
+#else
+    return qChecksum(fileData.constData(), fileData.length());
+#endif
+}
+
+} // anonymous namespace
+
 AnalysisDao::AnalysisDao(UserSettingsPointer pConfig)
         : m_pConfig(pConfig) {
     QDir storagePath = getAnalysisStoragePath();
@@ -81,24 +105,25 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         info.type = static_cast<AnalysisType>(query->value(typeColumn).toInt());
         info.description = query->value(descriptionColumn).toString();
         info.version = query->value(versionColumn).toString();
-        int checksum = query->value(dataChecksumColumn).toInt();
+        const int dataChecksum = query->value(dataChecksumColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(
             QString::number(info.analysisId));
-        const QByteArray compressedData = loadDataFromFile(dataPath);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        const int file_checksum = qChecksum(
-                compressedData);
-#else
-        const int file_checksum = qChecksum(
-                compressedData.constData(),
-                compressedData.length());
-#endif
-        if (checksum != file_checksum) {
+        auto pDataFile = std::make_shared<QFile>(dataPath);
+        const QByteArray fileData = loadDataFromFile(pDataFile.get());
+        const int file_checksum = checksum(fileData);
+        if (dataChecksum != file_checksum) {
             qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
-                     << "length" << compressedData.length();
+                     << "length" << fileData.length();
             continue;
         }
-        info.data = qUncompress(compressedData);
+        if (Waveform::columnarHeaderSize(fileData) > 0) {
+            // Columnar waveforms are stored uncompressed and decoded
+            // directly from the memory mapping
+            info.data = fileData;
+            info.dataFile = std::move(pDataFile);
+        } else {
+            info.data = qUncompress(fileData);
+        }
         bytes += info.data.length();
         analyses.append(info);
     }
@@ -120,15 +145,13 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     PerformanceTimer time;
     time.start();
 
-    const QByteArray compressedData = qCompress(info->data, kCompressionLevel);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    const int checksum = qChecksum(
-            compressedData);
-#else
-    const int checksum = qChecksum(
-            compressedData.constData(),
-            compressedData.length());
-#endif
+    // Columnar waveforms are stored uncompressed to allow reading them
+    // directly from a memory mapping of the file.
+    const int headerSize = Waveform::columnarHeaderSize(info->data);
+    const QByteArray fileData = headerSize > 0
+            ? info->data
+            : qCompress(info->data, kCompressionLevel);
+    const int dataChecksum = checksum(fileData);
     QSqlQuery query(m_database);
     if (info->analysisId == -1) {
         query.prepare(QString(
@@ -140,7 +163,7 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
         query.bindValue(":type", info->type);
         query.bindValue(":description", info->description);
         query.bindValue(":version", info->version);
-        query.bindValue(":data_checksum", checksum);
+        query.bindValue(":data_checksum", dataChecksum);
 
         if (!query.exec()) {
             LOG_FAILED_QUERY(query) << "couldn't save new analysis";
@@ -162,7 +185,7 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
         query.bindValue(":type", info->type);
         query.bindValue(":description", info->description);
         query.bindValue(":version", info->version);
-        query.bindValue(":data_checksum", checksum);
+        query.bindValue(":data_checksum", dataChecksum);
 
         if (!query.exec()) {
             LOG_FAILED_QUERY(query) << "couldn't update existing analysis";
@@ -172,14 +195,14 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
 
     QString dataPath = getAnalysisStoragePath().absoluteFilePath(
         QString::number(info->analysisId));
-    if (!saveDataToFile(dataPath, compressedData)) {
+    if (!saveDataToFile(dataPath, fileData)) {
         qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
         return false;
     }
 
     qDebug() << "AnalysisDAO saved analysis" << info->analysisId
-             << QString("%1 (%2 compressed)").arg(QString::number(info->data.length()),
-                                                  QString::number(compressedData.length()))
+             << QString("%1 (%2 stored)").arg(QString::number(info->data.length()),
+                                              QString::number(fileData.length()))
              << "bytes for track"
              << info->trackId << "in" << time.elapsed().debugMillisWithUnit();
     return true;
@@ -262,15 +285,24 @@ QDir AnalysisDao::getAnalysisStoragePath() const {
     return dir.absolutePath().append("/");
 }
 
-QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
-    QFile file(filename);
-    if (!file.exists()) {
+QByteArray AnalysisDao::loadDataFromFile(QFile* pFile) const {
+    if (!pFile->exists()) {
         return QByteArray();
     }
-    if (!file.open(QIODevice::ReadOnly)) {
+    if (!pFile->open(QIODevice::ReadOnly)) {
         return QByteArray();
     }
-    return file.readAll();
+    // The returned array refers to the memory mapping without copying
+    // and is only valid as long as the file is open.
+    const qint64 size = pFile->size();
+    if (size > 0 && size <= std::numeric_limits<int>::max()) {
+        const uchar* pData = pFile->map(0, size);
+        if (pData) {
+            return QByteArray::fromRawData(
+                    reinterpret_cast<const char*>(pData), static_cast<int>(size));
+        }
+    }
+    return pFile->readAll();
 }
 
 bool AnalysisDao::deleteFile(const QString& fileName) const {
@@ -279,40 +311,19 @@ bool AnalysisDao::deleteFile(const QString& fileName) const {
 }
 
 bool AnalysisDao::saveDataToFile(const QString& fileName, const QByteArray& data) const {
-    QFile file(fileName);
-
-    // If the file exists, do the right thing. Write to a temp file, unlink the
-    // existing file, and then move the temp file to the real file's name.
-    if (file.exists()) {
-        QString tempFileName = fileName + ".tmp";
-        QFile tempFile(tempFileName);
-        if (!tempFile.open(QIODevice::WriteOnly)) {
-            return false;
-        }
-        int bytesWritten = tempFile.write(data);
-        if (bytesWritten == -1 || bytesWritten != data.length()) {
-            return false;
-        }
-        tempFile.close();
-        if (!file.remove()) {
-            return false;
-        }
-        if (!tempFile.rename(fileName)) {
-            return false;
-        }
-        return true;
-    }
-
-    // If the file doesn't exist, just create a new file and write the data.
+    // The data is written to a temporary file that atomically replaces an
+    // existing file on commit. The existing file is never modified in place
+    // or removed, because it might still be memory mapped by an AnalysisInfo.
+    QSaveFile file(fileName);
     if (!file.open(QIODevice::WriteOnly)) {
         return false;
     }
-    int bytesWritten = file.write(data);
-    if (bytesWritten == -1 || bytesWritten != data.length()) {
+    const qint64 bytesWritten = file.write(data);
+    if (bytesWritten != data.length()) {
+        file.cancelWriting();
         return false;
     }
-    file.close();
-    return true;
+    return file.commit();
 }
 
 void AnalysisDao::saveTrackAnalyses(
@@ -340,7 +351,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
+    analysis.data = pWaveform->toColumnarByteArray();
     bool success = saveAnalysis(&analysis);
     if (success) {
         pWaveform->setSaveState(Waveform::SaveState::Saved);
@@ -355,7 +366,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
-    analysis.data = pWaveSummary->toByteArray();
+    analysis.data = pWaveSummary->toColumnarByteArray();
 
     success = saveAnalysis(&analysis);
     if (success) {
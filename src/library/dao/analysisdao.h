@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QDir>
+#include <QFile>
+#include <memory>
 
 #include "preferences/usersettings.h"
 #include "library/dao/dao.h"
@@ -29,7 +31,12 @@ class AnalysisDao : public DAO {
         AnalysisType type;
         QString description;
         QString version;
+        // Uncompressed data might refer to a memory mapping of the
+        // analysis file that is kept alive by dataFile. Copies of data
+        // must not outlive the AnalysisInfo. Release all copies of the
+        // AnalysisInfo to unmap the file before deleting the analysis.
         QByteArray data;
+        std::shared_ptr<QFile> dataFile;
     };
 
     explicit AnalysisDao(UserSettingsPointer pConfig);
@@ -59,7 +66,7 @@ class AnalysisDao : public DAO {
 
   private:
     QDir getAnalysisStoragePath() const;
-    QByteArray loadDataFromFile(const QString& fileName) const;
+    QByteArray loadDataFromFile(QFile* pFile) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
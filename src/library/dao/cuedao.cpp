@@ -9,6 +9,7 @@
 #include "util/assert.h"
 #include "util/color/rgbcolor.h"
 #include "util/db/fwdsqlquery.h"
+#include "util/db/fwdsqlquerycache.h"
 #include "util/logger.h"
 
 namespace {
@@ -78,14 +79,14 @@ QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
     //qDebug() << "CueDAO::getCuesForTrack" << QThread::currentThread() << m_database.connectionName();
     QList<CuePointer> cues;
 
-    FwdSqlQuery query(
+    auto query = FwdSqlQueryCache::prepare(
             m_database,
             QStringLiteral("SELECT * FROM " CUE_TABLE " WHERE track_id=:id"));
     DEBUG_ASSERT(
-            query.isPrepared() &&
-            !query.hasError());
-    query.bindValue(":id", trackId);
-    if (!query.execPrepared()) {
+            query->isPrepared() &&
+            !query->hasError());
+    query->bindValue(":id", trackId);
+    if (!query->execPrepared()) {
         kLogger.warning()
                 << "Failed to load cues of track"
                 << trackId;
@@ -93,8 +94,8 @@ QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
         return cues;
     }
     QMap<int, CuePointer> hotCuesByNumber;
-    while (query.next()) {
-        CuePointer pCue = cueFromRow(query.record());
+    while (query->next()) {
+        CuePointer pCue = cueFromRow(query->record());
         if (!pCue) {
             continue;
         }
@@ -155,44 +156,42 @@ bool CueDAO::saveCue(TrackId trackId, Cue* cue) const {
     }
 
     // Prepare query
-    QSqlQuery query(m_database);
-    if (cue->getId().isValid()) {
-        // Update cue
-        query.prepare(QStringLiteral("UPDATE " CUE_TABLE " SET "
-                        "track_id=:track_id,"
-                        "type=:type,"
-                        "position=:position,"
-                        "length=:length,"
-                        "hotcue=:hotcue,"
-                        "label=:label,"
-                        "color=:color"
-                        " WHERE id=:id"));
-        query.bindValue(":id", cue->getId().toVariant());
-    } else {
-        // New cue
-        query.prepare(
-                QStringLiteral("INSERT INTO " CUE_TABLE
-                               " (track_id, type, position, length, hotcue, "
-                               "label, color) VALUES (:track_id, :type, "
-                               ":position, :length, :hotcue, :label, :color)"));
+    const bool isNewCue = !cue->getId().isValid();
+    auto query = FwdSqlQueryCache::prepare(m_database,
+            isNewCue
+                    ? QStringLiteral("INSERT INTO " CUE_TABLE
+                                     " (track_id, type, position, length, hotcue, "
+                                     "label, color) VALUES (:track_id, :type, "
+                                     ":position, :length, :hotcue, :label, :color)")
+                    : QStringLiteral("UPDATE " CUE_TABLE " SET "
+                                     "track_id=:track_id,"
+                                     "type=:type,"
+                                     "position=:position,"
+                                     "length=:length,"
+                                     "hotcue=:hotcue,"
+                                     "label=:label,"
+                                     "color=:color"
+                                     " WHERE id=:id"));
+    if (!isNewCue) {
+        query->bindValue(":id", cue->getId());
     }
 
     // Bind values and execute query
-    query.bindValue(":track_id", trackId.toVariant());
-    query.bindValue(":type", static_cast<int>(cue->getType()));
-    query.bindValue(":position", cue->getPosition().toEngineSamplePosMaybeInvalid());
-    query.bindValue(":length", cue->getLengthFrames() * mixxx::kEngineChannelOutputCount);
-    query.bindValue(":hotcue", cue->getHotCue());
-    query.bindValue(":label", labelToQVariant(cue->getLabel()));
-    query.bindValue(":color", mixxx::RgbColor::toQVariant(cue->getColor()));
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    query->bindValue(":track_id", trackId);
+    query->bindValue(":type", QVariant(static_cast<int>(cue->getType())));
+    query->bindValue(":position",
+            QVariant(cue->getPosition().toEngineSamplePosMaybeInvalid()));
+    query->bindValue(":length",
+            QVariant(cue->getLengthFrames() * mixxx::kEngineChannelOutputCount));
+    query->bindValue(":hotcue", QVariant(cue->getHotCue()));
+    query->bindValue(":label", labelToQVariant(cue->getLabel()));
+    query->bindValue(":color", mixxx::RgbColor::toQVariant(cue->getColor()));
+    if (!query->execPrepared()) {
         return false;
     }
 
-    if (!cue->getId().isValid()) {
-        // New cue
-        const auto newId = DbId(query.lastInsertId());
+    if (isNewCue) {
+        const auto newId = DbId(query->lastInsertId());
         DEBUG_ASSERT(newId.isValid());
         cue->setId(newId);
     }
@@ -9,6 +9,7 @@
 #include "moc_playlistdao.cpp"
 #include "util/db/dbconnection.h"
 #include "util/db/fwdsqlquery.h"
+#include "util/db/fwdsqlquerycache.h"
 #include "util/make_const_iterator.h"
 #include "util/math.h"
 
@@ -441,18 +442,16 @@ int PlaylistDAO::setPlaylistsLocked(const QSet<int>& playlistIds, const bool loc
 }
 
 bool PlaylistDAO::isPlaylistLocked(const int playlistId) const {
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "SELECT locked FROM Playlists WHERE id = :id"));
-    query.bindValue(":id", playlistId);
+    auto query = FwdSqlQueryCache::prepare(m_database,
+            QStringLiteral(
+                    "SELECT locked FROM Playlists WHERE id = :id"));
+    query->bindValue(":id", QVariant(playlistId));
 
-    if (query.exec()) {
-        if (query.next()) {
-            int lockValue = query.value(0).toInt();
+    if (query->execPrepared()) {
+        if (query->next()) {
+            int lockValue = query->fieldValue(DbFieldIndex(0)).toInt();
             return lockValue == 1;
         }
-    } else {
-        LOG_FAILED_QUERY(query);
     }
     return false;
 }
@@ -489,18 +488,17 @@ bool PlaylistDAO::appendTracksToPlaylist(const QList<TrackId>& trackIds, const i
     ++position;
 
     //Insert the song into the PlaylistTracks table
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "INSERT INTO PlaylistTracks (playlist_id, track_id, position, pl_datetime_added)"
-            "VALUES (:playlist_id, :track_id, :position, CURRENT_TIMESTAMP)"));
-    query.bindValue(":playlist_id", playlistId);
+    auto query = FwdSqlQueryCache::prepare(m_database,
+            QStringLiteral(
+                    "INSERT INTO PlaylistTracks (playlist_id, track_id, position, pl_datetime_added)"
+                    "VALUES (:playlist_id, :track_id, :position, CURRENT_TIMESTAMP)"));
+    query->bindValue(":playlist_id", QVariant(playlistId));
 
     int insertPosition = position;
     for (const auto& trackId : trackIds) {
-        query.bindValue(":track_id", trackId.toVariant());
-        query.bindValue(":position", insertPosition++);
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
+        query->bindValue(":track_id", trackId);
+        query->bindValue(":position", QVariant(insertPosition++));
+        if (!query->execPrepared()) {
             return false;
         }
     }
@@ -1041,19 +1039,19 @@ bool PlaylistDAO::copyPlaylistTracks(const int sourcePlaylistID, const int targe
 int PlaylistDAO::getMaxPosition(const int playlistId) const {
     // Find out the highest position existing in the playlist so we know what
     // position this track should have.
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "SELECT max(position) as position FROM PlaylistTracks "
-            "WHERE playlist_id = :id"));
-    query.bindValue(":id", playlistId);
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    auto query = FwdSqlQueryCache::prepare(m_database,
+            QStringLiteral(
+                    "SELECT max(position) as position FROM PlaylistTracks "
+                    "WHERE playlist_id = :id"));
+    query->bindValue(":id", QVariant(playlistId));
+    if (!query->execPrepared()) {
+        return 0;
     }
 
     // Get the position of the highest track in the playlist.
     int position = 0;
-    if (query.next()) {
-        position = query.value(query.record().indexOf("position")).toInt();
+    if (query->next()) {
+        position = query->fieldValue(query->fieldIndex(QStringLiteral("position"))).toInt();
     }
     return position;
 }
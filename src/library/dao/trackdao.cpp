@@ -29,6 +29,7 @@
 #include "util/assert.h"
 #include "util/datetime.h"
 #include "util/db/fwdsqlquery.h"
+#include "util/db/fwdsqlquerycache.h"
 #include "util/db/sqlite.h"
 #include "util/db/sqlstringformatter.h"
 #include "util/db/sqltransaction.h"
@@ -156,24 +157,23 @@ TrackId TrackDAO::getTrackIdByLocation(const QString& location) const {
         return {};
     }
 
-    QSqlQuery query(m_database);
-    query.prepare(
-            "SELECT library.id FROM library "
-            "INNER JOIN track_locations ON library.location = track_locations.id "
-            "WHERE track_locations.location=:location");
-    query.bindValue(":location", location);
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    auto query = FwdSqlQueryCache::prepare(m_database,
+            QStringLiteral(
+                    "SELECT library.id FROM library "
+                    "INNER JOIN track_locations ON library.location = track_locations.id "
+                    "WHERE track_locations.location=:location"));
+    query->bindValue(":location", location);
+    if (!query->execPrepared()) {
         DEBUG_ASSERT(!"Failed query");
         return {};
     }
-    if (!query.next()) {
+    if (!query->next()) {
         kLogger.debug() << "getTrackId(): Track location not found "
                            "in library:"
                         << location;
         return {};
     }
-    const auto trackId = TrackId(query.value(query.record().indexOf(LIBRARYTABLE_ID)));
+    const auto trackId = TrackId(query->fieldValue(query->fieldIndex(LIBRARYTABLE_ID)));
     DEBUG_ASSERT(trackId.isValid());
     return trackId;
 }
@@ -1463,26 +1463,29 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
             columnsStr.append(columns[i].name);
         }
 
-        QSqlQuery query(m_database);
-        query.prepare(QString(
-                "SELECT %1 FROM Library "
-                "INNER JOIN track_locations ON library.location = track_locations.id "
-                "WHERE library.id = %2")
-                              .arg(columnsStr, trackId.toString()));
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query)
+        // The track id is bound instead of formatted into the statement
+        // to reuse the prepared statement for all tracks.
+        auto query = FwdSqlQueryCache::prepare(m_database,
+                QString(
+                        "SELECT %1 FROM Library "
+                        "INNER JOIN track_locations ON library.location = track_locations.id "
+                        "WHERE library.id=:id")
+                        .arg(columnsStr));
+        query->bindValue(":id", trackId);
+        if (!query->execPrepared()) {
+            kLogger.warning()
                     << QString("getTrack(%1)").arg(trackId.toString());
             DEBUG_ASSERT(!"Failed query");
             return nullptr;
         }
 
-        if (!query.next()) {
+        if (!query->next()) {
             kLogger.debug() << "Track with id =" << trackId << "not found";
             return nullptr;
         }
-        queryRecord = query.record();
+        queryRecord = query->record();
         // Only a single record is expected
-        DEBUG_ASSERT(!query.next());
+        DEBUG_ASSERT(!query->next());
     }
 
     { // Locking scope of cacheResolver
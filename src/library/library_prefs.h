@@ -14,6 +14,19 @@ extern const QString kConfigGroup;
 
 extern const ConfigKey kRescanOnStartupConfigKey;
 
+/// Number of worker threads per stage of the library scanner.
+/// Values <= 0 select the parallel scan mode that scales the
+/// worker pools with the number of available CPU cores.
+extern const ConfigKey kScannerThreadCountConfigKey;
+
+const int kScannerThreadCountDefault = 1;
+
+/// Run all analyzers of a track concurrently on separate threads while
+/// the audio data is decoded only once.
+extern const ConfigKey kAnalyzerPipelineConfigKey;
+
+const bool kAnalyzerPipelineDefault = false;
+
 extern const ConfigKey kKeyNotationConfigKey;
 
 extern const ConfigKey kTrackDoubleClickActionConfigKey;
@@ -22,9 +22,18 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer(QStringLiteral("ImportFilesTask::run"));
+    // Collect the results for the whole directory and report them
+    // in a single batch. The scanner thread then adds all new tracks
+    // of this directory within the current scan transaction without
+    // dispatching a separate queued signal for each file.
+    QStringList existingTrackLocations;
+    QStringList newTrackLocations;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
+            // Tracks that have already been discovered are still
+            // reported to keep the bookkeeping of the scanner consistent.
+            emitBatches(existingTrackLocations, newTrackLocations);
             setSuccess(false);
             return;
         }
@@ -40,7 +49,7 @@ void ImportFilesTask::run() {
             // If the track is in the database, mark it as existing. This code gets
             // executed when other files in the same directory have changed (the
             // directory hash has changed).
-            emit trackExists(trackLocation);
+            existingTrackLocations.append(trackLocation);
         } else {
             if (!fileInfo.exists()) {
                 qWarning() << "ImportFilesTask: Skipping inaccessible file"
@@ -49,10 +58,22 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            newTrackLocations.append(trackLocation);
         }
     }
+    emitBatches(existingTrackLocations, newTrackLocations);
     // Insert or update the hash in the database.
     emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
     setSuccess(true);
 }
+
+void ImportFilesTask::emitBatches(
+        const QStringList& existingTrackLocations,
+        const QStringList& newTrackLocations) {
+    if (!existingTrackLocations.isEmpty()) {
+        emit tracksExist(existingTrackLocations);
+    }
+    if (!newTrackLocations.isEmpty()) {
+        emit addNewTracks(newTrackLocations);
+    }
+}
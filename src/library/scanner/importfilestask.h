@@ -23,6 +23,10 @@ class ImportFilesTask : public ScannerTask {
     virtual void run();
 
   private:
+    void emitBatches(
+            const QStringList& existingTrackLocations,
+            const QStringList& newTrackLocations);
+
     const QString m_dirPath;
     const bool m_prevHashExists;
     const mixxx::cache_key_t m_newHash;
@@ -2,7 +2,9 @@
 
 #include "library/coverartutils.h"
 #include "library/library_decl.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
+#include "library/scanner/importfilestask.h"
 #include "library/scanner/libraryscannerdlg.h"
 #include "library/scanner/recursivescandirectorytask.h"
 #include "library/scanner/scannertask.h"
@@ -14,17 +16,32 @@
 #include "util/db/dbconnectionpooler.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/performancetimer.h"
 #include "util/timer.h"
 #include "util/trace.h"
 
 namespace {
 
-// TODO(rryan) make configurable
-constexpr int kScannerThreadPoolSize = 1;
-
 mixxx::Logger kLogger("LibraryScanner");
 
+/// Scanning is mostly I/O bound, i.e. we may use more threads than
+/// CPU cores without overcommitting the CPU. But the scanner thread
+/// that finally writes all results into the database must not fall
+/// too far behind.
+constexpr int kMaxScannerThreadPoolSize = 16;
+
+int scannerThreadPoolSize(const UserSettingsPointer& pConfig) {
+    const int configuredThreadCount = pConfig->getValue(
+            mixxx::library::prefs::kScannerThreadCountConfigKey,
+            mixxx::library::prefs::kScannerThreadCountDefault);
+    if (configuredThreadCount > 0) {
+        return math_min(configuredThreadCount, kMaxScannerThreadPoolSize);
+    }
+    // Parallel scan mode: Scale with the number of CPU cores
+    return math_clamp(QThread::idealThreadCount(), 1, kMaxScannerThreadPoolSize);
+}
+
 QAtomicInt s_instanceCounter(0);
 
 // Returns the number of affected rows or -1 on error
@@ -108,11 +125,18 @@ LibraryScanner::LibraryScanner(
     // queue to our event loop.
     moveToThread(this);
     m_pool.moveToThread(this);
+    m_importPool.moveToThread(this);
 
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    const int threadPoolSize = scannerThreadPoolSize(pConfig);
+    kLogger.info()
+            << "Using"
+            << threadPoolSize
+            << "worker thread(s) per scanner stage";
+    m_pool.setMaxThreadCount(threadPoolSize);
+    m_importPool.setMaxThreadCount(threadPoolSize);
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -538,10 +562,12 @@ void LibraryScanner::cancel() {
         scanner->cancel();
     }
 
-    // Wait for the thread pool to empty. This is important because ScannerTasks
+    // Wait for the thread pools to empty. This is important because ScannerTasks
     // have pointers to the LibraryScanner and can cause a segfault if they run
-    // after the LibraryScanner has been destroyed.
+    // after the LibraryScanner has been destroyed. Directory tasks might still
+    // queue import tasks until they are finished.
     m_pool.waitForDone();
+    m_importPool.waitForDone();
 }
 
 void LibraryScanner::queueTask(ScannerTask* pTask) {
@@ -564,13 +590,13 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::slotDirectoryUnchanged);
     connect(pTask,
-            &ScannerTask::trackExists,
+            &ScannerTask::tracksExist,
             this,
-            &LibraryScanner::slotTrackExists);
+            &LibraryScanner::slotTracksExist);
     connect(pTask,
-            &ScannerTask::addNewTrack,
+            &ScannerTask::addNewTracks,
             this,
-            &LibraryScanner::slotAddNewTrack);
+            &LibraryScanner::slotAddNewTracks);
 
     // Progress signals.
     // Pass directly to the main thread
@@ -583,7 +609,11 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::progressHashing);
 
-    m_pool.start(pTask);
+    if (qobject_cast<ImportFilesTask*>(pTask)) {
+        m_importPool.start(pTask);
+    } else {
+        m_pool.start(pTask);
+    }
 }
 
 void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
@@ -615,18 +645,32 @@ void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
     emit progressHashing(directoryPath);
 }
 
-void LibraryScanner::slotTrackExists(const QString& trackPath) {
-    //kLogger.debug() << "slotTrackExists" << trackPath;
-    ScopedTimer timer(QStringLiteral("LibraryScanner::slotTrackExists"));
+void LibraryScanner::slotTracksExist(const QStringList& trackPaths) {
+    //kLogger.debug() << "slotTracksExist" << trackPaths;
+    ScopedTimer timer(QStringLiteral("LibraryScanner::slotTracksExist"));
     if (m_scannerGlobal) {
-        m_scannerGlobal->addVerifiedTrack(trackPath);
+        for (const auto& trackPath : trackPaths) {
+            m_scannerGlobal->addVerifiedTrack(trackPath);
+        }
+    }
+}
+
+// triggered by ScannerTask::addNewTracks / in ImportFilesTask::run()
+void LibraryScanner::slotAddNewTracks(const QStringList& trackPaths) {
+    //kLogger.debug() << "slotAddNewTracks" << trackPaths;
+    ScopedTimer timer(QStringLiteral("LibraryScanner::slotAddNewTracks"));
+    // All tracks are added within the single transaction that has
+    // been started by TrackDAO::addTracksPrepare() for the whole scan.
+    for (const auto& trackPath : trackPaths) {
+        if (m_scannerGlobal && m_scannerGlobal->shouldCancel()) {
+            return;
+        }
+        addNewTrack(trackPath);
     }
 }
 
-// triggered by ScannerTask::addNewTrack / in ImportFilesTask::run()
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
-    //kLogger.debug() << "slotAddNewTrack" << trackPath;
-    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTrack"));
+void LibraryScanner::addNewTrack(const QString& trackPath) {
+    //kLogger.debug() << "addNewTrack" << trackPath;
     // For statistics tracking and to detect moved tracks
     TrackPointer pTrack = m_trackDao.addTracksAddFile(
             trackPath,
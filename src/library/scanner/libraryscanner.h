@@ -73,8 +73,8 @@ class LibraryScanner : public QThread {
     void slotDirectoryHashedAndScanned(const QString& directoryPath,
                                    bool newDirectory, mixxx::cache_key_t hash);
     void slotDirectoryUnchanged(const QString& directoryPath);
-    void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotTracksExist(const QStringList& trackPaths);
+    void slotAddNewTracks(const QStringList& trackPaths);
 
   private:
     enum ScannerState {
@@ -100,10 +100,18 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    void addNewTrack(const QString& trackPath);
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
 
-    // The pool of threads used for worker tasks.
+    // The scan is split into two pipeline stages with separate pools
+    // of worker threads. The first stage recursively traverses and
+    // hashes the directories, the second stage checks the files of
+    // changed directories and forwards new tracks for importing. Using
+    // separate pools prevents the directory traversal from being starved
+    // by pending import tasks and vice versa.
     QThreadPool m_pool;
+    QThreadPool m_importPool;
 
     // The library scanner thread's DAOs.
     LibraryHashDAO m_libraryHashDao;
@@ -22,8 +22,10 @@ class ScannerTask : public QObject, public QRunnable {
     void directoryHashedAndScanned(const QString& directoryPath,
                                    bool newDirectory, mixxx::cache_key_t hash);
     void directoryUnchanged(const QString& directoryPath);
-    void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    // Emitted once per directory in batches to reduce the number of
+    // queued signals that need to be dispatched by the scanner thread.
+    void tracksExist(const QStringList& filePaths);
+    void addNewTracks(const QStringList& filePaths);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
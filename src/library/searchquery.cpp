@@ -1,9 +1,12 @@
 #include "library/searchquery.h"
 
 #include <QRegularExpression>
+#include <algorithm>
+#include <iterator>
 
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
+#include "library/tracksearchindex.h"
 #include "library/trackset/crate/crateschema.h"
 #include "library/trackset/crate/cratestorage.h" // for CrateTrackSelectResult
 #include "track/keyutils.h"
@@ -104,6 +107,28 @@ QString concatSqlClauses(
 
 } // namespace
 
+bool AndNode::search(const TrackSearchIndex& index,
+        std::vector<TrackId>* pTrackIds) const {
+    // An empty AND node matches all tracks, consistent with match()
+    std::vector<TrackId> result = index.allTrackIds();
+    std::vector<TrackId> nodeTrackIds;
+    std::vector<TrackId> intersection;
+    for (const auto& pNode : m_nodes) {
+        if (!pNode->search(index, &nodeTrackIds)) {
+            return false;
+        }
+        intersection.clear();
+        std::set_intersection(result.begin(),
+                result.end(),
+                nodeTrackIds.begin(),
+                nodeTrackIds.end(),
+                std::back_inserter(intersection));
+        result.swap(intersection);
+    }
+    *pTrackIds = std::move(result);
+    return true;
+}
+
 bool AndNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode : m_nodes) {
         if (!pNode->match(pTrack)) {
@@ -136,6 +161,28 @@ bool OrNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool OrNode::search(const TrackSearchIndex& index,
+        std::vector<TrackId>* pTrackIds) const {
+    // An empty OR node matches no tracks, consistent with toSql()
+    std::vector<TrackId> result;
+    std::vector<TrackId> nodeTrackIds;
+    std::vector<TrackId> merged;
+    for (const auto& pNode : m_nodes) {
+        if (!pNode->search(index, &nodeTrackIds)) {
+            return false;
+        }
+        merged.clear();
+        std::set_union(result.begin(),
+                result.end(),
+                nodeTrackIds.begin(),
+                nodeTrackIds.end(),
+                std::back_inserter(merged));
+        result.swap(merged);
+    }
+    *pTrackIds = std::move(result);
+    return true;
+}
+
 QString OrNode::toSql() const {
     if (m_nodes.empty()) {
         return "FALSE";
@@ -155,6 +202,22 @@ bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
 
+bool NotNode::search(const TrackSearchIndex& index,
+        std::vector<TrackId>* pTrackIds) const {
+    std::vector<TrackId> nodeTrackIds;
+    if (!m_pNode->search(index, &nodeTrackIds)) {
+        return false;
+    }
+    const std::vector<TrackId>& allTrackIds = index.allTrackIds();
+    pTrackIds->clear();
+    std::set_difference(allTrackIds.begin(),
+            allTrackIds.end(),
+            nodeTrackIds.begin(),
+            nodeTrackIds.end(),
+            std::back_inserter(*pTrackIds));
+    return true;
+}
+
 QString NotNode::toSql() const {
     QString sql(m_pNode->toSql());
     if (sql.isEmpty()) {
@@ -228,6 +291,19 @@ QString TextFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool TextFilterNode::search(const TrackSearchIndex& index,
+        std::vector<TrackId>* pTrackIds) const {
+    if (m_matchMode != StringMatch::Contains) {
+        return false;
+    }
+    // The argument is passed verbatim to LIKE, i.e. it might contain
+    // wildcards that are not supported by the index.
+    if (m_argument.contains(kSqlLikeMatchOne) || m_argument.contains(kSqlLikeMatchAll)) {
+        return false;
+    }
+    return index.findTracksContaining(m_sqlColumns, m_argument, pTrackIds);
+}
+
 bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -255,21 +331,36 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
           m_matchInitialized(false) {
 }
 
-bool CrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        CrateTrackSelectResult crateTracks(
-                m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
+void CrateFilterNode::initMatchingTrackIds() const {
+    if (m_matchInitialized) {
+        return;
+    }
+    CrateTrackSelectResult crateTracks(
+            m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
 
-        while (crateTracks.next()) {
+    while (crateTracks.next()) {
+        // Tracks might be contained in multiple matching crates
+        if (m_matchingTrackIds.empty() || m_matchingTrackIds.back() != crateTracks.trackId()) {
             m_matchingTrackIds.push_back(crateTracks.trackId());
         }
-
-        m_matchInitialized = true;
     }
 
+    m_matchInitialized = true;
+}
+
+bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    initMatchingTrackIds();
     return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
 }
 
+bool CrateFilterNode::search(const TrackSearchIndex& index,
+        std::vector<TrackId>* pTrackIds) const {
+    Q_UNUSED(index);
+    initMatchingTrackIds();
+    *pTrackIds = m_matchingTrackIds;
+    return true;
+}
+
 QString CrateFilterNode::toSql() const {
     return QString("id IN (%1)")
             .arg(m_pCrateStorage->formatQueryForTrackIdsByCrateNameLike(
@@ -281,21 +372,39 @@ NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
           m_matchInitialized(false) {
 }
 
-bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        TrackSelectResult tracks(
-                m_pCrateStorage->selectAllTracksSorted());
-
-        while (tracks.next()) {
-            m_matchingTrackIds.push_back(tracks.trackId());
-        }
+void NoCrateFilterNode::initMatchingTrackIds() const {
+    if (m_matchInitialized) {
+        return;
+    }
+    TrackSelectResult tracks(
+            m_pCrateStorage->selectAllTracksSorted());
 
-        m_matchInitialized = true;
+    while (tracks.next()) {
+        m_matchingTrackIds.push_back(tracks.trackId());
     }
 
+    m_matchInitialized = true;
+}
+
+bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    initMatchingTrackIds();
     return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
 }
 
+bool NoCrateFilterNode::search(const TrackSearchIndex& index,
+        std::vector<TrackId>* pTrackIds) const {
+    // m_matchingTrackIds contains all tracks with a crate
+    initMatchingTrackIds();
+    const std::vector<TrackId>& allTrackIds = index.allTrackIds();
+    pTrackIds->clear();
+    std::set_difference(allTrackIds.begin(),
+            allTrackIds.end(),
+            m_matchingTrackIds.begin(),
+            m_matchingTrackIds.end(),
+            std::back_inserter(*pTrackIds));
+    return true;
+}
+
 QString NoCrateFilterNode::toSql() const {
     return QString("%1 NOT IN (%2)")
             .arg(CRATETABLE_ID,
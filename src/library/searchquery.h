@@ -15,6 +15,7 @@
 
 class CrateStorage;
 class TrackId;
+class TrackSearchIndex;
 
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
 
@@ -31,6 +32,16 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    /// Evaluates the node against the in-memory search index and stores
+    /// the sorted ids of all matching tracks. Returns false if the node
+    /// can only be evaluated by SQL.
+    virtual bool search(const TrackSearchIndex& index,
+            std::vector<TrackId>* pTrackIds) const {
+        Q_UNUSED(index);
+        Q_UNUSED(pTrackIds);
+        return false;
+    }
+
   protected:
     QueryNode() = default;
 };
@@ -53,12 +64,16 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const TrackSearchIndex& index,
+            std::vector<TrackId>* pTrackIds) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const TrackSearchIndex& index,
+            std::vector<TrackId>* pTrackIds) const override;
 };
 
 class NotNode : public QueryNode {
@@ -70,6 +85,8 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const TrackSearchIndex& index,
+            std::vector<TrackId>* pTrackIds) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -84,6 +101,8 @@ class TextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const TrackSearchIndex& index,
+            std::vector<TrackId>* pTrackIds) const override;
 
   private:
     QSqlDatabase m_database;
@@ -115,8 +134,12 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const TrackSearchIndex& index,
+            std::vector<TrackId>* pTrackIds) const override;
 
   private:
+    void initMatchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -129,8 +152,12 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const TrackSearchIndex& index,
+            std::vector<TrackId>* pTrackIds) const override;
 
   private:
+    void initMatchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
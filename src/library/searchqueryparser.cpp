@@ -140,6 +140,15 @@ void SearchQueryParser::setSearchColumns(QStringList searchColumns) {
     }
 }
 
+QStringList SearchQueryParser::textColumns() const {
+    QStringList columns = m_queryColumns;
+    for (const auto& field : m_textFilters) {
+        columns += m_fieldToSqlColumns.value(field);
+    }
+    columns.removeDuplicates();
+    return columns;
+}
+
 SearchQueryParser::TextArgumentResult SearchQueryParser::getTextArgument(QString argument,
         QStringList* tokens,
         bool removeLeadingEqualsSign) const {
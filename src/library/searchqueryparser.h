@@ -17,6 +17,9 @@ class SearchQueryParser {
 
     void setSearchColumns(QStringList searchColumns);
 
+    /// All columns that might be searched by text filters
+    QStringList textColumns() const;
+
     std::unique_ptr<QueryNode> parseQuery(
             const QString& query,
             const QString& extraFilter) const;
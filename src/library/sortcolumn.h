@@ -0,0 +1,13 @@
+#pragma once
+
+#include <Qt>
+
+class SortColumn {
+  public:
+    SortColumn(int column, Qt::SortOrder order)
+        : m_column(column),
+          m_order(order) {
+    }
+    int m_column;
+    Qt::SortOrder m_order;
+};
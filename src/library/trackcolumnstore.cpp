@@ -0,0 +1,767 @@
+#include "library/trackcolumnstore.h"
+
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+#include "util/assert.h"
+
+namespace {
+
+// Smaller tasks are not worth to be run on a separate thread
+constexpr std::size_t kMinRowsPerTask = 16384;
+
+// Updating the sorted rows of a column moves all following rows. After
+// that many updates rebuilding them from scratch on demand is cheaper.
+constexpr int kMaxSortedRowUpdates = 1024;
+
+// Doubles represent all integers up to this magnitude exactly
+constexpr double kMaxExactInteger = 9007199254740992.0;
+
+constexpr double kNoNumber = std::numeric_limits<double>::quiet_NaN();
+
+int numTasks(std::size_t size) {
+    const auto maxTasks = static_cast<std::size_t>(
+            std::max(QThreadPool::globalInstance()->maxThreadCount(), 1));
+    return static_cast<int>(std::clamp(size / kMinRowsPerTask,
+            static_cast<std::size_t>(1),
+            maxTasks));
+}
+
+/// Invokes func(task) for each task in 0..numTasks-1. Task 0 runs on the
+/// calling thread, the other tasks in the global thread pool.
+template<typename Func>
+void runTasks(int numTasks, const Func& func) {
+    QVector<QFuture<void>> futures;
+    futures.reserve(numTasks - 1);
+    for (int task = 1; task < numTasks; ++task) {
+        futures.append(QtConcurrent::run([&func, task] {
+            func(task);
+        }));
+    }
+    func(0);
+    for (auto& future : futures) {
+        future.waitForFinished();
+    }
+}
+
+/// Sorts slices of the range concurrently and merges them pairwise.
+template<typename T, typename Less>
+void parallelSort(std::vector<T>* pValues, const Less& less) {
+    const int tasks = numTasks(pValues->size());
+    if (tasks <= 1) {
+        std::sort(pValues->begin(), pValues->end(), less);
+        return;
+    }
+    std::vector<std::size_t> bounds;
+    bounds.reserve(tasks + 1);
+    for (int task = 0; task <= tasks; ++task) {
+        bounds.push_back(pValues->size() * task / tasks);
+    }
+    const auto begin = pValues->begin();
+    runTasks(tasks, [&](int task) {
+        std::sort(begin + bounds[task], begin + bounds[task + 1], less);
+    });
+    while (bounds.size() > 2) {
+        const int merges = static_cast<int>(bounds.size() - 1) / 2;
+        runTasks(merges, [&](int merge) {
+            std::inplace_merge(begin + bounds[2 * merge],
+                    begin + bounds[2 * merge + 1],
+                    begin + bounds[2 * merge + 2],
+                    less);
+        });
+        std::vector<std::size_t> mergedBounds;
+        mergedBounds.reserve(merges + 2);
+        for (std::size_t i = 0; i < bounds.size(); i += 2) {
+            mergedBounds.push_back(bounds[i]);
+        }
+        if (mergedBounds.back() != bounds.back()) {
+            mergedBounds.push_back(bounds.back());
+        }
+        bounds = std::move(mergedBounds);
+    }
+}
+
+bool isNumberType(int metaType) {
+    switch (metaType) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isIntegerType(int metaType) {
+    return isNumberType(metaType) &&
+            metaType != QMetaType::Float &&
+            metaType != QMetaType::Double;
+}
+
+QVariant numberToVariant(double number, int metaType) {
+    switch (metaType) {
+    case QMetaType::Bool:
+        return QVariant{number != 0};
+    case QMetaType::Int:
+        return QVariant{static_cast<int>(number)};
+    case QMetaType::UInt:
+        return QVariant{static_cast<uint>(number)};
+    case QMetaType::LongLong:
+        return QVariant{static_cast<qlonglong>(number)};
+    case QMetaType::ULongLong:
+        return QVariant{static_cast<qulonglong>(number)};
+    case QMetaType::Float:
+        return QVariant{static_cast<float>(number)};
+    default:
+        return QVariant{number};
+    }
+}
+
+QVariant nullVariant(int metaType) {
+    if (metaType == QMetaType::UnknownType) {
+        return QVariant{};
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return QVariant{QMetaType(metaType)};
+#else
+    return QVariant{metaType, nullptr};
+#endif
+}
+
+bool isNull(const QVariant& value) {
+    return !value.isValid() || value.isNull();
+}
+
+// Like CAST(value AS INTEGER) in SQLite, which takes the longest prefix
+// of a string that is an integer, e.g. 3 for "3/12" and 0 for "A1"
+double integerValue(const QVariant& value) {
+    if (isNumberType(value.userType())) {
+        return std::trunc(value.toDouble());
+    }
+    const QString text = value.toString();
+    int i = 0;
+    while (i < text.size() && text[i].isSpace()) {
+        ++i;
+    }
+    bool negative = false;
+    if (i < text.size() && (text[i] == QChar('-') || text[i] == QChar('+'))) {
+        negative = text[i] == QChar('-');
+        ++i;
+    }
+    double number = 0;
+    for (; i < text.size() && text[i] >= QChar('0') && text[i] <= QChar('9'); ++i) {
+        number = number * 10 + (text[i].unicode() - '0');
+    }
+    return negative ? -number : number;
+}
+
+double keyOrder(const QString& keyText, KeyUtils::KeyNotation keyNotation) {
+    return KeyUtils::keyToCircleOfFifthsOrder(
+            KeyUtils::guessKeyFromText(keyText), keyNotation);
+}
+
+} // anonymous namespace
+
+TrackColumnStore::TrackColumnStore(QVector<SortKind> sortKinds)
+        : m_sortedRowUpdates(0) {
+    m_columns.reserve(sortKinds.size());
+    for (SortKind sortKind : std::as_const(sortKinds)) {
+        m_columns.emplace_back(sortKind);
+    }
+}
+
+int TrackColumnStore::internString(const QString& string) {
+    const auto it = m_stringIds.constFind(string);
+    if (it != m_stringIds.constEnd()) {
+        return it.value();
+    }
+    const int stringId = static_cast<int>(m_strings.size());
+    m_strings.push_back(string);
+    m_stringIds.insert(string, stringId);
+    return stringId;
+}
+
+void TrackColumnStore::ensureSortKeys() {
+    const std::size_t first = m_stringSortKeys.size();
+    const std::size_t count = m_strings.size() - first;
+    if (count == 0) {
+        return;
+    }
+    // A QCollator must not be used concurrently, so each task has its own
+    const int tasks = numTasks(count);
+    std::vector<std::vector<QCollatorSortKey>> taskSortKeys(tasks);
+    runTasks(tasks, [&](int task) {
+        const mixxx::StringCollator collator;
+        const std::size_t begin = first + count * task / tasks;
+        const std::size_t end = first + count * (task + 1) / tasks;
+        taskSortKeys[task].reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i) {
+            taskSortKeys[task].push_back(collator.sortKey(m_strings[i]));
+        }
+    });
+    m_stringSortKeys.reserve(m_strings.size());
+    for (const auto& sortKeys : taskSortKeys) {
+        m_stringSortKeys.insert(m_stringSortKeys.end(), sortKeys.begin(), sortKeys.end());
+    }
+}
+
+int TrackColumnStore::allocateRow(TrackId trackId) {
+    int row;
+    if (m_freeRows.empty()) {
+        row = static_cast<int>(m_trackIds.size());
+        m_trackIds.push_back(trackId);
+        for (auto& column : m_columns) {
+            switch (column.storage) {
+            case Storage::None:
+                break;
+            case Storage::Number:
+                column.numbers.push_back(kNoNumber);
+                break;
+            case Storage::String:
+                column.strings.push_back(-1);
+                break;
+            case Storage::Variant:
+                column.variants.push_back(nullVariant(column.nullMetaType));
+                break;
+            }
+        }
+    } else {
+        row = m_freeRows.back();
+        m_freeRows.pop_back();
+        m_trackIds[row] = trackId;
+    }
+    m_rows.insert(trackId, row);
+    return row;
+}
+
+void TrackColumnStore::setValue(Column* pColumn, int row, const QVariant& value) {
+    Column& column = *pColumn;
+    if (!column.exceptions.isEmpty()) {
+        column.exceptions.remove(row);
+    }
+    const bool null = isNull(value);
+    if (null && column.nullMetaType == QMetaType::UnknownType) {
+        column.nullMetaType = value.userType();
+    }
+    if (column.storage == Storage::None) {
+        if (null) {
+            return;
+        }
+        // The first value determines how the column is stored
+        const auto numRows = m_trackIds.size();
+        column.metaType = value.userType();
+        if (isNumberType(column.metaType)) {
+            column.storage = Storage::Number;
+            column.numbers.assign(numRows, kNoNumber);
+        } else if (column.metaType == QMetaType::QString) {
+            column.storage = Storage::String;
+            column.strings.assign(numRows, -1);
+        } else {
+            column.storage = Storage::Variant;
+            column.variants.assign(numRows, nullVariant(column.nullMetaType));
+        }
+    }
+    switch (column.storage) {
+    case Storage::None:
+        DEBUG_ASSERT(!"unreachable");
+        return;
+    case Storage::Number:
+        if (!null && value.userType() == column.metaType) {
+            const double number = value.toDouble();
+            if (!std::isnan(number) &&
+                    (!isIntegerType(column.metaType) ||
+                            std::fabs(number) <= kMaxExactInteger)) {
+                column.numbers[row] = number;
+                return;
+            }
+        }
+        column.numbers[row] = kNoNumber;
+        break;
+    case Storage::String:
+        if (!null && value.userType() == QMetaType::QString) {
+            column.strings[row] = internString(value.toString());
+            return;
+        }
+        column.strings[row] = -1;
+        break;
+    case Storage::Variant:
+        column.variants[row] = value;
+        return;
+    }
+    if (!null) {
+        column.exceptions.insert(row, value);
+    }
+}
+
+QVariant TrackColumnStore::valueAt(const Column& column, int row) const {
+    switch (column.storage) {
+    case Storage::None:
+        return nullVariant(column.nullMetaType);
+    case Storage::Number: {
+        const double number = column.numbers[row];
+        if (!std::isnan(number)) {
+            return numberToVariant(number, column.metaType);
+        }
+        break;
+    }
+    case Storage::String: {
+        const int stringId = column.strings[row];
+        if (stringId >= 0) {
+            return QVariant{m_strings[stringId]};
+        }
+        break;
+    }
+    case Storage::Variant:
+        return column.variants[row];
+    }
+    const auto it = column.exceptions.constFind(row);
+    if (it != column.exceptions.constEnd()) {
+        return it.value();
+    }
+    return nullVariant(column.nullMetaType);
+}
+
+QVariant TrackColumnStore::value(TrackId trackId, int column) const {
+    const auto it = m_rows.constFind(trackId);
+    if (it == m_rows.constEnd() || column < 0 || column >= columnCount()) {
+        return QVariant{};
+    }
+    return valueAt(m_columns[column], it.value());
+}
+
+void TrackColumnStore::setValues(TrackId trackId, const QVector<QVariant>& values) {
+    DEBUG_ASSERT(values.size() == columnCount());
+    countSortedRowUpdate();
+
+    int row;
+    bool added = false;
+    const auto it = m_rows.constFind(trackId);
+    if (it != m_rows.constEnd()) {
+        row = it.value();
+    } else {
+        row = allocateRow(trackId);
+        added = true;
+    }
+    for (int i = 0; i < columnCount(); ++i) {
+        Column& column = m_columns[i];
+        column.ranksValid = false;
+        if (column.sortedRows.empty()) {
+            setValue(&column, row, values.value(i));
+            continue;
+        }
+        if (!added) {
+            removeSortedRow(&column, row);
+        }
+        setValue(&column, row, values.value(i));
+        insertSortedRow(&column, row);
+    }
+}
+
+void TrackColumnStore::removeTrack(TrackId trackId) {
+    const auto it = m_rows.constFind(trackId);
+    if (it == m_rows.constEnd()) {
+        return;
+    }
+    countSortedRowUpdate();
+    const int row = it.value();
+    m_rows.erase(it);
+    for (auto& column : m_columns) {
+        column.ranksValid = false;
+        if (!column.sortedRows.empty()) {
+            removeSortedRow(&column, row);
+        }
+        setValue(&column, row, QVariant{});
+    }
+    m_trackIds[row] = TrackId();
+    m_freeRows.push_back(row);
+}
+
+void TrackColumnStore::clear() {
+    for (auto& column : m_columns) {
+        column = Column(column.sortKind);
+    }
+    m_rows.clear();
+    m_trackIds.clear();
+    m_freeRows.clear();
+    m_strings.clear();
+    m_stringSortKeys.clear();
+    m_stringIds.clear();
+    m_sortedRowUpdates = 0;
+}
+
+void TrackColumnStore::countSortedRowUpdate() {
+    const bool sorted = std::any_of(m_columns.begin(), m_columns.end(), [](const Column& column) {
+        return !column.sortedRows.empty();
+    });
+    if (sorted && ++m_sortedRowUpdates > kMaxSortedRowUpdates) {
+        invalidateSortedRows();
+    }
+}
+
+void TrackColumnStore::invalidateSortedRows() {
+    for (auto& column : m_columns) {
+        column.sortedRows = std::vector<int>();
+        column.ranks = std::vector<int>();
+        column.ranksValid = false;
+    }
+    m_sortedRowUpdates = 0;
+}
+
+TrackColumnStore::RowValue TrackColumnStore::rowValue(const Column& column, int row) const {
+    if (column.storage == Storage::Number && !std::isnan(column.numbers[row]) &&
+            (column.sortKind == SortKind::Default ||
+                    column.sortKind == SortKind::Number)) {
+        return RowValue(RowValue::Type::Number, column.numbers[row], nullptr);
+    }
+    if (column.storage == Storage::String && column.strings[row] >= 0 &&
+            column.sortKind == SortKind::Default) {
+        return RowValue(RowValue::Type::String, 0, &m_stringSortKeys[column.strings[row]]);
+    }
+    const QVariant value = valueAt(column, row);
+    if (isNull(value)) {
+        return RowValue(RowValue::Type::Null, 0, nullptr);
+    }
+    switch (column.sortKind) {
+    case SortKind::Number:
+        return RowValue(RowValue::Type::Number, value.toDouble(), nullptr);
+    case SortKind::Integer:
+        return RowValue(RowValue::Type::Number, integerValue(value), nullptr);
+    case SortKind::Text: {
+        RowValue rowValue(RowValue::Type::Text, 0, nullptr);
+        rowValue.text = value.toString().toLower();
+        return rowValue;
+    }
+    case SortKind::Key:
+        return RowValue(RowValue::Type::Number,
+                keyOrder(value.toString(), column.keyNotation),
+                nullptr);
+    case SortKind::Default:
+        break;
+    }
+    if (isNumberType(value.userType())) {
+        return RowValue(RowValue::Type::Number, value.toDouble(), nullptr);
+    }
+    RowValue rowValue(RowValue::Type::String, 0, nullptr);
+    rowValue.ownSortKey = m_collator.sortKey(value.toString());
+    return rowValue;
+}
+
+int TrackColumnStore::compareRows(const Column& column, int lhs, int rhs) const {
+    const RowValue lhsValue = rowValue(column, lhs);
+    const RowValue rhsValue = rowValue(column, rhs);
+    if (lhsValue.type != rhsValue.type) {
+        return lhsValue.type < rhsValue.type ? -1 : 1;
+    }
+    switch (lhsValue.type) {
+    case RowValue::Type::Null:
+        return 0;
+    case RowValue::Type::Number:
+        if (lhsValue.number == rhsValue.number) {
+            return 0;
+        }
+        return lhsValue.number < rhsValue.number ? -1 : 1;
+    case RowValue::Type::String:
+        return lhsValue.sortKey().compare(rhsValue.sortKey());
+    case RowValue::Type::Text:
+        return lhsValue.text.compare(rhsValue.text);
+    }
+    return 0;
+}
+
+bool TrackColumnStore::lessRows(const Column& column, int lhs, int rhs) const {
+    const int result = compareRows(column, lhs, rhs);
+    if (result != 0) {
+        return result < 0;
+    }
+    return m_trackIds[lhs] < m_trackIds[rhs];
+}
+
+void TrackColumnStore::removeSortedRow(Column* pColumn, int row) {
+    auto& sortedRows = pColumn->sortedRows;
+    const auto it = std::find(sortedRows.begin(), sortedRows.end(), row);
+    VERIFY_OR_DEBUG_ASSERT(it != sortedRows.end()) {
+        return;
+    }
+    sortedRows.erase(it);
+}
+
+void TrackColumnStore::insertSortedRow(Column* pColumn, int row) {
+    ensureSortKeys();
+    auto& sortedRows = pColumn->sortedRows;
+    const auto it = std::upper_bound(sortedRows.begin(),
+            sortedRows.end(),
+            row,
+            [this, pColumn](int lhs, int rhs) {
+                return lessRows(*pColumn, lhs, rhs);
+            });
+    sortedRows.insert(it, row);
+}
+
+void TrackColumnStore::buildSortedRows(Column* pColumn, KeyUtils::KeyNotation keyNotation) {
+    Column& column = *pColumn;
+    column.keyNotation = keyNotation;
+    ensureSortKeys();
+
+    // Replace the values by keys that compare like the values, i.e.
+    // strings by their position among all strings of the column.
+    struct RowKey {
+        RowValue::Type type;
+        double value;
+    };
+    const int numRows = static_cast<int>(m_trackIds.size());
+    std::vector<RowKey> keys(numRows, RowKey{RowValue::Type::Null, 0});
+    std::vector<int> stringIds(numRows, -1);
+    // Sort keys of the strings that are not interned
+    std::vector<std::optional<QCollatorSortKey>> otherSortKeys(numRows);
+    struct TextRef {
+        QString text;
+        int row;
+    };
+    std::vector<TextRef> texts;
+    std::vector<double> keyOrders;
+    if (column.sortKind == SortKind::Key) {
+        keyOrders.assign(m_strings.size(), kNoNumber);
+    }
+    for (int row = 0; row < numRows; ++row) {
+        if (!m_trackIds[row].isValid()) {
+            continue;
+        }
+        if (column.storage == Storage::String && column.strings[row] >= 0) {
+            const int stringId = column.strings[row];
+            if (column.sortKind == SortKind::Default) {
+                keys[row].type = RowValue::Type::String;
+                stringIds[row] = stringId;
+                continue;
+            }
+            if (column.sortKind == SortKind::Key) {
+                // Parse each distinct key only once
+                double& order = keyOrders[stringId];
+                if (std::isnan(order)) {
+                    order = keyOrder(m_strings[stringId], keyNotation);
+                }
+                keys[row] = RowKey{RowValue::Type::Number, order};
+                continue;
+            }
+        }
+        RowValue rowValue = this->rowValue(column, row);
+        keys[row] = RowKey{rowValue.type, rowValue.number};
+        if (rowValue.type == RowValue::Type::String) {
+            otherSortKeys[row] = std::move(rowValue.ownSortKey);
+        } else if (rowValue.type == RowValue::Type::Text) {
+            texts.push_back(TextRef{std::move(rowValue.text), row});
+        }
+    }
+
+    // The distinct sort keys in ascending order
+    struct SortKeyRef {
+        const QCollatorSortKey* pSortKey;
+        // The interned string or otherwise the row of the sort key
+        int stringId;
+        int row;
+    };
+    std::vector<SortKeyRef> sortKeys;
+    std::vector<char> used(m_strings.size(), 0);
+    for (int row = 0; row < numRows; ++row) {
+        const int stringId = stringIds[row];
+        if (stringId >= 0 && !used[stringId]) {
+            used[stringId] = 1;
+            sortKeys.push_back(SortKeyRef{&m_stringSortKeys[stringId], stringId, -1});
+        } else if (otherSortKeys[row]) {
+            sortKeys.push_back(SortKeyRef{&*otherSortKeys[row], -1, row});
+        }
+    }
+    parallelSort(&sortKeys, [](const SortKeyRef& lhs, const SortKeyRef& rhs) {
+        return lhs.pSortKey->compare(*rhs.pSortKey) < 0;
+    });
+    std::vector<double> stringOrders(m_strings.size(), 0);
+    double order = 0;
+    for (std::size_t i = 0; i < sortKeys.size(); ++i) {
+        if (i > 0 && sortKeys[i - 1].pSortKey->compare(*sortKeys[i].pSortKey) != 0) {
+            ++order;
+        }
+        if (sortKeys[i].stringId >= 0) {
+            stringOrders[sortKeys[i].stringId] = order;
+        } else {
+            keys[sortKeys[i].row].value = order;
+        }
+    }
+    for (int row = 0; row < numRows; ++row) {
+        if (stringIds[row] >= 0) {
+            keys[row].value = stringOrders[stringIds[row]];
+        }
+    }
+    parallelSort(&texts, [](const TextRef& lhs, const TextRef& rhs) {
+        return lhs.text < rhs.text;
+    });
+    double textOrder = 0;
+    for (std::size_t i = 0; i < texts.size(); ++i) {
+        if (i > 0 && texts[i - 1].text != texts[i].text) {
+            ++textOrder;
+        }
+        keys[texts[i].row].value = textOrder;
+    }
+
+    column.sortedRows.clear();
+    column.sortedRows.reserve(m_rows.size());
+    for (int row = 0; row < numRows; ++row) {
+        if (m_trackIds[row].isValid()) {
+            column.sortedRows.push_back(row);
+        }
+    }
+    const auto equalKeys = [&keys](int lhs, int rhs) {
+        return keys[lhs].type == keys[rhs].type && keys[lhs].value == keys[rhs].value;
+    };
+    parallelSort(&column.sortedRows, [this, &keys, &equalKeys](int lhs, int rhs) {
+        if (!equalKeys(lhs, rhs)) {
+            if (keys[lhs].type != keys[rhs].type) {
+                return keys[lhs].type < keys[rhs].type;
+            }
+            return keys[lhs].value < keys[rhs].value;
+        }
+        return m_trackIds[lhs] < m_trackIds[rhs];
+    });
+
+    column.ranks.assign(numRows, -1);
+    for (std::size_t i = 0; i < column.sortedRows.size(); ++i) {
+        const int row = column.sortedRows[i];
+        if (i > 0 && equalKeys(column.sortedRows[i - 1], row)) {
+            column.ranks[row] = column.ranks[column.sortedRows[i - 1]];
+        } else {
+            column.ranks[row] = static_cast<int>(i);
+        }
+    }
+    column.ranksValid = true;
+}
+
+void TrackColumnStore::updateRanks(Column* pColumn) {
+    Column& column = *pColumn;
+    if (column.ranksValid) {
+        return;
+    }
+    ensureSortKeys();
+    column.ranks.assign(m_trackIds.size(), -1);
+    for (std::size_t i = 0; i < column.sortedRows.size(); ++i) {
+        const int row = column.sortedRows[i];
+        const int previousRow = i > 0 ? column.sortedRows[i - 1] : -1;
+        if (previousRow >= 0 && compareRows(column, previousRow, row) == 0) {
+            column.ranks[row] = column.ranks[previousRow];
+        } else {
+            column.ranks[row] = static_cast<int>(i);
+        }
+    }
+    column.ranksValid = true;
+}
+
+QVector<TrackId> TrackColumnStore::sortTracks(
+        const std::vector<TrackId>& trackIds,
+        const QList<SortColumn>& sortColumns,
+        KeyUtils::KeyNotation keyNotation) {
+    std::vector<std::pair<const Column*, bool>> sortOrder;
+    for (const auto& sortColumn : sortColumns) {
+        if (sortColumn.m_column < 0 || sortColumn.m_column >= columnCount()) {
+            continue;
+        }
+        Column* pColumn = &m_columns[sortColumn.m_column];
+        if (pColumn->sortedRows.empty() ||
+                (pColumn->sortKind == SortKind::Key && pColumn->keyNotation != keyNotation)) {
+            buildSortedRows(pColumn, keyNotation);
+        }
+        updateRanks(pColumn);
+        sortOrder.emplace_back(pColumn, sortColumn.m_order == Qt::DescendingOrder);
+    }
+
+    QVector<TrackId> sortedTrackIds;
+    sortedTrackIds.reserve(static_cast<int>(trackIds.size()));
+    if (sortOrder.empty()) {
+        for (const auto& trackId : trackIds) {
+            sortedTrackIds.append(trackId);
+        }
+        return sortedTrackIds;
+    }
+
+    std::vector<char> selected(m_trackIds.size(), 0);
+    QVector<TrackId> missingTrackIds;
+    for (const auto& trackId : trackIds) {
+        const auto it = m_rows.constFind(trackId);
+        if (it != m_rows.constEnd()) {
+            selected[it.value()] = 1;
+        } else {
+            missingTrackIds.append(trackId);
+        }
+    }
+
+    // The cached order of the first column already sorts the selected
+    // rows except for ties
+    const Column& primaryColumn = *sortOrder.front().first;
+    const std::vector<int>& sortedRows = primaryColumn.sortedRows;
+    const int filterTasks = numTasks(sortedRows.size());
+    std::vector<std::vector<int>> filteredRows(filterTasks);
+    runTasks(filterTasks, [&](int task) {
+        const auto begin = sortedRows.begin() + sortedRows.size() * task / filterTasks;
+        const auto end = sortedRows.begin() + sortedRows.size() * (task + 1) / filterTasks;
+        std::copy_if(begin, end, std::back_inserter(filteredRows[task]), [&selected](int row) {
+            return selected[row] != 0;
+        });
+    });
+    std::vector<int> rows;
+    rows.reserve(trackIds.size());
+    for (const auto& taskRows : filteredRows) {
+        rows.insert(rows.end(), taskRows.begin(), taskRows.end());
+    }
+    if (sortOrder.front().second) {
+        std::reverse(rows.begin(), rows.end());
+    }
+
+    // Order the ties of the first column by the other columns. Tasks are
+    // split between ties.
+    const std::vector<int>& primaryRanks = primaryColumn.ranks;
+    const int tieTasks = numTasks(rows.size());
+    std::vector<std::size_t> bounds{0};
+    for (int task = 1; task < tieTasks; ++task) {
+        std::size_t bound = std::max(rows.size() * task / tieTasks, bounds.back());
+        while (bound > 0 && bound < rows.size() &&
+                primaryRanks[rows[bound]] == primaryRanks[rows[bound - 1]]) {
+            ++bound;
+        }
+        bounds.push_back(bound);
+    }
+    bounds.push_back(rows.size());
+    const auto lessTie = [this, &sortOrder](int lhs, int rhs) {
+        for (std::size_t i = 1; i < sortOrder.size(); ++i) {
+            const std::vector<int>& ranks = sortOrder[i].first->ranks;
+            if (ranks[lhs] != ranks[rhs]) {
+                return sortOrder[i].second ? ranks[lhs] > ranks[rhs] : ranks[lhs] < ranks[rhs];
+            }
+        }
+        return m_trackIds[lhs] < m_trackIds[rhs];
+    };
+    runTasks(tieTasks, [&](int task) {
+        auto tieBegin = rows.begin() + bounds[task];
+        const auto end = rows.begin() + bounds[task + 1];
+        while (tieBegin != end) {
+            const int rank = primaryRanks[*tieBegin];
+            const auto tieEnd = std::find_if(tieBegin, end, [&primaryRanks, rank](int row) {
+                return primaryRanks[row] != rank;
+            });
+            if (tieEnd - tieBegin > 1) {
+                std::sort(tieBegin, tieEnd, lessTie);
+            }
+            tieBegin = tieEnd;
+        }
+    });
+
+    for (int row : rows) {
+        sortedTrackIds.append(m_trackIds[row]);
+    }
+    sortedTrackIds.append(missingTrackIds);
+    return sortedTrackIds;
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <QCollatorSortKey>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+#include <optional>
+#include <vector>
+
+#include "library/sortcolumn.h"
+#include "track/keyutils.h"
+#include "track/trackid.h"
+#include "util/string.h"
+
+/// Column oriented storage of the cached values of a BaseTrackCache.
+///
+/// Each track occupies one row. The values of a column are stored in a
+/// typed array that is chosen by the type of the first non-null value,
+/// i.e. numbers as doubles and strings as ids of interned strings. Values
+/// of a different type are kept in a per-column QHash. Every distinct
+/// string is only stored once together with its collation key.
+///
+/// The ascending order of the rows by a column is cached after it has
+/// been needed for sorting, and is updated incrementally when tracks are
+/// added, changed or removed.
+class TrackColumnStore {
+  public:
+    enum class SortKind {
+        /// Null values first, then numbers, then collated strings
+        /// like in SQLite
+        Default,
+        /// All values are compared as numbers
+        Number,
+        /// All values are compared as integers like CAST(... AS INTEGER)
+        /// in SQLite, i.e. strings by their leading digits
+        Integer,
+        /// All values are compared as lowercase text by code points like
+        /// lower() in SQLite, i.e. numbers as text
+        Text,
+        /// Musical keys in the order of the circle of fifths
+        Key,
+    };
+
+    explicit TrackColumnStore(QVector<SortKind> sortKinds);
+
+    int columnCount() const {
+        return static_cast<int>(m_columns.size());
+    }
+
+    int trackCount() const {
+        return static_cast<int>(m_rows.size());
+    }
+
+    bool contains(TrackId trackId) const {
+        return m_rows.contains(trackId);
+    }
+
+    /// Returns an invalid QVariant for unknown tracks.
+    QVariant value(TrackId trackId, int column) const;
+
+    /// Replaces the values of a track. The values must be provided
+    /// in the order of the columns.
+    void setValues(TrackId trackId, const QVector<QVariant>& values);
+    void removeTrack(TrackId trackId);
+    void clear();
+
+    /// Returns the tracks ordered by the given columns. Ties are broken
+    /// by the track id. Tracks that are not stored are appended in the
+    /// given order. Large sets of tracks are sorted on multiple threads.
+    QVector<TrackId> sortTracks(
+            const std::vector<TrackId>& trackIds,
+            const QList<SortColumn>& sortColumns,
+            KeyUtils::KeyNotation keyNotation);
+
+  private:
+    enum class Storage {
+        // Only null values have been stored so far
+        None,
+        Number,
+        String,
+        Variant,
+    };
+
+    struct Column {
+        explicit Column(SortKind sortKind)
+                : sortKind(sortKind),
+                  storage(Storage::None),
+                  metaType(QMetaType::UnknownType),
+                  nullMetaType(QMetaType::UnknownType),
+                  keyNotation(KeyUtils::KeyNotation::Invalid),
+                  ranksValid(false) {
+        }
+
+        SortKind sortKind;
+        Storage storage;
+        // The type of the values in numbers or strings
+        int metaType;
+        // The type of null values
+        int nullMetaType;
+
+        // Storage::Number, NaN refers to exceptions
+        std::vector<double> numbers;
+        // Storage::String, -1 refers to exceptions
+        std::vector<int> strings;
+        // Storage::Variant
+        std::vector<QVariant> variants;
+        // Null values and the values that do not match the storage type.
+        // A row without an entry is null.
+        QHash<int, QVariant> exceptions;
+
+        // All rows in ascending order, empty if not cached
+        std::vector<int> sortedRows;
+        KeyUtils::KeyNotation keyNotation;
+        // The position of each row in sortedRows, equal values share
+        // the same rank
+        std::vector<int> ranks;
+        bool ranksValid;
+    };
+
+    // A value as it is compared for sorting
+    struct RowValue {
+        enum class Type {
+            Null,
+            Number,
+            String,
+            Text,
+        };
+
+        RowValue(Type type, double number, const QCollatorSortKey* pSortKey)
+                : type(type),
+                  number(number),
+                  pSortKey(pSortKey) {
+        }
+
+        const QCollatorSortKey& sortKey() const {
+            return pSortKey ? *pSortKey : *ownSortKey;
+        }
+
+        Type type;
+        double number;
+        // The sort key of an interned string
+        const QCollatorSortKey* pSortKey;
+        // The sort key of any other string
+        std::optional<QCollatorSortKey> ownSortKey;
+        // Type::Text
+        QString text;
+    };
+
+    int internString(const QString& string);
+    void ensureSortKeys();
+
+    int allocateRow(TrackId trackId);
+    void setValue(Column* pColumn, int row, const QVariant& value);
+    QVariant valueAt(const Column& column, int row) const;
+
+    RowValue rowValue(const Column& column, int row) const;
+    int compareRows(const Column& column, int lhs, int rhs) const;
+    bool lessRows(const Column& column, int lhs, int rhs) const;
+
+    void countSortedRowUpdate();
+    void invalidateSortedRows();
+    void removeSortedRow(Column* pColumn, int row);
+    void insertSortedRow(Column* pColumn, int row);
+    void buildSortedRows(Column* pColumn, KeyUtils::KeyNotation keyNotation);
+    void updateRanks(Column* pColumn);
+
+    std::vector<Column> m_columns;
+
+    QHash<TrackId, int> m_rows;
+    // The track of each row, invalid for free rows
+    std::vector<TrackId> m_trackIds;
+    std::vector<int> m_freeRows;
+
+    // All distinct strings that have been stored. Unused strings are only
+    // discarded when the store is cleared. The sort keys are only created
+    // when needed for sorting.
+    std::vector<QString> m_strings;
+    std::vector<QCollatorSortKey> m_stringSortKeys;
+    QHash<QString, int> m_stringIds;
+
+    // Incremental updates of the sorted rows since they have been built.
+    // Rebuilding them is cheaper than updating them on bulk changes.
+    int m_sortedRowUpdates;
+
+    const mixxx::StringCollator m_collator;
+};
@@ -0,0 +1,172 @@
+#include "library/tracksearchindex.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+QStringList tokenize(const QString& value) {
+    QStringList tokens;
+    int tokenStart = -1;
+    for (int i = 0; i < value.size(); ++i) {
+        if (value.at(i).isSpace()) {
+            if (tokenStart >= 0) {
+                tokens.append(value.mid(tokenStart, i - tokenStart));
+                tokenStart = -1;
+            }
+        } else if (tokenStart < 0) {
+            tokenStart = i;
+        }
+    }
+    if (tokenStart >= 0) {
+        tokens.append(value.mid(tokenStart));
+    }
+    return tokens;
+}
+
+bool containsSpace(const QString& value) {
+    return std::any_of(value.begin(), value.end(), [](QChar c) {
+        return c.isSpace();
+    });
+}
+
+} // anonymous namespace
+
+TrackSearchIndex::TrackSearchIndex(QStringList columns)
+        : m_columns(std::move(columns)),
+          m_postings(m_columns.size()),
+          m_allTrackIdsValid(false) {
+}
+
+int TrackSearchIndex::internToken(const QString& token) {
+    const auto it = m_tokenIds.constFind(token);
+    if (it != m_tokenIds.constEnd()) {
+        return it.value();
+    }
+    const int tokenId = static_cast<int>(m_tokens.size());
+    m_tokens.push_back(token);
+    m_tokenIds.insert(token, tokenId);
+    return tokenId;
+}
+
+void TrackSearchIndex::updateTrack(TrackId trackId, const QStringList& values) {
+    DEBUG_ASSERT(values.size() == m_columns.size());
+    removeTrack(trackId);
+
+    std::vector<TokenRef> trackTokens;
+    for (int column = 0; column < m_columns.size(); ++column) {
+        QString value = values.value(column);
+        if (value.isEmpty()) {
+            continue;
+        }
+        mixxx::DbConnection::makeStringLatinLow(&value);
+        std::vector<int> tokenIds;
+        for (const auto& token : tokenize(value)) {
+            tokenIds.push_back(internToken(token));
+        }
+        std::sort(tokenIds.begin(), tokenIds.end());
+        tokenIds.erase(std::unique(tokenIds.begin(), tokenIds.end()), tokenIds.end());
+
+        for (int tokenId : tokenIds) {
+            PostingList& postingList = m_postings[column][tokenId];
+            // Tracks are usually indexed in ascending order
+            if (postingList.empty() || postingList.back() < trackId) {
+                postingList.push_back(trackId);
+            } else {
+                postingList.insert(
+                        std::lower_bound(postingList.begin(), postingList.end(), trackId),
+                        trackId);
+            }
+            trackTokens.push_back(TokenRef{column, tokenId});
+        }
+    }
+    m_trackTokens.insert(trackId, std::move(trackTokens));
+    m_allTrackIdsValid = false;
+}
+
+void TrackSearchIndex::removeTrack(TrackId trackId) {
+    const auto it = m_trackTokens.find(trackId);
+    if (it == m_trackTokens.end()) {
+        return;
+    }
+    for (const auto& tokenRef : it.value()) {
+        auto& postings = m_postings[tokenRef.column];
+        const auto postingIt = postings.find(tokenRef.token);
+        VERIFY_OR_DEBUG_ASSERT(postingIt != postings.end()) {
+            continue;
+        }
+        PostingList& postingList = postingIt.value();
+        const auto trackIt = std::lower_bound(
+                postingList.begin(), postingList.end(), trackId);
+        if (trackIt != postingList.end() && *trackIt == trackId) {
+            postingList.erase(trackIt);
+        }
+        if (postingList.empty()) {
+            postings.erase(postingIt);
+        }
+    }
+    m_trackTokens.erase(it);
+    m_allTrackIdsValid = false;
+}
+
+void TrackSearchIndex::clear() {
+    m_tokens.clear();
+    m_tokenIds.clear();
+    for (auto& postings : m_postings) {
+        postings.clear();
+    }
+    m_trackTokens.clear();
+    m_allTrackIds.clear();
+    m_allTrackIdsValid = true;
+}
+
+bool TrackSearchIndex::findTracksContaining(
+        const QStringList& columns,
+        const QString& foldedTerm,
+        std::vector<TrackId>* pTrackIds) const {
+    DEBUG_ASSERT(pTrackIds);
+    if (foldedTerm.isEmpty() || containsSpace(foldedTerm)) {
+        return false;
+    }
+    std::vector<int> columnIndices;
+    columnIndices.reserve(columns.size());
+    for (const auto& column : columns) {
+        const int columnIndex = m_columns.indexOf(column);
+        if (columnIndex < 0) {
+            return false;
+        }
+        columnIndices.push_back(columnIndex);
+    }
+
+    pTrackIds->clear();
+    for (int tokenId = 0; tokenId < static_cast<int>(m_tokens.size()); ++tokenId) {
+        if (!m_tokens[tokenId].contains(foldedTerm)) {
+            continue;
+        }
+        for (int columnIndex : columnIndices) {
+            const auto& postings = m_postings[columnIndex];
+            const auto it = postings.constFind(tokenId);
+            if (it != postings.constEnd()) {
+                pTrackIds->insert(pTrackIds->end(), it.value().begin(), it.value().end());
+            }
+        }
+    }
+    std::sort(pTrackIds->begin(), pTrackIds->end());
+    pTrackIds->erase(std::unique(pTrackIds->begin(), pTrackIds->end()), pTrackIds->end());
+    return true;
+}
+
+const std::vector<TrackId>& TrackSearchIndex::allTrackIds() const {
+    if (!m_allTrackIdsValid) {
+        m_allTrackIds.clear();
+        m_allTrackIds.reserve(m_trackTokens.size());
+        for (auto it = m_trackTokens.constBegin(); it != m_trackTokens.constEnd(); ++it) {
+            m_allTrackIds.push_back(it.key());
+        }
+        std::sort(m_allTrackIds.begin(), m_allTrackIds.end());
+        m_allTrackIdsValid = true;
+    }
+    return m_allTrackIds;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+#include "track/trackid.h"
+
+/// An in-memory inverted index of the text columns of a BaseTrackCache.
+///
+/// The column values are folded like in SQL LIKE comparisons (see
+/// DbConnection::makeStringLatinLow()) and split into whitespace separated
+/// tokens. Each distinct token is stored only once and is mapped to a
+/// sorted posting list with the ids of all tracks that contain the token
+/// in the corresponding column.
+///
+/// A search term without whitespace is contained in a value if and only
+/// if it is contained in one of its tokens. Matching the term against the
+/// vocabulary of distinct tokens and merging the posting lists therefore
+/// yields exactly the same tracks as the SQL LIKE '%term%' clause, but
+/// without comparing the values of each and every track.
+class TrackSearchIndex {
+  public:
+    explicit TrackSearchIndex(QStringList columns);
+
+    const QStringList& columns() const {
+        return m_columns;
+    }
+
+    int trackCount() const {
+        return m_trackTokens.size();
+    }
+
+    /// Replaces the indexed values of a track. The values must be
+    /// provided in the order of columns().
+    void updateTrack(TrackId trackId, const QStringList& values);
+    void removeTrack(TrackId trackId);
+    void clear();
+
+    /// Collects the sorted ids of all tracks that contain the folded term
+    /// in at least one of the given columns. Returns false if the term
+    /// contains whitespace or if any of the columns is not indexed.
+    bool findTracksContaining(
+            const QStringList& columns,
+            const QString& foldedTerm,
+            std::vector<TrackId>* pTrackIds) const;
+
+    /// The sorted ids of all indexed tracks.
+    const std::vector<TrackId>& allTrackIds() const;
+
+  private:
+    struct TokenRef {
+        int column;
+        int token;
+    };
+    typedef std::vector<TrackId> PostingList;
+
+    int internToken(const QString& token);
+
+    const QStringList m_columns;
+
+    // All distinct tokens that have been indexed. Unused tokens are only
+    // discarded when the index is cleared. Until then their posting lists
+    // are empty.
+    std::vector<QString> m_tokens;
+    QHash<QString, int> m_tokenIds;
+
+    // For each column the posting lists of the tokens that occur in it
+    std::vector<QHash<int, PostingList>> m_postings;
+
+    // The tokens of each track that need to be removed from the posting
+    // lists when the track is updated or removed.
+    QHash<TrackId, std::vector<TokenRef>> m_trackTokens;
+
+    mutable std::vector<TrackId> m_allTrackIds;
+    mutable bool m_allTrackIdsValid;
+};
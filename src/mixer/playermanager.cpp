@@ -195,13 +195,16 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
     // Connect the player to the analyzer queue so that loaded tracks are
     // analyzed.
     foreach(Deck* pDeck, m_decks) {
-        connect(pDeck, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeTrack);
+        connect(pDeck, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeDeckTrack);
     }
 
     // Connect the player to the analyzer queue so that loaded tracks are
     // analyzed.
     foreach(Sampler* pSampler, m_samplers) {
-        connect(pSampler, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeTrack);
+        connect(pSampler,
+                &BaseTrackPlayer::newTrackLoaded,
+                this,
+                &PlayerManager::slotAnalyzeSamplerTrack);
     }
 
     // Connect the player to the analyzer queue so that loaded tracks are
@@ -210,7 +213,7 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
         connect(pPreviewDeck,
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
-                &PlayerManager::slotAnalyzeTrack);
+                &PlayerManager::slotAnalyzePreviewDeckTrack);
     }
 }
 
@@ -429,7 +432,7 @@ void PlayerManager::addDeckInner() {
         connect(pDeck,
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
-                &PlayerManager::slotAnalyzeTrack);
+                &PlayerManager::slotAnalyzeDeckTrack);
     }
 
     m_players[handleGroup.handle()] = pDeck;
@@ -499,7 +502,7 @@ void PlayerManager::addSamplerInner() {
         connect(pSampler,
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
-                &PlayerManager::slotAnalyzeTrack);
+                &PlayerManager::slotAnalyzeSamplerTrack);
     }
     connect(pSampler,
             &BaseTrackPlayer::trackUnloaded,
@@ -536,7 +539,7 @@ void PlayerManager::addPreviewDeckInner() {
         connect(pPreviewDeck,
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
-                &PlayerManager::slotAnalyzeTrack);
+                &PlayerManager::slotAnalyzePreviewDeckTrack);
     }
 
     m_players[handleGroup.handle()] = pPreviewDeck;
@@ -700,12 +703,7 @@ void PlayerManager::slotLoadTrackToPlayer(
         // is in the AutoDJ queue twice in a row. This can happen when the option to
         // repeat the AutoDJ queue is enabled and the user presses the "Skip now"
         // button repeatedly.
-        // AutoDJProcessor is initialized after PlayerManager, so check that the
-        // ControlProxy is pointing to the real ControlObject.
-        if (!m_pAutoDjEnabled) {
-            m_pAutoDjEnabled = make_parented<ControlProxy>("[AutoDJ]", "enabled", this);
-        }
-        bool autoDjSkipClone = m_pAutoDjEnabled->toBool() &&
+        bool autoDjSkipClone = isAutoDjEnabled() &&
                 (pPlayer == m_decks.at(0) || pPlayer == m_decks.at(1));
 
         if (cloneOnDoubleTap && m_lastLoadedPlayer == group &&
@@ -820,12 +818,44 @@ void PlayerManager::slotLoadTrackIntoNextAvailableSampler(TrackPointer pTrack) {
 #endif
 }
 
-void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
+bool PlayerManager::isAutoDjEnabled() {
+    // AutoDJProcessor is initialized after PlayerManager, so check that the
+    // ControlProxy is pointing to the real ControlObject.
+    if (!m_pAutoDjEnabled) {
+        const ConfigKey autoDjEnabledKey("[AutoDJ]", "enabled");
+        if (!ControlObject::exists(autoDjEnabledKey)) {
+            // Tracks might be loaded on startup before AutoDJ is initialized
+            return false;
+        }
+        m_pAutoDjEnabled = make_parented<ControlProxy>(autoDjEnabledKey, this);
+    }
+    return m_pAutoDjEnabled->toBool();
+}
+
+void PlayerManager::slotAnalyzeDeckTrack(TrackPointer track) {
+    // While AutoDJ is enabled tracks are loaded ahead of the transition
+    // into the deck that is not playing.
+    analyzeTrack(track,
+            isAutoDjEnabled()
+                    ? AnalyzerPriority::AutoDjNext
+                    : AnalyzerPriority::DeckLoaded);
+}
+
+void PlayerManager::slotAnalyzeSamplerTrack(TrackPointer track) {
+    analyzeTrack(track, AnalyzerPriority::DeckLoaded);
+}
+
+void PlayerManager::slotAnalyzePreviewDeckTrack(TrackPointer track) {
+    analyzeTrack(track, AnalyzerPriority::Preview);
+}
+
+void PlayerManager::analyzeTrack(TrackPointer track, AnalyzerPriority priority) {
     VERIFY_OR_DEBUG_ASSERT(track) {
         return;
     }
     if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrack(track->getId())) {
+        if (m_pTrackAnalysisScheduler->scheduleTrack(AnalyzerScheduledTrack(
+                    track->getId(), AnalyzerTrack::Options(), priority))) {
             m_pTrackAnalysisScheduler->resume();
         }
         // The first progress signal will suspend a running batch analysis
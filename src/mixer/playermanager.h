@@ -231,7 +231,9 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
     void slotSaveEjectedTrack(TrackPointer track);
 
   private slots:
-    void slotAnalyzeTrack(TrackPointer track);
+    void slotAnalyzeDeckTrack(TrackPointer track);
+    void slotAnalyzeSamplerTrack(TrackPointer track);
+    void slotAnalyzePreviewDeckTrack(TrackPointer track);
 
     void onTrackAnalysisProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
     void onTrackAnalysisFinished();
@@ -264,6 +266,8 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
 
   private:
     TrackPointer lookupTrack(QString location);
+    void analyzeTrack(TrackPointer track, AnalyzerPriority priority);
+    bool isAutoDjEnabled();
     // Must hold m_mutex before calling this method. Internal method that
     // creates a new deck.
     void addDeckInner();
@@ -1,5 +1,8 @@
 #include "skin/legacy/colorschemeparser.h"
 
+#include <QDir>
+#include <QTextStream>
+
 #include "widget/wpixmapstore.h"
 #include "widget/wimagestore.h"
 #include "widget/wskincolor.h"
@@ -10,6 +13,25 @@
 #include "skin/legacy/imginvert.h"
 #include "skin/legacy/legacyskinparser.h"
 #include "skin/legacy/skincontext.h"
+#include "skin/legacy/skinimagecache.h"
+
+namespace {
+
+const QString kImageCacheDirectory = QStringLiteral("skincache");
+
+void setupImageCache(UserSettingsPointer pConfig, const QDomNode& filtersNode) {
+    // The cached images depend on the filters, not on the name of the scheme
+    QString colorSchemeKey;
+    if (!filtersNode.isNull()) {
+        QTextStream stream(&colorSchemeKey);
+        filtersNode.save(stream, 0);
+    }
+    WPixmapStore::setImageCache(std::make_shared<SkinImageCache>(
+            QDir(pConfig->getSettingsPath()).filePath(kImageCacheDirectory),
+            colorSchemeKey));
+}
+
+} // namespace
 
 void ColorSchemeParser::setupLegacyColorSchemes(const QDomElement& docElem,
         UserSettingsPointer pConfig,
@@ -23,6 +45,7 @@ void ColorSchemeParser::setupLegacyColorSchemes(const QDomElement& docElem,
         WPixmapStore::setLoader(pImgSrc);
         WImageStore::setLoader(pImgSrc);
         WSkinColor::setLoader(pImgSrc);
+        setupImageCache(pConfig, schemeNode.namedItem("Filters"));
 
         // This calls SkinContext::updateVariables which iterates over all
         // <SetVariable> nodes in the selected color scheme node.
@@ -37,6 +60,7 @@ void ColorSchemeParser::setupLegacyColorSchemes(const QDomElement& docElem,
         WPixmapStore::setLoader(pImgSrc);
         WImageStore::setLoader(pImgSrc);
         WSkinColor::setLoader(pImgSrc);
+        setupImageCache(pConfig, QDomNode());
     }
 }
 
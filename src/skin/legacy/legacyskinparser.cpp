@@ -5,6 +5,7 @@
 #include <QLabel>
 #include <QSplitter>
 #include <QStackedWidget>
+#include <QThreadPool>
 #include <QVBoxLayout>
 #include <QtDebug>
 #include <QtGlobal>
@@ -24,6 +25,7 @@
 #include "skin/legacy/colorschemeparser.h"
 #include "skin/legacy/launchimage.h"
 #include "skin/legacy/skincontext.h"
+#include "skin/legacy/skindocumentcache.h"
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/cmdlineargs.h"
@@ -101,6 +103,40 @@ QSet<QString> LegacySkinParser::s_sharedGroupStrings;
 
 static bool sDebug = false;
 
+namespace {
+
+const QString kDocumentCacheDirectory = QStringLiteral("skincache/documents");
+// The compiled documents of all shipped skins take a few MiB
+constexpr qint64 kMaxDocumentCacheSize = 32 * 1024 * 1024;
+
+QDomElement parseTemplateContent(const QByteArray& content, const QString& absolutePath) {
+    QDomDocument tmpl("template");
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    const auto parseResult = tmpl.setContent(content);
+    if (!parseResult) {
+        qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
+                   << absolutePath << "line:" << parseResult.errorLine
+                   << "column:" << parseResult.errorColumn;
+        qWarning() << "LegacySkinParser::loadTemplate - message:" << parseResult.errorMessage;
+#else
+    QString errorMessage;
+    int errorLine;
+    int errorColumn;
+
+    if (!tmpl.setContent(content, &errorMessage,
+                         &errorLine, &errorColumn)) {
+        qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
+                   << absolutePath << "line:" << errorLine << "column:" << errorColumn;
+        qWarning() << "LegacySkinParser::loadTemplate - message:" << errorMessage;
+#endif
+        return QDomElement();
+    }
+    return tmpl.documentElement();
+}
+
+} // namespace
+
 ControlObject* LegacySkinParser::controlFromConfigKey(
         const ConfigKey& key, bool bPersist, bool* pCreated) {
     if (!key.isValid()) {
@@ -216,7 +252,8 @@ bool LegacySkinParser::canParse(const QString& skinPath) {
 }
 
 // static
-QDomElement LegacySkinParser::openSkin(const QString& skinPath) {
+QDomElement LegacySkinParser::openSkin(const QString& skinPath,
+        const SkinDocumentCache* pDocumentCache) {
     QDir skinDir(skinPath);
 
     if (!skinDir.exists()) {
@@ -232,11 +269,20 @@ QDomElement LegacySkinParser::openSkin(const QString& skinPath) {
                  << "in directory:" << skinDir.path();
         return QDomElement();
     }
+    const QByteArray content = skinXmlFile.readAll();
+    skinXmlFile.close();
+
+    if (pDocumentCache) {
+        const QDomElement cachedSkin = pDocumentCache->load(content);
+        if (!cachedSkin.isNull()) {
+            return cachedSkin;
+        }
+    }
 
     QDomDocument skin("skin");
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
-    const auto parseResult = skin.setContent(&skinXmlFile);
+    const auto parseResult = skin.setContent(content);
     if (!parseResult) {
         qDebug() << "LegacySkinParser::openSkin - setContent failed see"
                  << "line:" << parseResult.errorLine << "column:" << parseResult.errorColumn;
@@ -246,7 +292,7 @@ QDomElement LegacySkinParser::openSkin(const QString& skinPath) {
     int errorLine;
     int errorColumn;
 
-    if (!skin.setContent(&skinXmlFile,&errorMessage,&errorLine,&errorColumn)) {
+    if (!skin.setContent(content, &errorMessage, &errorLine, &errorColumn)) {
         qDebug() << "LegacySkinParser::openSkin - setContent failed see"
                  << "line:" << errorLine << "column:" << errorColumn;
         qDebug() << "LegacySkinParser::openSkin - message:" << errorMessage;
@@ -254,7 +300,9 @@ QDomElement LegacySkinParser::openSkin(const QString& skinPath) {
         return QDomElement();
     }
 
-    skinXmlFile.close();
+    if (pDocumentCache) {
+        pDocumentCache->store(content, skin.documentElement());
+    }
     return skin.documentElement();
 }
 
@@ -342,7 +390,13 @@ QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent)
     if (m_pParent) {
         qDebug() << "ERROR: Somehow a parent already exists -- you are probably re-using a LegacySkinParser which is not advisable!";
     }
-    QDomElement skinDocument = openSkin(skinPath);
+    // Skin developers need the line numbers in the warnings, which are not
+    // part of the compiled documents
+    if (!CmdlineArgs::Instance().getDeveloper()) {
+        m_pDocumentCache = std::make_shared<SkinDocumentCache>(
+                QDir(m_pConfig->getSettingsPath()).filePath(kDocumentCacheDirectory));
+    }
+    QDomElement skinDocument = openSkin(skinPath, m_pDocumentCache.get());
 
     if (skinDocument.isNull()) {
         qDebug() << "LegacySkinParser::parseSkin - failed for skin:" << skinPath;
@@ -418,6 +472,8 @@ QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent)
     QDir::setSearchPaths("skins", QStringList{systemSkinsPath});
 
     ColorSchemeParser::setupLegacyColorSchemes(skinDocument, m_pConfig, &m_style, m_pContext.get());
+    // Depends on the color scheme
+    WPixmapStore::beginSkinLoad(skinPath, m_pContext->getScaleFactor());
 
     // don't parent till here so the first opengl waveform doesn't screw
     // up --bkgood
@@ -426,6 +482,12 @@ QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent)
     // (fullscreen mostly) --bkgood
     m_pParent = pParent;
     QList<QWidget*> widgets = parseNode(skinDocument);
+    WPixmapStore::endSkinLoad();
+    if (m_pDocumentCache) {
+        QThreadPool::globalInstance()->start([pCache = m_pDocumentCache]() {
+            pCache->prune(kMaxDocumentCacheSize);
+        });
+    }
 
     if (widgets.empty()) {
         SKIN_WARNING(skinDocument, *m_pContext, QStringLiteral("Skin produced no widgets!"));
@@ -1835,33 +1897,25 @@ QDomElement LegacySkinParser::loadTemplate(const QString& path) {
         qWarning() << "Could not open template file:" << absolutePath;
         return QDomElement();
     }
+    const QByteArray content = templateFile.readAll();
 
-    QDomDocument tmpl("template");
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
-    const auto parseResult = tmpl.setContent(&templateFile);
-    if (!parseResult) {
-        qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
-                   << absolutePath << "line:" << parseResult.errorLine
-                   << "column:" << parseResult.errorColumn;
-        qWarning() << "LegacySkinParser::loadTemplate - message:" << parseResult.errorMessage;
-#else
-    QString errorMessage;
-    int errorLine;
-    int errorColumn;
-
-    if (!tmpl.setContent(&templateFile, &errorMessage,
-                         &errorLine, &errorColumn)) {
-        qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
-                   << absolutePath << "line:" << errorLine << "column:" << errorColumn;
-        qWarning() << "LegacySkinParser::loadTemplate - message:" << errorMessage;
-#endif
-        return QDomElement();
+    QDomElement templateElement;
+    if (m_pDocumentCache) {
+        templateElement = m_pDocumentCache->load(content);
+    }
+    if (templateElement.isNull()) {
+        templateElement = parseTemplateContent(content, absolutePath);
+        if (templateElement.isNull()) {
+            return QDomElement();
+        }
+        if (m_pDocumentCache) {
+            m_pDocumentCache->store(content, templateElement);
+        }
     }
 
-    m_templateCache[absolutePath] = tmpl.documentElement();
+    m_templateCache[absolutePath] = templateElement;
     m_pContext->setSkinTemplatePath(templateFileInfo.absoluteDir().absolutePath());
-    return tmpl.documentElement();
+    return templateElement;
 }
 
 QList<QWidget*> LegacySkinParser::parseTemplate(const QDomElement& node) {
@@ -21,6 +21,7 @@ class EffectsManager;
 class RecordingManager;
 class ControllerManager;
 class SkinContext;
+class SkinDocumentCache;
 class WLabel;
 class WStemLabel;
 class ControlObject;
@@ -57,7 +58,10 @@ class LegacySkinParser : public QObject, public SkinParser {
                                             const SkinContext& context);
 
     static QString getStyleFromNode(const QDomNode& node);
-    static QDomElement openSkin(const QString& skinPath);
+    /// Returns the root element of the skin.xml file, which is loaded from
+    /// and stored in pDocumentCache if it is given.
+    static QDomElement openSkin(const QString& skinPath,
+            const SkinDocumentCache* pDocumentCache = nullptr);
 
   private:
 
@@ -174,5 +178,7 @@ class LegacySkinParser : public QObject, public SkinParser {
     QString m_style;
     Tooltips m_tooltips;
     QHash<QString, QDomElement> m_templateCache;
+    // Compiled skin and template documents, created by parseSkin()
+    std::shared_ptr<SkinDocumentCache> m_pDocumentCache;
     static QSet<QString> s_sharedGroupStrings;
 };
@@ -0,0 +1,236 @@
+#include "skin/legacy/skindocumentcache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStringList>
+
+#include "proto/skin.pb.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SkinDocumentCache");
+
+// Increment when the schema or the conversion of the documents changes
+constexpr quint32 kVersion = 1;
+
+const QString kEntrySuffix = QStringLiteral(".dom");
+
+using mixxx::skin::SkinDocument;
+
+class Compiler {
+  public:
+    explicit Compiler(SkinDocument* pDocument)
+            : m_pDocument(pDocument) {
+    }
+
+    void compileElement(const QDomElement& element, SkinDocument::Node* pNode) {
+        pNode->set_type(SkinDocument::Node::ELEMENT);
+        pNode->set_name(nameIndex(element.nodeName()));
+        const QDomNamedNodeMap attributes = element.attributes();
+        for (int i = 0; i < attributes.count(); ++i) {
+            const QDomNode attribute = attributes.item(i);
+            pNode->add_attribute_name(nameIndex(attribute.nodeName()));
+            pNode->add_attribute_value(attribute.nodeValue().toStdString());
+        }
+        for (QDomNode child = element.firstChild(); !child.isNull();
+                child = child.nextSibling()) {
+            switch (child.nodeType()) {
+            case QDomNode::ElementNode:
+                compileElement(child.toElement(), pNode->add_child());
+                break;
+            case QDomNode::TextNode:
+                addData(pNode, SkinDocument::Node::TEXT, child);
+                break;
+            case QDomNode::CDATASectionNode:
+                addData(pNode, SkinDocument::Node::CDATA_SECTION, child);
+                break;
+            case QDomNode::CommentNode:
+                addData(pNode, SkinDocument::Node::COMMENT, child);
+                break;
+            default:
+                // Entity references have already been resolved by the parser
+                break;
+            }
+        }
+    }
+
+  private:
+    quint32 nameIndex(const QString& name) {
+        const auto it = m_nameIndices.constFind(name);
+        if (it != m_nameIndices.constEnd()) {
+            return it.value();
+        }
+        const auto index = static_cast<quint32>(m_pDocument->name_size());
+        m_pDocument->add_name(name.toStdString());
+        m_nameIndices.insert(name, index);
+        return index;
+    }
+
+    static void addData(SkinDocument::Node* pParent,
+            SkinDocument::Node::Type type,
+            const QDomNode& node) {
+        SkinDocument::Node* pNode = pParent->add_child();
+        pNode->set_type(type);
+        pNode->set_data(node.nodeValue().toStdString());
+    }
+
+    SkinDocument* const m_pDocument;
+    QHash<QString, quint32> m_nameIndices;
+};
+
+class Decompiler {
+  public:
+    explicit Decompiler(const SkinDocument& document) {
+        m_names.reserve(document.name_size());
+        for (const std::string& name : document.name()) {
+            m_names.append(QString::fromStdString(name));
+        }
+    }
+
+    /// Returns a null element if the node refers to a name that doesn't exist.
+    QDomElement decompileElement(const SkinDocument::Node& node) {
+        if (node.type() != SkinDocument::Node::ELEMENT ||
+                node.name() >= static_cast<quint32>(m_names.size()) ||
+                node.attribute_name_size() != node.attribute_value_size()) {
+            return QDomElement();
+        }
+        QDomElement element = m_document.createElement(m_names[node.name()]);
+        for (int i = 0; i < node.attribute_name_size(); ++i) {
+            if (node.attribute_name(i) >= static_cast<quint32>(m_names.size())) {
+                return QDomElement();
+            }
+            element.setAttribute(m_names[node.attribute_name(i)],
+                    QString::fromStdString(node.attribute_value(i)));
+        }
+        for (const SkinDocument::Node& child : node.child()) {
+            const QString data = QString::fromStdString(child.data());
+            switch (child.type()) {
+            case SkinDocument::Node::ELEMENT: {
+                const QDomElement childElement = decompileElement(child);
+                if (childElement.isNull()) {
+                    return QDomElement();
+                }
+                element.appendChild(childElement);
+                break;
+            }
+            case SkinDocument::Node::TEXT:
+                element.appendChild(m_document.createTextNode(data));
+                break;
+            case SkinDocument::Node::CDATA_SECTION:
+                element.appendChild(m_document.createCDATASection(data));
+                break;
+            case SkinDocument::Node::COMMENT:
+                element.appendChild(m_document.createComment(data));
+                break;
+            }
+        }
+        return element;
+    }
+
+    QDomDocument& document() {
+        return m_document;
+    }
+
+  private:
+    QDomDocument m_document;
+    // Shared by all nodes with the same name
+    QStringList m_names;
+};
+
+} // namespace
+
+SkinDocumentCache::SkinDocumentCache(const QString& directory)
+        : m_directory(directory) {
+}
+
+QDomElement SkinDocumentCache::load(const QByteArray& content) const {
+    const QString path = entryPath(content);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QDomElement();
+    }
+    const QDomElement element = decompile(file.readAll());
+    if (element.isNull()) {
+        kLogger.info() << "Ignoring outdated or damaged file" << path;
+    }
+    return element;
+}
+
+bool SkinDocumentCache::store(const QByteArray& content, const QDomElement& element) const {
+    if (element.isNull() || !QDir().mkpath(m_directory)) {
+        return false;
+    }
+    // Written to a temporary file that replaces the entry on commit, so a
+    // concurrent reader never sees a partial document
+    QSaveFile file(entryPath(content));
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to open" << file.fileName() << file.errorString();
+        return false;
+    }
+    file.write(compile(element));
+    if (!file.commit()) {
+        kLogger.warning() << "Failed to write" << file.fileName() << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void SkinDocumentCache::prune(qint64 maxSize) const {
+    QFileInfoList entries = QDir(m_directory).entryInfoList(
+            QStringList{QStringLiteral("*") + kEntrySuffix},
+            QDir::Files,
+            QDir::Time | QDir::Reversed);
+    qint64 size = 0;
+    for (const QFileInfo& entry : std::as_const(entries)) {
+        size += entry.size();
+    }
+    // The oldest entries come first
+    for (const QFileInfo& entry : std::as_const(entries)) {
+        if (size <= maxSize) {
+            break;
+        }
+        if (QFile::remove(entry.filePath())) {
+            size -= entry.size();
+        }
+    }
+}
+
+// static
+QByteArray SkinDocumentCache::compile(const QDomElement& element) {
+    SkinDocument document;
+    document.set_version(kVersion);
+    Compiler(&document).compileElement(element, document.mutable_root());
+    std::string output;
+    document.SerializeToString(&output);
+    return QByteArray(output.data(), static_cast<int>(output.length()));
+}
+
+// static
+QDomElement SkinDocumentCache::decompile(const QByteArray& data) {
+    SkinDocument document;
+    if (!document.ParseFromArray(data.constData(), data.size()) ||
+            document.version() != kVersion || !document.has_root()) {
+        return QDomElement();
+    }
+    Decompiler decompiler(document);
+    const QDomElement root = decompiler.decompileElement(document.root());
+    if (root.isNull()) {
+        return QDomElement();
+    }
+    // The document is kept alive by its nodes
+    decompiler.document().appendChild(root);
+    return root;
+}
+
+QString SkinDocumentCache::entryPath(const QByteArray& content) const {
+    return QDir(m_directory).filePath(
+            QString::fromLatin1(
+                    QCryptographicHash::hash(content, QCryptographicHash::Sha1)
+                            .toHex()) +
+            kEntrySuffix);
+}
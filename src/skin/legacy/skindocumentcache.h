@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDomElement>
+#include <QString>
+
+/// Stores the parsed XML of skin and template files in a compiled binary
+/// form, so that the XML doesn't need to be parsed again the next time the
+/// skin is loaded.
+///
+/// An entry is identified by the content of the XML file. Element and
+/// attribute names are stored only once per entry and shared between the
+/// nodes that are created from it. Line numbers are not stored, so warnings
+/// about nodes from a compiled entry don't contain them.
+///
+/// All methods are thread-safe.
+class SkinDocumentCache {
+  public:
+    explicit SkinDocumentCache(const QString& directory);
+
+    /// Returns the root element of the document that has been stored for
+    /// the content of an XML file or a null element if there is no valid
+    /// entry.
+    QDomElement load(const QByteArray& content) const;
+    bool store(const QByteArray& content, const QDomElement& element) const;
+
+    /// Deletes the oldest entries until the cache is smaller than maxSize.
+    void prune(qint64 maxSize) const;
+
+    /// Converts the element and its descendants from and to the serialized
+    /// mixxx::skin::SkinDocument. Processing instructions are dropped.
+    static QByteArray compile(const QDomElement& element);
+    static QDomElement decompile(const QByteArray& data);
+
+  private:
+    QString entryPath(const QByteArray& content) const;
+
+    const QString m_directory;
+};
@@ -0,0 +1,208 @@
+#include "skin/legacy/skinimagecache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
+
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SkinImageCache");
+
+constexpr char kMagic[8] = {'M', 'X', 'X', 'S', 'K', 'I', 'M', 'G'};
+// Increment when the layout of the file or the processing of the images changes
+constexpr quint32 kVersion = 1;
+// Detects files that have been written on a machine with another byte order
+constexpr quint32 kByteOrderMark = 0x01020304;
+
+const QString kEntrySuffix = QStringLiteral(".img");
+const QString kFileListSuffix = QStringLiteral(".list");
+
+// Followed by the scanlines of the image
+struct EntryHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    qint32 width;
+    qint32 height;
+    qint32 format;
+    qint32 bytesPerLine;
+    double devicePixelRatio;
+};
+
+QString hashToName(const QByteArrayList& parts) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QByteArray& part : parts) {
+        hash.addData(part);
+        // Separates the parts, so that they can't be shifted into each other
+        hash.addData(QByteArray(1, '\0'));
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+} // namespace
+
+SkinImageCache::SkinImageCache(const QString& directory, const QString& colorSchemeKey)
+        : m_directory(directory),
+          m_colorSchemeKey(colorSchemeKey) {
+}
+
+QImage SkinImageCache::load(const QString& fileName, const QString& variant) const {
+    const QString path = entryPath(fileName, variant);
+    if (path.isEmpty()) {
+        return QImage();
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QImage();
+    }
+    EntryHeader header;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+            std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion ||
+            header.byteOrderMark != kByteOrderMark ||
+            header.format <= QImage::Format_Invalid ||
+            header.format >= QImage::NImageFormats) {
+        kLogger.info() << "Ignoring outdated file" << path;
+        return QImage();
+    }
+    // Validated before the image is allocated
+    if (header.width <= 0 || header.height <= 0 || header.bytesPerLine <= 0 ||
+            file.size() != static_cast<qint64>(sizeof(header)) +
+                            static_cast<qint64>(header.bytesPerLine) * header.height) {
+        kLogger.warning() << "Ignoring damaged file" << path;
+        return QImage();
+    }
+    QImage image(header.width, header.height, static_cast<QImage::Format>(header.format));
+    if (image.isNull() || image.bytesPerLine() != header.bytesPerLine) {
+        kLogger.warning() << "Ignoring damaged file" << path;
+        return QImage();
+    }
+    if (file.read(reinterpret_cast<char*>(image.bits()), image.sizeInBytes()) !=
+            image.sizeInBytes()) {
+        kLogger.warning() << "Failed to read" << path << file.errorString();
+        return QImage();
+    }
+    image.setDevicePixelRatio(header.devicePixelRatio);
+    return image;
+}
+
+bool SkinImageCache::store(const QString& fileName,
+        const QString& variant,
+        const QImage& image) const {
+    if (image.isNull()) {
+        return false;
+    }
+    const QString path = entryPath(fileName, variant);
+    if (path.isEmpty() || !QDir().mkpath(m_directory)) {
+        return false;
+    }
+    EntryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.width = image.width();
+    header.height = image.height();
+    header.format = image.format();
+    header.bytesPerLine = static_cast<qint32>(image.bytesPerLine());
+    header.devicePixelRatio = image.devicePixelRatio();
+
+    // Written to a temporary file that replaces the entry on commit, so a
+    // concurrent reader never sees a partial image
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to open" << file.fileName() << file.errorString();
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(image.constBits()), image.sizeInBytes());
+    if (!file.commit()) {
+        kLogger.warning() << "Failed to write" << file.fileName() << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QStringList SkinImageCache::loadFileList(const QString& name) const {
+    QFile file(QDir(m_directory).filePath(
+            hashToName({name.toUtf8(), m_colorSchemeKey.toUtf8()}) +
+            kFileListSuffix));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    QStringList fileNames = QString::fromUtf8(file.readAll()).split(QChar('\n'));
+    fileNames.removeAll(QString());
+    return fileNames;
+}
+
+bool SkinImageCache::storeFileList(const QString& name, const QStringList& fileNames) const {
+    if (!QDir().mkpath(m_directory)) {
+        return false;
+    }
+    QSaveFile file(QDir(m_directory).filePath(
+            hashToName({name.toUtf8(), m_colorSchemeKey.toUtf8()}) +
+            kFileListSuffix));
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to open" << file.fileName() << file.errorString();
+        return false;
+    }
+    file.write(fileNames.join(QChar('\n')).toUtf8());
+    return file.commit();
+}
+
+void SkinImageCache::prune(qint64 maxSize) const {
+    QFileInfoList entries = QDir(m_directory).entryInfoList(
+            QStringList{QStringLiteral("*") + kEntrySuffix},
+            QDir::Files,
+            QDir::Time | QDir::Reversed);
+    qint64 size = 0;
+    for (const QFileInfo& entry : std::as_const(entries)) {
+        size += entry.size();
+    }
+    // The oldest entries come first
+    for (const QFileInfo& entry : std::as_const(entries)) {
+        if (size <= maxSize) {
+            break;
+        }
+        if (QFile::remove(entry.filePath())) {
+            size -= entry.size();
+        }
+    }
+}
+
+QString SkinImageCache::entryPath(const QString& fileName, const QString& variant) const {
+    const QByteArray hash = fileHash(fileName);
+    if (hash.isEmpty()) {
+        return QString();
+    }
+    return QDir(m_directory).filePath(
+            hashToName({hash, variant.toUtf8(), m_colorSchemeKey.toUtf8()}) +
+            kEntrySuffix);
+}
+
+QByteArray SkinImageCache::fileHash(const QString& fileName) const {
+    {
+        const auto locker = lockMutex(&m_fileHashesMutex);
+        const auto it = m_fileHashes.constFind(fileName);
+        if (it != m_fileHashes.constEnd()) {
+            return it.value();
+        }
+    }
+    QByteArray hash;
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly)) {
+        QCryptographicHash hasher(QCryptographicHash::Sha1);
+        if (hasher.addData(&file)) {
+            hash = hasher.result();
+        }
+    }
+    const auto locker = lockMutex(&m_fileHashesMutex);
+    m_fileHashes.insert(fileName, hash);
+    return hash;
+}
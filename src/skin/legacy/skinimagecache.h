@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+/// Stores the images of legacy skins in files, so that they don't need to be
+/// decoded, scaled, color corrected or rasterized from SVG again the next
+/// time the skin is loaded.
+///
+/// An entry is identified by the content of the image file, a variant that
+/// describes how the image has been created from it (e.g. the scale factor or
+/// the rasterized size) and the filters of the color scheme. The pixels are
+/// stored uncompressed, so loading an entry only reads the file.
+///
+/// All methods are thread-safe.
+class SkinImageCache {
+  public:
+    /// @param colorSchemeKey identifies the filters of the color scheme that
+    /// are applied to the images.
+    SkinImageCache(const QString& directory, const QString& colorSchemeKey);
+
+    /// Returns a null image if there is no valid entry.
+    QImage load(const QString& fileName, const QString& variant) const;
+    bool store(const QString& fileName, const QString& variant, const QImage& image) const;
+
+    /// Lists of file names, e.g. of the images that have been used by a skin.
+    QStringList loadFileList(const QString& name) const;
+    bool storeFileList(const QString& name, const QStringList& fileNames) const;
+
+    /// Deletes the oldest entries until the cache is smaller than maxSize.
+    void prune(qint64 maxSize) const;
+
+  private:
+    QString entryPath(const QString& fileName, const QString& variant) const;
+    QByteArray fileHash(const QString& fileName) const;
+
+    const QString m_directory;
+    const QString m_colorSchemeKey;
+
+    // The files are only hashed once, they don't change while a skin is loaded
+    mutable QMutex m_fileHashesMutex;
+    mutable QHash<QString, QByteArray> m_fileHashes;
+};
@@ -7,6 +7,7 @@
 #include <QtDebug>
 
 #include "control/controlobject.h"
+#include "engine/engineprofiler.h"
 #include "sounddevicenetwork.h"
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanager.h"
@@ -18,6 +19,7 @@
 #include "util/sample.h"
 #include "util/timer.h"
 #include "util/trace.h"
+#include "util/tracerecorder.h"
 #include "waveform/visualplayposition.h"
 
 #ifdef PA_USE_ALSA
@@ -92,6 +94,7 @@ SoundDevicePortAudio::SoundDevicePortAudio(UserSettingsPointer config,
           m_outputDrift(false),
           m_inputDrift(false),
           m_bSetThreadPriority(false),
+          m_bCallbackThreadRegistered(false),
           m_audioLatencyUsage(kAppGroup, QStringLiteral("audio_latency_usage")),
           m_framesSinceAudioLatencyUsageUpdate(0),
           m_syncBuffers(2),
@@ -450,6 +453,17 @@ void SoundDevicePortAudio::makeStreamInactiveAndWait() {
     }
 }
 
+void SoundDevicePortAudio::registerCallbackThread() {
+    if (m_bCallbackThreadRegistered) {
+        return;
+    }
+    // The callback thread is created by PortAudio, so it can't be
+    // registered before its first callback. This is done once per
+    // stream before the first trace event, like setting the priority.
+    mixxx::TraceRecorder::registerCurrentThread(m_deviceId.debugName());
+    m_bCallbackThreadRegistered = true;
+}
+
 SoundDeviceStatus SoundDevicePortAudio::close() {
     //qDebug() << "SoundDevicePortAudio::close()" << m_deviceId;
 
@@ -496,6 +510,7 @@ SoundDeviceStatus SoundDevicePortAudio::close() {
     m_outputFifo.reset();
     m_inputFifo.reset();
     m_bSetThreadPriority = false;
+    m_bCallbackThreadRegistered = false;
 
     return SoundDeviceStatus::Ok;
 }
@@ -752,6 +767,8 @@ int SoundDevicePortAudio::callbackProcessDrift(
     Q_UNUSED(timeInfo);
     Trace trace("SoundDevicePortAudio::callbackProcessDrift %1",
             m_deviceId.debugName());
+    registerCallbackThread();
+    mixxx::ScopedTraceEvent traceEvent("SoundDevicePortAudio::callbackProcessDrift");
 
     if (statusFlags & (paOutputUnderflow | paInputOverflow)) {
         m_pSoundManager->underflowHappened(7);
@@ -884,6 +901,8 @@ int SoundDevicePortAudio::callbackProcess(const SINT framesPerBuffer,
         PaStreamCallbackFlags statusFlags) {
     Q_UNUSED(timeInfo);
     Trace trace("SoundDevicePortAudio::callbackProcess %1", m_deviceId.debugName());
+    registerCallbackThread();
+    mixxx::ScopedTraceEvent traceEvent("SoundDevicePortAudio::callbackProcess");
 
     if (statusFlags & (paOutputUnderflow | paInputOverflow)) {
         m_pSoundManager->underflowHappened(1);
@@ -939,6 +958,8 @@ int SoundDevicePortAudio::callbackProcessClkRef(
 
     Trace trace("SoundDevicePortAudio::callbackProcessClkRef %1",
             m_deviceId.debugName());
+    registerCallbackThread();
+    mixxx::ScopedTraceEvent traceEvent("SoundDevicePortAudio::callbackProcessClkRef");
 
     //qDebug() << "SoundDevicePortAudio::callbackProcess:" << m_deviceId;
 
@@ -1033,19 +1054,25 @@ int SoundDevicePortAudio::callbackProcessClkRef(
 
     m_pSoundManager->processUnderflowHappened(framesPerBuffer);
 
+    EngineProfiler::beginCallback(
+            framesPerBuffer * 1000000000LL / m_sampleRate.value());
+
     //Note: Input is processed first so that any ControlObject changes made in
     //      response to input are processed as soon as possible (that is, when
     //      m_pSoundManager->requestBuffer() is called below.)
 
-    // Send audio from the soundcard's input off to the SoundManager...
-    if (in) {
-        ScopedTimer t(QStringLiteral("SoundDevicePortAudio::callbackProcess input %1"),
-                m_deviceId.debugName());
-        composeInputBuffer(in, framesPerBuffer, 0, m_inputParams.channelCount);
-        m_pSoundManager->pushInputBuffers(m_audioInputs, framesPerBuffer);
-    }
+    {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Input);
+        // Send audio from the soundcard's input off to the SoundManager...
+        if (in) {
+            ScopedTimer t(QStringLiteral("SoundDevicePortAudio::callbackProcess input %1"),
+                    m_deviceId.debugName());
+            composeInputBuffer(in, framesPerBuffer, 0, m_inputParams.channelCount);
+            m_pSoundManager->pushInputBuffers(m_audioInputs, framesPerBuffer);
+        }
 
-    m_pSoundManager->readProcess(framesPerBuffer);
+        m_pSoundManager->readProcess(framesPerBuffer);
+    }
 
     {
         ScopedTimer t(QStringLiteral("SoundDevicePortAudio::callbackProcess prepare %1"),
@@ -1053,25 +1080,30 @@ int SoundDevicePortAudio::callbackProcessClkRef(
         m_pSoundManager->onDeviceOutputCallback(framesPerBuffer);
     }
 
-    if (out) {
-        ScopedTimer t(QStringLiteral("SoundDevicePortAudio::callbackProcess output %1"),
-                m_deviceId.debugName());
+    {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Output);
+        if (out) {
+            ScopedTimer t(QStringLiteral("SoundDevicePortAudio::callbackProcess output %1"),
+                    m_deviceId.debugName());
+
+            if (m_outputParams.channelCount <= 0) {
+                qWarning()
+                        << "SoundDevicePortAudio::callbackProcess m_outputParams channel count is zero or less:"
+                        << m_outputParams.channelCount;
+                // Bail out.
+                m_callbackResult.store(paAbort, std::memory_order_relaxed);
+            }
 
-        if (m_outputParams.channelCount <= 0) {
-            qWarning()
-                    << "SoundDevicePortAudio::callbackProcess m_outputParams channel count is zero or less:"
-                    << m_outputParams.channelCount;
-            // Bail out.
-            m_callbackResult.store(paAbort, std::memory_order_relaxed);
+            composeOutputBuffer(out, framesPerBuffer, 0, m_outputParams.channelCount);
         }
 
-        composeOutputBuffer(out, framesPerBuffer, 0, m_outputParams.channelCount);
+        m_pSoundManager->writeProcess(framesPerBuffer);
     }
 
-    m_pSoundManager->writeProcess(framesPerBuffer);
-
     updateAudioLatencyUsage(framesPerBuffer);
 
+    EngineProfiler::endCallback();
+
     return m_callbackResult.load(std::memory_order_acquire);
 }
 
@@ -63,6 +63,9 @@ class SoundDevicePortAudio : public SoundDevice {
     void updateAudioLatencyUsage(const SINT framesPerBuffer);
 
     void makeStreamInactiveAndWait();
+    // Registers the callback thread of the stream with the TraceRecorder
+    // on the first callback.
+    void registerCallbackThread();
 
     // PortAudio stream for this device.
     std::atomic<PaStream*> m_pStream;
@@ -83,6 +86,8 @@ class SoundDevicePortAudio : public SoundDevice {
     QString m_lastError;
     // Whether we have set the thread priority to realtime or not.
     bool m_bSetThreadPriority;
+    // Whether the callback thread has been registered for tracing or not.
+    bool m_bCallbackThreadRegistered;
     PollingControlProxy m_audioLatencyUsage;
     mixxx::Duration m_timeInAudioCallback;
     int m_framesSinceAudioLatencyUsageUpdate;
@@ -8,11 +8,13 @@
 
 #include "audio/types.h"
 #include "control/pollingcontrolproxy.h"
+#include "engine/engineprofiler.h"
 #include "engine/sidechain/enginenetworkstream.h"
 #include "preferences/usersettings.h"
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanagerconfig.h"
 #include "util/cmdlineargs.h"
+#include "util/tracerecorder.h"
 #include "util/types.h"
 
 class EngineMixer;
@@ -98,6 +100,10 @@ class SoundManager : public QObject {
 
     void underflowHappened(int code) {
         m_underflowHappened = 1;
+        // Capture the events that led to the underflow
+        mixxx::TraceRecorder::recordInstant("underflow");
+        mixxx::TraceRecorder::requestSnapshot();
+        EngineProfiler::requestSnapshot();
         // Disable the engine warnings by default, because printing a warning is a
         // locking function that will make the problem worse
         if (CmdlineArgs::Instance().getDeveloper()) {
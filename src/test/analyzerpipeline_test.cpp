@@ -0,0 +1,106 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/constants.h"
+
+namespace {
+
+constexpr int kNumAnalyzers = 3;
+constexpr int kNumChunks = 20;
+
+// Records the first sample of each processed chunk
+class AnalyzerRecorder : public Analyzer {
+  public:
+    explicit AnalyzerRecorder(std::vector<CSAMPLE>* pRecorded)
+            : m_pRecorded(pRecorded) {
+    }
+
+    bool initialize(const AnalyzerTrack&,
+            mixxx::audio::SampleRate,
+            mixxx::audio::ChannelCount,
+            SINT) override {
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        EXPECT_GT(count, 0);
+        m_pRecorded->push_back(pIn[0]);
+        return true;
+    }
+
+    void storeResults(TrackPointer) override {
+    }
+
+    void cleanup() override {
+    }
+
+  private:
+    std::vector<CSAMPLE>* const m_pRecorded;
+};
+
+class AnalyzerPipelineTest : public testing::Test {
+  protected:
+    AnalyzerPipelineTest()
+            : m_recorded(kNumAnalyzers) {
+        for (auto& recorded : m_recorded) {
+            m_analyzers.emplace_back(std::make_unique<AnalyzerRecorder>(&recorded));
+            m_analyzers.back().initialize(AnalyzerTrack(TrackPointer()),
+                    mixxx::audio::SampleRate(44100),
+                    mixxx::audio::ChannelCount::stereo(),
+                    kNumChunks * mixxx::kAnalysisFramesPerChunk);
+        }
+    }
+
+    ~AnalyzerPipelineTest() override {
+        for (auto& analyzer : m_analyzers) {
+            analyzer.cancel();
+        }
+    }
+
+    std::vector<std::vector<CSAMPLE>> m_recorded;
+    std::vector<AnalyzerWithState> m_analyzers;
+};
+
+TEST_F(AnalyzerPipelineTest, ProcessAllChunksInOrder) {
+    AnalyzerPipeline pipeline(&m_analyzers);
+    for (int i = 0; i < kNumChunks; ++i) {
+        auto chunkBuffer = pipeline.nextChunkBuffer();
+        ASSERT_EQ(mixxx::kAnalysisSamplesPerChunk, chunkBuffer.length());
+        chunkBuffer[0] = static_cast<CSAMPLE>(i);
+        pipeline.submitChunk(chunkBuffer.data(), chunkBuffer.length());
+    }
+    pipeline.drain();
+
+    for (const auto& recorded : m_recorded) {
+        ASSERT_EQ(kNumChunks, static_cast<int>(recorded.size()));
+        for (int i = 0; i < kNumChunks; ++i) {
+            EXPECT_EQ(static_cast<CSAMPLE>(i), recorded[i]);
+        }
+    }
+}
+
+TEST_F(AnalyzerPipelineTest, DiscardEmptyChunks) {
+    AnalyzerPipeline pipeline(&m_analyzers);
+    for (int i = 0; i < kNumChunks; ++i) {
+        auto chunkBuffer = pipeline.nextChunkBuffer();
+        if (i % 2) {
+            pipeline.submitChunk(nullptr, 0);
+        } else {
+            chunkBuffer[0] = static_cast<CSAMPLE>(i);
+            pipeline.submitChunk(chunkBuffer.data(), chunkBuffer.length());
+        }
+    }
+    pipeline.drain();
+
+    for (const auto& recorded : m_recorded) {
+        ASSERT_EQ(kNumChunks / 2, static_cast<int>(recorded.size()));
+        for (int i = 0; i < kNumChunks / 2; ++i) {
+            EXPECT_EQ(static_cast<CSAMPLE>(2 * i), recorded[i]);
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,115 @@
+#include "engine/cachingreader/cachingreader.h"
+
+#include <gtest/gtest.h>
+
+#include <QTest>
+#include <atomic>
+#include <thread>
+
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const QString kGroup = QStringLiteral("[Channel1]");
+const ConfigKey kPreloadWholeTrackConfigKey =
+        ConfigKey(QStringLiteral("[CachingReader]"), QStringLiteral("PreloadWholeTrack"));
+
+constexpr auto kChannelCount = mixxx::audio::ChannelCount::stereo();
+constexpr SINT kNumSamples = 1024;
+// A position in the middle of the track, that is never hinted and
+// only available after preloading
+constexpr SINT kStartSample = 44100 * 10 * kChannelCount;
+
+class CachingReaderTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    CachingReaderTest()
+            : m_buffer(kNumSamples) {
+        config()->setValue(kPreloadWholeTrackConfigKey, true);
+        m_pReader = std::make_unique<CachingReader>(kGroup, config(), kChannelCount);
+        m_pReader->setScheduler(&m_scheduler);
+        m_scheduler.start(QThread::HighPriority);
+    }
+
+    TrackPointer newTrack() const {
+        return Track::newTemporary(getTestDir().filePath(QStringLiteral("sine-30.wav")));
+    }
+
+    // Acts as the engine callback
+    CachingReader::ReadResult process() {
+        m_pReader->process();
+        const auto result = m_pReader->read(
+                kStartSample, kNumSamples, false, m_buffer.data(), kChannelCount);
+        m_scheduler.runWorkers();
+        return result;
+    }
+
+    bool processUntil(CachingReader::ReadResult expectedResult) {
+        for (int i = 0; i < 5000; ++i) {
+            if (process() == expectedResult) {
+                return true;
+            }
+            QTest::qSleep(1);
+        }
+        return false;
+    }
+
+    mixxx::SampleBuffer m_buffer;
+    std::unique_ptr<CachingReader> m_pReader;
+    // Stopped before the reader is destroyed
+    EngineWorkerScheduler m_scheduler;
+};
+
+TEST_F(CachingReaderTest, loadAndUnloadPreloadedTrack) {
+    m_pReader->newTrack(newTrack());
+    ASSERT_TRUE(processUntil(CachingReader::ReadResult::AVAILABLE));
+    const std::vector<CSAMPLE> expectedSamples(m_buffer.data(), m_buffer.data() + kNumSamples);
+
+    m_pReader->newTrack(TrackPointer());
+    ASSERT_TRUE(processUntil(CachingReader::ReadResult::UNAVAILABLE));
+
+    // The samples of the reloaded track are identical
+    m_pReader->newTrack(newTrack());
+    ASSERT_TRUE(processUntil(CachingReader::ReadResult::AVAILABLE));
+    EXPECT_EQ(expectedSamples,
+            std::vector<CSAMPLE>(m_buffer.data(), m_buffer.data() + kNumSamples));
+}
+
+TEST_F(CachingReaderTest, loadWhileReadingPreloadedTrack) {
+    m_pReader->newTrack(newTrack());
+    ASSERT_TRUE(processUntil(CachingReader::ReadResult::AVAILABLE));
+    const std::vector<CSAMPLE> expectedSamples(m_buffer.data(), m_buffer.data() + kNumSamples);
+
+    // Load and unload tracks from another thread like the GUI, while the
+    // engine keeps reading the preloaded samples. The samples of the
+    // previous track must stay valid until the reader has received the
+    // track change.
+    std::atomic<bool> done = false;
+    std::thread loader([this, &done]() {
+        for (int i = 0; i < 10; ++i) {
+            m_pReader->newTrack(newTrack());
+            QTest::qSleep(20);
+            if (i % 3 == 1) {
+                m_pReader->newTrack(TrackPointer());
+                QTest::qSleep(5);
+            }
+        }
+        done = true;
+    });
+    while (!done) {
+        if (process() == CachingReader::ReadResult::AVAILABLE) {
+            EXPECT_EQ(expectedSamples,
+                    std::vector<CSAMPLE>(m_buffer.data(), m_buffer.data() + kNumSamples));
+        }
+    }
+    loader.join();
+
+    ASSERT_TRUE(processUntil(CachingReader::ReadResult::AVAILABLE));
+    EXPECT_EQ(expectedSamples,
+            std::vector<CSAMPLE>(m_buffer.data(), m_buffer.data() + kNumSamples));
+}
+
+} // namespace
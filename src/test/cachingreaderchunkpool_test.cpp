@@ -0,0 +1,233 @@
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr SINT kNumChunks = 32;
+
+class CachingReaderChunkPoolTest : public testing::Test {
+  protected:
+    CachingReaderChunkPoolTest()
+            : m_pool(kNumChunks) {
+    }
+
+    ~CachingReaderChunkPoolTest() override {
+        for (const CachingReader* pReader : {readerA(), readerB(), readerC()}) {
+            m_pool.releaseAllChunks(pReader);
+            m_pool.removeReader(pReader);
+        }
+    }
+
+    // The pool only uses the readers for identification
+    const CachingReader* readerA() const {
+        return reinterpret_cast<const CachingReader*>(&m_readers[0]);
+    }
+    const CachingReader* readerB() const {
+        return reinterpret_cast<const CachingReader*>(&m_readers[1]);
+    }
+    const CachingReader* readerC() const {
+        return reinterpret_cast<const CachingReader*>(&m_readers[2]);
+    }
+
+    // Allocates a chunk and inserts it into the MRU/LRU list as if it
+    // has been read by the worker.
+    CachingReaderChunkForOwner* allocateReadyChunk(
+            const CachingReader* pReader, SINT chunkIndex) {
+        CachingReaderChunkForOwner* pChunk = m_pool.allocateChunk(
+                pReader, chunkIndex, CachingReaderChunk::kDefaultFrames);
+        if (pChunk) {
+            m_pool.freshenChunk(pChunk);
+        }
+        return pChunk;
+    }
+
+    CachingReaderChunkPool m_pool;
+
+  private:
+    int m_readers[3] = {};
+};
+
+TEST_F(CachingReaderChunkPoolTest, allocateAndFree) {
+    m_pool.addReader(readerA());
+    EXPECT_EQ(kNumChunks, m_pool.size());
+    EXPECT_EQ(kNumChunks, m_pool.numFreeChunks());
+
+    std::vector<CachingReaderChunkForOwner*> chunks;
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        CachingReaderChunkForOwner* pChunk = allocateReadyChunk(readerA(), i);
+        ASSERT_NE(nullptr, pChunk);
+        EXPECT_TRUE(m_pool.isChunkAllocatedBy(pChunk, readerA(), i));
+        chunks.push_back(pChunk);
+    }
+    EXPECT_EQ(0, m_pool.numFreeChunks());
+    EXPECT_EQ(kNumChunks, m_pool.numChunksAllocatedBy(readerA()));
+
+    m_pool.freeChunk(chunks.front());
+    EXPECT_EQ(1, m_pool.numFreeChunks());
+    EXPECT_FALSE(m_pool.isChunkAllocatedBy(chunks.front(), readerA(), 0));
+
+    m_pool.freeAllChunks(readerA());
+    EXPECT_EQ(kNumChunks, m_pool.numFreeChunks());
+    EXPECT_EQ(0, m_pool.numChunksAllocatedBy(readerA()));
+}
+
+TEST_F(CachingReaderChunkPoolTest, chunksOfWorkerAreNotEvicted) {
+    m_pool.addReader(readerA());
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        // Handed over to the worker and not inserted into the list
+        CachingReaderChunkForOwner* pChunk = m_pool.allocateChunk(
+                readerA(), i, CachingReaderChunk::kDefaultFrames);
+        ASSERT_NE(nullptr, pChunk);
+        pChunk->giveToWorker();
+    }
+    EXPECT_EQ(nullptr,
+            m_pool.allocateChunk(readerA(), kNumChunks, CachingReaderChunk::kDefaultFrames));
+    m_pool.releaseAllChunks(readerA());
+    EXPECT_EQ(kNumChunks, m_pool.numFreeChunks());
+}
+
+TEST_F(CachingReaderChunkPoolTest, evictLeastRecentlyUsed) {
+    m_pool.addReader(readerA());
+    std::vector<CachingReaderChunkForOwner*> chunks;
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        chunks.push_back(allocateReadyChunk(readerA(), i));
+    }
+    // Chunk 0 becomes the most recently used chunk
+    m_pool.freshenChunk(chunks[0]);
+
+    CachingReaderChunkForOwner* pChunk = allocateReadyChunk(readerA(), kNumChunks);
+    ASSERT_NE(nullptr, pChunk);
+    EXPECT_EQ(chunks[1], pChunk);
+    EXPECT_TRUE(m_pool.isChunkAllocatedBy(chunks[0], readerA(), 0));
+    EXPECT_FALSE(m_pool.isChunkAllocatedBy(chunks[1], readerA(), 1));
+    for (SINT i = 2; i < kNumChunks; ++i) {
+        EXPECT_TRUE(m_pool.isChunkAllocatedBy(chunks[i], readerA(), i));
+    }
+
+    pChunk = allocateReadyChunk(readerA(), kNumChunks + 1);
+    EXPECT_EQ(chunks[2], pChunk);
+}
+
+TEST_F(CachingReaderChunkPoolTest, reservation) {
+    EXPECT_EQ(0, m_pool.reservedChunksPerReader());
+    m_pool.addReader(readerA());
+    EXPECT_EQ(CachingReaderChunkPool::kMaxReservedChunksPerReader,
+            m_pool.reservedChunksPerReader());
+    m_pool.addReader(readerB());
+    m_pool.addReader(readerC());
+    // At most half of the pool is reserved
+    EXPECT_EQ(kNumChunks / 6, m_pool.reservedChunksPerReader());
+    m_pool.removeReader(readerC());
+    EXPECT_EQ(kNumChunks / 4, m_pool.reservedChunksPerReader());
+}
+
+TEST_F(CachingReaderChunkPoolTest, crossReaderEviction) {
+    m_pool.addReader(readerA());
+    m_pool.addReader(readerB());
+    const SINT reservedChunks = m_pool.reservedChunksPerReader();
+    ASSERT_GT(reservedChunks, 0);
+
+    // The playing deck allocates more than its reservation
+    std::vector<CachingReaderChunkForOwner*> chunksOfA;
+    for (SINT i = 0; i < 2 * reservedChunks; ++i) {
+        chunksOfA.push_back(allocateReadyChunk(readerA(), i));
+    }
+
+    // Loading a track into another deck requests many more chunks
+    // than available, so the chunks of the playing deck become the
+    // least recently used chunks.
+    for (SINT i = 0; i < 4 * kNumChunks; ++i) {
+        ASSERT_NE(nullptr, allocateReadyChunk(readerB(), i));
+    }
+
+    // Only the chunks beyond the reservation have been evicted
+    EXPECT_EQ(reservedChunks, m_pool.numChunksAllocatedBy(readerA()));
+    EXPECT_EQ(kNumChunks - reservedChunks, m_pool.numChunksAllocatedBy(readerB()));
+    for (SINT i = 0; i < reservedChunks; ++i) {
+        EXPECT_FALSE(m_pool.isChunkAllocatedBy(chunksOfA[i], readerA(), i));
+    }
+    for (SINT i = reservedChunks; i < 2 * reservedChunks; ++i) {
+        EXPECT_TRUE(m_pool.isChunkAllocatedBy(chunksOfA[i], readerA(), i));
+    }
+
+    // Readers can always replace their own chunks
+    ASSERT_NE(nullptr, allocateReadyChunk(readerA(), 2 * reservedChunks));
+    EXPECT_EQ(reservedChunks, m_pool.numChunksAllocatedBy(readerA()));
+}
+
+TEST_F(CachingReaderChunkPoolTest, unregisteredReadersAreEvicted) {
+    m_pool.addReader(readerB());
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        ASSERT_NE(nullptr, allocateReadyChunk(readerA(), i));
+    }
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        ASSERT_NE(nullptr, allocateReadyChunk(readerB(), i));
+    }
+    EXPECT_EQ(kNumChunks, m_pool.numChunksAllocatedBy(readerB()));
+    m_pool.freeAllChunks(readerA());
+}
+
+TEST_F(CachingReaderChunkPoolTest, pinnedChunksAreNotEvicted) {
+    m_pool.addReader(readerA());
+    std::vector<CachingReaderChunkForOwner*> chunks;
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        chunks.push_back(allocateReadyChunk(readerA(), i));
+        ASSERT_TRUE(m_pool.pinChunkIfAllocatedBy(chunks.back(), readerA(), i));
+    }
+    EXPECT_EQ(nullptr,
+            m_pool.allocateChunk(readerA(), kNumChunks, CachingReaderChunk::kDefaultFrames));
+
+    // Only the unpinned chunk is evicted, although it is the most
+    // recently used chunk
+    m_pool.unpinChunk(chunks.back());
+    EXPECT_EQ(chunks.back(), allocateReadyChunk(readerA(), kNumChunks));
+    for (SINT i = 0; i < kNumChunks - 1; ++i) {
+        EXPECT_TRUE(m_pool.isChunkAllocatedBy(chunks[i], readerA(), i));
+        m_pool.unpinChunk(chunks[i]);
+    }
+    EXPECT_EQ(chunks.front(), allocateReadyChunk(readerA(), kNumChunks + 1));
+}
+
+TEST_F(CachingReaderChunkPoolTest, concurrentReadersDoNotEvictPinnedChunks) {
+    // No reservation, so both readers evict the chunks of each other
+    constexpr int kIterations = 20000;
+    std::atomic<int> numEvictedWhilePinned = 0;
+    std::atomic<bool> done = false;
+
+    // Allocates many more chunks than available, like a reader after
+    // loading a track or seeking
+    std::thread allocator([this, &done]() {
+        for (SINT i = 0; !done; ++i) {
+            allocateReadyChunk(readerB(), i % (2 * kNumChunks));
+        }
+    });
+
+    // Reads from a few chunks, like the reader of a playing deck
+    std::array<CachingReaderChunkForOwner*, 4> chunksOfA = {};
+    for (int i = 0; i < kIterations; ++i) {
+        const SINT chunkIndex = i % static_cast<SINT>(chunksOfA.size());
+        CachingReaderChunkForOwner*& pChunk = chunksOfA[chunkIndex];
+        if (!pChunk || !m_pool.pinChunkIfAllocatedBy(pChunk, readerA(), chunkIndex)) {
+            pChunk = allocateReadyChunk(readerA(), chunkIndex);
+            continue;
+        }
+        for (int j = 0; j < 10; ++j) {
+            if (!m_pool.isChunkAllocatedBy(pChunk, readerA(), chunkIndex)) {
+                ++numEvictedWhilePinned;
+            }
+        }
+        m_pool.unpinChunk(pChunk);
+    }
+    done = true;
+    allocator.join();
+
+    EXPECT_EQ(0, numEvictedWhilePinned);
+}
+
+} // namespace
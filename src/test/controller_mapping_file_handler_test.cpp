@@ -142,6 +142,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, canParseScreenMapping) {
                     QImage::Format_RGBA8888,
                     LegacyControllerMapping::ScreenInfo::ColorEndian::Little,
                     false,
+                    false,
                     false)));
     EXPECT_CALL(*mapping, addModule(QFileInfo("/dummy/path/foobar"), false));
 
@@ -170,7 +171,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingTargetFPS) {
                     _, // gmock seems unable to assert QFileInfo
                     LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
                     true)));
-    EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, 20, _, _, _, _, _, _)));
+    EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, 20, _, _, _, _, _, _, _)));
 
     addScriptFilesToMapping(
             doc.documentElement(),
@@ -322,7 +323,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingSize) {
                     _, // gmock seems unable to assert QFileInfo
                     LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
                     true)));
-    EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, QSize(10, 10), _, _, _, _, _, _, _)));
+    EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, QSize(10, 10), _, _, _, _, _, _, _, _)));
 
     addScriptFilesToMapping(
             doc.documentElement(),
@@ -472,7 +473,9 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingBitFormatDefinition)
                     _, // gmock seems unable to assert QFileInfo
                     LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
                     true)));
-    EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, QImage::Format_RGB888, _, _, _)));
+    EXPECT_CALL(*mapping,
+            addScreenInfo(FieldsAre(
+                    _, _, _, _, _, QImage::Format_RGB888, _, _, _, _)));
 
     addScriptFilesToMapping(
             doc.documentElement(),
@@ -496,7 +499,9 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingBitFormatDefinition)
                     _, // gmock seems unable to assert QFileInfo
                     LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
                     true)));
-    EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, QImage::Format_RGB16, _, _, _)));
+    EXPECT_CALL(*mapping,
+            addScreenInfo(FieldsAre(
+                    _, _, _, _, _, QImage::Format_RGB16, _, _, _, _)));
 
     addScriptFilesToMapping(
             doc.documentElement(),
@@ -557,6 +562,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingBitFormatDefinition)
                     _,
                     LegacyControllerMapping::ScreenInfo::ColorEndian::Little,
                     _,
+                    _,
                     _)));
 
     addScriptFilesToMapping(
@@ -590,6 +596,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingBitFormatDefinition)
                     _,
                     LegacyControllerMapping::ScreenInfo::ColorEndian::Little,
                     _,
+                    _,
                     _)));
 
     addScriptFilesToMapping(
@@ -623,6 +630,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingBitFormatDefinition)
                     _,
                     LegacyControllerMapping::ScreenInfo::ColorEndian::Big,
                     _,
+                    _,
                     _)));
 
     addScriptFilesToMapping(
@@ -693,7 +701,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraBoolPropertiesD
                     QString("Unable to parse the field \"reversed\" as a "
                             "boolean in the screen definition."));
         }
-        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, false, _)));
+        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, false, _, _)));
 
         addScriptFilesToMapping(
                 doc.documentElement(),
@@ -720,7 +728,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraBoolPropertiesD
                         _, // gmock seems unable to assert QFileInfo
                         LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
                         true)));
-        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, true, _)));
+        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, true, _, _)));
 
         addScriptFilesToMapping(
                 doc.documentElement(),
@@ -749,7 +757,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraBoolPropertiesD
                         _, // gmock seems unable to assert QFileInfo
                         LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
                         true)));
-        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, _, false)));
+        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, _, false, _)));
         if (expectedWarning++) {
             EXPECT_LOG_MSG(QtWarningMsg,
                     QString("Unable to parse the field \"raw\" as a boolean in "
@@ -781,7 +789,68 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraBoolPropertiesD
                         _, // gmock seems unable to assert QFileInfo
                         LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
                         true)));
-        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, _, true)));
+        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, _, true, _)));
+
+        addScriptFilesToMapping(
+                doc.documentElement(),
+                mapping,
+                QDir());
+    }
+    // partialUpdate
+    expectedWarning = &kExpectedWarning[0];
+    for (const QString& falseValue : std::as_const(kFalseValue)) {
+        doc.setContent(
+                QString(R"EOF(
+                <controller id="DummyDevice">
+                        <screens>
+                        <screen identifier="main" width="10" height="10" partialUpdate="%0"/>
+                        </screens>
+                </controller>
+                )EOF")
+                        .arg(falseValue)
+                        .toUtf8());
+
+        mapping = std::make_shared<MockLegacyControllerMapping>();
+        // This file always gets added
+        EXPECT_CALL(*mapping,
+                addScriptFile(FieldsAre(QString("common-controller-scripts.js"),
+                        QString(""),
+                        _, // gmock seems unable to assert QFileInfo
+                        LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
+                        true)));
+        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, _, _, false)));
+        if (expectedWarning++) {
+            EXPECT_LOG_MSG(QtWarningMsg,
+                    QString("Unable to parse the field \"partialUpdate\" as a "
+                            "boolean in the screen definition."));
+        }
+
+        addScriptFilesToMapping(
+                doc.documentElement(),
+                mapping,
+                QDir());
+    }
+    for (const QString& trueValue : std::as_const(kTrueValue)) {
+        doc.setContent(
+                QString(R"EOF(
+                <controller id="DummyDevice">
+                        <screens>
+                        <screen identifier="main" width="10" height="10" partialUpdate="%0"/>
+                        </screens>
+                </controller>
+                )EOF")
+                        .arg(trueValue)
+                        .toUtf8());
+
+        mapping = std::make_shared<MockLegacyControllerMapping>();
+        // This file always gets added
+        EXPECT_CALL(*mapping,
+                addScriptFile(FieldsAre(QString("common-controller-scripts.js"),
+                        QString(""),
+                        _, // gmock seems unable to assert QFileInfo
+                        LegacyControllerMapping::ScriptFileInfo::Type::Javascript,
+                        true)));
+        EXPECT_CALL(*mapping, addScreenInfo(FieldsAre(_, _, _, _, _, _, _, _, _, true)));
 
         addScriptFilesToMapping(
                 doc.documentElement(),
@@ -813,7 +882,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraIntPropertiesDe
                     true)));
     EXPECT_CALL(*mapping,
             addScreenInfo(FieldsAre(
-                    _, _, _, _, std::chrono::milliseconds(0), _, _, _, _)));
+                    _, _, _, _, std::chrono::milliseconds(0), _, _, _, _, _)));
 
     addScriptFilesToMapping(
             doc.documentElement(),
@@ -839,7 +908,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraIntPropertiesDe
                     true)));
     EXPECT_CALL(*mapping,
             addScreenInfo(FieldsAre(
-                    _, _, _, _, std::chrono::milliseconds(500), _, _, _, _)));
+                    _, _, _, _, std::chrono::milliseconds(500), _, _, _, _, _)));
 
     addScriptFilesToMapping(
             doc.documentElement(),
@@ -872,6 +941,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraIntPropertiesDe
                     _,
                     _,
                     _,
+                    _,
                     _)));
     EXPECT_LOG_MSG(
             QtWarningMsg,
@@ -908,7 +978,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraIntPropertiesDe
                     "integer in the screen definition."));
     EXPECT_CALL(*mapping,
             addScreenInfo(FieldsAre(
-                    _, _, _, _, std::chrono::milliseconds(0), _, _, _, _)));
+                    _, _, _, _, std::chrono::milliseconds(0), _, _, _, _, _)));
 
     addScriptFilesToMapping(
             doc.documentElement(),
@@ -938,7 +1008,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, screenMappingExtraIntPropertiesDe
                     "integer in the screen definition."));
     EXPECT_CALL(*mapping,
             addScreenInfo(FieldsAre(
-                    _, _, _, _, std::chrono::milliseconds(0), _, _, _, _)));
+                    _, _, _, _, std::chrono::milliseconds(0), _, _, _, _, _)));
 
     addScriptFilesToMapping(
             doc.documentElement(),
@@ -995,6 +1065,7 @@ TEST_F(LegacyControllerMappingFileHandlerTest, canParseHybridMapping) {
                     QImage::Format_RGBA8888,
                     LegacyControllerMapping::ScreenInfo::ColorEndian::Little,
                     false,
+                    false,
                     false)));
     EXPECT_CALL(*mapping, addModule(QFileInfo("/dummy/path/foobar"), false));
 
@@ -47,7 +47,8 @@ TEST_F(ControllerRenderingEngineTest, createValidRendererWithSupportedTypes) {
                 pixelFormat,                                           // pixelFormat
                 LegacyControllerMapping::ScreenInfo::ColorEndian::Big, // endian
                 false,                                                 // reversedColor
-                false                                                  // rawData
+                false,                                                 // rawData
+                false                                                  // partialUpdate
         });
         EXPECT_TRUE(screenTest.isValid());
         EXPECT_TRUE(screenTest.stop());
@@ -208,7 +208,7 @@ class ControllerScriptEngineLegacyTest : public ControllerScriptEngineLegacy,
             const LegacyControllerMapping::ScreenInfo& screeninfo,
             const QImage& frame,
             const QDateTime& timestamp) {
-        handleScreenFrame(screeninfo, frame, timestamp);
+        handleScreenFrame(screeninfo, frame, timestamp, {frame.rect()});
     }
 #endif
 
@@ -1018,7 +1018,8 @@ TEST_F(ControllerScriptEngineLegacyTest, screenWontSentRawDataIfNotConfigured) {
             QImage::Format_RGB16,                                  // pixelFormat
             LegacyControllerMapping::ScreenInfo::ColorEndian::Big, // endian
             false,                                                 // rawData
-            false                                                  // reversedColor
+            false,                                                 // reversedColor
+            false                                                  // partialUpdate
     };
     QImage dummyFrame;
     // Allocate screen on the heap as it need to outlive the this function,
@@ -1053,7 +1054,8 @@ TEST_F(ControllerScriptEngineLegacyTest, screenWillSentRawDataIfConfigured) {
             QImage::Format_RGB16,                                  // pixelFormat
             LegacyControllerMapping::ScreenInfo::ColorEndian::Big, // endian
             false,                                                 // reversedColor
-            true                                                   // rawData
+            true,                                                  // rawData
+            false                                                  // partialUpdate
     };
     QImage dummyFrame;
     // Allocate screen on the heap as it need to outlive the this function,
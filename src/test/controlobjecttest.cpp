@@ -37,6 +37,18 @@ TEST_F(ControlObjectTest, getControl) {
             (ControlObject*)nullptr);
 }
 
+TEST_F(ControlObjectTest, getRecreatedControl) {
+    co2.reset();
+    EXPECT_TRUE(ControlDoublePrivate::getControl(
+            ck2, ControlFlag::NoAssertIfMissing)
+                    .isNull());
+
+    // The key stays interned when the control is deleted
+    co2 = std::make_unique<ControlObject>(ck2);
+    EXPECT_EQ(ControlDoublePrivate::getControl(ck2)->getCreatorCO(), co2.get());
+    EXPECT_EQ(ControlDoublePrivate::getControl(ck1)->getCreatorCO(), co1.get());
+}
+
 TEST_F(ControlObjectTest, AliasRetrieval) {
     ConfigKey ck("[Microphone1]", "volume");
     ConfigKey ckAlias("[Microphone]", "volume");
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <QList>
+#include <memory>
+#include <vector>
+
+#include "control/control.h"
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+
+namespace {
+
+constexpr int kNumGroups = 32;
+constexpr int kNumItemsPerGroup = 256;
+
+/// Creates a set of controls comparable to a full 4-deck configuration
+/// with effects, samplers and controllers.
+class ControlSet {
+  public:
+    ControlSet() {
+        for (int i = 0; i < kNumGroups; ++i) {
+            const QString group = QStringLiteral("[BenchmarkGroup%1]").arg(i);
+            for (int j = 0; j < kNumItemsPerGroup; ++j) {
+                const auto key = ConfigKey(group, QStringLiteral("item%1").arg(j));
+                m_controls.push_back(std::make_unique<ControlObject>(key));
+                m_keys.append(key);
+            }
+        }
+    }
+
+    const QList<ConfigKey>& keys() const {
+        return m_keys;
+    }
+
+  private:
+    std::vector<std::unique_ptr<ControlObject>> m_controls;
+    QList<ConfigKey> m_keys;
+};
+
+// Shared by all threads of a benchmark. Created and destroyed by the
+// first thread, the other threads wait before entering the loop.
+std::unique_ptr<ControlSet> s_pControlSet;
+
+/// Resolves all controls by their ConfigKey like controller scripts
+/// do during initialization.
+static void BM_ControlLookupByKey(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        s_pControlSet = std::make_unique<ControlSet>();
+    }
+    for (auto _ : state) {
+        for (const auto& key : s_pControlSet->keys()) {
+            benchmark::DoNotOptimize(ControlDoublePrivate::getControl(key));
+        }
+    }
+    state.counters["lookups/s"] = benchmark::Counter(
+            static_cast<double>(kNumGroups * kNumItemsPerGroup),
+            benchmark::Counter::kIsIterationInvariantRate);
+    if (state.thread_index() == 0) {
+        s_pControlSet.reset();
+    }
+}
+BENCHMARK(BM_ControlLookupByKey)->ThreadRange(1, 8)->UseRealTime();
+
+/// Creates and destroys a ControlProxy for each control like the
+/// widgets of a skin during loading.
+static void BM_ControlProxySkinLoad(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        s_pControlSet = std::make_unique<ControlSet>();
+    }
+    for (auto _ : state) {
+        for (const auto& key : s_pControlSet->keys()) {
+            ControlProxy proxy(key);
+            benchmark::DoNotOptimize(proxy.get());
+        }
+    }
+    state.counters["proxies/s"] = benchmark::Counter(
+            static_cast<double>(kNumGroups * kNumItemsPerGroup),
+            benchmark::Counter::kIsIterationInvariantRate);
+    if (state.thread_index() == 0) {
+        s_pControlSet.reset();
+    }
+}
+BENCHMARK(BM_ControlProxySkinLoad)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace
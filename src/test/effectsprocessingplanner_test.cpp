@@ -0,0 +1,136 @@
+#include "effects/effectsprocessingplanner.h"
+
+#include <gtest/gtest.h>
+
+#include "engine/channelhandle.h"
+
+namespace {
+
+class EffectsProcessingPlannerTest : public testing::Test {
+  protected:
+    EffectsProcessingPlannerTest()
+            : m_channel(m_channelHandleFactory.getOrCreateHandle(
+                      QStringLiteral("[Channel1]"))) {
+    }
+
+    // The planner only uses the chains for identification
+    EngineEffectChain* chain() {
+        return reinterpret_cast<EngineEffectChain*>(&m_chain);
+    }
+
+    bool send(EffectsRequest request) {
+        request.request_id = m_nextRequestId++;
+        return m_planner.onRequestSent(request);
+    }
+
+    bool addChain() {
+        EffectsRequest request;
+        request.type = EffectsRequest::ADD_EFFECT_CHAIN;
+        request.AddEffectChain.pChain = chain();
+        request.AddEffectChain.signalProcessingStage = SignalProcessingStage::Prefader;
+        return send(request);
+    }
+
+    bool addEffect() {
+        EffectsRequest request;
+        request.type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+        request.pTargetChain = chain();
+        request.AddEffectToChain.pEffect = nullptr;
+        request.AddEffectToChain.iIndex = 0;
+        return send(request);
+    }
+
+    bool enableForChannel() {
+        EffectsRequest request;
+        request.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+        request.pTargetChain = chain();
+        request.EnableInputChannelForChain.channelHandle = m_channel;
+        return send(request);
+    }
+
+    bool setParameters(bool enabled, double mix) {
+        EffectsRequest request;
+        request.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+        request.pTargetChain = chain();
+        request.SetEffectChainParameters.enabled = enabled;
+        request.SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+        request.SetEffectChainParameters.mix = mix;
+        return send(request);
+    }
+
+    bool isProcessed() const {
+        const auto pPlan = m_planner.createPlan();
+        return !pPlan->chains(SignalProcessingStage::Prefader, m_channel).empty();
+    }
+
+    qint64 lastRequestId() const {
+        return m_nextRequestId - 1;
+    }
+
+    EffectsProcessingPlanner m_planner;
+
+  private:
+    ChannelHandleFactory m_channelHandleFactory;
+    const ChannelHandle m_channel;
+    int m_chain = 0;
+    qint64 m_nextRequestId = 1;
+};
+
+TEST_F(EffectsProcessingPlannerTest, processEnabledChain) {
+    addChain();
+    addEffect();
+    enableForChannel();
+    EXPECT_FALSE(isProcessed());
+
+    EXPECT_TRUE(setParameters(true, 1.0));
+    EXPECT_TRUE(isProcessed());
+}
+
+TEST_F(EffectsProcessingPlannerTest, fadeOutDisabledChain) {
+    addChain();
+    addEffect();
+    enableForChannel();
+    setParameters(true, 1.0);
+
+    // Processed until the engine has received the request
+    EXPECT_FALSE(setParameters(false, 1.0));
+    EXPECT_TRUE(isProcessed());
+    EXPECT_TRUE(m_planner.onResponseReceived(lastRequestId()));
+    EXPECT_FALSE(isProcessed());
+
+    EXPECT_TRUE(setParameters(true, 1.0));
+    EXPECT_TRUE(isProcessed());
+}
+
+TEST_F(EffectsProcessingPlannerTest, fadeOutFullyDryChain) {
+    addChain();
+    addEffect();
+    enableForChannel();
+    setParameters(true, 1.0);
+
+    // Processed once more to flush the state of the effects
+    EXPECT_FALSE(setParameters(true, 0.0));
+    EXPECT_TRUE(isProcessed());
+    EXPECT_TRUE(m_planner.onResponseReceived(lastRequestId()));
+    EXPECT_FALSE(isProcessed());
+
+    EXPECT_TRUE(setParameters(true, 0.5));
+    EXPECT_TRUE(isProcessed());
+    EXPECT_FALSE(setParameters(true, 1.0));
+    EXPECT_TRUE(isProcessed());
+}
+
+TEST_F(EffectsProcessingPlannerTest, enableFullyDryChain) {
+    addChain();
+    addEffect();
+    enableForChannel();
+
+    // Enabled with the mix knob at zero
+    EXPECT_FALSE(setParameters(true, 0.0));
+    EXPECT_FALSE(isProcessed());
+
+    EXPECT_TRUE(setParameters(true, 1.0));
+    EXPECT_TRUE(isProcessed());
+}
+
+} // namespace
@@ -0,0 +1,124 @@
+#ifdef __RUBBERBAND__
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+
+#include "engine/bufferscalers/enginebufferscalerubberband.h"
+#include "engine/bufferscalers/rubberbandworkerpool.h"
+#include "engine/readaheadmanager.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::Invoke;
+using ::testing::StrictMock;
+
+namespace {
+
+constexpr SINT kBufferSize = 1024;
+
+class ReadAheadManagerMock : public ReadAheadManager {
+  public:
+    ReadAheadManagerMock()
+            : ReadAheadManager(),
+              m_iSamplesRead(0) {
+    }
+
+    SINT getNextSamplesFake(double dRate,
+            CSAMPLE* buffer,
+            SINT requested_samples,
+            mixxx::audio::ChannelCount channelCount) {
+        Q_UNUSED(dRate);
+        Q_UNUSED(channelCount);
+        for (SINT i = 0; i < requested_samples; ++i) {
+            buffer[i] = static_cast<CSAMPLE>(std::sin((m_iSamplesRead + i) * 0.01));
+        }
+        m_iSamplesRead += requested_samples;
+        return requested_samples;
+    }
+
+    SINT getSamplesRead() const {
+        return m_iSamplesRead;
+    }
+
+    MOCK_METHOD4(getNextSamples,
+            SINT(double dRate,
+                    CSAMPLE* buffer,
+                    SINT requested_samples,
+                    mixxx::audio::ChannelCount channelCount));
+
+  private:
+    SINT m_iSamplesRead;
+};
+
+class EngineBufferScaleRubberBandTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        RubberBandWorkerPool::createInstance();
+        m_pReadAheadMock = std::make_unique<StrictMock<ReadAheadManagerMock>>();
+        m_pScaler = std::make_unique<EngineBufferScaleRubberBand>(m_pReadAheadMock.get());
+        m_pScaler->setSignal(mixxx::audio::SampleRate(44100),
+                mixxx::audio::ChannelCount::stereo());
+        m_pScaler->setPrefetchEnabled(true);
+    }
+
+    void TearDown() override {
+        m_pScaler.reset();
+        m_pReadAheadMock.reset();
+        RubberBandWorkerPool::destroy();
+    }
+
+    void setRate(double rate) {
+        double tempoRatio = rate;
+        double pitchRatio = 1.0;
+        m_pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    }
+
+    void expectReads() {
+        EXPECT_CALL(*m_pReadAheadMock, getNextSamples(_, _, _, _))
+                .Times(AtLeast(1))
+                .WillRepeatedly(Invoke(m_pReadAheadMock.get(),
+                        &ReadAheadManagerMock::getNextSamplesFake));
+    }
+
+    std::unique_ptr<StrictMock<ReadAheadManagerMock>> m_pReadAheadMock;
+    std::unique_ptr<EngineBufferScaleRubberBand> m_pScaler;
+};
+
+TEST_F(EngineBufferScaleRubberBandTest, NoPrefetchAfterParameterChange) {
+    EXPECT_CALL(*m_pReadAheadMock, getNextSamples(_, _, _, _)).Times(0);
+    setRate(1.0);
+    m_pScaler->prefetch(kBufferSize);
+    setRate(1.1);
+    m_pScaler->prefetch(kBufferSize);
+}
+
+TEST_F(EngineBufferScaleRubberBandTest, PrefetchReadsAheadWhilePlayingSteadily) {
+    expectReads();
+    mixxx::SampleBuffer output(kBufferSize);
+    int prefetchedCallbacks = 0;
+    for (int callback = 0; callback < 16; ++callback) {
+        setRate(1.0);
+        const double framesRead = m_pScaler->scaleBuffer(output.data(), kBufferSize);
+        if (callback > 0) {
+            // Prefetched or not, the whole buffer is filled
+            EXPECT_DOUBLE_EQ(kBufferSize / 2, framesRead);
+        }
+        const SINT samplesRead = m_pReadAheadMock->getSamplesRead();
+        m_pScaler->prefetch(kBufferSize);
+        if (m_pReadAheadMock->getSamplesRead() > samplesRead) {
+            ++prefetchedCallbacks;
+        }
+    }
+    // The first callback follows the parameter change and is not prefetched
+    EXPECT_GT(prefetchedCallbacks, 0);
+}
+
+} // namespace
+
+#endif // __RUBBERBAND__
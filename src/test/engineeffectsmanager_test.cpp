@@ -0,0 +1,266 @@
+#include "engine/effects/engineeffectsmanager.h"
+
+#include <gtest/gtest.h>
+
+#include <QThreadPool>
+#include <QVarLengthArray>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/builtin/bitcrushereffect.h"
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/builtin/phasereffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "effects/effectsmessenger.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "test/mixxxtest.h"
+#include "util/messagepipe.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kNumChains = 3;
+constexpr int kNumChannels = 4;
+constexpr std::size_t kNumSamples = 512;
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+
+/// A set of postfader chains that are shared by multiple channels and
+/// carry state from one channel to the next, e.g. the Echo delay lines.
+class EffectsSetup {
+  public:
+    EffectsSetup(EffectsBackendManagerPointer pBackendManager,
+            ChannelHandleFactory* pChannelHandleFactory) {
+        auto [requestPipe, responsePipe] =
+                makeTwoWayMessagePipe<EffectsRequest*, EffectsResponse>(2048, 2048);
+        m_pMessenger = std::make_unique<EffectsMessenger>(std::move(requestPipe));
+        m_pEngineEffectsManager = std::make_unique<EngineEffectsManager>(
+                std::move(responsePipe));
+
+        QSet<ChannelHandleAndGroup> inputChannels;
+        for (int i = 0; i < kNumChannels; ++i) {
+            const QString group = QStringLiteral("[Channel%1]").arg(i + 1);
+            inputChannels.insert(ChannelHandleAndGroup(
+                    pChannelHandleFactory->getOrCreateHandle(group), group));
+        }
+        const QString outputGroup = QStringLiteral("[Master]");
+        m_outputHandle = pChannelHandleFactory->getOrCreateHandle(outputGroup);
+        const QSet<ChannelHandleAndGroup> outputChannels = {
+                ChannelHandleAndGroup(m_outputHandle, outputGroup)};
+
+        const QStringList effectIds = {
+                EchoEffect::getId(),
+                PhaserEffect::getId(),
+                BitCrusherEffect::getId(),
+        };
+        for (int i = 0; i < kNumChains; ++i) {
+            auto pChain = std::make_unique<EngineEffectChain>(
+                    QStringLiteral("[EffectRack1_EffectUnit%1]").arg(i + 1),
+                    inputChannels,
+                    outputChannels);
+
+            auto* pRequest = new EffectsRequest();
+            pRequest->type = EffectsRequest::ADD_EFFECT_CHAIN;
+            pRequest->AddEffectChain.pChain = pChain.get();
+            pRequest->AddEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+            m_pMessenger->writeRequest(pRequest);
+
+            auto pEffect = std::make_unique<EngineEffect>(
+                    pBackendManager->getManifest(effectIds[i], EffectBackendType::BuiltIn),
+                    pBackendManager,
+                    inputChannels,
+                    inputChannels,
+                    outputChannels);
+
+            pRequest = new EffectsRequest();
+            pRequest->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+            pRequest->pTargetChain = pChain.get();
+            pRequest->AddEffectToChain.pEffect = pEffect.get();
+            pRequest->AddEffectToChain.iIndex = 0;
+            m_pMessenger->writeRequest(pRequest);
+
+            pRequest = new EffectsRequest();
+            pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
+            pRequest->pTargetEffect = pEffect.get();
+            pRequest->SetEffectParameters.enabled = true;
+            m_pMessenger->writeRequest(pRequest);
+
+            pRequest = new EffectsRequest();
+            pRequest->type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+            pRequest->pTargetChain = pChain.get();
+            pRequest->SetEffectChainParameters.enabled = true;
+            pRequest->SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+            pRequest->SetEffectChainParameters.mix = 0.5;
+            m_pMessenger->writeRequest(pRequest);
+
+            // Each chain is shared by a different subset of the channels
+            for (const auto& inputChannel : std::as_const(inputChannels)) {
+                if ((inputChannel.handle().handle() + i) % 3 == 0) {
+                    continue;
+                }
+                pRequest = new EffectsRequest();
+                pRequest->type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+                pRequest->pTargetChain = pChain.get();
+                pRequest->EnableInputChannelForChain.channelHandle = inputChannel.handle();
+                m_pMessenger->writeRequest(pRequest);
+            }
+
+            m_chains.push_back(std::move(pChain));
+            m_effects.push_back(std::move(pEffect));
+        }
+
+        m_pEngineEffectsManager->onCallbackStart();
+        m_pMessenger->processEffectsResponses();
+        m_pEngineEffectsManager->onCallbackStart();
+        m_pMessenger->processEffectsResponses();
+    }
+
+    ~EffectsSetup() {
+        m_pMessenger->initiateShutdown();
+        m_pEngineEffectsManager.reset();
+        m_pMessenger.reset();
+    }
+
+    EngineEffectsManager* engineEffectsManager() const {
+        return m_pEngineEffectsManager.get();
+    }
+
+    ChannelHandle outputHandle() const {
+        return m_outputHandle;
+    }
+
+  private:
+    ChannelHandle m_outputHandle;
+    std::vector<std::unique_ptr<EngineEffectChain>> m_chains;
+    std::vector<std::unique_ptr<EngineEffect>> m_effects;
+    std::unique_ptr<EffectsMessenger> m_pMessenger;
+    std::unique_ptr<EngineEffectsManager> m_pEngineEffectsManager;
+};
+
+class EngineEffectsManagerTest : public MixxxTest {
+  protected:
+    EngineEffectsManagerTest()
+            : m_pBackendManager(EffectsBackendManagerPointer::create()) {
+        m_workerPool.setMaxThreadCount(kNumChannels - 1);
+    }
+
+    /// Processes the same signal with both setups, serially and in parallel,
+    /// and expects that the mixed outputs are identical.
+    void processAndCompare(EffectsSetup* pSerial, EffectsSetup* pParallel, bool inPlace) {
+        std::vector<mixxx::SampleBuffer> serialBuffers;
+        std::vector<mixxx::SampleBuffer> parallelBuffers;
+        QVarLengthArray<EngineEffectsManager::PostFaderChannel, kNumChannels> serialChannels;
+        QVarLengthArray<EngineEffectsManager::PostFaderChannel, kNumChannels> parallelChannels;
+        for (int i = 0; i < kNumChannels; ++i) {
+            serialBuffers.emplace_back(kNumSamples);
+            parallelBuffers.emplace_back(kNumSamples);
+        }
+        mixxx::SampleBuffer serialOutput(kNumSamples);
+        mixxx::SampleBuffer parallelOutput(kNumSamples);
+
+        for (int callback = 0; callback < 16; ++callback) {
+            serialChannels.clear();
+            parallelChannels.clear();
+            for (int i = 0; i < kNumChannels; ++i) {
+                for (std::size_t j = 0; j < kNumSamples; ++j) {
+                    const auto sample = static_cast<CSAMPLE>(
+                            std::sin((callback * kNumSamples + j) * 0.01 * (i + 1)));
+                    serialBuffers[i].data()[j] = sample;
+                    parallelBuffers[i].data()[j] = sample;
+                }
+                // Ramp the gain of the first callback like a fader
+                const CSAMPLE_GAIN oldGain = callback == 0 ? 0.0f : 0.8f;
+                const ChannelHandle inputHandle =
+                        m_channelHandleFactory.handleForGroup(
+                                QStringLiteral("[Channel%1]").arg(i + 1));
+                serialChannels.append({inputHandle,
+                        serialBuffers[i].data(),
+                        &m_featureState,
+                        oldGain,
+                        0.8f,
+                        false});
+                parallelChannels.append({inputHandle,
+                        parallelBuffers[i].data(),
+                        &m_featureState,
+                        oldGain,
+                        0.8f,
+                        false});
+            }
+
+            pSerial->engineEffectsManager()->onCallbackStart();
+            serialOutput.clear();
+            for (const auto& channel : std::as_const(serialChannels)) {
+                if (inPlace) {
+                    pSerial->engineEffectsManager()->processPostFaderInPlace(
+                            channel.inputHandle,
+                            pSerial->outputHandle(),
+                            channel.pBuffer,
+                            kNumSamples,
+                            kSampleRate,
+                            *channel.pGroupFeatures,
+                            channel.oldGain,
+                            channel.newGain,
+                            channel.fadeout);
+                    SampleUtil::add(serialOutput.data(), channel.pBuffer, kNumSamples);
+                } else {
+                    pSerial->engineEffectsManager()->processPostFaderAndMix(
+                            channel.inputHandle,
+                            pSerial->outputHandle(),
+                            channel.pBuffer,
+                            serialOutput.data(),
+                            kNumSamples,
+                            kSampleRate,
+                            *channel.pGroupFeatures,
+                            channel.oldGain,
+                            channel.newGain,
+                            channel.fadeout);
+                }
+            }
+
+            pParallel->engineEffectsManager()->onCallbackStart();
+            parallelOutput.clear();
+            ASSERT_TRUE(pParallel->engineEffectsManager()->processPostFaderAndMixInParallel(
+                    parallelChannels,
+                    pParallel->outputHandle(),
+                    parallelOutput.data(),
+                    kNumSamples,
+                    kSampleRate,
+                    inPlace));
+
+            ASSERT_EQ(0,
+                    std::memcmp(serialOutput.data(),
+                            parallelOutput.data(),
+                            kNumSamples * sizeof(CSAMPLE)))
+                    << "callback " << callback;
+        }
+    }
+
+    EffectsBackendManagerPointer m_pBackendManager;
+    ChannelHandleFactory m_channelHandleFactory;
+    QThreadPool m_workerPool;
+    const GroupFeatureState m_featureState;
+};
+
+TEST_F(EngineEffectsManagerTest, parallelIsBitIdenticalToSerial) {
+    for (const bool inPlace : {false, true}) {
+        EffectsSetup serial(m_pBackendManager, &m_channelHandleFactory);
+        EffectsSetup parallel(m_pBackendManager, &m_channelHandleFactory);
+        parallel.engineEffectsManager()->setWorkerPool(&m_workerPool);
+        parallel.engineEffectsManager()->reserveParallelChannels(kNumChannels);
+        processAndCompare(&serial, &parallel, inPlace);
+    }
+}
+
+TEST_F(EngineEffectsManagerTest, parallelRequiresWorkerPool) {
+    EffectsSetup setup(m_pBackendManager, &m_channelHandleFactory);
+    mixxx::SampleBuffer output(kNumSamples);
+    EXPECT_FALSE(setup.engineEffectsManager()->processPostFaderAndMixInParallel(
+            {}, setup.outputHandle(), output.data(), kNumSamples, kSampleRate, true));
+}
+
+} // namespace
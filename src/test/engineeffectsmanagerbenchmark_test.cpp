@@ -0,0 +1,176 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "effects/backends/builtin/bitcrushereffect.h"
+#include "effects/backends/builtin/filtereffect.h"
+#include "effects/backends/builtin/phasereffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "effects/effectsmessenger.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectsmanager.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "util/messagepipe.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kNumEffectUnits = 4;
+constexpr int kNumChannels = 8;
+constexpr std::size_t kNumSamples = 1024;
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+
+/// Four standard effect units with three effects each that are assigned
+/// to eight decks, of which only the first numEnabledUnits are enabled.
+/// The requests are sent through the EffectsMessenger like EffectsManager
+/// does.
+class EffectUnits {
+  public:
+    explicit EffectUnits(int numEnabledUnits)
+            : m_pBackendManager(EffectsBackendManagerPointer::create()) {
+        auto [requestPipe, responsePipe] =
+                makeTwoWayMessagePipe<EffectsRequest*, EffectsResponse>(2048, 2048);
+        m_pMessenger = std::make_unique<EffectsMessenger>(std::move(requestPipe));
+        m_pEngineEffectsManager = std::make_unique<EngineEffectsManager>(
+                std::move(responsePipe));
+
+        QSet<ChannelHandleAndGroup> inputChannels;
+        for (int i = 0; i < kNumChannels; ++i) {
+            const QString group = QStringLiteral("[Channel%1]").arg(i + 1);
+            const ChannelHandle handle = m_channelHandleFactory.getOrCreateHandle(group);
+            inputChannels.insert(ChannelHandleAndGroup(handle, group));
+            m_inputHandles.push_back(handle);
+        }
+        const QString outputGroup = QStringLiteral("[Master]");
+        m_outputHandle = m_channelHandleFactory.getOrCreateHandle(outputGroup);
+        const QSet<ChannelHandleAndGroup> outputChannels = {
+                ChannelHandleAndGroup(m_outputHandle, outputGroup)};
+
+        const QStringList effectIds = {
+                FilterEffect::getId(),
+                BitCrusherEffect::getId(),
+                PhaserEffect::getId(),
+        };
+        for (int unit = 0; unit < kNumEffectUnits; ++unit) {
+            auto pChain = std::make_unique<EngineEffectChain>(
+                    QStringLiteral("[EffectRack1_EffectUnit%1]").arg(unit + 1),
+                    inputChannels,
+                    outputChannels);
+
+            auto* pRequest = new EffectsRequest();
+            pRequest->type = EffectsRequest::ADD_EFFECT_CHAIN;
+            pRequest->AddEffectChain.pChain = pChain.get();
+            pRequest->AddEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+            m_pMessenger->writeRequest(pRequest);
+
+            for (int i = 0; i < effectIds.size(); ++i) {
+                auto pEffect = std::make_unique<EngineEffect>(
+                        m_pBackendManager->getManifest(
+                                effectIds[i], EffectBackendType::BuiltIn),
+                        m_pBackendManager,
+                        inputChannels,
+                        inputChannels,
+                        outputChannels);
+
+                pRequest = new EffectsRequest();
+                pRequest->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+                pRequest->pTargetChain = pChain.get();
+                pRequest->AddEffectToChain.pEffect = pEffect.get();
+                pRequest->AddEffectToChain.iIndex = i;
+                m_pMessenger->writeRequest(pRequest);
+
+                pRequest = new EffectsRequest();
+                pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
+                pRequest->pTargetEffect = pEffect.get();
+                pRequest->SetEffectParameters.enabled = true;
+                m_pMessenger->writeRequest(pRequest);
+
+                m_effects.push_back(std::move(pEffect));
+            }
+
+            pRequest = new EffectsRequest();
+            pRequest->type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+            pRequest->pTargetChain = pChain.get();
+            pRequest->SetEffectChainParameters.enabled = unit < numEnabledUnits;
+            pRequest->SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+            pRequest->SetEffectChainParameters.mix = 1.0;
+            m_pMessenger->writeRequest(pRequest);
+
+            for (const auto& inputHandle : m_inputHandles) {
+                pRequest = new EffectsRequest();
+                pRequest->type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+                pRequest->pTargetChain = pChain.get();
+                pRequest->EnableInputChannelForChain.channelHandle = inputHandle;
+                m_pMessenger->writeRequest(pRequest);
+            }
+
+            m_chains.push_back(std::move(pChain));
+        }
+
+        // Process all requests and collect the responses
+        m_pEngineEffectsManager->onCallbackStart();
+        m_pMessenger->processEffectsResponses();
+        m_pEngineEffectsManager->onCallbackStart();
+        m_pMessenger->processEffectsResponses();
+    }
+
+    ~EffectUnits() {
+        m_pMessenger->initiateShutdown();
+        m_pEngineEffectsManager.reset();
+        m_pMessenger.reset();
+    }
+
+    EngineEffectsManager* engineEffectsManager() const {
+        return m_pEngineEffectsManager.get();
+    }
+
+    const std::vector<ChannelHandle>& inputHandles() const {
+        return m_inputHandles;
+    }
+
+    ChannelHandle outputHandle() const {
+        return m_outputHandle;
+    }
+
+  private:
+    EffectsBackendManagerPointer m_pBackendManager;
+    ChannelHandleFactory m_channelHandleFactory;
+    std::vector<ChannelHandle> m_inputHandles;
+    ChannelHandle m_outputHandle;
+    std::vector<std::unique_ptr<EngineEffectChain>> m_chains;
+    std::vector<std::unique_ptr<EngineEffect>> m_effects;
+    std::unique_ptr<EffectsMessenger> m_pMessenger;
+    std::unique_ptr<EngineEffectsManager> m_pEngineEffectsManager;
+};
+
+/// Processes the postfader effects of all channels like EngineMixer does
+/// in every callback. The argument is the number of enabled effect units.
+static void BM_EngineEffectsManagerPostFader(benchmark::State& state) {
+    EffectUnits effectUnits(static_cast<int>(state.range(0)));
+    EngineEffectsManager* pEngineEffectsManager = effectUnits.engineEffectsManager();
+    mixxx::SampleBuffer buffer(kNumSamples);
+    buffer.fill(0.5f);
+    const GroupFeatureState featureState;
+
+    for (auto _ : state) {
+        pEngineEffectsManager->onCallbackStart();
+        for (const auto& inputHandle : effectUnits.inputHandles()) {
+            pEngineEffectsManager->processPostFaderInPlace(inputHandle,
+                    effectUnits.outputHandle(),
+                    buffer.data(),
+                    kNumSamples,
+                    kSampleRate,
+                    featureState);
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["channels/s"] = benchmark::Counter(
+            static_cast<double>(kNumChannels),
+            benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_EngineEffectsManagerPostFader)->Arg(0)->Arg(1)->Arg(kNumEffectUnits);
+
+} // namespace
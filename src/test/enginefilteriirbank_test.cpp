@@ -0,0 +1,77 @@
+#include "engine/filters/enginefilteriirbank.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr std::size_t kBufferSize = 1024;
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+class EngineFilterIIRBankTest : public testing::Test {
+  protected:
+    EngineFilterIIRBankTest()
+            : m_input(kBufferSize) {
+        for (std::size_t i = 0; i < kBufferSize; ++i) {
+            m_input.data()[i] = static_cast<CSAMPLE>(
+                    std::sin(i * 0.05) + 0.5 * std::sin(i * 0.7 + (i % 2)));
+        }
+    }
+
+    void expectEqual(const mixxx::SampleBuffer& expected, const mixxx::SampleBuffer& actual) {
+        for (std::size_t i = 0; i < kBufferSize; ++i) {
+            EXPECT_NEAR(expected.data()[i], actual.data()[i], 1e-6) << "sample " << i;
+        }
+    }
+
+    mixxx::SampleBuffer m_input;
+};
+
+TEST_F(EngineFilterIIRBankTest, matchesSerialFilters) {
+    EngineFilterBessel8Low serialLow1(kSampleRate, 246);
+    EngineFilterBessel8Low serialLow2(kSampleRate, 2484);
+    EngineFilterBessel8Low bankLow1(kSampleRate, 246);
+    EngineFilterBessel8Low bankLow2(kSampleRate, 2484);
+    // The first buffer ramps in and is processed by each filter on its own
+    for (int pass = 0; pass < 3; ++pass) {
+        mixxx::SampleBuffer serialOut1(kBufferSize);
+        mixxx::SampleBuffer serialOut2(kBufferSize);
+        serialLow1.process(m_input.data(), serialOut1.data(), kBufferSize);
+        serialLow2.process(m_input.data(), serialOut2.data(), kBufferSize);
+
+        mixxx::SampleBuffer bankOut1(kBufferSize);
+        mixxx::SampleBuffer bankOut2(kBufferSize);
+        EngineFilterIIRBank<8, IIR_LP, 2>::process(
+                {&bankLow1, &bankLow2},
+                {m_input.data(), m_input.data()},
+                {bankOut1.data(), bankOut2.data()},
+                kBufferSize);
+
+        expectEqual(serialOut1, bankOut1);
+        expectEqual(serialOut2, bankOut2);
+    }
+}
+
+TEST_F(EngineFilterIIRBankTest, processesInPlace) {
+    EngineFilterBessel4High serialHigh(kSampleRate, 2484);
+    EngineFilterBessel4High bankHigh(kSampleRate, 2484);
+    serialHigh.assumeSettled();
+    bankHigh.assumeSettled();
+
+    mixxx::SampleBuffer serialOut(kBufferSize);
+    serialHigh.process(m_input.data(), serialOut.data(), kBufferSize);
+
+    mixxx::SampleBuffer bankOut(kBufferSize);
+    SampleUtil::copy(bankOut.data(), m_input.data(), kBufferSize);
+    EngineFilterIIRBank<4, IIR_HP, 1>::process(
+            {&bankHigh}, {bankOut.data()}, {bankOut.data()}, kBufferSize);
+
+    expectEqual(serialOut, bankOut);
+}
+
+} // namespace
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilteriirbank.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+mixxx::SampleBuffer createInput(std::size_t bufferSize) {
+    mixxx::SampleBuffer input(bufferSize);
+    for (std::size_t i = 0; i < bufferSize; ++i) {
+        input.data()[i] = static_cast<CSAMPLE>(std::sin(i * 0.05));
+    }
+    return input;
+}
+
+/// The two low passes of the Bessel8 LV-Mix EQ, one after the other
+static void BM_LVMixLowPassesSerial(benchmark::State& state) {
+    const auto bufferSize = static_cast<std::size_t>(state.range(0));
+    const auto input = createInput(bufferSize);
+    mixxx::SampleBuffer low(bufferSize);
+    mixxx::SampleBuffer band(bufferSize);
+    EngineFilterBessel8Low low1(kSampleRate, 246);
+    EngineFilterBessel8Low low2(kSampleRate, 2484);
+    low1.assumeSettled();
+    low2.assumeSettled();
+    for (auto _ : state) {
+        low1.process(input.data(), low.data(), bufferSize);
+        low2.process(input.data(), band.data(), bufferSize);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_LVMixLowPassesSerial)->Range(64, 4096);
+
+/// The two low passes of the Bessel8 LV-Mix EQ in parallel lanes
+static void BM_LVMixLowPassesBank(benchmark::State& state) {
+    const auto bufferSize = static_cast<std::size_t>(state.range(0));
+    const auto input = createInput(bufferSize);
+    mixxx::SampleBuffer low(bufferSize);
+    mixxx::SampleBuffer band(bufferSize);
+    EngineFilterBessel8Low low1(kSampleRate, 246);
+    EngineFilterBessel8Low low2(kSampleRate, 2484);
+    low1.assumeSettled();
+    low2.assumeSettled();
+    for (auto _ : state) {
+        EngineFilterIIRBank<8, IIR_LP, 2>::process(
+                {&low1, &low2},
+                {input.data(), input.data()},
+                {low.data(), band.data()},
+                bufferSize);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_LVMixLowPassesBank)->Range(64, 4096);
+
+/// The band split of AnalyzerWaveform, one filter after the other
+static void BM_WaveformBandsSerial(benchmark::State& state) {
+    const auto bufferSize = static_cast<std::size_t>(state.range(0));
+    const auto input = createInput(bufferSize);
+    mixxx::SampleBuffer low(bufferSize);
+    mixxx::SampleBuffer mid(bufferSize);
+    mixxx::SampleBuffer high(bufferSize);
+    EngineFilterBessel4Low lowFilter(kSampleRate, 600);
+    EngineFilterBessel4Band midFilter(kSampleRate, 600, 4000);
+    EngineFilterBessel4High highFilter(kSampleRate, 4000);
+    lowFilter.assumeSettled();
+    midFilter.assumeSettled();
+    highFilter.assumeSettled();
+    for (auto _ : state) {
+        lowFilter.process(input.data(), low.data(), bufferSize);
+        midFilter.process(input.data(), mid.data(), bufferSize);
+        highFilter.process(input.data(), high.data(), bufferSize);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_WaveformBandsSerial)->Range(64, 4096);
+
+/// The band split of AnalyzerWaveform with both channels in parallel lanes
+static void BM_WaveformBandsBank(benchmark::State& state) {
+    const auto bufferSize = static_cast<std::size_t>(state.range(0));
+    const auto input = createInput(bufferSize);
+    mixxx::SampleBuffer low(bufferSize);
+    mixxx::SampleBuffer mid(bufferSize);
+    mixxx::SampleBuffer high(bufferSize);
+    EngineFilterBessel4Low lowFilter(kSampleRate, 600);
+    EngineFilterBessel4Band midFilter(kSampleRate, 600, 4000);
+    EngineFilterBessel4High highFilter(kSampleRate, 4000);
+    lowFilter.assumeSettled();
+    midFilter.assumeSettled();
+    highFilter.assumeSettled();
+    for (auto _ : state) {
+        EngineFilterIIRBank<4, IIR_LP, 1>::process(
+                {&lowFilter}, {input.data()}, {low.data()}, bufferSize);
+        EngineFilterIIRBank<8, IIR_BP, 1>::process(
+                {&midFilter}, {input.data()}, {mid.data()}, bufferSize);
+        EngineFilterIIRBank<4, IIR_HP, 1>::process(
+                {&highFilter}, {input.data()}, {high.data()}, bufferSize);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_WaveformBandsBank)->Range(64, 4096);
+
+} // namespace
@@ -0,0 +1,93 @@
+#include "controllers/rendering/framedamagetracker.h"
+
+#include <gtest/gtest.h>
+
+#include <QPainter>
+
+namespace {
+
+QImage createFrame(QImage::Format format = QImage::Format_RGB16) {
+    QImage frame(QSize(480, 272), format);
+    frame.fill(Qt::black);
+    return frame;
+}
+
+void fillRect(QImage* pFrame, const QRect& rect, const QColor& color) {
+    QPainter painter(pFrame);
+    painter.fillRect(rect, color);
+}
+
+TEST(FrameDamageTrackerTest, firstFrameIsDamagedEntirely) {
+    FrameDamageTracker tracker;
+    const QImage frame = createFrame();
+    EXPECT_EQ(QList<QRect>{frame.rect()}, tracker.update(frame));
+}
+
+TEST(FrameDamageTrackerTest, unchangedFrameIsNotDamaged) {
+    FrameDamageTracker tracker;
+    tracker.update(createFrame());
+    // An identical frame with its own pixel data
+    EXPECT_TRUE(tracker.update(createFrame()).isEmpty());
+}
+
+TEST(FrameDamageTrackerTest, otherSizeOrFormatIsDamagedEntirely) {
+    FrameDamageTracker tracker;
+    tracker.update(createFrame());
+    const QImage otherFormat = createFrame(QImage::Format_RGBA8888);
+    EXPECT_EQ(QList<QRect>{otherFormat.rect()}, tracker.update(otherFormat));
+    const QImage otherSize = otherFormat.copy(0, 0, 100, 100);
+    EXPECT_EQ(QList<QRect>{otherSize.rect()}, tracker.update(otherSize));
+}
+
+TEST(FrameDamageTrackerTest, changedPixelDamagesItsTile) {
+    FrameDamageTracker tracker(16);
+    QImage frame = createFrame();
+    tracker.update(frame);
+    frame.setPixelColor(20, 40, Qt::white);
+    EXPECT_EQ(QList<QRect>{QRect(16, 32, 16, 16)}, tracker.update(frame));
+    // The damage is relative to the previous frame
+    EXPECT_TRUE(tracker.update(frame).isEmpty());
+}
+
+TEST(FrameDamageTrackerTest, adjacentTilesAreMerged) {
+    FrameDamageTracker tracker(16);
+    QImage frame = createFrame();
+    tracker.update(frame);
+    // Covers the tiles 1 and 2 of the rows 1 and 2
+    fillRect(&frame, QRect(20, 20, 28, 20), Qt::white);
+    EXPECT_EQ(QList<QRect>{QRect(16, 16, 32, 32)}, tracker.update(frame));
+}
+
+TEST(FrameDamageTrackerTest, separateRegionsAreReportedSeparately) {
+    FrameDamageTracker tracker(16);
+    QImage frame = createFrame();
+    tracker.update(frame);
+    fillRect(&frame, QRect(0, 0, 4, 4), Qt::white);
+    fillRect(&frame, QRect(100, 0, 4, 4), Qt::white);
+    fillRect(&frame, QRect(0, 100, 4, 4), Qt::white);
+    const QList<QRect> damage = tracker.update(frame);
+    EXPECT_EQ(3, damage.size());
+    EXPECT_TRUE(damage.contains(QRect(0, 0, 16, 16)));
+    EXPECT_TRUE(damage.contains(QRect(96, 0, 16, 16)));
+    EXPECT_TRUE(damage.contains(QRect(0, 96, 16, 16)));
+}
+
+TEST(FrameDamageTrackerTest, damageIsClippedToTheFrame) {
+    FrameDamageTracker tracker(16);
+    // Neither the width nor the height are multiples of the tile size
+    QImage frame(QSize(100, 50), QImage::Format_RGB16);
+    frame.fill(Qt::black);
+    tracker.update(frame);
+    frame.setPixelColor(99, 49, Qt::white);
+    EXPECT_EQ(QList<QRect>{QRect(96, 48, 4, 2)}, tracker.update(frame));
+}
+
+TEST(FrameDamageTrackerTest, resetDamagesNextFrameEntirely) {
+    FrameDamageTracker tracker;
+    const QImage frame = createFrame();
+    tracker.update(frame);
+    tracker.reset();
+    EXPECT_EQ(QList<QRect>{frame.rect()}, tracker.update(frame));
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <QByteArray>
+#include <QPainter>
+#include <QVector>
+
+#include "controllers/rendering/framedamagetracker.h"
+
+namespace {
+
+// A mock device with the screen of a typical DJ controller
+const QSize kScreenSize(480, 272);
+constexpr auto kPixelFormat = QImage::Format_RGB16;
+constexpr int kTargetFps = 30;
+// The size of the header that precedes each region in a partial update
+constexpr int kRegionHeaderSize = 8;
+
+/// One second of a deck screen with a static background, a playhead that
+/// moves across the waveform overview and a time display that changes twice
+/// per second.
+QVector<QImage> createFrames() {
+    QVector<QImage> frames;
+    for (int i = 0; i < kTargetFps; ++i) {
+        QImage frame(kScreenSize, kPixelFormat);
+        frame.fill(Qt::darkGray);
+        QPainter painter(&frame);
+        painter.fillRect(QRect(10, 200, 460, 60), Qt::blue);
+        painter.fillRect(QRect(10 + i * 15, 200, 2, 60), Qt::white);
+        if (i % (kTargetFps / 2) == 0) {
+            painter.fillRect(QRect(360, 10, 110, 30), Qt::yellow);
+        }
+        frames.append(frame);
+    }
+    return frames;
+}
+
+QByteArray packFullFrame(const QImage& frame) {
+    return QByteArray(reinterpret_cast<const char*>(frame.constBits()),
+            static_cast<int>(frame.sizeInBytes()));
+}
+
+QByteArray packPartialFrame(const QImage& frame, const QList<QRect>& damage) {
+    const int bytesPerPixel = frame.depth() / 8;
+    QByteArray packet;
+    for (const QRect& region : damage) {
+        packet.append(kRegionHeaderSize, '\0');
+        for (int y = region.top(); y <= region.bottom(); ++y) {
+            packet.append(reinterpret_cast<const char*>(frame.constScanLine(y)) +
+                            region.left() * bytesPerPixel,
+                    region.width() * bytesPerPixel);
+        }
+    }
+    return packet;
+}
+
+void setCounters(benchmark::State& state, qint64 bytes, qint64 numFrames) {
+    const double bytesPerFrame = static_cast<double>(bytes) / numFrames;
+    state.counters["bytes_per_frame"] = bytesPerFrame;
+    // The USB bandwidth that the device needs while rendering at the target fps
+    state.counters["device_bytes_per_second"] = bytesPerFrame * kTargetFps;
+    state.SetItemsProcessed(numFrames);
+}
+
+/// Every rendered frame is sent to the device entirely
+static void BM_ControllerScreenFullFrames(benchmark::State& state) {
+    const QVector<QImage> frames = createFrames();
+    qint64 bytes = 0;
+    qint64 numFrames = 0;
+    for (auto _ : state) {
+        const QImage& frame = frames[numFrames % frames.size()];
+        const QByteArray packet = packFullFrame(frame);
+        benchmark::DoNotOptimize(packet.constData());
+        bytes += packet.size();
+        ++numFrames;
+    }
+    setCounters(state, bytes, numFrames);
+}
+BENCHMARK(BM_ControllerScreenFullFrames);
+
+/// Only the regions that have changed since the previous frame are sent
+static void BM_ControllerScreenPartialFrames(benchmark::State& state) {
+    const QVector<QImage> frames = createFrames();
+    FrameDamageTracker tracker(static_cast<int>(state.range(0)));
+    qint64 bytes = 0;
+    qint64 numFrames = 0;
+    for (auto _ : state) {
+        const QImage& frame = frames[numFrames % frames.size()];
+        const QList<QRect> damage = tracker.update(frame);
+        if (!damage.isEmpty()) {
+            const QByteArray packet = packPartialFrame(frame, damage);
+            benchmark::DoNotOptimize(packet.constData());
+            bytes += packet.size();
+        }
+        ++numFrames;
+    }
+    setCounters(state, bytes, numFrames);
+}
+BENCHMARK(BM_ControllerScreenPartialFrames)->RangeMultiplier(2)->Range(8, 64);
+
+} // namespace
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "test/mixxxdbtest.h"
+#include "util/db/fwdsqlquerycache.h"
+
+namespace {
+
+const QString kStatement = QStringLiteral("SELECT :value");
+
+class FwdSqlQueryCacheTest : public MixxxDbTest {
+};
+
+TEST_F(FwdSqlQueryCacheTest, reusePreparedQuery) {
+    const FwdSqlQuery* pCachedQuery;
+    {
+        auto query = FwdSqlQueryCache::prepare(dbConnection(), kStatement);
+        ASSERT_TRUE(query->isPrepared());
+        query->bindValue(QStringLiteral(":value"), QVariant(1));
+        EXPECT_TRUE(query->execPrepared());
+        ASSERT_TRUE(query->next());
+        EXPECT_EQ(1, query->fieldValue(DbFieldIndex(0)).toInt());
+        pCachedQuery = &*query;
+    }
+    {
+        auto query = FwdSqlQueryCache::prepare(dbConnection(), kStatement);
+        EXPECT_EQ(pCachedQuery, &*query);
+        EXPECT_TRUE(query->isPrepared());
+        query->bindValue(QStringLiteral(":value"), QVariant(2));
+        EXPECT_TRUE(query->execPrepared());
+        ASSERT_TRUE(query->next());
+        EXPECT_EQ(2, query->fieldValue(DbFieldIndex(0)).toInt());
+    }
+}
+
+TEST_F(FwdSqlQueryCacheTest, prepareQueryInUse) {
+    auto query = FwdSqlQueryCache::prepare(dbConnection(), kStatement);
+    // A query that is in use must not be shared
+    auto nestedQuery = FwdSqlQueryCache::prepare(dbConnection(), kStatement);
+    EXPECT_NE(&*query, &*nestedQuery);
+    EXPECT_TRUE(nestedQuery->isPrepared());
+
+    query->bindValue(QStringLiteral(":value"), QVariant(1));
+    nestedQuery->bindValue(QStringLiteral(":value"), QVariant(2));
+    EXPECT_TRUE(query->execPrepared());
+    EXPECT_TRUE(nestedQuery->execPrepared());
+    ASSERT_TRUE(query->next());
+    ASSERT_TRUE(nestedQuery->next());
+    EXPECT_EQ(1, query->fieldValue(DbFieldIndex(0)).toInt());
+    EXPECT_EQ(2, nestedQuery->fieldValue(DbFieldIndex(0)).toInt());
+}
+
+} // namespace
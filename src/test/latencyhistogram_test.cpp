@@ -0,0 +1,77 @@
+#include "util/latencyhistogram.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+namespace mixxx {
+
+class LatencyHistogramTest : public testing::Test {
+};
+
+TEST_F(LatencyHistogramTest, bucketBounds) {
+    // Small values are counted exactly
+    for (qint64 nanos = 0; nanos < 64; ++nanos) {
+        EXPECT_EQ(nanos, LatencyHistogram::bucketUpperBound(
+                                 LatencyHistogram::bucketIndex(nanos)));
+    }
+    // Larger values with a relative error of less than 1/32
+    for (qint64 nanos = 64; nanos < (qint64{1} << 34); nanos = nanos * 3 / 2 + 7) {
+        const int index = LatencyHistogram::bucketIndex(nanos);
+        ASSERT_GE(index, 0);
+        ASSERT_LT(index, LatencyHistogram::kNumBuckets);
+        const qint64 upperBound = LatencyHistogram::bucketUpperBound(index);
+        EXPECT_GE(upperBound, nanos);
+        EXPECT_LE(upperBound - nanos, nanos / 32);
+        EXPECT_LT(LatencyHistogram::bucketUpperBound(index - 1), nanos);
+    }
+    // Out of range values are clamped
+    EXPECT_EQ(0, LatencyHistogram::bucketIndex(-1));
+    EXPECT_EQ(LatencyHistogram::kNumBuckets - 1,
+            LatencyHistogram::bucketIndex(std::numeric_limits<qint64>::max()));
+}
+
+TEST_F(LatencyHistogramTest, percentiles) {
+    LatencyHistogram histogram(QStringLiteral("LatencyHistogramTest"));
+    EXPECT_EQ(0, histogram.snapshot().valueAtPercentile(50));
+    for (int i = 1; i <= 100; ++i) {
+        histogram.record(i * 1000);
+    }
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(100u, snapshot.count());
+    EXPECT_NEAR(50000, snapshot.valueAtPercentile(50), 50000 / 32);
+    EXPECT_NEAR(99000, snapshot.valueAtPercentile(99), 99000 / 32);
+    EXPECT_NEAR(100000, snapshot.maxValue(), 100000 / 32);
+    EXPECT_EQ(snapshot.maxValue(), snapshot.valueAtPercentile(100));
+}
+
+TEST_F(LatencyHistogramTest, since) {
+    LatencyHistogram histogram(QStringLiteral("LatencyHistogramTest"));
+    histogram.record(1000000);
+    const auto earlier = histogram.snapshot();
+    histogram.record(10);
+    histogram.record(20);
+    const auto interval = histogram.snapshot().since(earlier);
+    EXPECT_EQ(2u, interval.count());
+    EXPECT_EQ(20, interval.maxValue());
+}
+
+TEST_F(LatencyHistogramTest, forEachInstance) {
+    const auto countInstances = []() {
+        int count = 0;
+        LatencyHistogram::forEachInstance([&count](const LatencyHistogram& histogram) {
+            if (histogram.name() == QStringLiteral("LatencyHistogramTest")) {
+                ++count;
+            }
+        });
+        return count;
+    };
+    EXPECT_EQ(0, countInstances());
+    {
+        LatencyHistogram histogram(QStringLiteral("LatencyHistogramTest"));
+        EXPECT_EQ(1, countInstances());
+    }
+    EXPECT_EQ(0, countInstances());
+}
+
+} // namespace mixxx
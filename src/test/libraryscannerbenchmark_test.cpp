@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QEventLoop>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include "library/dao/directorydao.h"
+#include "library/library_prefs.h"
+#include "library/scanner/libraryscanner.h"
+#include "test/librarytest.h"
+
+namespace {
+
+constexpr int kNumDirectories = 64;
+constexpr int kNumFilesPerDirectory = 16;
+
+/// Provides the database and settings of LibraryTest outside
+/// of a GoogleTest test case.
+class LibraryScannerBenchmark : public LibraryTest {
+  public:
+    LibraryScannerBenchmark() = default;
+
+    void TestBody() override {
+    }
+
+    UserSettingsPointer settings() const {
+        return config();
+    }
+
+    const mixxx::DbConnectionPoolPtr& dbConnectionPool() const {
+        return dbConnectionPooler();
+    }
+};
+
+void populateLibraryDirectory(const QDir& rootDir) {
+    const QString sourceFile = MixxxTest::getOrInitTestDir().filePath(
+            QStringLiteral("id3-test-data/all.mp3"));
+    for (int i = 0; i < kNumDirectories; ++i) {
+        const QString dirName = QStringLiteral("dir%1").arg(i);
+        rootDir.mkdir(dirName);
+        const QDir dir(rootDir.filePath(dirName));
+        for (int j = 0; j < kNumFilesPerDirectory; ++j) {
+            QFile::copy(sourceFile, dir.filePath(QStringLiteral("track%1.mp3").arg(j)));
+        }
+    }
+}
+
+void runScan(LibraryScanner* pScanner) {
+    QEventLoop eventLoop;
+    QObject::connect(pScanner,
+            &LibraryScanner::scanFinished,
+            &eventLoop,
+            &QEventLoop::quit,
+            Qt::QueuedConnection);
+    pScanner->scan();
+    eventLoop.exec();
+}
+
+/// Measures the throughput of the library scanner in files/sec for
+/// an initial import and for a subsequent rescan of the unmodified
+/// directories. The argument is the configured number of threads per
+/// scanner stage, 0 selects the parallel scan mode.
+static void BM_LibraryScannerImport(benchmark::State& state) {
+    LibraryScannerBenchmark fixture;
+    fixture.settings()->setValue(
+            mixxx::library::prefs::kScannerThreadCountConfigKey,
+            static_cast<int>(state.range(0)));
+
+    QTemporaryDir libraryDir;
+    populateLibraryDirectory(QDir(libraryDir.path()));
+    DirectoryDAO directoryDao;
+    directoryDao.initialize(mixxx::DbConnectionPooled(fixture.dbConnectionPool()));
+    directoryDao.addDirectory(mixxx::FileInfo(libraryDir.path()));
+
+    LibraryScanner scanner(fixture.dbConnectionPool(), fixture.settings());
+    scanner.start();
+    for (auto _ : state) {
+        state.PauseTiming();
+        // Force a full import of all files
+        QSqlQuery(mixxx::DbConnectionPooled(fixture.dbConnectionPool()))
+                .exec(QStringLiteral("DELETE FROM LibraryHashes"));
+        QSqlQuery(mixxx::DbConnectionPooled(fixture.dbConnectionPool()))
+                .exec(QStringLiteral("DELETE FROM library"));
+        QSqlQuery(mixxx::DbConnectionPooled(fixture.dbConnectionPool()))
+                .exec(QStringLiteral("DELETE FROM track_locations"));
+        state.ResumeTiming();
+        runScan(&scanner);
+    }
+    state.counters["files/s"] = benchmark::Counter(
+            static_cast<double>(kNumDirectories * kNumFilesPerDirectory),
+            benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_LibraryScannerImport)->Arg(1)->Arg(2)->Arg(4)->Arg(0)->UseRealTime();
+
+static void BM_LibraryScannerRescan(benchmark::State& state) {
+    LibraryScannerBenchmark fixture;
+    fixture.settings()->setValue(
+            mixxx::library::prefs::kScannerThreadCountConfigKey,
+            static_cast<int>(state.range(0)));
+
+    QTemporaryDir libraryDir;
+    populateLibraryDirectory(QDir(libraryDir.path()));
+    DirectoryDAO directoryDao;
+    directoryDao.initialize(mixxx::DbConnectionPooled(fixture.dbConnectionPool()));
+    directoryDao.addDirectory(mixxx::FileInfo(libraryDir.path()));
+
+    LibraryScanner scanner(fixture.dbConnectionPool(), fixture.settings());
+    scanner.start();
+    // Initial import, not measured
+    runScan(&scanner);
+    for (auto _ : state) {
+        runScan(&scanner);
+    }
+    state.counters["files/s"] = benchmark::Counter(
+            static_cast<double>(kNumDirectories * kNumFilesPerDirectory),
+            benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_LibraryScannerRescan)->Arg(1)->Arg(2)->Arg(4)->Arg(0)->UseRealTime();
+
+} // namespace
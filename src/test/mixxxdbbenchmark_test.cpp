@@ -0,0 +1,170 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QTemporaryDir>
+
+#include "database/mixxxdb.h"
+#include "library/coverartcache.h"
+#include "library/dao/trackdao.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+
+namespace {
+
+constexpr int kNumTracks = 256;
+
+void deleteTrack(Track* pTrack) {
+    // Delete track objects directly without a main event loop
+    delete pTrack;
+};
+
+/// Selects the database tuning, 0 = SQLite defaults without
+/// statement caching, 1 = default PerformanceProfile.
+UserSettingsPointer configWithPerformanceProfile(
+        UserSettingsPointer pConfig,
+        bool enabled) {
+    if (!enabled) {
+        pConfig->setValue(MixxxDb::kWriteAheadLogConfigKey, false);
+        pConfig->setValue(MixxxDb::kMmapSizeMBConfigKey, 0);
+        pConfig->setValue(MixxxDb::kCacheSizeMBConfigKey, 0);
+        pConfig->setValue(MixxxDb::kStatementCacheSizeConfigKey, 0);
+    }
+    return pConfig;
+}
+
+std::unique_ptr<TrackCollectionManager> newTrackCollectionManager(
+        UserSettingsPointer userSettings,
+        mixxx::DbConnectionPoolPtr dbConnectionPool) {
+    const auto dbConnection = mixxx::DbConnectionPooled(dbConnectionPool);
+    if (!MixxxDb::initDatabaseSchema(dbConnection)) {
+        return nullptr;
+    }
+    return std::make_unique<TrackCollectionManager>(
+            nullptr,
+            std::move(userSettings),
+            std::move(dbConnectionPool),
+            deleteTrack);
+}
+
+/// Provides a file-based library database outside of a GoogleTest
+/// test case. In contrast to LibraryTest the database is not kept in
+/// memory, otherwise the journal and I/O settings would not matter.
+class MixxxDbBenchmark : public MixxxTest, SoundSourceProviderRegistration {
+  public:
+    explicit MixxxDbBenchmark(bool performanceProfile)
+            : m_mixxxDb(configWithPerformanceProfile(config(), performanceProfile)),
+              m_dbConnectionPooler(m_mixxxDb.connectionPool()),
+              m_pTrackCollectionManager(newTrackCollectionManager(
+                      config(), m_dbConnectionPooler)) {
+        CoverArtCache::createInstance();
+    }
+    ~MixxxDbBenchmark() override {
+        m_pTrackCollectionManager.reset();
+        CoverArtCache::destroy();
+    }
+
+    void TestBody() override {
+    }
+
+    TrackCollectionManager* trackCollectionManager() const {
+        return m_pTrackCollectionManager.get();
+    }
+
+    /// Adds kNumTracks copies of a test file to the library
+    QList<TrackId> addTracks(const QDir& dir) const {
+        const QString sourceFile = getOrInitTestDir().filePath(
+                QStringLiteral("id3-test-data/all.mp3"));
+        QList<TrackId> trackIds;
+        trackIds.reserve(kNumTracks);
+        for (int i = 0; i < kNumTracks; ++i) {
+            const QString filePath = dir.filePath(QStringLiteral("track%1.mp3").arg(i));
+            QFile::copy(sourceFile, filePath);
+            const auto pTrack = m_pTrackCollectionManager->getOrAddTrack(
+                    TrackRef::fromFilePath(filePath));
+            if (pTrack) {
+                pTrack->createAndAddCue(mixxx::CueType::HotCue,
+                        0,
+                        mixxx::audio::FramePos(1000),
+                        mixxx::audio::kInvalidFramePos);
+                trackIds.append(pTrack->getId());
+            }
+        }
+        return trackIds;
+    }
+
+  private:
+    const MixxxDb m_mixxxDb;
+    const mixxx::DbConnectionPooler m_dbConnectionPooler;
+    std::unique_ptr<TrackCollectionManager> m_pTrackCollectionManager;
+};
+
+/// Loads each track including its cues from the database. The track
+/// pointers are released immediately, i.e. every iteration needs to
+/// query the database again.
+static void BM_MixxxDbLoadTrack(benchmark::State& state) {
+    MixxxDbBenchmark fixture(state.range(0) != 0);
+    QTemporaryDir libraryDir;
+    const auto trackIds = fixture.addTracks(QDir(libraryDir.path()));
+    for (auto _ : state) {
+        for (const auto& trackId : trackIds) {
+            benchmark::DoNotOptimize(
+                    fixture.trackCollectionManager()->getTrackById(trackId));
+        }
+    }
+    state.counters["tracks/s"] = benchmark::Counter(
+            static_cast<double>(trackIds.size()),
+            benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_MixxxDbLoadTrack)->Arg(0)->Arg(1);
+
+/// Saves modified tracks including their cues
+static void BM_MixxxDbSaveTrack(benchmark::State& state) {
+    MixxxDbBenchmark fixture(state.range(0) != 0);
+    QTemporaryDir libraryDir;
+    const auto trackIds = fixture.addTracks(QDir(libraryDir.path()));
+    QList<TrackPointer> tracks;
+    for (const auto& trackId : trackIds) {
+        tracks.append(fixture.trackCollectionManager()->getTrackById(trackId));
+    }
+    TrackDAO& trackDao = fixture.trackCollectionManager()->internalCollection()->getTrackDAO();
+    int rating = 0;
+    for (auto _ : state) {
+        rating = (rating + 1) % 6;
+        for (const auto& pTrack : std::as_const(tracks)) {
+            pTrack->setRating(rating);
+            trackDao.saveTrack(pTrack.get());
+        }
+    }
+    state.counters["tracks/s"] = benchmark::Counter(
+            static_cast<double>(tracks.size()),
+            benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_MixxxDbSaveTrack)->Arg(0)->Arg(1);
+
+/// Resolves the ids of tracks by their file locations
+static void BM_MixxxDbSearchLocation(benchmark::State& state) {
+    MixxxDbBenchmark fixture(state.range(0) != 0);
+    QTemporaryDir libraryDir;
+    const auto trackIds = fixture.addTracks(QDir(libraryDir.path()));
+    QList<mixxx::FileInfo> fileInfos;
+    for (int i = 0; i < trackIds.size(); ++i) {
+        fileInfos.append(mixxx::FileInfo(
+                QDir(libraryDir.path()).filePath(QStringLiteral("track%1.mp3").arg(i))));
+    }
+    TrackDAO& trackDao = fixture.trackCollectionManager()->internalCollection()->getTrackDAO();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(trackDao.resolveTrackIds(fileInfos));
+    }
+    state.counters["tracks/s"] = benchmark::Counter(
+            static_cast<double>(fileInfos.size()),
+            benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_MixxxDbSearchLocation)->Arg(0)->Arg(1);
+
+} // namespace
@@ -0,0 +1,102 @@
+#include "util/mpmcqueue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kCapacity = 8;
+
+TEST(MpmcQueueTest, firstInFirstOut) {
+    MpmcQueue<int, kCapacity> queue;
+    int value = 0;
+    EXPECT_FALSE(queue.tryPop(&value));
+
+    // Wraps around multiple times
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < static_cast<int>(kCapacity); ++i) {
+            EXPECT_TRUE(queue.tryPush(round * 100 + i));
+        }
+        for (int i = 0; i < static_cast<int>(kCapacity); ++i) {
+            ASSERT_TRUE(queue.tryPop(&value));
+            EXPECT_EQ(round * 100 + i, value);
+        }
+        EXPECT_FALSE(queue.tryPop(&value));
+    }
+}
+
+TEST(MpmcQueueTest, rejectWhenFull) {
+    MpmcQueue<int, kCapacity> queue;
+    for (int i = 0; i < static_cast<int>(kCapacity); ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(-1));
+
+    int value = 0;
+    ASSERT_TRUE(queue.tryPop(&value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(queue.tryPush(static_cast<int>(kCapacity)));
+    EXPECT_FALSE(queue.tryPush(-1));
+}
+
+TEST(MpmcQueueTest, concurrentProducersAndConsumers) {
+    constexpr int kNumThreads = 4;
+    constexpr int kValuesPerProducer = 20000;
+    MpmcQueue<int, kCapacity> queue;
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kNumThreads; ++producer) {
+        producers.emplace_back([&queue, producer]() {
+            for (int i = 0; i < kValuesPerProducer; ++i) {
+                const int value = producer * kValuesPerProducer + i;
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::atomic<int> numPopped = 0;
+    std::vector<std::vector<int>> poppedValues(kNumThreads);
+    std::vector<std::thread> consumers;
+    for (int consumer = 0; consumer < kNumThreads; ++consumer) {
+        consumers.emplace_back([&queue, &numPopped, &poppedValues, consumer]() {
+            while (numPopped.load() < kNumThreads * kValuesPerProducer) {
+                int value;
+                if (queue.tryPop(&value)) {
+                    poppedValues[consumer].push_back(value);
+                    ++numPopped;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    // Each value is popped exactly once and the values of each producer
+    // are popped in order
+    std::vector<int> count(kNumThreads * kValuesPerProducer, 0);
+    for (const auto& values : poppedValues) {
+        std::vector<int> lastValueOfProducer(kNumThreads, -1);
+        for (const int value : values) {
+            ++count[value];
+            const int producer = value / kValuesPerProducer;
+            EXPECT_LT(lastValueOfProducer[producer], value);
+            lastValueOfProducer[producer] = value;
+        }
+    }
+    for (const int n : count) {
+        EXPECT_EQ(1, n);
+    }
+}
+
+} // namespace
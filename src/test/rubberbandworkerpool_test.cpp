@@ -0,0 +1,121 @@
+#ifdef __RUBBERBAND__
+
+#include "engine/bufferscalers/rubberbandworkerpool.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "engine/bufferscalers/rubberbandtask.h"
+
+namespace {
+
+constexpr size_t kSampleRate = 44100;
+constexpr size_t kNumSamples = 256;
+
+class RubberBandWorkerPoolTest : public testing::Test {
+  protected:
+    RubberBandWorkerPoolTest()
+            : m_samples(kNumSamples, 0.0f),
+              m_input{m_samples.data()} {
+    }
+
+    void TearDown() override {
+        RubberBandWorkerPool::destroy();
+    }
+
+    std::vector<std::unique_ptr<RubberBandTask>> createTasks(int numTasks) {
+        std::vector<std::unique_ptr<RubberBandTask>> tasks;
+        for (int i = 0; i < numTasks; ++i) {
+            tasks.push_back(std::make_unique<RubberBandTask>(
+                    kSampleRate, 1, RubberBandStretcher::OptionProcessRealTime));
+        }
+        return tasks;
+    }
+
+    // Submits all tasks like RubberBandWrapper and runs the tasks that
+    // could not be queued inline. Returns the number of queued tasks.
+    int submitAndWait(RubberBandWorkerPool* pPool,
+            const std::vector<std::unique_ptr<RubberBandTask>>& tasks) {
+        int numSubmitted = 0;
+        for (const auto& pTask : tasks) {
+            pTask->set(m_input, kNumSamples, false, 0);
+            if (pPool->trySubmit(pTask.get())) {
+                ++numSubmitted;
+            } else {
+                pTask->run();
+            }
+        }
+        for (const auto& pTask : tasks) {
+            pTask->waitReady();
+            EXPECT_TRUE(pTask->isCompleted());
+        }
+        return numSubmitted;
+    }
+
+    std::vector<float> m_samples;
+    const float* m_input[1];
+};
+
+TEST_F(RubberBandWorkerPoolTest, runInlineWithoutWorkers) {
+    RubberBandWorkerPool* pPool = RubberBandWorkerPool::createInstance(nullptr, 0);
+    EXPECT_EQ(0, pPool->numWorkers());
+
+    const auto tasks = createTasks(2);
+    EXPECT_EQ(0, submitAndWait(pPool, tasks));
+}
+
+TEST_F(RubberBandWorkerPoolTest, runInlineWhenQueuesAreFull) {
+    RubberBandWorkerPool* pPool = RubberBandWorkerPool::createInstance(nullptr, 1);
+    EXPECT_EQ(1, pPool->numWorkers());
+
+    // Much more tasks than the capacity of the queue. Those that don't
+    // fit are run by the caller, all are completed.
+    const auto tasks = createTasks(200);
+    EXPECT_GT(submitAndWait(pPool, tasks), 0);
+}
+
+TEST_F(RubberBandWorkerPoolTest, concurrentSubmitters) {
+    RubberBandWorkerPool* pPool = RubberBandWorkerPool::createInstance(nullptr, 2);
+
+    // Like the engine thread and the channel workers, that submit and
+    // wait for the tasks of different decks at the same time
+    std::vector<std::thread> submitters;
+    for (int i = 0; i < 3; ++i) {
+        submitters.emplace_back([this, pPool]() {
+            const auto tasks = createTasks(2);
+            for (int j = 0; j < 50; ++j) {
+                submitAndWait(pPool, tasks);
+            }
+        });
+    }
+    for (auto& submitter : submitters) {
+        submitter.join();
+    }
+}
+
+TEST_F(RubberBandWorkerPoolTest, shutdownParkedWorkers) {
+    RubberBandWorkerPool* pPool = RubberBandWorkerPool::createInstance(nullptr, 2);
+    const auto tasks = createTasks(2);
+    submitAndWait(pPool, tasks);
+    // Let the workers park
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    // Must return although the workers are blocked
+    RubberBandWorkerPool::destroy();
+    pPool = RubberBandWorkerPool::createInstance(nullptr, 2);
+    submitAndWait(pPool, tasks);
+}
+
+TEST_F(RubberBandWorkerPoolTest, shutdownSpinningWorkers) {
+    RubberBandWorkerPool* pPool = RubberBandWorkerPool::createInstance(nullptr, 2);
+    const auto tasks = createTasks(2);
+    submitAndWait(pPool, tasks);
+    // Must return although the workers still poll for new tasks
+    RubberBandWorkerPool::destroy();
+    RubberBandWorkerPool::createInstance(nullptr, 2);
+}
+
+} // namespace
+
+#endif // __RUBBERBAND__
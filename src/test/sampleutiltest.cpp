@@ -652,4 +652,126 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+static void BM_ApplyRampingGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::applyRampingGain(buffer, 1.1f, 0.9f, size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_ApplyRampingGain)->Range(64, 4096);
+
+static void BM_CopyWithRampingGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copyWithRampingGain(buffer, buffer2, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_CopyWithRampingGain)->Range(64, 4096);
+
+static void BM_Add3WithGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.1f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.2f, size);
+    CSAMPLE* buffer4 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer4, 0.3f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::add3WithGain(buffer, buffer2, 1.1f, buffer3, 1.2f, buffer4, 1.3f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+    SampleUtil::free(buffer4);
+}
+BENCHMARK(BM_Add3WithGain)->Range(64, 4096);
+
+static void BM_InterleaveBuffer(benchmark::State& state) {
+    SINT numFrames = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(buffer, 0.0f, numFrames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer2, 0.1f, numFrames);
+    CSAMPLE* buffer3 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer3, 0.2f, numFrames);
+
+    while (state.KeepRunning()) {
+        SampleUtil::interleaveBuffer(buffer, buffer2, buffer3, numFrames);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK(BM_InterleaveBuffer)->Range(64, 4096);
+
+static void BM_DeinterleaveBuffer(benchmark::State& state) {
+    SINT numFrames = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(buffer, 0.1f, numFrames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer2, 0.0f, numFrames);
+    CSAMPLE* buffer3 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer3, 0.0f, numFrames);
+
+    while (state.KeepRunning()) {
+        SampleUtil::deinterleaveBuffer(buffer2, buffer3, buffer, numFrames);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK(BM_DeinterleaveBuffer)->Range(64, 4096);
+
+static void BM_MixMultichannelToStereo(benchmark::State& state) {
+    SINT numFrames = static_cast<SINT>(state.range(0));
+    const auto numChannels = mixxx::audio::ChannelCount::stem();
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(buffer, 0.0f, numFrames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames * numChannels);
+    SampleUtil::fill(buffer2, 0.1f, numFrames * numChannels);
+
+    while (state.KeepRunning()) {
+        SampleUtil::mixMultichannelToStereo(buffer, buffer2, numFrames, numChannels);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_MixMultichannelToStereo)->Range(64, 4096);
+
+static void BM_SumAbsPerChannel(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+    CSAMPLE absL = 0;
+    CSAMPLE absR = 0;
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(
+                SampleUtil::sumAbsPerChannel(&absL, &absR, buffer, size));
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_SumAbsPerChannel)->Range(64, 4096);
+
 }  // namespace
@@ -0,0 +1,177 @@
+#include "encoder/sharedencoder.h"
+
+#include <gtest/gtest.h>
+
+#include <QVector>
+#include <vector>
+
+#include "recording/defs_recording.h"
+#include "util/math.h"
+#include "util/time.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+const auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+class TestEncoderSettings : public EncoderSettings {
+  public:
+    TestEncoderSettings(const QString& format, int bitrate)
+            : m_format(format),
+              m_bitrate(bitrate) {
+    }
+
+    int getQuality() const override {
+        return m_bitrate;
+    }
+    ChannelMode getChannelMode() const override {
+        return ChannelMode::STEREO;
+    }
+    QString getFormat() const override {
+        return m_format;
+    }
+
+  private:
+    QString m_format;
+    int m_bitrate;
+};
+
+class TestSubscriber : public SharedEncoder::Subscriber {
+  public:
+    void receivePacket(const QByteArray& packet) override {
+        m_packets.append(packet);
+    }
+
+    QVector<QByteArray> m_packets;
+};
+
+EncoderSettingsPointer mp3Settings(int bitrate) {
+    return std::make_shared<TestEncoderSettings>(ENCODING_MP3, bitrate);
+}
+
+// One second of a stereo sine wave
+std::vector<CSAMPLE> sineWave() {
+    std::vector<CSAMPLE> samples(2 * kSampleRate.value());
+    for (std::size_t i = 0; i < samples.size(); i += 2) {
+        const auto value = static_cast<CSAMPLE>(
+                0.5 * std::sin(2 * M_PI * 440 * (i / 2) / kSampleRate.value()));
+        samples[i] = value;
+        samples[i + 1] = value;
+    }
+    return samples;
+}
+
+class SharedEncoderTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        // The feeder is only replaced after it has fallen behind
+        mixxx::Time::setTestMode(true);
+        mixxx::Time::addTestTime(10ms);
+    }
+
+    void TearDown() override {
+        mixxx::Time::setTestMode(false);
+    }
+};
+
+TEST_F(SharedEncoderTest, isShareable) {
+    EXPECT_TRUE(SharedEncoder::isShareable(TestEncoderSettings(ENCODING_MP3, 128)));
+    EXPECT_TRUE(SharedEncoder::isShareable(TestEncoderSettings(ENCODING_AAC, 128)));
+    EXPECT_FALSE(SharedEncoder::isShareable(TestEncoderSettings(ENCODING_OGG, 128)));
+    EXPECT_FALSE(SharedEncoder::isShareable(TestEncoderSettings(ENCODING_OPUS, 128)));
+}
+
+TEST_F(SharedEncoderTest, shareIdenticalSettings) {
+    SharedEncoderRegistry registry;
+    TestSubscriber subscriber1;
+    TestSubscriber subscriber2;
+    TestSubscriber subscriber3;
+
+    SharedEncoderPointer pEncoder1 = registry.subscribe(
+            mp3Settings(128), kSampleRate, &subscriber1, nullptr);
+    SharedEncoderPointer pEncoder2 = registry.subscribe(
+            mp3Settings(128), kSampleRate, &subscriber2, nullptr);
+    SharedEncoderPointer pEncoder3 = registry.subscribe(
+            mp3Settings(192), kSampleRate, &subscriber3, nullptr);
+    ASSERT_TRUE(pEncoder1);
+    ASSERT_TRUE(pEncoder3);
+    EXPECT_EQ(pEncoder1, pEncoder2);
+    EXPECT_NE(pEncoder1, pEncoder3);
+    EXPECT_EQ(2, pEncoder1->subscriberCount());
+
+    // A new encoder is created after the last one has been released
+    pEncoder3->unsubscribe(&subscriber3);
+    pEncoder3.reset();
+    SharedEncoderPointer pEncoder4 = registry.subscribe(
+            mp3Settings(192), kSampleRate, &subscriber3, nullptr);
+    ASSERT_TRUE(pEncoder4);
+    EXPECT_EQ(1, pEncoder4->subscriberCount());
+
+    pEncoder1->unsubscribe(&subscriber1);
+    pEncoder2->unsubscribe(&subscriber2);
+    pEncoder4->unsubscribe(&subscriber3);
+}
+
+TEST_F(SharedEncoderTest, fanOutPackets) {
+    SharedEncoderRegistry registry;
+    TestSubscriber subscriber1;
+    TestSubscriber subscriber2;
+    SharedEncoderPointer pEncoder = registry.subscribe(
+            mp3Settings(128), kSampleRate, &subscriber1, nullptr);
+    ASSERT_TRUE(pEncoder);
+    registry.subscribe(mp3Settings(128), kSampleRate, &subscriber2, nullptr);
+
+    const std::vector<CSAMPLE> samples = sineWave();
+    // The first subscriber that submits samples feeds the encoder, the
+    // samples of the others are ignored
+    EXPECT_TRUE(pEncoder->encodeBuffer(&subscriber1, samples.data(), samples.size()));
+    EXPECT_FALSE(pEncoder->encodeBuffer(&subscriber2, samples.data(), samples.size()));
+
+    ASSERT_FALSE(subscriber1.m_packets.isEmpty());
+    ASSERT_EQ(subscriber1.m_packets.size(), subscriber2.m_packets.size());
+    for (int i = 0; i < subscriber1.m_packets.size(); ++i) {
+        // Both subscribers share the data of each packet
+        EXPECT_EQ(subscriber1.m_packets[i].constData(),
+                subscriber2.m_packets[i].constData());
+    }
+
+    // Another subscriber takes over when the feeder leaves
+    pEncoder->unsubscribe(&subscriber1);
+    const int numPackets = subscriber1.m_packets.size();
+    EXPECT_TRUE(pEncoder->encodeBuffer(&subscriber2, samples.data(), samples.size()));
+    EXPECT_EQ(numPackets, subscriber1.m_packets.size());
+    EXPECT_LT(numPackets, subscriber2.m_packets.size());
+
+    pEncoder->unsubscribe(&subscriber2);
+}
+
+TEST_F(SharedEncoderTest, replaceFeederThatFellBehind) {
+    SharedEncoderRegistry registry;
+    TestSubscriber subscriber1;
+    TestSubscriber subscriber2;
+    SharedEncoderPointer pEncoder = registry.subscribe(
+            mp3Settings(128), kSampleRate, &subscriber1, nullptr);
+    ASSERT_TRUE(pEncoder);
+    registry.subscribe(mp3Settings(128), kSampleRate, &subscriber2, nullptr);
+
+    const std::vector<CSAMPLE> samples = sineWave();
+    EXPECT_TRUE(pEncoder->encodeBuffer(&subscriber1, samples.data(), samples.size()));
+    mixxx::Time::addTestTime(50ms);
+    EXPECT_FALSE(pEncoder->encodeBuffer(&subscriber2, samples.data(), samples.size()));
+
+    // The thread of the feeder is stuck, e.g. sending to a slow server
+    mixxx::Time::addTestTime(200ms);
+    const int numPackets = subscriber1.m_packets.size();
+    EXPECT_TRUE(pEncoder->encodeBuffer(&subscriber2, samples.data(), samples.size()));
+    // Both still receive the packets
+    EXPECT_LT(numPackets, subscriber1.m_packets.size());
+    EXPECT_EQ(subscriber1.m_packets.size(), subscriber2.m_packets.size());
+    // The samples of the previous feeder are ignored from now on
+    EXPECT_FALSE(pEncoder->encodeBuffer(&subscriber1, samples.data(), samples.size()));
+
+    pEncoder->unsubscribe(&subscriber1);
+    pEncoder->unsubscribe(&subscriber2);
+}
+
+} // namespace
@@ -0,0 +1,88 @@
+#include "skin/legacy/skindocumentcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDomDocument>
+#include <QTemporaryDir>
+
+namespace {
+
+const QByteArray kContent = QByteArrayLiteral(
+        "<!DOCTYPE template>\n"
+        "<Template>\n"
+        "  <!-- Comment -->\n"
+        "  <SetVariable name=\"group\">[Channel1]</SetVariable>\n"
+        "  <WidgetGroup>\n"
+        "    <ObjectName>Deck</ObjectName>\n"
+        "    <Size>100f,20me</Size>\n"
+        "    <Style><![CDATA[#Deck { color: red; }]]></Style>\n"
+        "    <Children>\n"
+        "      <Template src=\"skin:button.xml\" group=\"&lt;Channel1&gt;\"/>\n"
+        "      <PushButton><Connection><ConfigKey>[Channel1],play</ConfigKey>"
+        "</Connection></PushButton>\n"
+        "    </Children>\n"
+        "  </WidgetGroup>\n"
+        "</Template>\n");
+
+QDomElement parse(const QByteArray& content) {
+    QDomDocument document;
+    document.setContent(content);
+    return document.documentElement();
+}
+
+void expectEqualNodes(const QDomNode& expected, const QDomNode& actual) {
+    ASSERT_EQ(expected.nodeType(), actual.nodeType());
+    EXPECT_EQ(expected.nodeName(), actual.nodeName());
+    EXPECT_EQ(expected.nodeValue(), actual.nodeValue());
+    const QDomNamedNodeMap attributes = expected.attributes();
+    EXPECT_EQ(attributes.count(), actual.attributes().count());
+    for (int i = 0; i < attributes.count(); ++i) {
+        const QDomNode attribute = attributes.item(i);
+        EXPECT_EQ(attribute.nodeValue(),
+                actual.toElement().attribute(attribute.nodeName()));
+    }
+    ASSERT_EQ(expected.childNodes().count(), actual.childNodes().count());
+    for (int i = 0; i < expected.childNodes().count(); ++i) {
+        expectEqualNodes(expected.childNodes().at(i), actual.childNodes().at(i));
+    }
+}
+
+TEST(SkinDocumentCacheTest, compileAndDecompile) {
+    const QDomElement element = parse(kContent);
+    ASSERT_FALSE(element.isNull());
+    const QDomElement decompiledElement =
+            SkinDocumentCache::decompile(SkinDocumentCache::compile(element));
+    ASSERT_FALSE(decompiledElement.isNull());
+    expectEqualNodes(element, decompiledElement);
+    EXPECT_EQ(decompiledElement, decompiledElement.ownerDocument().documentElement());
+}
+
+TEST(SkinDocumentCacheTest, decompileInvalidData) {
+    EXPECT_TRUE(SkinDocumentCache::decompile(QByteArray()).isNull());
+    EXPECT_TRUE(SkinDocumentCache::decompile(QByteArrayLiteral("<Template/>")).isNull());
+    const QByteArray data = SkinDocumentCache::compile(parse(kContent));
+    EXPECT_TRUE(SkinDocumentCache::decompile(data.left(data.size() / 2)).isNull());
+}
+
+TEST(SkinDocumentCacheTest, storeAndLoad) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const SkinDocumentCache cache(tempDir.filePath(QStringLiteral("cache")));
+    EXPECT_TRUE(cache.load(kContent).isNull());
+
+    const QDomElement element = parse(kContent);
+    ASSERT_TRUE(cache.store(kContent, element));
+    const QDomElement loadedElement = cache.load(kContent);
+    ASSERT_FALSE(loadedElement.isNull());
+    expectEqualNodes(element, loadedElement);
+
+    // A changed file doesn't match the entry
+    EXPECT_TRUE(cache.load(kContent + '\n').isNull());
+
+    cache.prune(1024 * 1024);
+    EXPECT_FALSE(cache.load(kContent).isNull());
+    cache.prune(0);
+    EXPECT_TRUE(cache.load(kContent).isNull());
+}
+
+} // namespace
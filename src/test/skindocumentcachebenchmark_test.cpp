@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QDomDocument>
+#include <QFile>
+#include <QList>
+#include <QTemporaryDir>
+
+#include "skin/legacy/skindocumentcache.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+/// The skin.xml and template files of the largest shipped skin
+QList<QByteArray> readSkinFiles() {
+    const QString skinPath = MixxxTest::getOrInitTestDir().filePath(
+            QStringLiteral("../../res/skins/LateNight"));
+    QList<QByteArray> contents;
+    QDirIterator it(skinPath,
+            QStringList{QStringLiteral("*.xml")},
+            QDir::Files,
+            QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QFile file(it.next());
+        if (file.open(QIODevice::ReadOnly)) {
+            contents.append(file.readAll());
+        }
+    }
+    return contents;
+}
+
+/// Parses the XML of all files, as on every start without the cache
+static void BM_SkinDocumentsParseXml(benchmark::State& state) {
+    const QList<QByteArray> contents = readSkinFiles();
+    for (auto _ : state) {
+        for (const QByteArray& content : contents) {
+            QDomDocument document;
+            document.setContent(content);
+            benchmark::DoNotOptimize(document.documentElement());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * contents.size());
+}
+BENCHMARK(BM_SkinDocumentsParseXml)->Unit(benchmark::kMillisecond);
+
+/// Loads the compiled documents of all files from the cache, as on every
+/// start after the first one
+static void BM_SkinDocumentsLoadCompiled(benchmark::State& state) {
+    const QList<QByteArray> contents = readSkinFiles();
+    QTemporaryDir tempDir;
+    const SkinDocumentCache cache(tempDir.path());
+    for (const QByteArray& content : contents) {
+        QDomDocument document;
+        document.setContent(content);
+        cache.store(content, document.documentElement());
+    }
+    for (auto _ : state) {
+        for (const QByteArray& content : contents) {
+            benchmark::DoNotOptimize(cache.load(content));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * contents.size());
+}
+BENCHMARK(BM_SkinDocumentsLoadCompiled)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,91 @@
+#include "skin/legacy/skinimagecache.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+class SkinImageCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_fileName = m_tempDir.filePath(QStringLiteral("button.svg"));
+        writeFile(m_fileName, "<svg/>");
+    }
+
+    static void writeFile(const QString& fileName, const QByteArray& content) {
+        QFile file(fileName);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    }
+
+    QString cacheDirectory() const {
+        return m_tempDir.filePath(QStringLiteral("cache"));
+    }
+
+    static QImage createImage() {
+        QImage image(QSize(30, 20), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::red);
+        image.setPixelColor(5, 7, Qt::blue);
+        image.setDevicePixelRatio(2.0);
+        return image;
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_fileName;
+};
+
+TEST_F(SkinImageCacheTest, storeAndLoad) {
+    const SkinImageCache cache(cacheDirectory(), QString());
+    EXPECT_TRUE(cache.load(m_fileName, QStringLiteral("variant")).isNull());
+
+    const QImage image = createImage();
+    ASSERT_TRUE(cache.store(m_fileName, QStringLiteral("variant"), image));
+    const QImage loadedImage = cache.load(m_fileName, QStringLiteral("variant"));
+    EXPECT_EQ(image, loadedImage);
+    EXPECT_EQ(image.devicePixelRatio(), loadedImage.devicePixelRatio());
+
+    // The entries of other variants, color schemes and files are separate
+    EXPECT_TRUE(cache.load(m_fileName, QStringLiteral("other")).isNull());
+    const SkinImageCache otherColorScheme(cacheDirectory(), QStringLiteral("<Invert/>"));
+    EXPECT_TRUE(otherColorScheme.load(m_fileName, QStringLiteral("variant")).isNull());
+    EXPECT_TRUE(cache.load(m_tempDir.filePath(QStringLiteral("missing.svg")),
+                             QStringLiteral("variant"))
+                        .isNull());
+}
+
+TEST_F(SkinImageCacheTest, changedFileIsNotLoaded) {
+    ASSERT_TRUE(SkinImageCache(cacheDirectory(), QString())
+                        .store(m_fileName, QStringLiteral("variant"), createImage()));
+    writeFile(m_fileName, "<svg></svg>");
+    // The hashes of the files are only computed once per instance
+    const SkinImageCache cache(cacheDirectory(), QString());
+    EXPECT_TRUE(cache.load(m_fileName, QStringLiteral("variant")).isNull());
+}
+
+TEST_F(SkinImageCacheTest, storeAndLoadFileList) {
+    const SkinImageCache cache(cacheDirectory(), QString());
+    EXPECT_TRUE(cache.loadFileList(QStringLiteral("skin")).isEmpty());
+    const QStringList fileNames = {QStringLiteral("a.png"), QStringLiteral("b.png")};
+    ASSERT_TRUE(cache.storeFileList(QStringLiteral("skin"), fileNames));
+    EXPECT_EQ(fileNames, cache.loadFileList(QStringLiteral("skin")));
+    EXPECT_TRUE(cache.loadFileList(QStringLiteral("other")).isEmpty());
+}
+
+TEST_F(SkinImageCacheTest, prune) {
+    const SkinImageCache cache(cacheDirectory(), QString());
+    ASSERT_TRUE(cache.store(m_fileName, QStringLiteral("variant1"), createImage()));
+    ASSERT_TRUE(cache.store(m_fileName, QStringLiteral("variant2"), createImage()));
+
+    cache.prune(1024 * 1024);
+    EXPECT_FALSE(cache.load(m_fileName, QStringLiteral("variant1")).isNull());
+    EXPECT_FALSE(cache.load(m_fileName, QStringLiteral("variant2")).isNull());
+
+    cache.prune(0);
+    EXPECT_TRUE(cache.load(m_fileName, QStringLiteral("variant1")).isNull());
+    EXPECT_TRUE(cache.load(m_fileName, QStringLiteral("variant2")).isNull());
+}
+
+} // namespace
@@ -0,0 +1,145 @@
+#ifdef __VINYLCONTROL__
+
+#include "vinylcontrol/timecodelutcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <cstddef>
+
+namespace {
+
+constexpr unsigned int kLength = 1000;
+constexpr unsigned int kNumHashes = 1u << LUT_HASH_BITS;
+// The size of the header that precedes the hash table in the file
+constexpr qint64 kHeaderSize = 48;
+
+qint64 tableEntryOffset(unsigned int hash) {
+    return kHeaderSize + static_cast<qint64>(sizeof(slot_no_t)) * hash;
+}
+
+qint64 nextSlotOffset(unsigned int slotNo) {
+    return kHeaderSize + static_cast<qint64>(sizeof(slot_no_t)) * kNumHashes +
+            static_cast<qint64>(sizeof(struct slot)) * slotNo +
+            offsetof(struct slot, next);
+}
+
+class TimecodeLutCacheTest : public testing::Test {
+  protected:
+    TimecodeLutCacheTest()
+            : m_cache(m_directory.path()),
+              m_def{} {
+        m_def.name = "test_timecode";
+        m_def.bits = 20;
+        m_def.seed = 0x59017;
+        m_def.taps = 0x361e4;
+        m_def.length = kLength;
+        m_def.lookup = true;
+        lut_init(&m_def.lut, kLength);
+        // Only 7 different hashes, so the slots form long chains
+        for (unsigned int i = 0; i < kLength; ++i) {
+            lut_push(&m_def.lut, (i << LUT_HASH_BITS) | (i % 7));
+        }
+    }
+
+    ~TimecodeLutCacheTest() override {
+        lut_clear(&m_def.lut);
+    }
+
+    timecode_def loadedDef() const {
+        timecode_def def = m_def;
+        def.lookup = false;
+        def.lut = {};
+        return def;
+    }
+
+    void overwrite(qint64 offset, quint32 value) {
+        QFile file(m_directory.filePath(QStringLiteral("test_timecode.lut")));
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        ASSERT_TRUE(file.seek(offset));
+        ASSERT_EQ(static_cast<qint64>(sizeof(value)),
+                file.write(reinterpret_cast<const char*>(&value), sizeof(value)));
+    }
+
+    QTemporaryDir m_directory;
+    TimecodeLutCache m_cache;
+    timecode_def m_def;
+};
+
+TEST_F(TimecodeLutCacheTest, storeAndLoad) {
+    timecode_def def = loadedDef();
+    EXPECT_FALSE(m_cache.load(&def));
+
+    ASSERT_TRUE(m_cache.store(m_def));
+    ASSERT_TRUE(m_cache.load(&def));
+    EXPECT_TRUE(def.lookup);
+    EXPECT_TRUE(def.external_lookup);
+    for (unsigned int i = 0; i < kLength; ++i) {
+        const unsigned int timecode = (i << LUT_HASH_BITS) | (i % 7);
+        EXPECT_EQ(i, lut_lookup(&def.lut, timecode));
+    }
+    EXPECT_EQ(LUT_NO_SLOT, lut_lookup(&def.lut, kLength << LUT_HASH_BITS));
+}
+
+TEST_F(TimecodeLutCacheTest, rejectOtherTimecode) {
+    ASSERT_TRUE(m_cache.store(m_def));
+    timecode_def def = loadedDef();
+    def.seed = 0x5b1a2;
+    EXPECT_FALSE(m_cache.load(&def));
+}
+
+TEST_F(TimecodeLutCacheTest, rejectWrongHeader) {
+    ASSERT_TRUE(m_cache.store(m_def));
+    // The version follows the magic
+    overwrite(8, 0);
+    timecode_def def = loadedDef();
+    EXPECT_FALSE(m_cache.load(&def));
+}
+
+TEST_F(TimecodeLutCacheTest, rejectWrongSize) {
+    ASSERT_TRUE(m_cache.store(m_def));
+    QFile file(m_directory.filePath(QStringLiteral("test_timecode.lut")));
+    ASSERT_TRUE(file.resize(file.size() - 1));
+    timecode_def def = loadedDef();
+    EXPECT_FALSE(m_cache.load(&def));
+}
+
+TEST_F(TimecodeLutCacheTest, rejectOutOfRangeSlot) {
+    ASSERT_TRUE(m_cache.store(m_def));
+    overwrite(tableEntryOffset(0), kLength);
+    timecode_def def = loadedDef();
+    EXPECT_FALSE(m_cache.load(&def));
+
+    ASSERT_TRUE(m_cache.store(m_def));
+    overwrite(nextSlotOffset(kLength - 1), kLength);
+    EXPECT_FALSE(m_cache.load(&def));
+}
+
+TEST_F(TimecodeLutCacheTest, rejectSlotWithOtherHash) {
+    ASSERT_TRUE(m_cache.store(m_def));
+    // Slot 1 has hash 1
+    overwrite(tableEntryOffset(0), 1);
+    timecode_def def = loadedDef();
+    EXPECT_FALSE(m_cache.load(&def));
+
+    ASSERT_TRUE(m_cache.store(m_def));
+    // Slot 7 must be followed by slot 0 with the same hash, not by slot 1
+    overwrite(nextSlotOffset(7), 1);
+    EXPECT_FALSE(m_cache.load(&def));
+}
+
+TEST_F(TimecodeLutCacheTest, rejectCyclicChain) {
+    ASSERT_TRUE(m_cache.store(m_def));
+    overwrite(nextSlotOffset(7), 7);
+    timecode_def def = loadedDef();
+    EXPECT_FALSE(m_cache.load(&def));
+
+    // Slot 0 is followed by slot 7, which is followed by slot 0 again
+    ASSERT_TRUE(m_cache.store(m_def));
+    overwrite(nextSlotOffset(0), 7);
+    EXPECT_FALSE(m_cache.load(&def));
+}
+
+} // namespace
+
+#endif // __VINYLCONTROL__
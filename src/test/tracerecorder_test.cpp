@@ -0,0 +1,168 @@
+#include "util/tracerecorder.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <atomic>
+#include <optional>
+#include <thread>
+
+namespace {
+
+class TraceRecorderTest : public testing::Test {
+  protected:
+    QJsonArray readTraceEvents(const QString& filePath) {
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::ReadOnly));
+        QJsonParseError error;
+        const auto doc = QJsonDocument::fromJson(file.readAll(), &error);
+        EXPECT_EQ(QJsonParseError::NoError, error.error);
+        return doc.object().value(QStringLiteral("traceEvents")).toArray();
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(TraceRecorderTest, disabled) {
+    EXPECT_FALSE(mixxx::TraceRecorder::isEnabled());
+    // Must not crash or record anything
+    mixxx::ScopedTraceEvent traceEvent("disabled");
+    mixxx::TraceRecorder::recordInstant("disabled");
+    mixxx::TraceRecorder::requestSnapshot();
+}
+
+TEST_F(TraceRecorderTest, recordEventsPerThread) {
+    const QString filePath = m_tempDir.filePath(QStringLiteral("trace.json"));
+    mixxx::TraceRecorder::enable(filePath);
+    {
+        mixxx::ScopedTraceEvent traceEvent("main");
+        mixxx::TraceRecorder::recordInstant("instant");
+    }
+    std::thread([] {
+        mixxx::ScopedTraceEvent traceEvent("worker");
+    }).join();
+    mixxx::TraceRecorder::disable();
+    EXPECT_FALSE(mixxx::TraceRecorder::isEnabled());
+
+    const QJsonArray events = readTraceEvents(filePath);
+    QSet<int> threadIds;
+    int numComplete = 0;
+    int numInstant = 0;
+    for (const auto& value : events) {
+        const QJsonObject event = value.toObject();
+        const QString phase = event.value(QStringLiteral("ph")).toString();
+        if (phase == QStringLiteral("M")) {
+            threadIds.insert(event.value(QStringLiteral("tid")).toInt());
+        } else if (phase == QStringLiteral("X")) {
+            ++numComplete;
+            EXPECT_GE(event.value(QStringLiteral("dur")).toDouble(), 0.0);
+        } else if (phase == QStringLiteral("i")) {
+            ++numInstant;
+            EXPECT_EQ(QStringLiteral("instant"), event.value(QStringLiteral("name")).toString());
+        }
+    }
+    EXPECT_EQ(2, threadIds.size());
+    EXPECT_EQ(2, numComplete);
+    EXPECT_EQ(1, numInstant);
+}
+
+TEST_F(TraceRecorderTest, registerThreadBeforeRecording) {
+    std::atomic<int> session = 0;
+    std::atomic<int> recordedSession = 0;
+    std::thread worker([&session, &recordedSession] {
+        mixxx::TraceRecorder::registerCurrentThread(QStringLiteral("Worker"));
+        while (session != -1) {
+            // Keeps the buffer of the previous session when recording
+            // is enabled again, until the next event
+            if (recordedSession != session) {
+                mixxx::TraceRecorder::recordInstant("worker");
+                recordedSession = session.load();
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    for (int i = 1; i <= 2; ++i) {
+        const QString filePath = m_tempDir.filePath(QStringLiteral("trace%1.json").arg(i));
+        mixxx::TraceRecorder::enable(filePath);
+        session = i;
+        while (recordedSession != i) {
+            std::this_thread::yield();
+        }
+        mixxx::TraceRecorder::disable();
+
+        QStringList threadNames;
+        for (const auto& value : readTraceEvents(filePath)) {
+            const QJsonObject event = value.toObject();
+            if (event.value(QStringLiteral("ph")).toString() == QStringLiteral("M")) {
+                threadNames.append(event.value(QStringLiteral("args"))
+                                           .toObject()
+                                           .value(QStringLiteral("name"))
+                                           .toString());
+            }
+        }
+        EXPECT_EQ(QStringList{QStringLiteral("Worker")}, threadNames);
+    }
+    session = -1;
+    worker.join();
+}
+
+TEST_F(TraceRecorderTest, overwriteOldestEvents) {
+    const QString filePath = m_tempDir.filePath(QStringLiteral("trace.json"));
+    constexpr int kEventsPerThread = 16;
+    mixxx::TraceRecorder::enable(filePath, kEventsPerThread);
+    for (int i = 0; i < 3 * kEventsPerThread; ++i) {
+        mixxx::TraceRecorder::recordInstant("instant");
+    }
+    mixxx::TraceRecorder::disable();
+
+    const QJsonArray events = readTraceEvents(filePath);
+    // Thread name and the most recent events. The slot of the oldest
+    // event is discarded, because it would be overwritten next.
+    EXPECT_EQ(kEventsPerThread, events.size());
+}
+
+TEST_F(TraceRecorderTest, discardTornRecordsWhileRecording) {
+    const QString filePath = m_tempDir.filePath(QStringLiteral("trace.json"));
+    constexpr int kEventsPerThread = 16;
+    mixxx::TraceRecorder::enable(filePath, kEventsPerThread);
+    std::atomic<bool> started = false;
+    std::atomic<bool> done = false;
+    std::thread writer([&started, &done] {
+        // The duration and the start of each event are written
+        // with the same value, so torn records can be detected.
+        for (qint64 i = 1; !done; ++i) {
+            mixxx::TraceRecorder::recordComplete("event", i * 1000, i * 1000);
+            started = true;
+        }
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    mixxx::TraceRecorder::disable();
+    done = true;
+    writer.join();
+
+    const QJsonArray events = readTraceEvents(filePath);
+    std::optional<double> offset;
+    for (const auto& value : events) {
+        const QJsonObject event = value.toObject();
+        if (event.value(QStringLiteral("ph")).toString() != QStringLiteral("X")) {
+            continue;
+        }
+        const double dur = event.value(QStringLiteral("dur")).toDouble();
+        const double ts = event.value(QStringLiteral("ts")).toDouble();
+        if (!offset) {
+            offset = dur - ts;
+        }
+        EXPECT_NEAR(*offset, dur - ts, 0.01);
+    }
+}
+
+} // namespace
@@ -0,0 +1,85 @@
+#include "analyzer/trackanalysisqueue.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+AnalyzerScheduledTrack scheduledTrack(int id, AnalyzerPriority priority) {
+    return AnalyzerScheduledTrack(TrackId(QVariant(id)), AnalyzerTrack::Options(), priority);
+}
+
+std::vector<int> dequeueAll(TrackAnalysisQueue* pQueue) {
+    std::vector<int> trackIds;
+    while (!pQueue->isEmpty()) {
+        trackIds.push_back(pQueue->front().track.getTrackId().toVariant().toInt());
+        pQueue->popFront();
+    }
+    return trackIds;
+}
+
+TEST(TrackAnalysisQueueTest, dequeueByPriority) {
+    TrackAnalysisQueue queue;
+    EXPECT_TRUE(queue.isEmpty());
+    queue.enqueue(scheduledTrack(1, AnalyzerPriority::Batch));
+    queue.enqueue(scheduledTrack(2, AnalyzerPriority::AutoDjNext));
+    queue.enqueue(scheduledTrack(3, AnalyzerPriority::Batch));
+    queue.enqueue(scheduledTrack(4, AnalyzerPriority::DeckLoaded));
+    queue.enqueue(scheduledTrack(5, AnalyzerPriority::Preview));
+    queue.enqueue(scheduledTrack(6, AnalyzerPriority::DeckLoaded));
+    EXPECT_EQ(6, queue.size());
+
+    // FIFO order within the same priority
+    EXPECT_EQ((std::vector<int>{4, 6, 5, 2, 1, 3}), dequeueAll(&queue));
+    EXPECT_EQ(0, queue.size());
+}
+
+TEST(TrackAnalysisQueueTest, requeuePreemptedTrack) {
+    TrackAnalysisQueue queue;
+    queue.enqueue(scheduledTrack(1, AnalyzerPriority::Batch));
+    queue.enqueue(scheduledTrack(2, AnalyzerPriority::Batch));
+    queue.enqueue(scheduledTrack(3, AnalyzerPriority::DeckLoaded));
+
+    // The preempted track is analyzed before all other tracks of the
+    // same priority, but after more urgent tracks
+    queue.requeue(scheduledTrack(4, AnalyzerPriority::Batch));
+    EXPECT_EQ((std::vector<int>{3, 4, 1, 2}), dequeueAll(&queue));
+}
+
+TEST(TrackAnalysisQueueTest, preemptLeastUrgentWorker) {
+    TrackAnalysisQueue queue;
+    const std::vector<std::optional<AnalyzerPriority>> workerPriorities = {
+            AnalyzerPriority::Preview,
+            AnalyzerPriority::Batch,
+            AnalyzerPriority::AutoDjNext,
+    };
+    queue.enqueue(scheduledTrack(1, AnalyzerPriority::DeckLoaded));
+    EXPECT_EQ(std::optional<std::size_t>(1),
+            queue.workerToPreempt(AnalyzerPriority::DeckLoaded, workerPriorities));
+
+    // Only workers with less urgent tracks are preempted
+    EXPECT_EQ(std::nullopt,
+            queue.workerToPreempt(AnalyzerPriority::Batch, workerPriorities));
+}
+
+TEST(TrackAnalysisQueueTest, preferIdleWorkers) {
+    TrackAnalysisQueue queue;
+    std::vector<std::optional<AnalyzerPriority>> workerPriorities = {
+            AnalyzerPriority::Batch,
+            std::nullopt,
+    };
+    queue.enqueue(scheduledTrack(1, AnalyzerPriority::DeckLoaded));
+    EXPECT_EQ(std::nullopt,
+            queue.workerToPreempt(AnalyzerPriority::DeckLoaded, workerPriorities));
+
+    // Queued tracks of a lower priority don't need an idle worker
+    queue.enqueue(scheduledTrack(2, AnalyzerPriority::AutoDjNext));
+    EXPECT_EQ(std::nullopt,
+            queue.workerToPreempt(AnalyzerPriority::DeckLoaded, workerPriorities));
+
+    // The idle worker will receive the first track
+    queue.enqueue(scheduledTrack(3, AnalyzerPriority::DeckLoaded));
+    EXPECT_EQ(std::optional<std::size_t>(0),
+            queue.workerToPreempt(AnalyzerPriority::DeckLoaded, workerPriorities));
+}
+
+} // namespace
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include "library/trackcolumnstore.h"
+
+namespace {
+
+constexpr int kArtistColumn = 1;
+constexpr int kBpmColumn = 2;
+constexpr int kYearColumn = 3;
+
+TrackId makeTrackId(int id) {
+    return TrackId(QVariant(id));
+}
+
+class TrackColumnStoreTest : public testing::Test {
+  protected:
+    TrackColumnStoreTest()
+            : m_store({TrackColumnStore::SortKind::Number,
+                      TrackColumnStore::SortKind::Default,
+                      TrackColumnStore::SortKind::Number,
+                      TrackColumnStore::SortKind::Default}) {
+        setTrack(1, QStringLiteral("beta"), 120, QStringLiteral("2001"));
+        setTrack(2, QStringLiteral("Alpha"), 128, QStringLiteral("1999"));
+        setTrack(3, QVariant(), 90, 2005);
+        setTrack(4, QStringLiteral("alpha"), 128, QVariant());
+    }
+
+    void setTrack(int id, const QVariant& artist, double bpm, const QVariant& year) {
+        m_store.setValues(makeTrackId(id), {QVariant(id), artist, QVariant(bpm), year});
+    }
+
+    std::vector<int> sortTracks(const QList<SortColumn>& sortColumns,
+            const std::vector<TrackId>& trackIds = {
+                    makeTrackId(1), makeTrackId(2), makeTrackId(3), makeTrackId(4)}) {
+        std::vector<int> result;
+        for (const auto& trackId : m_store.sortTracks(
+                     trackIds, sortColumns, KeyUtils::KeyNotation::OpenKey)) {
+            result.push_back(trackId.toVariant().toInt());
+        }
+        return result;
+    }
+
+    TrackColumnStore m_store;
+};
+
+TEST_F(TrackColumnStoreTest, storeValues) {
+    EXPECT_EQ(QVariant(2), m_store.value(makeTrackId(2), 0));
+    EXPECT_EQ(QVariant(QStringLiteral("beta")), m_store.value(makeTrackId(1), kArtistColumn));
+    EXPECT_EQ(QVariant(128.0), m_store.value(makeTrackId(4), kBpmColumn));
+    // Values of another type than the first one are preserved
+    EXPECT_EQ(QVariant(2005), m_store.value(makeTrackId(3), kYearColumn));
+    EXPECT_TRUE(m_store.value(makeTrackId(3), kArtistColumn).isNull());
+    EXPECT_FALSE(m_store.value(makeTrackId(5), kArtistColumn).isValid());
+}
+
+TEST_F(TrackColumnStoreTest, sortTracks) {
+    // Null values first, case insensitive, ties by id
+    EXPECT_EQ(std::vector<int>({3, 2, 4, 1}),
+            sortTracks({SortColumn(kArtistColumn, Qt::AscendingOrder)}));
+    EXPECT_EQ(std::vector<int>({1, 2, 4, 3}),
+            sortTracks({SortColumn(kArtistColumn, Qt::DescendingOrder)}));
+    EXPECT_EQ(std::vector<int>({2, 4, 1, 3}),
+            sortTracks({SortColumn(kBpmColumn, Qt::DescendingOrder),
+                    SortColumn(kArtistColumn, Qt::AscendingOrder)}));
+    // Numbers before strings like in SQLite
+    EXPECT_EQ(std::vector<int>({4, 3, 2, 1}),
+            sortTracks({SortColumn(kYearColumn, Qt::AscendingOrder)}));
+    EXPECT_EQ(std::vector<int>({3, 2, 1}),
+            sortTracks({SortColumn(kArtistColumn, Qt::AscendingOrder)},
+                    {makeTrackId(1), makeTrackId(2), makeTrackId(3)}));
+}
+
+TEST_F(TrackColumnStoreTest, updateSortedTracks) {
+    // Cache the order of both columns
+    sortTracks({SortColumn(kArtistColumn, Qt::AscendingOrder)});
+    sortTracks({SortColumn(kBpmColumn, Qt::AscendingOrder)});
+
+    setTrack(1, QStringLiteral("Aardvark"), 60, QVariant());
+    m_store.removeTrack(makeTrackId(2));
+    setTrack(5, QStringLiteral("zeta"), 100, QVariant());
+    EXPECT_EQ(4, m_store.trackCount());
+    EXPECT_FALSE(m_store.contains(makeTrackId(2)));
+
+    const std::vector<TrackId> trackIds = {
+            makeTrackId(1), makeTrackId(2), makeTrackId(3), makeTrackId(4), makeTrackId(5)};
+    // Tracks that are not stored are appended
+    EXPECT_EQ(std::vector<int>({3, 1, 4, 5, 2}),
+            sortTracks({SortColumn(kArtistColumn, Qt::AscendingOrder)}, trackIds));
+    EXPECT_EQ(std::vector<int>({1, 3, 5, 4, 2}),
+            sortTracks({SortColumn(kBpmColumn, Qt::AscendingOrder)}, trackIds));
+}
+
+TEST(TrackColumnStoreSqlTest, sortLikeSql) {
+    constexpr int kTextColumn = 0;
+    constexpr int kIntegerColumn = 1;
+    TrackColumnStore store({TrackColumnStore::SortKind::Text,
+            TrackColumnStore::SortKind::Integer});
+    const auto setTrack = [&store](int id, const QVariant& year, const QVariant& trackNumber) {
+        store.setValues(makeTrackId(id), {year, trackNumber});
+    };
+    setTrack(1, QStringLiteral("2005-03-01"), QStringLiteral("3/12"));
+    setTrack(2, QStringLiteral("2004"), QStringLiteral("10"));
+    setTrack(3, QStringLiteral("2005"), QStringLiteral("2"));
+    setTrack(4, QVariant(), QVariant());
+    setTrack(5, QStringLiteral("1999-12-31"), QStringLiteral("A1"));
+    setTrack(6, 2003, 1);
+
+    std::vector<TrackId> trackIds;
+    for (int id = 1; id <= 7; ++id) {
+        trackIds.push_back(makeTrackId(id));
+    }
+    const auto sortTracks = [&store, &trackIds](int column) {
+        std::vector<int> result;
+        for (const auto& trackId : store.sortTracks(trackIds,
+                     {SortColumn(column, Qt::AscendingOrder)},
+                     KeyUtils::KeyNotation::OpenKey)) {
+            result.push_back(trackId.toVariant().toInt());
+        }
+        return result;
+    };
+
+    // Years are compared as text like lower(year), dates are not parsed
+    // as numbers
+    EXPECT_EQ(std::vector<int>({4, 5, 6, 2, 3, 1, 7}), sortTracks(kTextColumn));
+    // Track numbers are compared by their leading digits like
+    // CAST(tracknumber AS INTEGER)
+    EXPECT_EQ(std::vector<int>({4, 5, 6, 3, 1, 2, 7}), sortTracks(kIntegerColumn));
+
+    // Inserted into the cached order
+    setTrack(7, QStringLiteral("2005-01"), QStringLiteral(" 4 "));
+    EXPECT_EQ(std::vector<int>({4, 5, 6, 2, 3, 7, 1}), sortTracks(kTextColumn));
+    EXPECT_EQ(std::vector<int>({4, 5, 6, 3, 1, 7, 2}), sortTracks(kIntegerColumn));
+}
+
+} // namespace
@@ -0,0 +1,139 @@
+#include <benchmark/benchmark.h>
+
+#include <QHash>
+#include <QVariant>
+#include <QVector>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "library/trackcolumnstore.h"
+#include "util/string.h"
+
+namespace {
+
+constexpr int kNumArtists = 2000;
+
+constexpr int kArtistColumn = 1;
+constexpr int kTitleColumn = 2;
+constexpr int kBpmColumn = 3;
+
+TrackId makeTrackId(int id) {
+    return TrackId(QVariant(id));
+}
+
+QVector<QVariant> makeRecord(int id) {
+    return {QVariant(id),
+            QVariant(QStringLiteral("Artist %1").arg((id * 7919) % kNumArtists)),
+            QVariant(QStringLiteral("Title %1").arg((id * 104729) % 1000003)),
+            QVariant(80.0 + (id * 31) % 90)};
+}
+
+std::unique_ptr<TrackColumnStore> makeStore(int numTracks) {
+    auto pStore = std::make_unique<TrackColumnStore>(QVector<TrackColumnStore::SortKind>{
+            TrackColumnStore::SortKind::Number,
+            TrackColumnStore::SortKind::Default,
+            TrackColumnStore::SortKind::Default,
+            TrackColumnStore::SortKind::Number});
+    for (int id = 1; id <= numTracks; ++id) {
+        pStore->setValues(makeTrackId(id), makeRecord(id));
+    }
+    return pStore;
+}
+
+std::vector<TrackId> makeTrackIds(int numTracks) {
+    std::vector<TrackId> trackIds;
+    trackIds.reserve(numTracks);
+    for (int id = 1; id <= numTracks; ++id) {
+        trackIds.push_back(makeTrackId(id));
+    }
+    return trackIds;
+}
+
+const QList<SortColumn> kSortByArtistAndTitle = {
+        SortColumn(kArtistColumn, Qt::AscendingOrder),
+        SortColumn(kTitleColumn, Qt::AscendingOrder)};
+
+/// Sorts records of QVariants by comparing the strings with the collator
+/// like the BaseTrackCache did before the values were stored by column.
+static void BM_SortVariantRecords(benchmark::State& state) {
+    const int numTracks = static_cast<int>(state.range(0));
+    QHash<TrackId, QVector<QVariant>> records;
+    for (int id = 1; id <= numTracks; ++id) {
+        records.insert(makeTrackId(id), makeRecord(id));
+    }
+    const mixxx::StringCollator collator;
+    for (auto _ : state) {
+        std::vector<TrackId> trackIds = makeTrackIds(numTracks);
+        std::sort(trackIds.begin(), trackIds.end(), [&](TrackId lhs, TrackId rhs) {
+            const QVector<QVariant> lhsRecord = records.value(lhs);
+            const QVector<QVariant> rhsRecord = records.value(rhs);
+            for (int column : {kArtistColumn, kTitleColumn}) {
+                const int result = collator.compare(
+                        lhsRecord[column].toString(), rhsRecord[column].toString());
+                if (result != 0) {
+                    return result < 0;
+                }
+            }
+            return lhs < rhs;
+        });
+        benchmark::DoNotOptimize(trackIds);
+    }
+    state.SetItemsProcessed(state.iterations() * numTracks);
+}
+BENCHMARK(BM_SortVariantRecords)->RangeMultiplier(8)->Range(1 << 12, 1 << 19);
+
+/// Sorts by columns whose order has not been cached yet.
+static void BM_SortTrackColumnStore(benchmark::State& state) {
+    const int numTracks = static_cast<int>(state.range(0));
+    const std::vector<TrackId> trackIds = makeTrackIds(numTracks);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto pStore = makeStore(numTracks);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(pStore->sortTracks(
+                trackIds, kSortByArtistAndTitle, KeyUtils::KeyNotation::OpenKey));
+    }
+    state.SetItemsProcessed(state.iterations() * numTracks);
+}
+BENCHMARK(BM_SortTrackColumnStore)->RangeMultiplier(8)->Range(1 << 12, 1 << 19);
+
+/// Sorts by columns whose order has been cached, e.g. when the search
+/// changes.
+static void BM_SortTrackColumnStoreCached(benchmark::State& state) {
+    const int numTracks = static_cast<int>(state.range(0));
+    const std::vector<TrackId> trackIds = makeTrackIds(numTracks);
+    auto pStore = makeStore(numTracks);
+    pStore->sortTracks(trackIds, kSortByArtistAndTitle, KeyUtils::KeyNotation::OpenKey);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pStore->sortTracks(
+                trackIds, kSortByArtistAndTitle, KeyUtils::KeyNotation::OpenKey));
+    }
+    state.SetItemsProcessed(state.iterations() * numTracks);
+}
+BENCHMARK(BM_SortTrackColumnStoreCached)->RangeMultiplier(8)->Range(1 << 12, 1 << 19);
+
+/// Updates a track while the order of the sorted columns is cached.
+static void BM_UpdateTrackColumnStore(benchmark::State& state) {
+    const int numTracks = static_cast<int>(state.range(0));
+    const std::vector<TrackId> trackIds = makeTrackIds(numTracks);
+    const QList<SortColumn> sortColumns = {
+            SortColumn(kArtistColumn, Qt::AscendingOrder),
+            SortColumn(kTitleColumn, Qt::AscendingOrder),
+            SortColumn(kBpmColumn, Qt::AscendingOrder)};
+    auto pStore = makeStore(numTracks);
+    int id = 0;
+    for (auto _ : state) {
+        if (id % 256 == 0) {
+            // Bulk updates discard the cached order, sort again
+            state.PauseTiming();
+            pStore->sortTracks(trackIds, sortColumns, KeyUtils::KeyNotation::OpenKey);
+            state.ResumeTiming();
+        }
+        id = id % numTracks + 1;
+        pStore->setValues(makeTrackId(id), makeRecord(id + 1));
+    }
+}
+BENCHMARK(BM_UpdateTrackColumnStore)->RangeMultiplier(8)->Range(1 << 12, 1 << 19);
+
+} // namespace
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "library/tracksearchindex.h"
+
+namespace {
+
+const QString kArtist = QStringLiteral("artist");
+const QString kTitle = QStringLiteral("title");
+
+TrackId makeTrackId(int id) {
+    return TrackId(QVariant(id));
+}
+
+class TrackSearchIndexTest : public testing::Test {
+  protected:
+    TrackSearchIndexTest()
+            : m_index(QStringList{kArtist, kTitle}) {
+        m_index.updateTrack(makeTrackId(1), {QStringLiteral("The Beatles"), QStringLiteral("Help!")});
+        m_index.updateTrack(makeTrackId(3), {QStringLiteral("Björk"), QStringLiteral("Hyperballad")});
+        m_index.updateTrack(makeTrackId(2), {QStringLiteral("Beat Happening"), QString()});
+    }
+
+    std::vector<TrackId> find(const QStringList& columns, const QString& term) {
+        std::vector<TrackId> trackIds;
+        EXPECT_TRUE(m_index.findTracksContaining(columns, term, &trackIds));
+        return trackIds;
+    }
+
+    TrackSearchIndex m_index;
+};
+
+TEST_F(TrackSearchIndexTest, findSubstrings) {
+    EXPECT_EQ(std::vector<TrackId>({makeTrackId(1), makeTrackId(2)}), find({kArtist}, "beat"));
+    // Matches inside of tokens like SQL LIKE
+    EXPECT_EQ(std::vector<TrackId>({makeTrackId(1)}), find({kArtist}, "eatles"));
+    EXPECT_EQ(std::vector<TrackId>({makeTrackId(2)}), find({kArtist}, "pe"));
+    EXPECT_EQ(std::vector<TrackId>({makeTrackId(2), makeTrackId(3)}), find({kArtist, kTitle}, "pe"));
+    EXPECT_EQ(std::vector<TrackId>(), find({kTitle}, "beat"));
+}
+
+TEST_F(TrackSearchIndexTest, foldValues) {
+    // Values are folded like the argument of TextFilterNode
+    EXPECT_EQ(std::vector<TrackId>({makeTrackId(3)}), find({kArtist}, "bjork"));
+}
+
+TEST_F(TrackSearchIndexTest, rejectUnsupportedTerms) {
+    std::vector<TrackId> trackIds;
+    EXPECT_FALSE(m_index.findTracksContaining({kArtist}, "the beatles", &trackIds));
+    EXPECT_FALSE(m_index.findTracksContaining({kArtist}, QString(), &trackIds));
+    EXPECT_FALSE(m_index.findTracksContaining({QStringLiteral("genre")}, "beat", &trackIds));
+}
+
+TEST_F(TrackSearchIndexTest, updateAndRemoveTracks) {
+    m_index.updateTrack(makeTrackId(1), {QStringLiteral("Paul McCartney"), QStringLiteral("Help!")});
+    EXPECT_EQ(std::vector<TrackId>({makeTrackId(2)}), find({kArtist}, "beat"));
+    EXPECT_EQ(std::vector<TrackId>({makeTrackId(1)}), find({kArtist}, "paul"));
+
+    m_index.removeTrack(makeTrackId(2));
+    EXPECT_EQ(std::vector<TrackId>(), find({kArtist}, "beat"));
+    EXPECT_EQ(std::vector<TrackId>({makeTrackId(1), makeTrackId(3)}), m_index.allTrackIds());
+
+    m_index.clear();
+    EXPECT_EQ(0, m_index.trackCount());
+    EXPECT_EQ(std::vector<TrackId>(), find({kArtist}, "paul"));
+}
+
+} // namespace
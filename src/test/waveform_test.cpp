@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "waveform/waveform.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr int kVisualSampleRate = 441;
+constexpr SINT kFrameLength = 4410;
+
+class WaveformTest : public testing::Test {
+  protected:
+    void fillWaveform(Waveform* pWaveform) {
+        WaveformData* pData = pWaveform->data();
+        for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+            pData[i].filtered.all = static_cast<unsigned char>(i);
+            pData[i].filtered.low = static_cast<unsigned char>(i + 1);
+            pData[i].filtered.mid = static_cast<unsigned char>(i + 2);
+            pData[i].filtered.high = static_cast<unsigned char>(i + 3);
+            for (int stemIdx = 0; stemIdx < mixxx::kMaxSupportedStems; ++stemIdx) {
+                pData[i].stems[stemIdx] = static_cast<unsigned char>(i + 4 + stemIdx);
+            }
+        }
+        pWaveform->setCompletion(pWaveform->getDataSize());
+    }
+
+    void expectEqualWaveforms(
+            const Waveform& expected,
+            const Waveform& actual,
+            int stemCount) {
+        ASSERT_EQ(expected.getDataSize(), actual.getDataSize());
+        EXPECT_DOUBLE_EQ(expected.getAudioVisualRatio(), actual.getAudioVisualRatio());
+        EXPECT_EQ(expected.hasStem(), actual.hasStem());
+        EXPECT_EQ(actual.getDataSize(), actual.getCompletion());
+        for (int i = 0; i < expected.getDataSize(); ++i) {
+            EXPECT_EQ(expected.getAll(i), actual.getAll(i));
+            EXPECT_EQ(expected.getLow(i), actual.getLow(i));
+            EXPECT_EQ(expected.getMid(i), actual.getMid(i));
+            EXPECT_EQ(expected.getHigh(i), actual.getHigh(i));
+            for (int stemIdx = 0; stemIdx < stemCount; ++stemIdx) {
+                EXPECT_EQ(expected.get(i).stems[stemIdx], actual.get(i).stems[stemIdx]);
+            }
+        }
+    }
+};
+
+TEST_F(WaveformTest, columnarRoundTrip) {
+    for (int stemCount : {0, mixxx::kMaxSupportedStems}) {
+        Waveform waveform(kSampleRate, kFrameLength, kVisualSampleRate, -1, stemCount);
+        fillWaveform(&waveform);
+
+        const QByteArray data = waveform.toColumnarByteArray();
+        EXPECT_GT(Waveform::columnarHeaderSize(data), 0);
+
+        const Waveform loaded(data);
+        expectEqualWaveforms(waveform, loaded, stemCount);
+        EXPECT_EQ(Waveform::SaveState::Saved, loaded.saveState());
+    }
+}
+
+TEST_F(WaveformTest, migrateProtobuf) {
+    Waveform waveform(kSampleRate,
+            kFrameLength,
+            kVisualSampleRate,
+            -1,
+            mixxx::kMaxSupportedStems);
+    fillWaveform(&waveform);
+
+    const QByteArray data = waveform.toByteArray();
+    EXPECT_EQ(0, Waveform::columnarHeaderSize(data));
+
+    const Waveform loaded(data);
+    expectEqualWaveforms(waveform, loaded, mixxx::kMaxSupportedStems);
+    // Legacy data needs to be rewritten in the columnar format
+    EXPECT_EQ(Waveform::SaveState::SavePending, loaded.saveState());
+}
+
+TEST_F(WaveformTest, rejectCorruptColumnarData) {
+    Waveform waveform(kSampleRate, kFrameLength, kVisualSampleRate, -1, 0);
+    fillWaveform(&waveform);
+
+    QByteArray data = waveform.toColumnarByteArray();
+    data[data.size() - 1] = static_cast<char>(data.at(data.size() - 1) + 1);
+    const Waveform corrupt(data);
+    EXPECT_EQ(0, corrupt.getDataSize());
+
+    data = waveform.toColumnarByteArray();
+    data.chop(1);
+    const Waveform truncated(data);
+    EXPECT_EQ(0, truncated.getDataSize());
+}
+
+TEST_F(WaveformTest, mipLevels) {
+    Waveform waveform(kSampleRate, kFrameLength, kVisualSampleRate, -1, 0);
+    fillWaveform(&waveform);
+    EXPECT_EQ(0, waveform.selectMipLevel(1000));
+
+    waveform.buildMipLevels();
+    EXPECT_EQ(0, waveform.selectMipLevel(1.5));
+    EXPECT_EQ(1, waveform.selectMipLevel(2));
+    EXPECT_EQ(2, waveform.selectMipLevel(7.9));
+
+    int levelCount = 0;
+    while (waveform.selectMipLevel(1 << (levelCount + 1)) > levelCount) {
+        ++levelCount;
+    }
+    // The top level contains a single frame
+    EXPECT_EQ(2, waveform.getMipLevelDataSize(levelCount));
+
+    for (int level = 1; level <= levelCount; ++level) {
+        const WaveformData* pParent = waveform.getMipLevelData(level - 1);
+        const int parentDataSize = waveform.getMipLevelDataSize(level - 1);
+        const WaveformData* pData = waveform.getMipLevelData(level);
+        const int dataSize = waveform.getMipLevelDataSize(level);
+        EXPECT_EQ((parentDataSize / 2 + 1) / 2 * 2, dataSize);
+        for (int i = 0; i < dataSize; ++i) {
+            const int frame = i / 2;
+            const int chn = i % 2;
+            const int first = 4 * frame + chn;
+            const int second = first + 2 < parentDataSize ? first + 2 : first;
+            EXPECT_EQ(std::max(pParent[first].filtered.all, pParent[second].filtered.all),
+                    pData[i].filtered.all);
+            EXPECT_EQ(std::max(pParent[first].filtered.high, pParent[second].filtered.high),
+                    pData[i].filtered.high);
+        }
+    }
+}
+
+TEST_F(WaveformTest, columnarHeaderChecksum) {
+    Waveform waveform(kSampleRate, kFrameLength, kVisualSampleRate, -1, 0);
+    fillWaveform(&waveform);
+
+    const QByteArray data = waveform.toColumnarByteArray();
+    const int headerSize = Waveform::columnarHeaderSize(data);
+    const quint32 checksum = Waveform::columnarHeaderChecksum(data);
+    // The CRC-32 of the bands and the last byte of the header
+    for (int i : {20, headerSize - 1}) {
+        QByteArray corruptData = data;
+        corruptData[i] = static_cast<char>(corruptData.at(i) ^ 0x10);
+        EXPECT_NE(checksum, Waveform::columnarHeaderChecksum(corruptData));
+    }
+
+    // A corruption of the bands is only detected when they are decoded
+    QByteArray corruptData = data;
+    corruptData[headerSize] = static_cast<char>(corruptData.at(headerSize) ^ 0x10);
+    EXPECT_EQ(checksum, Waveform::columnarHeaderChecksum(corruptData));
+    const Waveform corrupt(corruptData);
+    EXPECT_EQ(0, corrupt.getDataSize());
+}
+
+} // namespace
@@ -227,7 +227,8 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
 
     const QCommandLineOption timelinePath(QStringLiteral("timeline-path"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
-                                      "Path the debug statistics time line is written to")
+                                      "Path the debug statistics time line is written to. "
+                                      "Use the .json extension to write a Chrome trace.")
                             : QString(),
             QStringLiteral("path"));
     QCommandLineOption timelinePathDeprecated(
@@ -237,6 +238,18 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     parser.addOption(timelinePath);
     parser.addOption(timelinePathDeprecated);
 
+    const QCommandLineOption tracePath(QStringLiteral("trace-path"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Record timing events of the audio engine, "
+                                      "the waveform rendering, analysis and controller "
+                                      "scripts and write them to this path as a Chrome "
+                                      "trace (JSON), which can be opened with "
+                                      "https://ui.perfetto.dev. An additional snapshot is "
+                                      "written after audio buffer underflows.")
+                            : QString(),
+            QStringLiteral("path"));
+    parser.addOption(tracePath);
+
     const QCommandLineOption enableLegacyVuMeter(QStringLiteral("enable-legacy-vumeter"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Use legacy vu meter")
@@ -451,6 +464,10 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_timelinePath = parser.value(timelinePathDeprecated);
     }
 
+    if (parser.isSet(tracePath)) {
+        m_tracePath = parser.value(tracePath);
+    }
+
     m_useLegacyVuMeter = parser.isSet(enableLegacyVuMeter);
     m_useLegacySpinny = parser.isSet(enableLegacySpinny);
     m_controllerDebug = parser.isSet(controllerDebug) || parser.isSet(controllerDebugDeprecated);
@@ -69,6 +69,9 @@ class CmdlineArgs final {
         return m_logMaxFileSize;
     }
     bool getTimelineEnabled() const { return !m_timelinePath.isEmpty(); }
+    bool getTracingEnabled() const {
+        return !m_tracePath.isEmpty();
+    }
     const QString& getLocale() const { return m_locale; }
     const QString& getSettingsPath() const { return m_settingsPath; }
     void setSettingsPath(const QString& newSettingsPath) {
@@ -76,6 +79,9 @@ class CmdlineArgs final {
     }
     const QString& getResourcePath() const { return m_resourcePath; }
     const QString& getTimelinePath() const { return m_timelinePath; }
+    const QString& getTracePath() const {
+        return m_tracePath;
+    }
 
     const QString& getStyle() const {
         return m_styleName;
@@ -122,5 +128,6 @@ class CmdlineArgs final {
     QString m_settingsPath;
     QString m_resourcePath;
     QString m_timelinePath;
+    QString m_tracePath;
     QString m_styleName;
 };
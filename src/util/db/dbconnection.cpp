@@ -1,5 +1,6 @@
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -311,18 +312,83 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
     return true;
 }
 
+#ifdef __SQLITE3__
+bool execPragma(const QSqlDatabase& database, const QString& pragma, QVariant* pResult = nullptr) {
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("PRAGMA ") + pragma)) {
+        kLogger.warning()
+                << "Failed to execute"
+                << pragma
+                << query.lastError();
+        return false;
+    }
+    if (pResult && query.next()) {
+        *pResult = query.value(0);
+    }
+    return true;
+}
+#endif // __SQLITE3__
+
+void applyPerformanceProfile(
+        const QSqlDatabase& database,
+        const DbConnection::PerformanceProfile& profile) {
+    DEBUG_ASSERT(database.isOpen());
+#ifdef __SQLITE3__
+    // The journal mode is persistent and applies to all connections.
+    // It needs to be reverted explicitly when disabling WAL. In-memory
+    // databases don't support WAL and keep their journal in memory.
+    QVariant journalMode;
+    if (execPragma(database,
+                profile.writeAheadLog
+                        ? QStringLiteral("journal_mode=WAL")
+                        : QStringLiteral("journal_mode=DELETE"),
+                &journalMode)) {
+        kLogger.debug()
+                << "Journal mode"
+                << journalMode.toString();
+        if (journalMode.toString().compare(
+                    QLatin1String("wal"), Qt::CaseInsensitive) == 0) {
+            // Committing transactions only needs to sync the WAL on
+            // checkpoints. This is safe for WAL, i.e. the database
+            // might only lose the most recent transactions on power
+            // failure but will never be corrupted.
+            execPragma(database, QStringLiteral("synchronous=NORMAL"));
+        }
+    }
+    execPragma(database,
+            QStringLiteral("mmap_size=%1")
+                    .arg(static_cast<qint64>(profile.mmapSizeMB) * 1024 * 1024));
+    if (profile.cacheSizeMB > 0) {
+        // Negative values are interpreted as KiB instead of pages
+        execPragma(database,
+                QStringLiteral("cache_size=-%1")
+                        .arg(static_cast<qint64>(profile.cacheSizeMB) * 1024));
+    }
+    if (profile.tempStoreInMemory) {
+        execPragma(database, QStringLiteral("temp_store=MEMORY"));
+    }
+#else
+    Q_UNUSED(database);
+    Q_UNUSED(profile);
+#endif // __SQLITE3__
+}
+
 } // anonymous namespace
 
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_performanceProfile(params.performanceProfile),
+      m_sqlDatabase(createDatabase(params, connectionName)),
+      m_queryCache(m_performanceProfile.statementCacheSize) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
         const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+    : m_performanceProfile(prototype.m_performanceProfile),
+      m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)),
+      m_queryCache(m_performanceProfile.statementCacheSize) {
 }
 
 DbConnection::~DbConnection() {
@@ -350,11 +416,15 @@ bool DbConnection::open() {
         m_sqlDatabase.close();
         return false; // abort
     }
+    applyPerformanceProfile(m_sqlDatabase, m_performanceProfile);
+    m_queryCache.attach(name());
     return true;
 }
 
 void DbConnection::close() {
     if (m_sqlDatabase.isOpen()) {
+        // All prepared statements must be finalized before closing
+        m_queryCache.detach();
         // There should never be an outstanding transaction when this code is
         // called. If there is, it means we probably aren't committing a
         // transaction somewhere that should be.
@@ -3,6 +3,7 @@
 #include <QSqlDatabase>
 #include <QtDebug>
 
+#include "util/db/fwdsqlquerycache.h"
 #include "util/string.h"
 
 namespace mixxx {
@@ -22,6 +23,23 @@ class DbConnection final {
 
     static void makeStringLatinLow(QString* string);
 
+    // SQLite specific tuning that is applied to each connection
+    // after it has been opened.
+    struct PerformanceProfile {
+        // Use a write-ahead log instead of a rollback journal. Readers
+        // are not blocked by a concurrent writer on another connection.
+        bool writeAheadLog = true;
+        // Size of the memory-mapped I/O region, 0 = disabled
+        int mmapSizeMB = 256;
+        // Size of the page cache per connection
+        int cacheSizeMB = 16;
+        // Keep temporary tables and indices in memory
+        bool tempStoreInMemory = true;
+        // Max. number of prepared statements per connection
+        // in the FwdSqlQueryCache, 0 = disabled
+        int statementCacheSize = 64;
+    };
+
     struct Params {
         QString type;
         QString connectOptions;
@@ -29,6 +47,7 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        PerformanceProfile performanceProfile;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -61,8 +80,10 @@ class DbConnection final {
     DbConnection(const DbConnection&) = delete;
     DbConnection(const DbConnection&&) = delete;
 
+    const PerformanceProfile m_performanceProfile;
     QSqlDatabase m_sqlDatabase;
     mixxx::StringCollator m_collator;
+    FwdSqlQueryCache m_queryCache;
 };
 
 } // namespace mixxx
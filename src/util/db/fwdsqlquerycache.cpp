@@ -0,0 +1,161 @@
+#include "util/db/fwdsqlquerycache.h"
+
+#include "util/assert.h"
+#include "util/counter.h"
+#include "util/db/sqlqueryfinisher.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("FwdSqlQueryCache");
+
+// Connections are only used by the thread that opened them and each
+// thread has its own connections. The registry is accessed frequently
+// and therefore thread-local to avoid locking.
+QHash<QString, FwdSqlQueryCache*>& threadLocalCaches() {
+    thread_local QHash<QString, FwdSqlQueryCache*> caches;
+    return caches;
+}
+
+} // anonymous namespace
+
+FwdSqlQueryCache::Query::Query(FwdSqlQueryCache* pCache, EntryList::iterator entry)
+        : m_pCache(pCache),
+          m_entry(entry),
+          m_pQuery(&entry->query) {
+    DEBUG_ASSERT(!m_entry->inUse);
+    m_entry->inUse = true;
+}
+
+FwdSqlQueryCache::Query::Query(std::unique_ptr<FwdSqlQuery> pUncachedQuery)
+        : m_pCache(nullptr),
+          m_entry(),
+          m_pUncachedQuery(std::move(pUncachedQuery)),
+          m_pQuery(m_pUncachedQuery.get()) {
+}
+
+FwdSqlQueryCache::Query::Query(Query&& other)
+        : m_pCache(other.m_pCache),
+          m_entry(other.m_entry),
+          m_pUncachedQuery(std::move(other.m_pUncachedQuery)),
+          m_pQuery(other.m_pQuery) {
+    other.m_pCache = nullptr;
+    other.m_pQuery = nullptr;
+}
+
+FwdSqlQueryCache::Query::~Query() {
+    if (m_pCache) {
+        m_pCache->release(m_entry);
+    }
+}
+
+//static
+FwdSqlQueryCache::Query FwdSqlQueryCache::prepare(
+        const QSqlDatabase& database,
+        const QString& statement) {
+    const auto& caches = threadLocalCaches();
+    const auto it = caches.constFind(database.connectionName());
+    if (it == caches.constEnd() || it.value()->capacity() <= 0) {
+        return Query(std::make_unique<FwdSqlQuery>(database, statement));
+    }
+    return it.value()->acquire(database, statement);
+}
+
+FwdSqlQueryCache::FwdSqlQueryCache(int capacity)
+        : m_capacity(capacity) {
+}
+
+FwdSqlQueryCache::~FwdSqlQueryCache() {
+    detach();
+}
+
+void FwdSqlQueryCache::attach(const QString& connectionName) {
+    DEBUG_ASSERT(m_connectionName.isEmpty());
+    DEBUG_ASSERT(!threadLocalCaches().contains(connectionName));
+    m_connectionName = connectionName;
+    threadLocalCaches().insert(m_connectionName, this);
+}
+
+void FwdSqlQueryCache::detach() {
+    if (m_connectionName.isEmpty()) {
+        DEBUG_ASSERT(m_entries.empty());
+        return;
+    }
+    DEBUG_ASSERT(threadLocalCaches().value(m_connectionName) == this);
+    threadLocalCaches().remove(m_connectionName);
+    m_connectionName.clear();
+    for (const auto& entry : m_entries) {
+        // Queries must not outlive the scope of the calling function
+        DEBUG_ASSERT(!entry.inUse);
+        Q_UNUSED(entry);
+    }
+    m_entriesByStatement.clear();
+    m_entries.clear();
+}
+
+FwdSqlQueryCache::Query FwdSqlQueryCache::acquire(
+        const QSqlDatabase& database,
+        const QString& statement) {
+    DEBUG_ASSERT(database.connectionName() == m_connectionName);
+    const auto it = m_entriesByStatement.constFind(statement);
+    if (it != m_entriesByStatement.constEnd()) {
+        const auto entry = it.value();
+        if (entry->inUse) {
+            return Query(std::make_unique<FwdSqlQuery>(database, statement));
+        }
+        // Move to the front of the LRU list
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+        static Counter s_hitCounter(QStringLiteral("FwdSqlQueryCache hit"));
+        s_hitCounter++;
+        return Query(this, entry);
+    }
+
+    static Counter s_missCounter(QStringLiteral("FwdSqlQueryCache miss"));
+    s_missCounter++;
+    m_entries.emplace_front(database, statement);
+    const auto entry = m_entries.begin();
+    if (!entry->query.isPrepared()) {
+        // Don't cache invalid statements. The error has already
+        // been logged by FwdSqlQuery.
+        auto pQuery = std::make_unique<FwdSqlQuery>(std::move(entry->query));
+        m_entries.erase(entry);
+        return Query(std::move(pQuery));
+    }
+    m_entriesByStatement.insert(statement, entry);
+    // The new entry is in use and will not be evicted
+    Query query(this, entry);
+    evictUnused();
+    return query;
+}
+
+void FwdSqlQueryCache::release(EntryList::iterator entry) {
+    DEBUG_ASSERT(entry->inUse);
+    if (entry->query.hasError()) {
+        // The error would persist until the next execution. Discard
+        // the query instead of reusing it in a failure state.
+        m_entriesByStatement.remove(entry->statement);
+        m_entries.erase(entry);
+        return;
+    }
+    // Free the resources of the prepared statement and release
+    // any read locks until it is executed again
+    SqlQueryFinisher(&entry->query).tryFinish();
+    entry->inUse = false;
+}
+
+void FwdSqlQueryCache::evictUnused() {
+    auto it = m_entries.end();
+    while (size() > m_capacity && it != m_entries.begin()) {
+        --it;
+        if (it->inUse) {
+            continue;
+        }
+        if (kLogger.traceEnabled()) {
+            kLogger.trace()
+                    << "Evicting"
+                    << it->statement;
+        }
+        m_entriesByStatement.remove(it->statement);
+        it = m_entries.erase(it);
+    }
+}
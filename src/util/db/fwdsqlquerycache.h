@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <list>
+#include <memory>
+
+#include "util/db/fwdsqlquery.h"
+
+/// A per-connection LRU cache of prepared FwdSqlQuery objects.
+///
+/// Preparing an SQLite statement requires parsing the SQL and
+/// planning the query, which often takes longer than executing
+/// it. Statements with a constant SQL text that are executed
+/// frequently, e.g. for loading a single track, should therefore
+/// be obtained from the cache of the corresponding connection.
+///
+/// The cache is owned by DbConnection and registered for the
+/// thread that opened the connection. The connection must only
+/// be used from this thread.
+class FwdSqlQueryCache final {
+    struct Entry {
+        Entry(const QSqlDatabase& database, const QString& statement)
+                : statement(statement),
+                  query(database, statement),
+                  inUse(false) {
+        }
+
+        const QString statement;
+        FwdSqlQuery query;
+        bool inUse;
+    };
+    typedef std::list<Entry> EntryList;
+
+  public:
+    /// Exclusive access to a prepared query that is returned to
+    /// the cache when going out of scope. The query is finished
+    /// at this point, i.e. results must not be accessed afterwards.
+    ///
+    /// A query that is already in use, e.g. by a recursive call,
+    /// or that could not be cached is prepared individually.
+    class Query final {
+      public:
+        Query(Query&& other);
+        ~Query();
+
+        FwdSqlQuery& operator*() const {
+            return *m_pQuery;
+        }
+        FwdSqlQuery* operator->() const {
+            return m_pQuery;
+        }
+
+      private:
+        friend class FwdSqlQueryCache;
+        Query(FwdSqlQueryCache* pCache, EntryList::iterator entry);
+        explicit Query(std::unique_ptr<FwdSqlQuery> pUncachedQuery);
+
+        Query(const Query&) = delete;
+        Query& operator=(const Query&) = delete;
+        Query& operator=(Query&&) = delete;
+
+        FwdSqlQueryCache* m_pCache;
+        EntryList::iterator m_entry;
+        std::unique_ptr<FwdSqlQuery> m_pUncachedQuery;
+        FwdSqlQuery* m_pQuery;
+    };
+
+    /// Returns a prepared query for the statement from the cache of
+    /// the database connection. Falls back to preparing an individual
+    /// query if caching is disabled for this connection.
+    static Query prepare(
+            const QSqlDatabase& database,
+            const QString& statement);
+
+    explicit FwdSqlQueryCache(int capacity);
+    ~FwdSqlQueryCache();
+
+    int capacity() const {
+        return m_capacity;
+    }
+    int size() const {
+        return static_cast<int>(m_entries.size());
+    }
+
+    /// Enables the cache for all queries of the named connection
+    /// from the current thread.
+    void attach(const QString& connectionName);
+    /// Disables the cache and discards all prepared queries. Must
+    /// be invoked before the database connection is closed.
+    void detach();
+
+  private:
+    FwdSqlQueryCache(const FwdSqlQueryCache&) = delete;
+    FwdSqlQueryCache& operator=(const FwdSqlQueryCache&) = delete;
+
+    Query acquire(const QSqlDatabase& database, const QString& statement);
+    void release(EntryList::iterator entry);
+    void evictUnused();
+
+    const int m_capacity;
+
+    QString m_connectionName;
+
+    // Ordered from most recently to least recently used
+    EntryList m_entries;
+    QHash<QString, EntryList::iterator> m_entriesByStatement;
+};
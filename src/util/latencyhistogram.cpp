@@ -0,0 +1,124 @@
+#include "util/latencyhistogram.h"
+
+#include <QList>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+#include "util/assert.h"
+#include "util/mutex.h"
+
+namespace mixxx {
+
+namespace {
+
+// Function local statics, because histograms might be static objects
+// themselves that are constructed during static initialization.
+MMutex& instancesMutex() {
+    static MMutex s_mutex;
+    return s_mutex;
+}
+
+QList<const LatencyHistogram*>& instances() {
+    static QList<const LatencyHistogram*> s_instances;
+    return s_instances;
+}
+
+} // anonymous namespace
+
+LatencyHistogram::LatencyHistogram(QString name)
+        : m_name(std::move(name)) {
+    for (auto& count : m_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    const MMutexLocker locker(&instancesMutex());
+    instances().append(this);
+}
+
+LatencyHistogram::~LatencyHistogram() {
+    const MMutexLocker locker(&instancesMutex());
+    instances().removeOne(this);
+}
+
+//static
+int LatencyHistogram::bucketIndex(qint64 nanos) {
+    constexpr quint64 kMaxValue = (quint64{1} << kMaxValueBits) - 1;
+    const quint64 value = std::min(static_cast<quint64>(std::max(nanos, qint64{0})), kMaxValue);
+    if (value < 2 * kHalfSubBucketCount) {
+        return static_cast<int>(value);
+    }
+    // Values in [2^n, 2^(n+1)) share the same resolution of 2^shift
+    const int msb = std::bit_width(value) - 1;
+    const int shift = msb - (kSubBucketBits - 1);
+    return shift * kHalfSubBucketCount + static_cast<int>(value >> shift);
+}
+
+//static
+qint64 LatencyHistogram::bucketUpperBound(int index) {
+    DEBUG_ASSERT(index >= 0 && index < kNumBuckets);
+    if (index < 2 * kHalfSubBucketCount) {
+        return index;
+    }
+    const int shift = index / kHalfSubBucketCount - 1;
+    const qint64 subBucket = index % kHalfSubBucketCount + kHalfSubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot snapshot;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        const quint64 count = m_counts[i].load(std::memory_order_relaxed);
+        snapshot.m_counts[i] = count;
+        snapshot.m_totalCount += count;
+    }
+    return snapshot;
+}
+
+//static
+void LatencyHistogram::forEachInstance(
+        const std::function<void(const LatencyHistogram&)>& function) {
+    const MMutexLocker locker(&instancesMutex());
+    for (const auto* pHistogram : std::as_const(instances())) {
+        function(*pHistogram);
+    }
+}
+
+qint64 LatencyHistogram::Snapshot::valueAtPercentile(double percentile) const {
+    if (m_totalCount == 0) {
+        return 0;
+    }
+    const auto threshold = std::max(quint64{1},
+            static_cast<quint64>(std::ceil(
+                    std::clamp(percentile, 0.0, 100.0) / 100.0 * m_totalCount)));
+    quint64 count = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        count += m_counts[i];
+        if (count >= threshold) {
+            return bucketUpperBound(i);
+        }
+    }
+    return maxValue();
+}
+
+qint64 LatencyHistogram::Snapshot::maxValue() const {
+    for (int i = kNumBuckets - 1; i >= 0; --i) {
+        if (m_counts[i] > 0) {
+            return bucketUpperBound(i);
+        }
+    }
+    return 0;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Snapshot::since(const Snapshot& earlier) const {
+    Snapshot result;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        // The 32 bit counters of the histogram might have wrapped around
+        const auto count = static_cast<quint32>(m_counts[i] - earlier.m_counts[i]);
+        result.m_counts[i] = count;
+        result.m_totalCount += count;
+    }
+    return result;
+}
+
+} // namespace mixxx
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "util/performancetimer.h"
+
+namespace mixxx {
+
+/// A histogram of durations with logarithmic buckets that are linearly
+/// subdivided, like an HDR histogram. Durations between 0 and ~68 s are
+/// recorded with a relative error of less than 3% in a fixed amount of
+/// memory.
+///
+/// Recording is lock-free and does not allocate, so it is safe to call
+/// from the audio thread, also concurrently from multiple threads.
+/// Snapshots can be taken from any other thread at any time.
+///
+/// All instances register themselves by name while they exist, so that
+/// they can be enumerated e.g. for publishing them in the StatsManager.
+class LatencyHistogram final {
+  public:
+    static constexpr int kSubBucketBits = 6;
+    static constexpr int kMaxValueBits = 36;
+
+  private:
+    static constexpr int kHalfSubBucketCount = 1 << (kSubBucketBits - 1);
+
+  public:
+    static constexpr int kNumBuckets =
+            (kMaxValueBits - kSubBucketBits + 2) * kHalfSubBucketCount;
+
+    /// A consistent copy of the counters.
+    class Snapshot {
+      public:
+        Snapshot()
+                : m_counts(kNumBuckets, 0),
+                  m_totalCount(0) {
+        }
+
+        quint64 count() const {
+            return m_totalCount;
+        }
+
+        /// Returns the (upper bound of the) duration in ns below which
+        /// the given percentage of all recorded durations lie, or 0 if
+        /// the snapshot is empty.
+        qint64 valueAtPercentile(double percentile) const;
+        /// Returns the (upper bound of the) longest recorded duration in ns.
+        qint64 maxValue() const;
+
+        /// Returns the durations that have been recorded after the
+        /// earlier snapshot.
+        Snapshot since(const Snapshot& earlier) const;
+
+      private:
+        std::vector<quint64> m_counts;
+        quint64 m_totalCount;
+
+        friend class LatencyHistogram;
+    };
+
+    explicit LatencyHistogram(QString name);
+    ~LatencyHistogram();
+
+    const QString& name() const {
+        return m_name;
+    }
+
+    void record(qint64 nanos) {
+        m_counts[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const;
+
+    /// Invokes the function for all existing histograms. New histograms are
+    /// not created or destroyed while the function runs.
+    static void forEachInstance(
+            const std::function<void(const LatencyHistogram&)>& function);
+
+    static int bucketIndex(qint64 nanos);
+    /// The largest duration that is counted in the bucket.
+    static qint64 bucketUpperBound(int index);
+
+  private:
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    const QString m_name;
+    std::array<std::atomic<quint32>, kNumBuckets> m_counts;
+};
+
+/// Records the lifetime of the scope in the histogram, if any.
+class ScopedLatencyRecorder final {
+  public:
+    explicit ScopedLatencyRecorder(LatencyHistogram* pHistogram)
+            : m_pHistogram(pHistogram) {
+        if (m_pHistogram) {
+            m_timer.start();
+        }
+    }
+    ~ScopedLatencyRecorder() {
+        if (m_pHistogram) {
+            m_pHistogram->record(m_timer.elapsed().toIntegerNanos());
+        }
+    }
+
+  private:
+    ScopedLatencyRecorder(const ScopedLatencyRecorder&) = delete;
+    ScopedLatencyRecorder& operator=(const ScopedLatencyRecorder&) = delete;
+
+    LatencyHistogram* const m_pHistogram;
+    PerformanceTimer m_timer;
+};
+
+} // namespace mixxx
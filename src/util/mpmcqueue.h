@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/// A bounded lock-free FIFO queue for multiple producers and consumers.
+///
+/// Each slot carries a sequence number that tells whether it is ready to
+/// be written or read in the current round. Neither tryPush() nor tryPop()
+/// ever waits for another thread: If a slot is still being accessed by a
+/// preempted thread, the operation fails instead, like when the queue is
+/// full or empty. This makes the queue safe to share between threads of
+/// different real-time priorities.
+///
+/// See Dmitry Vyukov's bounded MPMC queue:
+/// https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template<typename T, std::size_t kCapacity>
+class MpmcQueue {
+    static_assert(kCapacity >= 2 && (kCapacity & (kCapacity - 1)) == 0,
+            "The capacity must be a power of 2");
+
+  public:
+    MpmcQueue()
+            : m_enqueuePos(0),
+              m_dequeuePos(0) {
+        for (std::size_t i = 0; i < kCapacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// Returns false if the queue is full.
+    bool tryPush(const T& value) {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = m_slots[pos & kMask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Full or the slot is still being read
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Returns false if the queue is empty.
+    bool tryPop(T* pValue) {
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = m_slots[pos & kMask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed)) {
+                    *pValue = slot.value;
+                    slot.sequence.store(pos + kCapacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Empty or the slot is still being written
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+  private:
+    static constexpr std::size_t kMask = kCapacity - 1;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value{};
+    };
+
+    std::array<Slot, kCapacity> m_slots;
+    // Separate cache lines avoid false sharing between
+    // producers and consumers
+    alignas(64) std::atomic<std::size_t> m_enqueuePos;
+    alignas(64) std::atomic<std::size_t> m_dequeuePos;
+};
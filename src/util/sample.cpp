@@ -21,6 +21,24 @@ typedef qint32 int32_t;
 // "SINT i" is the preferred loop index type that should allow vectorization in
 // general. Unfortunately there are exceptions where "int i" is required for some reasons.
 
+// Distribution packages are built for the baseline instruction set of the
+// target architecture, i.e. only SSE2 on x86-64. The hottest kernels are
+// compiled into additional clones for AVX2 and AVX-512 and the dynamic loader
+// selects the best clone for the CPU at runtime (GNU ifunc). This requires
+// ifunc support and is not needed if the build already targets AVX2, e.g.
+// with OPTIMIZE=native. On ARM64 NEON is part of the baseline instruction set
+// and already used for the vectorized loops.
+#if defined(__x86_64__) && defined(__linux__) && !defined(__AVX2__) && \
+        defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define SAMPLE_UTIL_TARGET_CLONES \
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef SAMPLE_UTIL_TARGET_CLONES
+#define SAMPLE_UTIL_TARGET_CLONES
+#endif
+
 namespace {
 
 #ifdef __AVX__
@@ -38,6 +56,172 @@ constexpr bool useAlignedAlloc() {
             sizeof(CSAMPLE*) == sizeof(size_t);
 }
 
+// The loops of the kernels below must not be changed without verifying
+// that they are still vectorized for all clones.
+
+SAMPLE_UTIL_TARGET_CLONES
+void applyRampingGainKernel(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN start_gain,
+        CSAMPLE_GAIN gain_delta,
+        int numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
+        // a loop counter i += 2 prevents vectorizing.
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+SAMPLE_UTIL_TARGET_CLONES
+void copyWithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN start_gain,
+        CSAMPLE_GAIN gain_delta,
+        int numFrames) {
+    // note: LOOP VECTORIZED only with "int i" (not SINT i).
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+SAMPLE_UTIL_TARGET_CLONES
+void add3WithGainKernel(CSAMPLE* pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+SAMPLE_UTIL_TARGET_CLONES
+void sumAbsPerChannelKernel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        CSAMPLE* pClippedL,
+        CSAMPLE* pClippedR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    CSAMPLE clippedL = 0;
+    CSAMPLE clippedR = 0;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        CSAMPLE absl = fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        // Replacing the code with a bool clipped will prevent vetorizing
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pClippedL = clippedL;
+    *pClippedR = clippedR;
+}
+
+SAMPLE_UTIL_TARGET_CLONES
+void interleaveStereoKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+SAMPLE_UTIL_TARGET_CLONES
+void interleaveStemKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        const CSAMPLE* M_RESTRICT pSrc4,
+        const CSAMPLE* M_RESTRICT pSrc5,
+        const CSAMPLE* M_RESTRICT pSrc6,
+        const CSAMPLE* M_RESTRICT pSrc7,
+        const CSAMPLE* M_RESTRICT pSrc8,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[8 * i] = pSrc1[i];
+        pDest[8 * i + 1] = pSrc2[i];
+        pDest[8 * i + 2] = pSrc3[i];
+        pDest[8 * i + 3] = pSrc4[i];
+        pDest[8 * i + 4] = pSrc5[i];
+        pDest[8 * i + 5] = pSrc6[i];
+        pDest[8 * i + 6] = pSrc7[i];
+        pDest[8 * i + 7] = pSrc8[i];
+    }
+}
+
+SAMPLE_UTIL_TARGET_CLONES
+void deinterleaveStereoKernel(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+SAMPLE_UTIL_TARGET_CLONES
+void deinterleaveStemKernel(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        CSAMPLE* M_RESTRICT pDest3,
+        CSAMPLE* M_RESTRICT pDest4,
+        CSAMPLE* M_RESTRICT pDest5,
+        CSAMPLE* M_RESTRICT pDest6,
+        CSAMPLE* M_RESTRICT pDest7,
+        CSAMPLE* M_RESTRICT pDest8,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 8];
+        pDest2[i] = pSrc[i * 8 + 1];
+        pDest3[i] = pSrc[i * 8 + 2];
+        pDest4[i] = pSrc[i * 8 + 3];
+        pDest5[i] = pSrc[i * 8 + 4];
+        pDest6[i] = pSrc[i * 8 + 5];
+        pDest7[i] = pSrc[i * 8 + 6];
+        pDest8[i] = pSrc[i * 8 + 7];
+    }
+}
+
+// Adds a single stereo channel pair of a multi channel buffer to a stereo buffer
+SAMPLE_UTIL_TARGET_CLONES
+void addStereoFromMultiKernel(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        int numFrames,
+        int numChannels,
+        int stemIdx) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; i++) {
+        const int srcIdx = numChannels * i +
+                stemIdx * mixxx::audio::ChannelCount::stereo();
+        const int destIdx = mixxx::audio::ChannelCount::stereo() * i;
+        pDest[destIdx] +=
+                pSrc[srcIdx];
+        pDest[destIdx + 1] +=
+                pSrc[srcIdx + 1];
+    }
+}
+
 } // anonymous namespace
 
 // static
@@ -142,13 +326,10 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            // a loop counter i += 2 prevents vectorizing.
-            pBuffer[i * 2] *= gain;
-            pBuffer[i * 2 + 1] *= gain;
-        }
+        applyRampingGainKernel(pBuffer,
+                start_gain,
+                gain_delta,
+                static_cast<int>(numSamples / 2));
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -317,10 +498,7 @@ void SampleUtil::add3WithGain(CSAMPLE* pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
-    }
+    add3WithGainKernel(pDest, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, numSamples);
 }
 
 // static
@@ -365,12 +543,11 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i" (not SINT i).
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
+        copyWithRampingGainKernel(pDest,
+                pSrc,
+                start_gain,
+                gain_delta,
+                static_cast<int>(numSamples / 2));
     } else {
         // note: LOOP VECTORIZED.
         for (SINT i = 0; i < numSamples; ++i) {
@@ -415,24 +592,10 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE fAbsL = CSAMPLE_ZERO;
-    CSAMPLE fAbsR = CSAMPLE_ZERO;
     CSAMPLE clippedL = 0;
     CSAMPLE clippedR = 0;
+    sumAbsPerChannelKernel(pfAbsL, pfAbsR, &clippedL, &clippedR, pBuffer, numSamples / 2);
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples / 2; ++i) {
-        CSAMPLE absl = fabs(pBuffer[i * 2]);
-        fAbsL += absl;
-        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
-        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
-        fAbsR += absr;
-        // Replacing the code with a bool clipped will prevent vetorizing
-        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
-    }
-
-    *pfAbsL = fAbsL;
-    *pfAbsR = fAbsR;
     SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
     if (clippedL > 0) {
         clipping |= SampleUtil::CLIPPING_LEFT;
@@ -486,11 +649,7 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    interleaveStereoKernel(pDest, pSrc1, pSrc2, numFrames);
 }
 
 // static
@@ -504,17 +663,16 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc7,
         const CSAMPLE* M_RESTRICT pSrc8,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[8 * i] = pSrc1[i];
-        pDest[8 * i + 1] = pSrc2[i];
-        pDest[8 * i + 2] = pSrc3[i];
-        pDest[8 * i + 3] = pSrc4[i];
-        pDest[8 * i + 4] = pSrc5[i];
-        pDest[8 * i + 5] = pSrc6[i];
-        pDest[8 * i + 6] = pSrc7[i];
-        pDest[8 * i + 7] = pSrc8[i];
-    }
+    interleaveStemKernel(pDest,
+            pSrc1,
+            pSrc2,
+            pSrc3,
+            pSrc4,
+            pSrc5,
+            pSrc6,
+            pSrc7,
+            pSrc8,
+            numFrames);
 }
 
 // static
@@ -522,11 +680,7 @@ void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
         CSAMPLE* M_RESTRICT pDest2,
         const CSAMPLE* M_RESTRICT pSrc,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest1[i] = pSrc[i * 2];
-        pDest2[i] = pSrc[i * 2 + 1];
-    }
+    deinterleaveStereoKernel(pDest1, pDest2, pSrc, numFrames);
 }
 
 // static
@@ -540,17 +694,16 @@ void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
         CSAMPLE* M_RESTRICT pDest8,
         const CSAMPLE* M_RESTRICT pSrc,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest1[i] = pSrc[i * 8];
-        pDest2[i] = pSrc[i * 8 + 1];
-        pDest3[i] = pSrc[i * 8 + 2];
-        pDest4[i] = pSrc[i * 8 + 3];
-        pDest5[i] = pSrc[i * 8 + 4];
-        pDest6[i] = pSrc[i * 8 + 5];
-        pDest7[i] = pSrc[i * 8 + 6];
-        pDest8[i] = pSrc[i * 8 + 7];
-    }
+    deinterleaveStemKernel(pDest1,
+            pDest2,
+            pDest3,
+            pDest4,
+            pDest5,
+            pDest6,
+            pDest7,
+            pDest8,
+            pSrc,
+            numFrames);
 }
 
 // static
@@ -782,16 +935,11 @@ void SampleUtil::mixMultichannelToStereo(CSAMPLE* pDest,
         if (excludeChannelMask >> stemIdx & 0b1) {
             continue;
         }
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numFrames; i++) {
-            const int srcIdx = numChannels * i +
-                    stemIdx * mixxx::audio::ChannelCount::stereo();
-            const int destIdx = mixxx::audio::ChannelCount::stereo() * i;
-            pDest[destIdx] +=
-                    pSrc[srcIdx];
-            pDest[destIdx + 1] +=
-                    pSrc[srcIdx + 1];
-        }
+        addStereoFromMultiKernel(pDest,
+                pSrc,
+                static_cast<int>(numFrames),
+                numChannels,
+                stemIdx);
     }
 }
 
@@ -804,16 +952,11 @@ void SampleUtil::mixMultichannelToStereo(CSAMPLE* pDest,
     int stereoChCount = numChannels / mixxx::audio::ChannelCount::stereo();
     SampleUtil::clear(pDest, numFrames * mixxx::audio::ChannelCount::stereo());
     for (int stemIdx = 0; stemIdx < stereoChCount; stemIdx++) {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numFrames; i++) {
-            const int srcIdx = numChannels * i +
-                    stemIdx * mixxx::audio::ChannelCount::stereo();
-            const int destIdx = mixxx::audio::ChannelCount::stereo() * i;
-            pDest[destIdx] +=
-                    pSrc[srcIdx];
-            pDest[destIdx + 1] +=
-                    pSrc[srcIdx + 1];
-        }
+        addStereoFromMultiKernel(pDest,
+                pSrc,
+                static_cast<int>(numFrames),
+                numChannels,
+                stemIdx);
     }
 }
 
@@ -1,5 +1,6 @@
 #include "util/statsmanager.h"
 
+#include <QCoreApplication>
 #include <QFile>
 #include <QMetaType>
 #include <QTextStream>
@@ -104,6 +105,11 @@ QString humanizeNanos(qint64 nanos) {
 }
 
 void StatsManager::writeTimeline(const QString& filename) {
+    if (filename.endsWith(QStringLiteral(".json"), Qt::CaseInsensitive)) {
+        writeTimelineJson(filename);
+        return;
+    }
+
     QFile timeline(filename);
     if (!timeline.open(QIODevice::WriteOnly | QIODevice::Text)) {
         qDebug() << "Could not open timeline file for writing:"
@@ -162,6 +168,54 @@ void StatsManager::writeTimeline(const QString& filename) {
     timeline.close();
 }
 
+// Writes the events in the Chrome trace-event format. Events are not
+// associated with threads, so they are exported as async events that
+// are grouped by tag and don't need to be nested.
+void StatsManager::writeTimelineJson(const QString& filename) {
+    QFile timeline(filename);
+    if (!timeline.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "Could not open timeline file for writing:"
+                 << timeline.fileName();
+        return;
+    }
+
+    std::sort(m_events.begin(), m_events.end(), OrderByTime());
+
+    const auto pid = QCoreApplication::applicationPid();
+    QTextStream out(&timeline);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const Event& event : std::as_const(m_events)) {
+        QString phase;
+        switch (event.m_type) {
+        case Stat::EVENT_START:
+            phase = QStringLiteral("b");
+            break;
+        case Stat::EVENT_END:
+            phase = QStringLiteral("e");
+            break;
+        default:
+            phase = QStringLiteral("n");
+            break;
+        }
+        QString tag = event.m_tag;
+        tag.replace(QChar('\\'), QStringLiteral("\\\\"));
+        tag.replace(QChar('"'), QStringLiteral("\\\""));
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+        out << "{\"name\":\"" << tag
+            << "\",\"cat\":\"event\",\"ph\":\"" << phase
+            << "\",\"id2\":{\"local\":\"" << tag
+            << "\"},\"pid\":" << pid
+            << ",\"tid\":0,\"ts\":"
+            << QString::number(event.m_time.toDoubleMicros(), 'f', 3) << "}";
+    }
+    out << "\n]}\n";
+    timeline.close();
+}
+
 void StatsManager::onStatsPipeDestroyed(StatsPipe* pPipe) {
     const auto locker = lockMutex(&m_statsPipeLock);
     processIncomingStatReports();
@@ -78,6 +78,7 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
     StatsPipe* getStatsPipeForThread();
     void onStatsPipeDestroyed(StatsPipe* pPipe);
     void writeTimeline(const QString& filename);
+    void writeTimelineJson(const QString& filename);
 
     QAtomicInt m_emitAllStats;
     QAtomicInt m_quit;
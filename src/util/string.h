@@ -29,6 +29,12 @@ class StringCollator {
         return m_collator.compare(s1, s2);
     }
 
+    /// Sort keys compare like the strings, but much faster. Unlike
+    /// compare() they may also be compared concurrently.
+    QCollatorSortKey sortKey(const QString& s) const {
+        return m_collator.sortKey(s);
+    }
+
   private:
     QCollator m_collator;
 };
@@ -0,0 +1,476 @@
+#include "util/tracerecorder.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QMutex>
+#include <QTextStream>
+#include <algorithm>
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("TraceRecorder");
+
+// Buffers of finished threads are kept to include their events
+// in the trace. Only the most recent ones are kept to bound the
+// memory consumption for short-lived threads.
+constexpr int kMaxRetiredBuffers = 16;
+
+// Buffers are allocated upfront, because threads that record their
+// first event from a real-time context must neither lock nor allocate.
+// The snapshot thread replaces the spare buffers that have been taken.
+constexpr std::size_t kSpareBuffers = 4;
+
+// Multiple underflows typically occur in a row when the system is
+// overloaded. A single snapshot covers all of them.
+constexpr auto kMinSnapshotInterval = std::chrono::seconds(10);
+constexpr auto kSnapshotPollInterval = std::chrono::milliseconds(500);
+constexpr int kMaxSnapshots = 16;
+
+struct Record {
+    // All fields are atomic, because the ring buffer is read
+    // concurrently while being overwritten by the recording
+    // thread. Torn records are detected and discarded by the
+    // reader.
+    std::atomic<const char*> name{nullptr};
+    std::atomic<qint64> startNanos{0};
+    // -1 for instant events
+    std::atomic<qint64> durationNanos{0};
+};
+
+struct ThreadBuffer {
+    ThreadBuffer(int generation, int tid, int capacity)
+            : generation(generation),
+              tid(tid),
+              records(new Record[capacity]),
+              mask(capacity - 1),
+              head(0),
+              retired(false) {
+    }
+
+    const int generation;
+    const int tid;
+    // Guarded by the mutex of the recorder. Empty for the default name.
+    QString name;
+    const std::unique_ptr<Record[]> records;
+    const quint64 mask;
+    std::atomic<quint64> head;
+    std::atomic<bool> retired;
+};
+
+struct RecordCopy {
+    const char* name;
+    qint64 startNanos;
+    qint64 durationNanos;
+};
+
+class Recorder {
+  public:
+    ~Recorder() {
+        // The recorder might not have been disabled explicitly
+        if (snapshotThread.joinable()) {
+            {
+                std::lock_guard lock(snapshotMutex);
+                snapshotThreadStopping = true;
+            }
+            snapshotCondition.notify_all();
+            snapshotThread.join();
+        }
+    }
+
+    QMutex mutex;
+    QString filePath;
+    int capacity = 0;
+    qint64 epochNanos = 0;
+    int nextTid = 1;
+    // std::vector instead of QList, because QList of Qt 5 allocates
+    // a node when appending a std::shared_ptr
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::shared_ptr<ThreadBuffer>> spareBuffers;
+    // Buffers that are no longer part of the trace, but might still be
+    // referenced by their threads. The recorder keeps a reference until
+    // it holds the last one, so a thread never frees its buffer when it
+    // switches to a new one.
+    std::vector<std::shared_ptr<ThreadBuffer>> staleBuffers;
+
+    std::thread snapshotThread;
+    std::mutex snapshotMutex;
+    std::condition_variable snapshotCondition;
+    bool snapshotThreadStopping = false;
+    int snapshotCount = 0;
+};
+
+Recorder s_recorder;
+std::atomic<int> s_generation{0};
+std::atomic<bool> s_snapshotRequested{false};
+
+/// Owns the reference of a thread to its buffer and marks the
+/// buffer as retired when the thread finishes.
+class ThreadLocalBuffer {
+  public:
+    ~ThreadLocalBuffer() {
+        if (m_pBuffer) {
+            m_pBuffer->retired.store(true);
+        }
+    }
+
+    QString m_name;
+    std::shared_ptr<ThreadBuffer> m_pBuffer;
+};
+
+// Trivially destructible, so accessing it from a real-time thread
+// neither allocates nor registers a destructor
+thread_local ThreadLocalBuffer* t_pThreadLocalBuffer = nullptr;
+
+/// Constructs the thread-local state of the calling thread. The first
+/// call per thread registers its destructor, which may allocate.
+ThreadLocalBuffer* threadLocalBuffer() {
+    if (!t_pThreadLocalBuffer) {
+        thread_local ThreadLocalBuffer instance;
+        t_pThreadLocalBuffer = &instance;
+    }
+    return t_pThreadLocalBuffer;
+}
+
+/// Moves the buffers to the stale buffers and frees all stale buffers
+/// that are no longer referenced by their threads. Not real-time safe.
+void releaseBuffersLocked(std::vector<std::shared_ptr<ThreadBuffer>>* pBuffers) {
+    std::move(pBuffers->begin(),
+            pBuffers->end(),
+            std::back_inserter(s_recorder.staleBuffers));
+    pBuffers->clear();
+    const auto staleEnd = std::remove_if(
+            s_recorder.staleBuffers.begin(),
+            s_recorder.staleBuffers.end(),
+            [](const std::shared_ptr<ThreadBuffer>& pBuffer) {
+                return pBuffer.use_count() == 1;
+            });
+    // Synchronizes with the release of the last reference by a thread,
+    // which happens after its last write to the buffer
+    std::atomic_thread_fence(std::memory_order_acquire);
+    s_recorder.staleBuffers.erase(staleEnd, s_recorder.staleBuffers.end());
+}
+
+/// Allocates spare buffers until kSpareBuffers are available and drops
+/// the buffers of finished threads. Not real-time safe.
+void replenishSpareBuffersLocked(int generation) {
+    std::vector<std::shared_ptr<ThreadBuffer>> retiredBuffers;
+    int numRetired = 0;
+    for (auto i = s_recorder.buffers.size(); i-- > 0;) {
+        if (s_recorder.buffers[i]->retired.load() &&
+                ++numRetired > kMaxRetiredBuffers) {
+            retiredBuffers.push_back(std::move(s_recorder.buffers[i]));
+            s_recorder.buffers.erase(s_recorder.buffers.begin() + i);
+        }
+    }
+    releaseBuffersLocked(&retiredBuffers);
+    while (s_recorder.spareBuffers.size() < kSpareBuffers) {
+        s_recorder.spareBuffers.push_back(std::make_shared<ThreadBuffer>(
+                generation,
+                s_recorder.nextTid++,
+                s_recorder.capacity));
+    }
+    // Taking a spare buffer must not reallocate the list
+    s_recorder.buffers.reserve(s_recorder.buffers.size() + kSpareBuffers);
+}
+
+/// Hands a preallocated buffer to the calling thread. Real-time safe:
+/// Returns nullptr instead of waiting for the mutex or allocating if no
+/// spare buffer is available. The event is then dropped and the thread
+/// tries again with its next event.
+std::shared_ptr<ThreadBuffer> takeSpareBuffer(int generation, const QString& name) {
+    if (!s_recorder.mutex.tryLock()) {
+        return nullptr;
+    }
+    std::shared_ptr<ThreadBuffer> pBuffer;
+    if (TraceRecorder::isEnabled() &&
+            generation == s_generation.load() &&
+            !s_recorder.spareBuffers.empty()) {
+        pBuffer = std::move(s_recorder.spareBuffers.back());
+        s_recorder.spareBuffers.pop_back();
+        s_recorder.buffers.push_back(pBuffer);
+        // Spare buffers have no name, so assigning the shared string
+        // neither allocates nor frees
+        pBuffer->name = name;
+    }
+    s_recorder.mutex.unlock();
+    return pBuffer;
+}
+
+ThreadBuffer* currentThreadBuffer() {
+    ThreadLocalBuffer* pThreadLocalBuffer = threadLocalBuffer();
+    const int generation = s_generation.load(std::memory_order_relaxed);
+    if (!pThreadLocalBuffer->m_pBuffer ||
+            pThreadLocalBuffer->m_pBuffer->generation != generation) {
+        // Only once per thread and recording session. The recorder
+        // still references the previous buffer, which is not freed here.
+        pThreadLocalBuffer->m_pBuffer =
+                takeSpareBuffer(generation, pThreadLocalBuffer->m_name);
+    }
+    return pThreadLocalBuffer->m_pBuffer.get();
+}
+
+void record(const char* name, qint64 startNanos, qint64 durationNanos) {
+    ThreadBuffer* pBuffer = currentThreadBuffer();
+    if (!pBuffer) {
+        return;
+    }
+    const quint64 head = pBuffer->head.load(std::memory_order_relaxed);
+    Record& record = pBuffer->records[head & pBuffer->mask];
+    // The writer side of a seqlock: A reader that sees any of the
+    // following stores also sees the head that marks the slot as being
+    // overwritten, even on weakly ordered CPUs.
+    std::atomic_thread_fence(std::memory_order_release);
+    record.name.store(name, std::memory_order_relaxed);
+    record.startNanos.store(startNanos, std::memory_order_relaxed);
+    record.durationNanos.store(durationNanos, std::memory_order_relaxed);
+    pBuffer->head.store(head + 1, std::memory_order_release);
+}
+
+QList<RecordCopy> copyRecords(const ThreadBuffer& buffer) {
+    const quint64 capacity = buffer.mask + 1;
+    const quint64 headBefore = buffer.head.load(std::memory_order_acquire);
+    const quint64 begin = headBefore > capacity ? headBefore - capacity : 0;
+    QList<RecordCopy> records;
+    records.reserve(static_cast<int>(headBefore - begin));
+    for (quint64 i = begin; i < headBefore; ++i) {
+        const Record& record = buffer.records[i & buffer.mask];
+        records.append(RecordCopy{
+                record.name.load(std::memory_order_relaxed),
+                record.startNanos.load(std::memory_order_relaxed),
+                record.durationNanos.load(std::memory_order_relaxed)});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Records that have been overwritten while copying are discarded.
+    // This includes the slot at headAfter, which might have been
+    // partially overwritten by an event that is not published yet.
+    const quint64 headAfter = buffer.head.load(std::memory_order_relaxed);
+    const quint64 validBegin = headAfter + 1 > capacity ? headAfter + 1 - capacity : 0;
+    if (validBegin > begin) {
+        records.erase(records.begin(),
+                records.begin() +
+                        static_cast<int>(std::min(validBegin - begin,
+                                static_cast<quint64>(records.size()))));
+    }
+    return records;
+}
+
+QString jsonEscaped(const QString& str) {
+    QString escaped = str;
+    escaped.replace(QChar('\\'), QStringLiteral("\\\\"));
+    escaped.replace(QChar('"'), QStringLiteral("\\\""));
+    return escaped;
+}
+
+QString micros(qint64 nanos) {
+    return QString::number(static_cast<double>(nanos) / 1000, 'f', 3);
+}
+
+bool writeTrace(const QString& filePath) {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    QStringList threadNames;
+    qint64 epochNanos;
+    {
+        QMutexLocker locker(&s_recorder.mutex);
+        buffers = s_recorder.buffers;
+        for (const auto& pBuffer : std::as_const(buffers)) {
+            threadNames.append(pBuffer->name.isEmpty()
+                            ? QStringLiteral("Thread %1").arg(pBuffer->tid)
+                            : pBuffer->name);
+        }
+        epochNanos = s_recorder.epochNanos;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        kLogger.warning()
+                << "Failed to open trace file"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+    const auto pid = QCoreApplication::applicationPid();
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    for (int i = 0; i < threadNames.size(); ++i) {
+        const ThreadBuffer& buffer = *buffers[i];
+        if (i > 0) {
+            out << ",\n";
+        }
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+            << ",\"tid\":" << buffer.tid
+            << ",\"args\":{\"name\":\"" << jsonEscaped(threadNames[i]) << "\"}}";
+        const auto records = copyRecords(buffer);
+        for (const auto& record : records) {
+            if (!record.name) {
+                continue;
+            }
+            out << ",\n{\"name\":\"" << jsonEscaped(QString::fromUtf8(record.name))
+                << "\",\"cat\":\"mixxx\",\"pid\":" << pid
+                << ",\"tid\":" << buffer.tid
+                << ",\"ts\":" << micros(record.startNanos - epochNanos);
+            if (record.durationNanos < 0) {
+                out << ",\"ph\":\"i\",\"s\":\"t\"}";
+            } else {
+                out << ",\"ph\":\"X\",\"dur\":" << micros(record.durationNanos) << "}";
+            }
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    file.close();
+    kLogger.info() << "Wrote trace" << filePath;
+    return true;
+}
+
+QString snapshotFilePath(const QString& filePath, int snapshot) {
+    const QFileInfo fileInfo(filePath);
+    return fileInfo.dir().filePath(
+            QStringLiteral("%1-xrun%2.%3")
+                    .arg(fileInfo.completeBaseName(),
+                            QString::number(snapshot),
+                            fileInfo.suffix().isEmpty()
+                                    ? QStringLiteral("json")
+                                    : fileInfo.suffix()));
+}
+
+void runSnapshotThread() {
+    // Polling avoids waking up this thread from the audio thread
+    auto lastSnapshot = std::chrono::steady_clock::now() - kMinSnapshotInterval;
+    std::unique_lock lock(s_recorder.snapshotMutex);
+    while (!s_recorder.snapshotThreadStopping) {
+        s_recorder.snapshotCondition.wait_for(lock, kSnapshotPollInterval);
+        if (s_recorder.snapshotThreadStopping) {
+            break;
+        }
+        {
+            QMutexLocker locker(&s_recorder.mutex);
+            replenishSpareBuffersLocked(s_generation.load());
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastSnapshot < kMinSnapshotInterval ||
+                !s_snapshotRequested.exchange(false)) {
+            continue;
+        }
+        if (s_recorder.snapshotCount >= kMaxSnapshots) {
+            kLogger.warning()
+                    << "Maximum number of snapshots reached";
+            continue;
+        }
+        lastSnapshot = now;
+        const int snapshot = ++s_recorder.snapshotCount;
+        lock.unlock();
+        writeTrace(snapshotFilePath(s_recorder.filePath, snapshot));
+        lock.lock();
+    }
+}
+
+} // anonymous namespace
+
+//static
+std::atomic<bool> TraceRecorder::s_enabled{false};
+
+//static
+void TraceRecorder::enable(const QString& filePath, int eventsPerThread) {
+    VERIFY_OR_DEBUG_ASSERT(!isEnabled()) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(eventsPerThread > 0) {
+        eventsPerThread = kDefaultEventsPerThread;
+    }
+    int capacity = 1;
+    while (capacity < eventsPerThread) {
+        capacity <<= 1;
+    }
+    {
+        QMutexLocker locker(&s_recorder.mutex);
+        s_recorder.filePath = filePath;
+        s_recorder.capacity = capacity;
+        s_recorder.epochNanos = nowNanos();
+        releaseBuffersLocked(&s_recorder.buffers);
+        releaseBuffersLocked(&s_recorder.spareBuffers);
+        replenishSpareBuffersLocked(s_generation.fetch_add(1) + 1);
+        s_enabled.store(true);
+    }
+    s_snapshotRequested.store(false);
+    s_recorder.snapshotThreadStopping = false;
+    s_recorder.snapshotCount = 0;
+    s_recorder.snapshotThread = std::thread(runSnapshotThread);
+    kLogger.info()
+            << "Recording"
+            << capacity
+            << "events per thread, writing trace to"
+            << filePath;
+}
+
+//static
+void TraceRecorder::disable() {
+    if (!isEnabled()) {
+        return;
+    }
+    {
+        std::lock_guard lock(s_recorder.snapshotMutex);
+        s_recorder.snapshotThreadStopping = true;
+    }
+    s_recorder.snapshotCondition.notify_all();
+    s_recorder.snapshotThread.join();
+
+    s_enabled.store(false);
+    writeTrace(s_recorder.filePath);
+
+    QMutexLocker locker(&s_recorder.mutex);
+    // Invalidate the buffers of all threads. Buffers that are still
+    // referenced by their threads are freed when recording is enabled
+    // again or on exit.
+    s_generation.fetch_add(1);
+    releaseBuffersLocked(&s_recorder.buffers);
+    releaseBuffersLocked(&s_recorder.spareBuffers);
+}
+
+//static
+void TraceRecorder::recordComplete(
+        const char* name, qint64 startNanos, qint64 durationNanos) {
+    DEBUG_ASSERT(durationNanos >= 0);
+    record(name, startNanos, durationNanos);
+}
+
+//static
+void TraceRecorder::recordInstant(const char* name) {
+    if (!isEnabled()) {
+        return;
+    }
+    record(name, nowNanos(), -1);
+}
+
+//static
+void TraceRecorder::requestSnapshot() {
+    if (!isEnabled()) {
+        return;
+    }
+    s_snapshotRequested.store(true, std::memory_order_relaxed);
+}
+
+//static
+void TraceRecorder::registerCurrentThread(const QString& name) {
+    ThreadLocalBuffer* pThreadLocalBuffer = threadLocalBuffer();
+    QMutexLocker locker(&s_recorder.mutex);
+    pThreadLocalBuffer->m_name = name;
+    if (pThreadLocalBuffer->m_pBuffer) {
+        pThreadLocalBuffer->m_pBuffer->name = name;
+    }
+}
+
+} // namespace mixxx
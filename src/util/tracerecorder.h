@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+
+namespace mixxx {
+
+/// A flight recorder for timing events that are exported in the
+/// Chrome trace-event JSON format, which can be opened with Perfetto
+/// (https://ui.perfetto.dev) or chrome://tracing.
+///
+/// Each thread records its events into its own fixed-size ring buffer
+/// that overwrites the oldest events. Recording an event neither locks
+/// nor allocates, so it is cheap enough to keep enabled permanently.
+/// The buffers are allocated in advance and handed to each thread on
+/// its first event. Events of a thread that finds no spare buffer are
+/// dropped until the spare buffers have been replenished. Buffers are
+/// only ever freed by the recorder, never by a recording thread.
+///
+/// Threads that record events from a real-time context must call
+/// registerCurrentThread() in advance, because the first use of the
+/// thread-local state allocates. Other threads are registered on their
+/// first event.
+///
+/// Event names must be string literals or otherwise outlive the recorder,
+/// because only the pointer is recorded.
+///
+/// When tracing is enabled a snapshot of all buffers is written after each
+/// audio buffer underflow and when the recorder is disabled on shutdown.
+class TraceRecorder final {
+  public:
+    static constexpr int kDefaultEventsPerThread = 1 << 14;
+
+    /// Starts recording. The final trace is written to filePath,
+    /// snapshots are written next to it.
+    static void enable(
+            const QString& filePath,
+            int eventsPerThread = kDefaultEventsPerThread);
+    /// Stops recording and writes the final trace.
+    static void disable();
+
+    static bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    static qint64 nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+    }
+
+    /// Records an event with a duration. Lock-free.
+    static void recordComplete(const char* name, qint64 startNanos, qint64 durationNanos);
+    /// Records an event without a duration. Lock-free.
+    static void recordInstant(const char* name);
+
+    /// Requests to write a snapshot of the recorded events, e.g. after an
+    /// xrun. Only sets a flag and is safe to call from the audio thread.
+    static void requestSnapshot();
+
+    /// Registers the calling thread and sets its name in the trace,
+    /// which by default is "Thread <n>". May be called before recording
+    /// is enabled and again to rename the thread. Not real-time safe.
+    static void registerCurrentThread(const QString& name);
+
+  private:
+    static std::atomic<bool> s_enabled;
+};
+
+/// Records the lifetime of the scope as a trace event if the
+/// TraceRecorder is enabled.
+class ScopedTraceEvent final {
+  public:
+    explicit ScopedTraceEvent(const char* name)
+            : m_name(TraceRecorder::isEnabled() ? name : nullptr),
+              m_startNanos(m_name ? TraceRecorder::nowNanos() : 0) {
+    }
+    ~ScopedTraceEvent() {
+        if (m_name) {
+            TraceRecorder::recordComplete(m_name,
+                    m_startNanos,
+                    TraceRecorder::nowNanos() - m_startNanos);
+        }
+    }
+
+  private:
+    ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+    ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+    const char* const m_name;
+    const qint64 m_startNanos;
+};
+
+} // namespace mixxx
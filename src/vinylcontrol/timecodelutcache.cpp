@@ -0,0 +1,162 @@
+#include "vinylcontrol/timecodelutcache.h"
+
+#include <QDir>
+#include <QSaveFile>
+#include <cstring>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TimecodeLutCache");
+
+constexpr char kMagic[8] = {'M', 'X', 'X', 'W', 'X', 'L', 'U', 'T'};
+// Increment when the layout of the file or of the xwax tables changes
+constexpr quint32 kVersion = 1;
+// Detects files that have been written on a machine with another byte order
+constexpr quint32 kByteOrderMark = 0x01020304;
+constexpr quint32 kNumHashes = 1u << LUT_HASH_BITS;
+
+// Followed by the hash table and the slots of the xwax lut
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    // The parameters of the timecode that determine the table
+    quint32 bits;
+    quint32 seed;
+    quint32 taps;
+    quint32 length;
+    // The layout of the table
+    quint32 numHashes;
+    quint32 slotSize;
+    quint32 reserved[2];
+};
+static_assert(sizeof(FileHeader) % alignof(struct slot) == 0,
+        "The hash table and the slots must be aligned");
+
+FileHeader makeHeader(const timecode_def& def) {
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.bits = static_cast<quint32>(def.bits);
+    header.seed = def.seed;
+    header.taps = def.taps;
+    header.length = def.length;
+    header.numHashes = kNumHashes;
+    header.slotSize = sizeof(struct slot);
+    return header;
+}
+
+qint64 tableSize() {
+    return static_cast<qint64>(sizeof(slot_no_t)) * kNumHashes;
+}
+
+qint64 slotsSize(const timecode_def& def) {
+    return static_cast<qint64>(sizeof(struct slot)) * def.length;
+}
+
+quint32 hashOf(unsigned int timecode) {
+    return timecode & (kNumHashes - 1);
+}
+
+// The slot numbers are followed by xwax without any checks, so a damaged
+// file must neither refer to slots outside of the table nor contain
+// cycles. The table refers to the most recently pushed slot with each
+// hash, which refers to the previously pushed slot with the same hash.
+bool isValidTable(const slot_no_t* pTable, const struct slot* pSlots, quint32 numSlots) {
+    for (quint32 hash = 0; hash < kNumHashes; ++hash) {
+        const slot_no_t slotNo = pTable[hash];
+        if (slotNo != LUT_NO_SLOT &&
+                (slotNo >= numSlots || hashOf(pSlots[slotNo].timecode) != hash)) {
+            return false;
+        }
+    }
+    for (quint32 i = 0; i < numSlots; ++i) {
+        const slot_no_t next = pSlots[i].next;
+        if (next != LUT_NO_SLOT &&
+                (next >= i || hashOf(pSlots[next].timecode) != hashOf(pSlots[i].timecode))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TimecodeLutCache::TimecodeLutCache(const QString& directory)
+        : m_directory(directory) {
+}
+
+bool TimecodeLutCache::load(timecode_def* pDef) {
+    DEBUG_ASSERT(!pDef->lookup);
+    auto pFile = std::make_unique<QFile>(filePath(*pDef));
+    if (!pFile->exists()) {
+        return false;
+    }
+    const qint64 expectedSize =
+            static_cast<qint64>(sizeof(FileHeader)) + tableSize() + slotsSize(*pDef);
+    if (pFile->size() != expectedSize || !pFile->open(QIODevice::ReadOnly)) {
+        kLogger.warning() << "Ignoring invalid file" << pFile->fileName();
+        return false;
+    }
+    uchar* pData = pFile->map(0, expectedSize);
+    if (!pData) {
+        kLogger.warning() << "Failed to map" << pFile->fileName() << pFile->errorString();
+        return false;
+    }
+
+    const FileHeader expectedHeader = makeHeader(*pDef);
+    if (std::memcmp(pData, &expectedHeader, sizeof(FileHeader)) != 0) {
+        kLogger.info() << "Ignoring outdated file" << pFile->fileName();
+        return false;
+    }
+    auto* pTable = reinterpret_cast<slot_no_t*>(pData + sizeof(FileHeader));
+    auto* pSlots = reinterpret_cast<struct slot*>(
+            pData + sizeof(FileHeader) + tableSize());
+    if (!isValidTable(pTable, pSlots, pDef->length)) {
+        kLogger.warning() << "Ignoring damaged file" << pFile->fileName();
+        return false;
+    }
+
+    timecoder_set_lookup(pDef, pSlots, pTable);
+    kLogger.info() << "Mapped lookup table for" << pDef->name << "from"
+                   << pFile->fileName();
+    m_mappedFiles.push_back(std::move(pFile));
+    return true;
+}
+
+bool TimecodeLutCache::store(const timecode_def& def) const {
+    VERIFY_OR_DEBUG_ASSERT(def.lookup) {
+        return false;
+    }
+    if (!QDir().mkpath(m_directory)) {
+        kLogger.warning() << "Failed to create directory" << m_directory;
+        return false;
+    }
+    // Written to a temporary file that replaces the cache file on commit,
+    // so a concurrent reader never sees a partial table
+    QSaveFile file(filePath(def));
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to open" << file.fileName() << file.errorString();
+        return false;
+    }
+    const FileHeader header = makeHeader(def);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(def.lut.table), tableSize());
+    file.write(reinterpret_cast<const char*>(def.lut.slot), slotsSize(def));
+    if (!file.commit()) {
+        kLogger.warning() << "Failed to write" << file.fileName() << file.errorString();
+        return false;
+    }
+    kLogger.info() << "Stored lookup table for" << def.name << "in" << file.fileName();
+    return true;
+}
+
+QString TimecodeLutCache::filePath(const timecode_def& def) const {
+    return QDir(m_directory).filePath(QString::fromLatin1(def.name) +
+            QStringLiteral(".lut"));
+}
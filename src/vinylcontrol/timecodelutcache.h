@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <memory>
+#include <vector>
+
+#ifdef _MSC_VER
+#include "timecoder.h"
+#else
+extern "C" {
+#include "timecoder.h"
+}
+#endif
+
+/// Stores the lookup tables of the xwax timecodes in files, because
+/// generating them for the long timecodes takes several seconds.
+///
+/// A cached table is mapped read-only into memory instead of being
+/// generated again, and the mapping is shared by all decks that use the
+/// timecode. The files are versioned and are rewritten if they do not
+/// match the timecode definition or the layout of the table.
+///
+/// Not thread-safe, VinylControlXwax guards it with its LUT mutex.
+class TimecodeLutCache {
+  public:
+    explicit TimecodeLutCache(const QString& directory);
+
+    /// Maps the cached table of the timecode and hands it over to xwax.
+    /// Returns false if there is no valid cache file.
+    bool load(timecode_def* pDef);
+    /// Writes the table that xwax has generated for the timecode.
+    bool store(const timecode_def& def) const;
+
+  private:
+    QString filePath(const timecode_def& def) const;
+
+    const QString m_directory;
+    // The files stay open while their tables are in use by xwax
+    std::vector<std::unique_ptr<QFile>> m_mappedFiles;
+};
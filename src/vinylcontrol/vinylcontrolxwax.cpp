@@ -1,5 +1,6 @@
 #include "vinylcontrol/vinylcontrolxwax.h"
 
+#include <QDir>
 #include <QtDebug>
 
 #include "audio/types.h"
@@ -11,6 +12,7 @@
 #include "util/timer.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 #include "vinylcontrol/steadypitch.h"
+#include "vinylcontrol/timecodelutcache.h"
 #include "vinylcontrol/vinylsignalquality.h"
 
 /****** TODO *******
@@ -23,6 +25,8 @@
 
 namespace {
 constexpr int kChannels = 2;
+
+const QString kLUTCacheDirectory = QStringLiteral("vinylcontrol");
 } // namespace
 
 // Sample threshold below which we consider there to be no signal.
@@ -30,6 +34,7 @@ constexpr double kMinSignal = 75.0 / SAMPLE_MAXIMUM;
 
 bool VinylControlXwax::s_bLUTInitialized = false;
 QMutex VinylControlXwax::s_xwaxLUTMutex;
+std::unique_ptr<TimecodeLutCache> VinylControlXwax::s_pLUTCache;
 
 VinylControlXwax::VinylControlXwax(UserSettingsPointer pConfig, const QString& group)
         : VinylControl(pConfig, group),
@@ -117,14 +122,6 @@ VinylControlXwax::VinylControlXwax(UserSettingsPointer pConfig, const QString& g
         m_pSteadyGross = new SteadyPitch(0.5, false);
     }
 
-    timecode_def* tc_def = timecoder_find_definition(timecode);
-    if (tc_def == nullptr) {
-        qDebug() << "Error finding timecode definition for " << timecode
-                 << ", defaulting to" << MIXXX_VINYL_DEFAULT_XWAX_NAME;
-        timecode = MIXXX_VINYL_DEFAULT_XWAX_NAME;
-        tc_def = timecoder_find_definition(timecode);
-    }
-
     double speed = 1.0;
     double rpm = 100.0 / 3.0;
     if (strVinylSpeed == MIXXX_VINYL_SPEED_45) {
@@ -149,12 +146,20 @@ VinylControlXwax::VinylControlXwax(UserSettingsPointer pConfig, const QString& g
     m_pPitchRing.resize(m_iPitchRingSize);
 
     qDebug() << "Xwax Vinyl control starting with a sample rate of:" << sampleRate;
-    qDebug() << "Building timecode lookup tables for" << strVinylType << "with speed" << strVinylSpeed;
+    qDebug() << "Loading timecode lookup tables for" << strVinylType << "with speed" << strVinylSpeed;
 
     // Initialize the timecoder structure. Use the static mutex so that we only
     // do this once across the VinylControlXwax instances.
     s_xwaxLUTMutex.lock();
 
+    timecode_def* tc_def = findTimecodeDefinition(timecode, m_pConfig->getSettingsPath());
+    if (tc_def == nullptr) {
+        qDebug() << "Error finding timecode definition for " << timecode
+                 << ", defaulting to" << MIXXX_VINYL_DEFAULT_XWAX_NAME;
+        timecode = MIXXX_VINYL_DEFAULT_XWAX_NAME;
+        tc_def = findTimecodeDefinition(timecode, m_pConfig->getSettingsPath());
+    }
+
     timecoder_init(&timecoder, tc_def, speed, sampleRate.value(), /* phono */ false);
     timecoder_monitor_init(&timecoder, MIXXX_VINYL_SCOPE_SIZE);
     //Note that timecoder_init will not double-malloc the LUTs, and after this we are guaranteed
@@ -175,13 +180,33 @@ VinylControlXwax::~VinylControlXwax() {
     timecoder_monitor_clear(&timecoder);
     timecoder_clear(&timecoder);
 
-    // TODO(rryan): This looks wrong. freeLUTs is called later by
-    // VinylControlProcessor so we are probably leaking the LUTs.
-    s_bLUTInitialized = false;
-
     m_pVCRate->set(0.0);
 }
 
+//static
+timecode_def* VinylControlXwax::findTimecodeDefinition(
+        const char* timecode, const QString& settingsPath) {
+    timecode_def* tc_def = timecoder_find_definition_without_lookup(timecode);
+    if (tc_def == nullptr || tc_def->lookup) {
+        return tc_def;
+    }
+
+    // Generating the tables of the long timecodes takes several seconds,
+    // so they are only generated once and mapped in later sessions.
+    if (!s_pLUTCache) {
+        s_pLUTCache = std::make_unique<TimecodeLutCache>(
+                QDir(settingsPath).filePath(kLUTCacheDirectory));
+    }
+    if (!s_pLUTCache->load(tc_def)) {
+        if (timecoder_build_lookup(tc_def) == -1) {
+            return nullptr;
+        }
+        s_pLUTCache->store(*tc_def);
+    }
+    s_bLUTInitialized = true;
+    return tc_def;
+}
+
 //static
 void VinylControlXwax::freeLUTs() {
     s_xwaxLUTMutex.lock(); //Static mutex! We don't want two threads doing this!
@@ -189,6 +214,8 @@ void VinylControlXwax::freeLUTs() {
         timecoder_free_lookup(); //Frees all the LUTs in xwax.
         s_bLUTInitialized = false;
     }
+    // Unmaps the cached LUTs after xwax has forgotten them
+    s_pLUTCache.reset();
     s_xwaxLUTMutex.unlock();
 }
 
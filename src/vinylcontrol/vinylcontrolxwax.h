@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QMutex>
+#include <memory>
 #include <vector>
 
 #include "util/types.h"
@@ -20,6 +21,7 @@ extern "C" {
 
 class ControlProxy;
 class SteadyPitch;
+class TimecodeLutCache;
 struct VinylSignalQualityReport;
 
 class VinylControlXwax : public VinylControl {
@@ -37,6 +39,12 @@ class VinylControlXwax : public VinylControl {
     float getAngle();
 
   private:
+    // Returns the definition of the timecode with its lookup table, which
+    // is mapped from the cache or generated once. Must be called with
+    // s_xwaxLUTMutex locked.
+    static timecode_def* findTimecodeDefinition(
+            const char* timecode, const QString& settingsPath);
+
     void syncPosition();
     void togglePlayButton(bool on);
     bool checkEnabled(bool was, bool is);
@@ -151,4 +159,5 @@ class VinylControlXwax : public VinylControl {
     // Static mutex that protects our creation/destruction of the xwax LUTs
     static QMutex s_xwaxLUTMutex;
     static bool s_bLUTInitialized;
+    static std::unique_ptr<TimecodeLutCache> s_pLUTCache;
 };
@@ -44,13 +44,7 @@ bool WaveformRendererFiltered::preprocessInner() {
         return false;
     }
 
-    const int dataSize = waveform->getDataSize();
-    if (dataSize <= 1) {
-        return false;
-    }
-
-    const WaveformData* data = waveform->data();
-    if (data == nullptr) {
+    if (waveform->getDataSize() <= 1) {
         return false;
     }
 #ifdef __STEM__
@@ -68,11 +62,23 @@ bool WaveformRendererFiltered::preprocessInner() {
     const float halfPixelSize = 0.5f / devicePixelRatio;
 
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
-    const int visualFramesSize = dataSize / 2;
-    const double firstVisualFrame =
-            m_waveformRenderer->getFirstDisplayedPosition() * visualFramesSize;
-    const double lastVisualFrame =
-            m_waveformRenderer->getLastDisplayedPosition() * visualFramesSize;
+    const double firstDisplayedPosition =
+            m_waveformRenderer->getFirstDisplayedPosition();
+    const double lastDisplayedPosition =
+            m_waveformRenderer->getLastDisplayedPosition();
+    // Read the mip level that matches the zoom factor, so that the number
+    // of visual frames per pixel stays bounded when zooming out.
+    const int mipLevel = waveform->selectMipLevel(
+            (lastDisplayedPosition - firstDisplayedPosition) *
+            (waveform->getDataSize() / 2) / pixelLength);
+    const WaveformData* data = waveform->getMipLevelData(mipLevel);
+    if (data == nullptr) {
+        return false;
+    }
+    const int dataSize = waveform->getMipLevelDataSize(mipLevel);
+    const double visualFramesSize = waveform->getDataSize() / 2.0 / (1 << mipLevel);
+    const double firstVisualFrame = firstDisplayedPosition * visualFramesSize;
+    const double lastVisualFrame = lastDisplayedPosition * visualFramesSize;
 
     // Represents the # of visual frames per horizontal pixel.
     const double visualIncrementPerPixel =
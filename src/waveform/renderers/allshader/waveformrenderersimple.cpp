@@ -42,13 +42,7 @@ bool WaveformRendererSimple::preprocessInner() {
         return false;
     }
 
-    const int dataSize = waveform->getDataSize();
-    if (dataSize <= 1) {
-        return false;
-    }
-
-    const WaveformData* data = waveform->data();
-    if (data == nullptr) {
+    if (waveform->getDataSize() <= 1) {
         return false;
     }
 #ifdef __STEM__
@@ -69,12 +63,24 @@ bool WaveformRendererSimple::preprocessInner() {
     //
     // WaveformData* data contains the L and R waveform values interleaved. In the calculations
     // below, 'frame' refers to the index of such an L-R pair.
-    const int visualFramesSize = dataSize / 2;
+    const double firstDisplayedPosition =
+            m_waveformRenderer->getFirstDisplayedPosition();
+    const double lastDisplayedPosition =
+            m_waveformRenderer->getLastDisplayedPosition();
+    // Read the mip level that matches the zoom factor, so that the number
+    // of visual frames per pixel stays bounded when zooming out.
+    const int mipLevel = waveform->selectMipLevel(
+            (lastDisplayedPosition - firstDisplayedPosition) *
+            (waveform->getDataSize() / 2) / pixelLength);
+    const WaveformData* data = waveform->getMipLevelData(mipLevel);
+    if (data == nullptr) {
+        return false;
+    }
+    const int dataSize = waveform->getMipLevelDataSize(mipLevel);
+    const double visualFramesSize = waveform->getDataSize() / 2.0 / (1 << mipLevel);
     // Calculate the first and last frame to draw, from the normalized display position
-    const double firstVisualFrame =
-            m_waveformRenderer->getFirstDisplayedPosition() * visualFramesSize;
-    const double lastVisualFrame =
-            m_waveformRenderer->getLastDisplayedPosition() * visualFramesSize;
+    const double firstVisualFrame = firstDisplayedPosition * visualFramesSize;
+    const double lastVisualFrame = lastDisplayedPosition * visualFramesSize;
 
     // Represents the # of visual frames per horizontal pixel.
     const double visualIncrementPerPixel =
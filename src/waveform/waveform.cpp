@@ -1,13 +1,92 @@
 #include "waveform/waveform.h"
 
 #include <QtDebug>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <memory>
 
 #include "analyzer/constants.h"
 #include "engine/engine.h"
+#include "musicbrainz/crc.h"
 #include "proto/waveform.pb.h"
+#include "util/assert.h"
 
 using namespace mixxx::track;
 
+namespace {
+
+// Layout of the columnar storage format. All values are stored in
+// little endian byte order.
+//
+//   offset  type     content
+//   ------  -------  ----------------------------------------------
+//        0  char[4]  magic "MXWF"
+//        4  quint32  format version
+//        8  quint32  header size in bytes, i.e. the offset of the bands
+//       12  quint32  data size, i.e. the number of values per band
+//       16  quint32  stem count
+//       20  quint32  CRC-32 of all bands
+//       24  double   visual sample rate
+//       32  double   audio/visual ratio
+//
+// The header is followed by the bands all, low, mid, high, and one band
+// for each stem. Each band consists of data size values with one byte
+// per value.
+constexpr char kColumnarMagic[4] = {'M', 'X', 'W', 'F'};
+// Version 2 replaced the 16-bit checksum of the bands with a CRC-32
+constexpr quint32 kColumnarVersion = 2;
+constexpr int kColumnarVersionOffset = 4;
+constexpr int kColumnarHeaderSizeOffset = 8;
+constexpr int kColumnarDataSizeOffset = 12;
+constexpr int kColumnarStemCountOffset = 16;
+constexpr int kColumnarChecksumOffset = 20;
+constexpr int kColumnarVisualSampleRateOffset = 24;
+constexpr int kColumnarAudioVisualRatioOffset = 32;
+constexpr int kColumnarHeaderSize = 40;
+
+quint32 readUInt32(const char* pHeader, int offset) {
+    return qFromLittleEndian<quint32>(pHeader + offset);
+}
+
+double readDouble(const char* pHeader, int offset) {
+    const quint64 bits = qFromLittleEndian<quint64>(pHeader + offset);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void writeUInt32(char* pHeader, int offset, quint32 value) {
+    qToLittleEndian<quint32>(value, pHeader + offset);
+}
+
+void writeDouble(char* pHeader, int offset, double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint64>(bits, pHeader + offset);
+}
+
+WaveformData maxWaveformData(const WaveformData& lhs, const WaveformData& rhs) {
+    WaveformData result;
+    result.filtered.low = std::max(lhs.filtered.low, rhs.filtered.low);
+    result.filtered.mid = std::max(lhs.filtered.mid, rhs.filtered.mid);
+    result.filtered.high = std::max(lhs.filtered.high, rhs.filtered.high);
+    result.filtered.all = std::max(lhs.filtered.all, rhs.filtered.all);
+    for (int stemIdx = 0; stemIdx < mixxx::kMaxSupportedStems; ++stemIdx) {
+        result.stems[stemIdx] = std::max(lhs.stems[stemIdx], rhs.stems[stemIdx]);
+    }
+    return result;
+}
+
+quint32 crc32(const char* pData, qsizetype size) {
+    const crc_t crc = crc_update(crc_init(),
+            reinterpret_cast<const unsigned char*>(pData),
+            static_cast<size_t>(size));
+    return static_cast<quint32>(crc_finalize(crc));
+}
+
+} // anonymous namespace
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -25,7 +104,8 @@ Waveform::Waveform(const QByteArray& data)
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
-          m_completion(-1) {
+          m_completion(-1),
+          m_stemCount(0) {
     readByteArray(data);
 }
 
@@ -74,6 +154,7 @@ Waveform::Waveform(
 }
 
 Waveform::~Waveform() {
+    delete m_pMipLevels.loadAcquire();
 }
 
 QByteArray Waveform::toByteArray() const {
@@ -151,11 +232,134 @@ QByteArray Waveform::toByteArray() const {
     return QByteArray(output.data(), static_cast<int>(output.length()));
 }
 
+QByteArray Waveform::toColumnarByteArray() const {
+    const int dataSize = getDataSize();
+    const int bandCount = BandCount + m_stemCount;
+    QByteArray data(kColumnarHeaderSize + bandCount * dataSize, Qt::Uninitialized);
+
+    char* pHeader = data.data();
+    auto* pAll = reinterpret_cast<unsigned char*>(pHeader + kColumnarHeaderSize);
+    unsigned char* pLow = pAll + dataSize;
+    unsigned char* pMid = pLow + dataSize;
+    unsigned char* pHigh = pMid + dataSize;
+    unsigned char* pStems = pHigh + dataSize;
+    for (int i = 0; i < dataSize; ++i) {
+        const WaveformData& datum = m_data[i];
+        pAll[i] = datum.filtered.all;
+        pLow[i] = datum.filtered.low;
+        pMid[i] = datum.filtered.mid;
+        pHigh[i] = datum.filtered.high;
+        for (int stemIdx = 0; stemIdx < m_stemCount; ++stemIdx) {
+            pStems[stemIdx * dataSize + i] = datum.stems[stemIdx];
+        }
+    }
+
+    std::memcpy(pHeader, kColumnarMagic, sizeof(kColumnarMagic));
+    writeUInt32(pHeader, kColumnarVersionOffset, kColumnarVersion);
+    writeUInt32(pHeader, kColumnarHeaderSizeOffset, kColumnarHeaderSize);
+    writeUInt32(pHeader, kColumnarDataSizeOffset, dataSize);
+    writeUInt32(pHeader, kColumnarStemCountOffset, m_stemCount);
+    writeUInt32(pHeader,
+            kColumnarChecksumOffset,
+            crc32(pHeader + kColumnarHeaderSize, bandCount * dataSize));
+    writeDouble(pHeader, kColumnarVisualSampleRateOffset, m_visualSampleRate);
+    writeDouble(pHeader, kColumnarAudioVisualRatioOffset, m_audioVisualRatio);
+
+    return data;
+}
+
+// static
+int Waveform::columnarHeaderSize(const QByteArray& data) {
+    if (data.size() < kColumnarHeaderSize ||
+            std::memcmp(data.constData(), kColumnarMagic, sizeof(kColumnarMagic)) != 0) {
+        return 0;
+    }
+    // Future versions may extend the header
+    const quint32 headerSize = readUInt32(data.constData(), kColumnarHeaderSizeOffset);
+    if (headerSize < kColumnarHeaderSize ||
+            headerSize > static_cast<quint32>(data.size())) {
+        return 0;
+    }
+    return static_cast<int>(headerSize);
+}
+
+// static
+quint32 Waveform::columnarHeaderChecksum(const QByteArray& data) {
+    const int headerSize = columnarHeaderSize(data);
+    DEBUG_ASSERT(headerSize > 0);
+    return crc32(data.constData(), headerSize);
+}
+
 void Waveform::readByteArray(const QByteArray& data) {
     if (data.isNull()) {
         return;
     }
 
+    if (columnarHeaderSize(data) > 0) {
+        readColumnarByteArray(data);
+    } else {
+        readProtobufByteArray(data);
+    }
+}
+
+void Waveform::readColumnarByteArray(const QByteArray& data) {
+    const int headerSize = columnarHeaderSize(data);
+    DEBUG_ASSERT(headerSize > 0);
+    const char* pHeader = data.constData();
+
+    const quint32 version = readUInt32(pHeader, kColumnarVersionOffset);
+    if (version != kColumnarVersion) {
+        qDebug() << "ERROR: Unsupported columnar waveform version" << version;
+        return;
+    }
+
+    const quint32 dataSize = readUInt32(pHeader, kColumnarDataSizeOffset);
+    const quint32 stemCount = readUInt32(pHeader, kColumnarStemCountOffset);
+    if (stemCount > static_cast<quint32>(mixxx::kMaxSupportedStems)) {
+        qDebug() << "ERROR: Columnar waveform has too many stems:" << stemCount;
+        return;
+    }
+    const qint64 bandsSize = static_cast<qint64>(BandCount + stemCount) * dataSize;
+    if (bandsSize > data.size() - headerSize) {
+        qDebug() << "ERROR: Columnar waveform is truncated:"
+                 << "expected" << bandsSize << "bytes"
+                 << "actual" << data.size() - headerSize << "bytes";
+        return;
+    }
+    const char* pBands = pHeader + headerSize;
+    if (crc32(pBands, bandsSize) != readUInt32(pHeader, kColumnarChecksumOffset)) {
+        qDebug() << "ERROR: Columnar waveform checksum mismatch. Skipping.";
+        return;
+    }
+
+    m_visualSampleRate = readDouble(pHeader, kColumnarVisualSampleRateOffset);
+    m_audioVisualRatio = readDouble(pHeader, kColumnarAudioVisualRatioOffset);
+    m_stemCount = static_cast<int>(stemCount);
+
+    resize(static_cast<int>(dataSize));
+
+    const auto* pAll = reinterpret_cast<const unsigned char*>(pBands);
+    const unsigned char* pLow = pAll + dataSize;
+    const unsigned char* pMid = pLow + dataSize;
+    const unsigned char* pHigh = pMid + dataSize;
+    const unsigned char* pStems = pHigh + dataSize;
+    for (int i = 0; i < m_dataSize; ++i) {
+        WaveformData& datum = m_data[i];
+        datum.filtered.all = pAll[i];
+        datum.filtered.low = pLow[i];
+        datum.filtered.mid = pMid[i];
+        datum.filtered.high = pHigh[i];
+        for (int stemIdx = 0; stemIdx < m_stemCount; ++stemIdx) {
+            datum.stems[stemIdx] = pStems[stemIdx * dataSize + i];
+        }
+    }
+
+    m_completion = m_dataSize;
+    m_saveState = SaveState::Saved;
+    buildMipLevels();
+}
+
+void Waveform::readProtobufByteArray(const QByteArray& data) {
     io::Waveform waveform;
 
     if (!waveform.ParseFromArray(data.constData(), data.size())) {
@@ -235,7 +439,75 @@ void Waveform::readByteArray(const QByteArray& data) {
     }
 
     m_completion = dataSize;
-    m_saveState = SaveState::Saved;
+    // Waveforms that have been stored in the legacy protobuf format are
+    // migrated to the columnar format when the analyses of the track are
+    // saved the next time.
+    m_saveState = SaveState::SavePending;
+    buildMipLevels();
+}
+
+void Waveform::buildMipLevels() {
+    if (m_pMipLevels.loadAcquire()) {
+        return;
+    }
+    auto pMipLevels = std::make_unique<MipLevels>();
+    const WaveformData* pSource = m_data.data();
+    int sourceFrames = m_dataSize / ChannelCount;
+    while (sourceFrames > 1) {
+        const int frames = (sourceFrames + 1) / 2;
+        std::vector<WaveformData> level(frames * ChannelCount);
+        for (int frame = 0; frame < frames; ++frame) {
+            // An odd trailing frame is carried over unmodified
+            const int first = 2 * frame * ChannelCount;
+            const int second = 2 * frame + 1 < sourceFrames
+                    ? first + ChannelCount
+                    : first;
+            for (int chn = 0; chn < ChannelCount; ++chn) {
+                level[frame * ChannelCount + chn] = maxWaveformData(
+                        pSource[first + chn], pSource[second + chn]);
+            }
+        }
+        pMipLevels->push_back(std::move(level));
+        // Moving a vector preserves its buffer
+        pSource = pMipLevels->back().data();
+        sourceFrames = frames;
+    }
+    m_pMipLevels.storeRelease(pMipLevels.release());
+}
+
+int Waveform::selectMipLevel(double visualFramesPerPixel) const {
+    const MipLevels* pMipLevels = m_pMipLevels.loadAcquire();
+    if (!pMipLevels) {
+        return 0;
+    }
+    int level = 0;
+    while (level < static_cast<int>(pMipLevels->size()) &&
+            (2 << level) <= visualFramesPerPixel) {
+        ++level;
+    }
+    return level;
+}
+
+const WaveformData* Waveform::getMipLevelData(int level) const {
+    if (level == 0) {
+        return data();
+    }
+    const MipLevels* pMipLevels = m_pMipLevels.loadAcquire();
+    VERIFY_OR_DEBUG_ASSERT(pMipLevels && level <= static_cast<int>(pMipLevels->size())) {
+        return nullptr;
+    }
+    return (*pMipLevels)[level - 1].data();
+}
+
+int Waveform::getMipLevelDataSize(int level) const {
+    if (level == 0) {
+        return getDataSize();
+    }
+    const MipLevels* pMipLevels = m_pMipLevels.loadAcquire();
+    VERIFY_OR_DEBUG_ASSERT(pMipLevels && level <= static_cast<int>(pMipLevels->size())) {
+        return 0;
+    }
+    return static_cast<int>((*pMipLevels)[level - 1].size());
 }
 
 void Waveform::resize(int size) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QAtomicInt>
+#include <QAtomicPointer>
 #include <QByteArray>
 #include <QMutex>
 #include <QSharedPointer>
@@ -79,8 +80,27 @@ class Waveform {
         m_description = description;
     }
 
+    // Serializes the waveform as an io::Waveform protobuf message.
     QByteArray toByteArray() const;
 
+    // Serializes the waveform in the uncompressed, columnar storage
+    // format: A fixed size header followed by the values of each band
+    // (all, low, mid, high, and stems) stored contiguously. This format
+    // can be read from a memory mapped file without inflating or parsing,
+    // but the bands are still copied into the interleaved in-memory
+    // layout. The constructor accepts both formats.
+    QByteArray toColumnarByteArray() const;
+
+    // Returns the size of the header if data starts with a valid header
+    // of the columnar format or 0 otherwise. The header contains a CRC-32
+    // of the following band data that is verified when the waveform is read.
+    static int columnarHeaderSize(const QByteArray& data);
+
+    // The CRC-32 of the header of data in the columnar format. It covers
+    // the CRC-32 of the bands, so the bands themselves are only read when
+    // the waveform is decoded.
+    static quint32 columnarHeaderChecksum(const QByteArray& data);
+
     SaveState saveState() const {
         return m_saveState;
     }
@@ -137,10 +157,29 @@ class Waveform {
         return m_stemCount > 0;
     }
 
+    // Builds the mip pyramid of the completed waveform data. Level n
+    // reduces 2^n visual frames into a single frame by taking the maximum
+    // of each band and channel. Renderers can then read a fixed number of
+    // values per pixel independent of the zoom factor.
+    void buildMipLevels();
+
+    // Returns the highest mip level that reduces at most the given number
+    // of visual frames into one, or 0 if no mip levels have been built.
+    int selectMipLevel(double visualFramesPerPixel) const;
+
+    // Level 0 is the waveform data itself. Like data() the returned
+    // values are interleaved left/right.
+    const WaveformData* getMipLevelData(int level) const;
+    int getMipLevelDataSize(int level) const;
+
     void dump() const;
 
   private:
+    typedef std::vector<std::vector<WaveformData>> MipLevels;
+
     void readByteArray(const QByteArray& data);
+    void readProtobufByteArray(const QByteArray& data);
+    void readColumnarByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size);
 
@@ -185,6 +224,11 @@ class Waveform {
     // The number of stem contained in waveform samples. 0 if not a stem waveform
     int m_stemCount;
 
+    // The mip levels 1..n. Published once after the waveform has been
+    // completed while renderers might already access the waveform
+    // concurrently. Never modified afterwards.
+    QAtomicPointer<const MipLevels> m_pMipLevels;
+
     mutable QMutex m_mutex;
 
     DISALLOW_COPY_AND_ASSIGN(Waveform);
@@ -21,6 +21,7 @@
 #include "util/math.h"
 #include "util/performancetimer.h"
 #include "util/timer.h"
+#include "util/tracerecorder.h"
 #include "waveform/guitick.h"
 #include "waveform/sharedglcontext.h"
 #include "waveform/visualsmanager.h"
@@ -727,6 +728,7 @@ void WaveformWidgetFactory::notifyZoomChange(WWaveformViewer* viewer) {
 void WaveformWidgetFactory::renderSelf() {
     ScopedTimer t(QStringLiteral("WaveformWidgetFactory::render() %1waveforms"),
             static_cast<int>(m_waveformWidgetHolders.size()));
+    mixxx::ScopedTraceEvent traceEvent("WaveformWidgetFactory::render");
 
     if (!m_skipRender) {
         if (m_type) {   // no regular updates for an empty waveform
@@ -801,6 +803,7 @@ void WaveformWidgetFactory::render() {
 void WaveformWidgetFactory::swapSelf() {
     ScopedTimer t(QStringLiteral("WaveformWidgetFactory::swap() %1waveforms"),
             static_cast<int>(m_waveformWidgetHolders.size()));
+    mixxx::ScopedTraceEvent traceEvent("WaveformWidgetFactory::swap");
 
     // Do this in an extra slot to be sure to hit the desired interval
     if (!m_skipRender) {
@@ -51,7 +51,8 @@ QString Paintable::DrawModeToString(DrawMode mode) {
 }
 
 Paintable::Paintable(const PixmapSource& source, DrawMode mode, double scaleFactor)
-        : m_drawMode(mode) {
+        : m_fileName(source.isEmpty() ? QString() : source.getPath()),
+          m_drawMode(mode) {
     if (!source.isSVG()) {
         auto pPixmap = WPixmapStore::getPixmapNoCache(source.getPath(), scaleFactor);
         if (!pPixmap) {
@@ -232,43 +233,34 @@ void Paintable::drawInternal(const QRectF& targetRect, QPainter* pPainter,
     // qDebug() << "Paintable::drawInternal" << DrawModeToString(m_drawMode)
     //          << targetRect << sourceRect;
     if (m_pSvg) {
+        qreal devicePixelRatio = pPainter->device()->devicePixelRatio();
         if (m_drawMode == DrawMode::Tile) {
             if (!m_pPixmap) {
                 // qDebug() << "Paintable cache miss";
-                qreal devicePixelRatio = pPainter->device()->devicePixelRatio();
-                m_pPixmap = std::make_unique<QPixmap>(m_pSvg->defaultSize() * devicePixelRatio);
-                m_pPixmap->setDevicePixelRatio(devicePixelRatio);
-                m_pPixmap->fill(Qt::transparent);
-                { // QPainter Scope
-                    auto pixmapPainter = QPainter(m_pPixmap.get());
-                    m_pSvg->render(&pixmapPainter);
-                }
-                mayCorrectColors();
+                rasterizeSvg(m_pSvg->defaultSize(), devicePixelRatio, true);
             }
             // The SVG renderer doesn't directly support tiling, so we render
             // it to a pixmap which will then get tiled.
             pPainter->drawTiledPixmap(targetRect, *m_pPixmap);
         } else {
+            const QSize targetSize = targetRect.size().toSize();
+            // The size of the pixmap is in device pixels
             if (!m_pPixmap ||
-                    m_pPixmap->size() != targetRect.size().toSize() ||
+                    m_pPixmap->size() != targetSize * devicePixelRatio ||
                     m_lastSourceRect != sourceRect) {
                 // qDebug() << "Paintable cache miss";
-                qreal devicePixelRatio = pPainter->device()->devicePixelRatio();
-                m_pPixmap = std::make_unique<QPixmap>(
-                        targetRect.size().toSize() * devicePixelRatio);
-                m_pPixmap->setDevicePixelRatio(devicePixelRatio);
-                m_pPixmap->fill(Qt::transparent);
-                { // QPainter Scope
-                    auto pixmapPainter = QPainter(m_pPixmap.get());
-                    QRectF deviceSourceRect = QRectF(
-                            sourceRect.x() * devicePixelRatio,
-                            sourceRect.y() * devicePixelRatio,
-                            sourceRect.width() * devicePixelRatio,
-                            sourceRect.height() * devicePixelRatio);
-                    m_pSvg->setViewBox(deviceSourceRect);
-                    m_pSvg->render(&pixmapPainter);
+                QRectF deviceSourceRect = QRectF(
+                        sourceRect.x() * devicePixelRatio,
+                        sourceRect.y() * devicePixelRatio,
+                        sourceRect.width() * devicePixelRatio,
+                        sourceRect.height() * devicePixelRatio);
+                m_pSvg->setViewBox(deviceSourceRect);
+                if (m_persistentSize.isEmpty()) {
+                    m_persistentSize = targetSize;
                 }
-                mayCorrectColors();
+                rasterizeSvg(targetSize,
+                        devicePixelRatio,
+                        targetSize == m_persistentSize);
                 m_lastSourceRect = sourceRect;
             }
             pPainter->drawPixmap(targetRect.topLeft(), *m_pPixmap);
@@ -295,11 +287,35 @@ void Paintable::drawInternal(const QRectF& targetRect, QPainter* pPainter,
     }
 }
 
-
-void Paintable::mayCorrectColors() {
-    if (WPixmapStore::willCorrectColors()) {
-        QImage image = m_pPixmap->toImage();
-        WPixmapStore::correctImageColors(&image);
-        m_pPixmap->convertFromImage(image);
+void Paintable::rasterizeSvg(const QSize& size, qreal devicePixelRatio, bool persistent) {
+    QString variant;
+    QImage image;
+    if (persistent) {
+        const QRectF viewBox = m_pSvg->viewBoxF();
+        variant = QStringLiteral("svg:%1x%2@%3:%4,%5,%6,%7")
+                          .arg(QString::number(size.width()),
+                                  QString::number(size.height()),
+                                  QString::number(devicePixelRatio),
+                                  QString::number(viewBox.x()),
+                                  QString::number(viewBox.y()),
+                                  QString::number(viewBox.width()),
+                                  QString::number(viewBox.height()));
+        image = WPixmapStore::loadCachedImage(m_fileName, variant);
+    }
+    if (image.isNull()) {
+        image = QImage(size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(devicePixelRatio);
+        image.fill(Qt::transparent);
+        { // QPainter Scope
+            auto imagePainter = QPainter(&image);
+            m_pSvg->render(&imagePainter);
+        }
+        if (WPixmapStore::willCorrectColors()) {
+            WPixmapStore::correctImageColors(&image);
+        }
+        if (persistent) {
+            WPixmapStore::storeCachedImage(m_fileName, variant, image);
+        }
     }
+    m_pPixmap = std::make_unique<QPixmap>(QPixmap::fromImage(image));
 }
@@ -52,10 +52,18 @@ class Paintable {
   private:
     void drawInternal(const QRectF& targetRect, QPainter* pPainter,
                       const QRectF& sourceRect);
-    void mayCorrectColors();
+    // Renders the current view box of the SVG into m_pPixmap. Persistent
+    // rasterizations are loaded from and stored in the image cache of
+    // WPixmapStore, others are only kept in memory.
+    void rasterizeSvg(const QSize& size, qreal devicePixelRatio, bool persistent);
 
+    QString m_fileName;
     std::unique_ptr<QPixmap> m_pPixmap;
     std::unique_ptr<QSvgRenderer> m_pSvg;
     DrawMode m_drawMode;
     QRectF m_lastSourceRect;
+    // The target size of the first paint after the skin has been loaded.
+    // Only rasterizations of this size are cached on disk, so resizing the
+    // window doesn't fill the cache with transient sizes.
+    QSize m_persistentSize;
 };
@@ -1,11 +1,58 @@
 #include "widget/wpixmapstore.h"
 
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
 #include "skin/legacy/imgloader.h"
+#include "skin/legacy/skinimagecache.h"
+#include "util/timer.h"
 #include "widget/paintable.h"
 
+namespace {
+
+// The cache keeps all images of a few skins and color schemes
+constexpr qint64 kMaxImageCacheSize = 256 * 1024 * 1024;
+
+QString bitmapVariant(double scaleFactor) {
+    return QStringLiteral("bitmap@") + QString::number(scaleFactor);
+}
+
+QString fileListName(const QString& skinPath, double scaleFactor) {
+    return skinPath + QChar('@') + QString::number(scaleFactor);
+}
+
+/// Decodes, scales and color corrects the bitmap unless it is cached.
+/// Thread-safe, the loaders don't have any mutable state.
+QImage loadBitmap(const ImgSource& loader,
+        const SkinImageCache* pCache,
+        const QString& fileName,
+        double scaleFactor) {
+    if (pCache) {
+        QImage image = pCache->load(fileName, bitmapVariant(scaleFactor));
+        if (!image.isNull()) {
+            return image;
+        }
+    }
+    const std::unique_ptr<QImage> pImage(loader.getImage(fileName, scaleFactor));
+    if (!pImage || pImage->isNull()) {
+        return QImage();
+    }
+    if (pCache) {
+        pCache->store(fileName, bitmapVariant(scaleFactor), *pImage);
+    }
+    return *pImage;
+}
+
+} // namespace
+
 // static
 QHash<PixmapKey, WeakPaintablePointer> WPixmapStore::m_paintableCache;
 std::shared_ptr<ImgSource> WPixmapStore::m_loader = std::make_shared<ImgLoader>();
+std::shared_ptr<SkinImageCache> WPixmapStore::m_pImageCache;
+QString WPixmapStore::m_loadingSkinPath;
+double WPixmapStore::m_loadingScaleFactor = 1.0;
+QHash<QString, QImage> WPixmapStore::m_preloadedImages;
+QSet<QString> WPixmapStore::m_usedFileNames;
 
 // static
 PaintablePointer WPixmapStore::getPaintable(const PixmapSource& source,
@@ -33,11 +80,23 @@ PaintablePointer WPixmapStore::getPaintable(const PixmapSource& source,
 std::unique_ptr<QPixmap> WPixmapStore::getPixmapNoCache(
         const QString& fileName,
         double scaleFactor) {
-    auto* pImage = m_loader->getImage(fileName, scaleFactor);
-    if (!pImage || pImage->isNull()) {
+    const QImage image = loadImage(fileName, scaleFactor);
+    if (image.isNull()) {
         return nullptr;
     }
-    return std::make_unique<QPixmap>(QPixmap::fromImage(*pImage));
+    return std::make_unique<QPixmap>(QPixmap::fromImage(image));
+}
+
+// static
+QImage WPixmapStore::loadImage(const QString& fileName, double scaleFactor) {
+    if (!m_loadingSkinPath.isEmpty() && scaleFactor == m_loadingScaleFactor) {
+        m_usedFileNames.insert(fileName);
+        const auto it = m_preloadedImages.constFind(fileName);
+        if (it != m_preloadedImages.constEnd()) {
+            return it.value();
+        }
+    }
+    return loadBitmap(*m_loader, m_pImageCache.get(), fileName, scaleFactor);
 }
 
 // static
@@ -57,3 +116,74 @@ void WPixmapStore::setLoader(std::shared_ptr<ImgSource> ld) {
     // referring to them are destroyed.
     m_paintableCache.clear();
 }
+
+// static
+void WPixmapStore::setImageCache(std::shared_ptr<SkinImageCache> pCache) {
+    m_pImageCache = std::move(pCache);
+}
+
+// static
+QImage WPixmapStore::loadCachedImage(const QString& fileName, const QString& variant) {
+    if (!m_pImageCache) {
+        return QImage();
+    }
+    return m_pImageCache->load(fileName, variant);
+}
+
+// static
+void WPixmapStore::storeCachedImage(const QString& fileName,
+        const QString& variant,
+        const QImage& image) {
+    if (!m_pImageCache) {
+        return;
+    }
+    QThreadPool::globalInstance()->start(
+            [pCache = m_pImageCache, fileName, variant, image]() {
+                pCache->store(fileName, variant, image);
+            });
+}
+
+// static
+void WPixmapStore::beginSkinLoad(const QString& skinPath, double scaleFactor) {
+    ScopedTimer t(QStringLiteral("WPixmapStore::beginSkinLoad"));
+    m_loadingSkinPath = skinPath;
+    m_loadingScaleFactor = scaleFactor;
+    m_preloadedImages.clear();
+    m_usedFileNames.clear();
+    if (!m_pImageCache) {
+        return;
+    }
+
+    const QStringList fileNames = m_pImageCache->loadFileList(
+            fileListName(skinPath, scaleFactor));
+    const std::shared_ptr<ImgSource> pLoader = m_loader;
+    const std::shared_ptr<SkinImageCache> pCache = m_pImageCache;
+    // Runs in the global thread pool and the calling thread
+    const QList<QImage> images = QtConcurrent::blockingMapped<QList<QImage>>(
+            fileNames,
+            [pLoader, pCache, scaleFactor](const QString& fileName) {
+                return loadBitmap(*pLoader, pCache.get(), fileName, scaleFactor);
+            });
+    for (int i = 0; i < fileNames.size(); ++i) {
+        if (!images[i].isNull()) {
+            m_preloadedImages.insert(fileNames[i], images[i]);
+        }
+    }
+}
+
+// static
+void WPixmapStore::endSkinLoad() {
+    if (m_pImageCache && !m_loadingSkinPath.isEmpty()) {
+        QThreadPool::globalInstance()->start(
+                [pCache = m_pImageCache,
+                        name = fileListName(m_loadingSkinPath, m_loadingScaleFactor),
+                        fileNames = QStringList(m_usedFileNames.cbegin(),
+                                m_usedFileNames.cend())]() {
+                    pCache->storeFileList(name, fileNames);
+                    pCache->prune(kMaxImageCacheSize);
+                });
+    }
+    m_loadingSkinPath.clear();
+    m_preloadedImages.clear();
+    m_usedFileNames.clear();
+}
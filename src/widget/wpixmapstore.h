@@ -5,6 +5,7 @@
 #include <QPainter>
 #include <QPixmap>
 #include <QRectF>
+#include <QSet>
 #include <QString>
 #include <QSvgRenderer>
 #include <memory>
@@ -13,6 +14,8 @@
 #include "skin/legacy/pixmapsource.h"
 #include "widget/paintable.h"
 
+class SkinImageCache;
+
 struct PixmapKey {
     QString path;
     Paintable::DrawMode mode;
@@ -45,7 +48,33 @@ class WPixmapStore {
     static void correctImageColors(QImage* p);
     static bool willCorrectColors();
 
+    /// Sets the persistent cache for the images of the current skin and
+    /// color scheme, nullptr disables it.
+    static void setImageCache(std::shared_ptr<SkinImageCache> pCache);
+    /// Returns a null image if the image is not cached.
+    static QImage loadCachedImage(const QString& fileName, const QString& variant);
+    /// Stores the image in the background.
+    static void storeCachedImage(const QString& fileName,
+            const QString& variant,
+            const QImage& image);
+
+    /// Loads the bitmaps that the previous load of the skin has used in
+    /// parallel, and records the bitmaps that are used until endSkinLoad().
+    static void beginSkinLoad(const QString& skinPath, double scaleFactor);
+    /// Remembers the used bitmaps for the next load and releases the
+    /// preloaded ones.
+    static void endSkinLoad();
+
   private:
+    static QImage loadImage(const QString& fileName, double scaleFactor);
+
     static QHash<PixmapKey, WeakPaintablePointer> m_paintableCache;
     static std::shared_ptr<ImgSource> m_loader;
+    static std::shared_ptr<SkinImageCache> m_pImageCache;
+
+    // The state of the skin that is currently being loaded
+    static QString m_loadingSkinPath;
+    static double m_loadingScaleFactor;
+    static QHash<QString, QImage> m_preloadedImages;
+    static QSet<QString> m_usedFileNames;
 };